@@ -12,6 +12,11 @@ B2_ARGS="${B2_ARGS:-32 32 32 100 5}"
 B3_ARGS="${B3_ARGS:-32 32 32 100 5}"
 B4_ARGS="${B4_ARGS:-32 32 32 20 3}"
 B5_ARGS="${B5_ARGS:-16384 200 20 8}"
+B6_ARGS="${B6_ARGS:-64 64 64 10 2 8}"
+B7_ARGS="${B7_ARGS:-64 8 2000 16}"
+B8_ARGS="${B8_ARGS:-128 128 128 10 4}"
+B9_ARGS="${B9_ARGS:-96000 128 480000 2}"
+B10_ARGS="${B10_ARGS:-65536 20}"
 
 echo "--- Configuring project ---"
 cmake -S "$ROOT_DIR" -B "$BUILD_DIR" -DCMAKE_BUILD_TYPE="$BUILD_TYPE"
@@ -22,7 +27,12 @@ for target in \
   benchmark_c2r_3d_long_double \
   benchmark_r2r_3d_float \
   benchmark_c2c_3d_all_precisions \
-  benchmark_parallel_c2c_1d_threads
+  benchmark_parallel_c2c_1d_threads \
+  benchmark_parallel_c2c_3d \
+  benchmark_coalesced_c2c_1d \
+  benchmark_nested_flatten \
+  benchmark_partitioned_convolution \
+  benchmark_pruned_dft
 do
   echo "Building: $target"
   cmake --build "$BUILD_DIR" --target "$target"
@@ -54,5 +64,30 @@ echo
 echo ">>> benchmark_parallel_c2c_1d_threads $B5_ARGS"
 "$BUILD_DIR/benchmark_parallel_c2c_1d_threads" $B5_ARGS
 
+echo
+
+echo ">>> benchmark_parallel_c2c_3d $B6_ARGS"
+"$BUILD_DIR/benchmark_parallel_c2c_3d" $B6_ARGS
+
+echo
+
+echo ">>> benchmark_coalesced_c2c_1d $B7_ARGS"
+"$BUILD_DIR/benchmark_coalesced_c2c_1d" $B7_ARGS
+
+echo
+
+echo ">>> benchmark_nested_flatten $B8_ARGS"
+"$BUILD_DIR/benchmark_nested_flatten" $B8_ARGS
+
+echo
+
+echo ">>> benchmark_partitioned_convolution $B9_ARGS"
+"$BUILD_DIR/benchmark_partitioned_convolution" $B9_ARGS
+
+echo
+
+echo ">>> benchmark_pruned_dft $B10_ARGS"
+"$BUILD_DIR/benchmark_pruned_dft" $B10_ARGS
+
 echo
 echo "--- All benchmarks completed successfully ---"
@@ -8,6 +8,10 @@
 namespace clapfft
 {
 
+    // FFTW's advanced interface. Plans go through PlanCache and are reused
+    // across calls; ranks above PlanKey::max_rank (8) are planned on the
+    // caller's arrays for each call instead, so planning flags other than
+    // ESTIMATE may overwrite them as plain FFTW would.
     class AdvancedFFT
     {
     public:
@@ -18,7 +22,8 @@ namespace clapfft
                              std::complex<T> *out, const int *onembed,
                              int ostride, int odist,
                              int sign,
-                             fft_flags flags = CLAP_FFT_ESTIMATE);
+                             fft_flags flags = CLAP_FFT_DEFAULT,
+                             int nthreads = 1);
 
         template <typename T>
         static void many_dft_r2c(int rank, const int *n, int howmany,
@@ -26,7 +31,8 @@ namespace clapfft
                                  int istride, int idist,
                                  std::complex<T> *out, const int *onembed,
                                  int ostride, int odist,
-                                 fft_flags flags = CLAP_FFT_ESTIMATE);
+                                 fft_flags flags = CLAP_FFT_DEFAULT,
+                                 int nthreads = 1);
 
         template <typename T>
         static void many_dft_c2r(int rank, const int *n, int howmany,
@@ -34,7 +40,8 @@ namespace clapfft
                                  int istride, int idist,
                                  T *out, const int *onembed,
                                  int ostride, int odist,
-                                 fft_flags flags = CLAP_FFT_ESTIMATE);
+                                 fft_flags flags = CLAP_FFT_DEFAULT,
+                                 int nthreads = 1);
 
         template <typename T>
         static void many_r2r(int rank, const int *n, int howmany,
@@ -43,7 +50,8 @@ namespace clapfft
                              T *out, const int *onembed,
                              int ostride, int odist,
                              const int *kind,
-                             fft_flags flags = CLAP_FFT_ESTIMATE);
+                             fft_flags flags = CLAP_FFT_DEFAULT,
+                             int nthreads = 1);
     };
 
 } // namespace clapfft
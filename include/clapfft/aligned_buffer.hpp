@@ -0,0 +1,90 @@
+#ifndef CLAPFFT_ALIGNED_BUFFER_HPP
+#define CLAPFFT_ALIGNED_BUFFER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace clapfft
+{
+    // Start alignment of every AlignedBuffer; a cache line, and enough for
+    // any SIMD load or non-temporal store.
+    const std::size_t buffer_alignment = 64;
+
+    // Fixed-size, buffer_alignment-aligned array of trivially copyable
+    // values. The sized constructor zeroes the elements; uninitialized()
+    // leaves them as allocated, for buffers that are about to be
+    // overwritten completely anyway.
+    template <typename U>
+    class AlignedBuffer
+    {
+    public:
+        AlignedBuffer() : storage(nullptr), values(nullptr), count(0) {}
+
+        explicit AlignedBuffer(std::size_t n) : AlignedBuffer(uninitialized(n))
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                new (values + i) U();
+            }
+        }
+
+        static AlignedBuffer uninitialized(std::size_t n)
+        {
+            AlignedBuffer buffer;
+            if (n == 0)
+            {
+                return buffer;
+            }
+            buffer.storage = ::operator new(n * sizeof(U) + buffer_alignment);
+            const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(buffer.storage);
+            const std::size_t offset = (buffer_alignment - address % buffer_alignment) % buffer_alignment;
+            buffer.values = reinterpret_cast<U *>(static_cast<unsigned char *>(buffer.storage) + offset);
+            buffer.count = n;
+            return buffer;
+        }
+
+        ~AlignedBuffer()
+        {
+            ::operator delete(storage);
+        }
+
+        AlignedBuffer(AlignedBuffer &&other) : storage(other.storage), values(other.values), count(other.count)
+        {
+            other.storage = nullptr;
+            other.values = nullptr;
+            other.count = 0;
+        }
+
+        AlignedBuffer &operator=(AlignedBuffer &&other)
+        {
+            if (this != &other)
+            {
+                ::operator delete(storage);
+                storage = other.storage;
+                values = other.values;
+                count = other.count;
+                other.storage = nullptr;
+                other.values = nullptr;
+                other.count = 0;
+            }
+            return *this;
+        }
+
+        AlignedBuffer(const AlignedBuffer &) = delete;
+        AlignedBuffer &operator=(const AlignedBuffer &) = delete;
+
+        U *data() { return values; }
+        const U *data() const { return values; }
+        std::size_t size() const { return count; }
+        U &operator[](std::size_t i) { return values[i]; }
+        const U &operator[](std::size_t i) const { return values[i]; }
+
+    private:
+        void *storage;
+        U *values;
+        std::size_t count;
+    };
+} // namespace clapfft
+
+#endif // CLAPFFT_ALIGNED_BUFFER_HPP
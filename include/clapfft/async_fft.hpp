@@ -0,0 +1,74 @@
+#ifndef CLAPFFT_ASYNC_FFT_HPP
+#define CLAPFFT_ASYNC_FFT_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "batch_fft.hpp"
+
+namespace clapfft
+{
+    // Runs transforms on its own worker threads so the caller can overlap
+    // I/O and pre/post-processing with FFT execution. submit() hands back
+    // a std::future<bool> that becomes ready once the job ran; its value is
+    // what BatchFFT::execute would have returned. The submission queue is
+    // bounded: submit() blocks while it is full, try_submit() fails
+    // instead, which gives producers natural back-pressure.
+    //
+    // The arrays of a job must stay valid until its future is ready.
+    class AsyncFFT
+    {
+    public:
+        // threads == 0 uses std::thread::hardware_concurrency().
+        explicit AsyncFFT(unsigned threads = 0, std::size_t queue_capacity = 1024);
+
+        // Runs every job already queued, then stops the workers.
+        ~AsyncFFT();
+
+        AsyncFFT(const AsyncFFT &) = delete;
+        AsyncFFT &operator=(const AsyncFFT &) = delete;
+
+        template <typename T>
+        std::future<bool> submit(const TransformJob<T> &job);
+
+        // Leaves `result` untouched and returns false if the queue is full.
+        template <typename T>
+        bool try_submit(const TransformJob<T> &job, std::future<bool> &result);
+
+        // Blocks until the queue is empty and no job is running.
+        void wait_idle();
+
+        std::size_t pending() const; // queued, not yet started
+        std::size_t capacity() const;
+        unsigned size() const;
+
+        // Shared executor sized to the machine, created on first use.
+        static AsyncFFT &global();
+
+    private:
+        using Task = std::packaged_task<bool()>;
+
+        bool enqueue(Task &task, bool wait);
+        void worker_loop();
+
+        const std::size_t queue_capacity;
+        std::deque<Task> queue;
+        std::size_t running;
+        bool stopping;
+
+        mutable std::mutex mutex;
+        std::condition_variable not_empty;
+        std::condition_variable not_full;
+        std::condition_variable idle;
+
+        std::vector<std::thread> threads;
+    };
+
+} // namespace clapfft
+
+#endif // CLAPFFT_ASYNC_FFT_HPP
@@ -0,0 +1,114 @@
+#ifndef CLAPFFT_BATCH_FFT_HPP
+#define CLAPFFT_BATCH_FFT_HPP
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+#include "fft_flags.hpp"
+#include "plan_key.hpp"
+#include "thread_pool.hpp"
+
+namespace clapfft
+{
+    // One independent transform of a batch: what to compute (the PlanKey
+    // shape, kind, sign, r2r kinds, flags and FFTW thread count) and on
+    // which tightly packed, row-major arrays.
+    template <typename T>
+    struct TransformJob
+    {
+        PlanKey key;
+        const void *in;
+        void *out;
+
+        TransformJob() : key(), in(nullptr), out(nullptr) {}
+
+        static TransformJob c2c(int rank, const int *n, const std::complex<T> *in, std::complex<T> *out, int sign,
+                                fft_flags flags = CLAP_FFT_DEFAULT)
+        {
+            TransformJob job = make(TransformKind::C2C, rank, n, in, out, flags);
+            job.key.sign = sign;
+            return job;
+        }
+
+        static TransformJob r2c(int rank, const int *n, const T *in, std::complex<T> *out,
+                                fft_flags flags = CLAP_FFT_DEFAULT)
+        {
+            return make(TransformKind::R2C, rank, n, in, out, flags);
+        }
+
+        // The input is left untouched: it is copied to per-worker scratch
+        // first, since FFTW's multi-dimensional c2r overwrites its input.
+        static TransformJob c2r(int rank, const int *n, const std::complex<T> *in, T *out,
+                                fft_flags flags = CLAP_FFT_DEFAULT)
+        {
+            return make(TransformKind::C2R, rank, n, in, out, flags);
+        }
+
+        static TransformJob r2r(int rank, const int *n, const T *in, T *out, const int *kinds,
+                                fft_flags flags = CLAP_FFT_DEFAULT)
+        {
+            TransformJob job = make(TransformKind::R2R, rank, n, in, out, flags);
+            for (int i = 0; i < job.key.rank && kinds != nullptr; ++i)
+            {
+                job.key.r2r_kind[i] = kinds[i];
+            }
+            return job;
+        }
+
+    private:
+        static TransformJob make(TransformKind kind, int rank, const int *n, const void *in, void *out, fft_flags flags)
+        {
+            TransformJob job;
+            if (n != nullptr && rank > 0 && rank <= PlanKey::max_rank)
+            {
+                job.key = PlanKey(kind, rank, n, flags);
+            }
+            job.in = in;
+            job.out = out;
+            return job;
+        }
+    };
+
+    class BatchFFT
+    {
+    public:
+        // Runs every job on `pool` and returns once all of them finished.
+        // Jobs must not write memory that another job of the batch touches;
+        // in-place jobs (in == out) are supported for c2c and r2r. Plans come
+        // from PlanCache<T> and are executed concurrently. Returns false if
+        // some job was malformed or could not be planned; its output is left
+        // as it was and the remaining jobs still run. On a pool pinned to
+        // several NUMA nodes each job is queued on the node holding its input.
+        template <typename T>
+        static bool execute(const TransformJob<T> *jobs, std::size_t count,
+                            ThreadPool &pool = ThreadPool::global());
+
+        template <typename T>
+        static bool execute(const std::vector<TransformJob<T>> &jobs,
+                            ThreadPool &pool = ThreadPool::global());
+
+        // Same contract as execute, for mixed batches such as hundreds of
+        // signals of a dozen lengths. Jobs are grouped by plan key and each
+        // group runs as cached many-plans (howmany > 1) instead of one
+        // transform per job: directly on the caller's arrays when they are
+        // evenly spaced in memory, otherwise through packed, aligned
+        // per-worker copies. Large groups are split so groups and their
+        // pieces spread across the pool. Jobs with their own strides or
+        // batching run one by one.
+        template <typename T>
+        static bool transform_batch(const TransformJob<T> *jobs, std::size_t count,
+                                    ThreadPool &pool = ThreadPool::global());
+
+        template <typename T>
+        static bool transform_batch(const std::vector<TransformJob<T>> &jobs,
+                                    ThreadPool &pool = ThreadPool::global());
+
+        // Runs a single job on the calling thread.
+        template <typename T>
+        static bool execute(const TransformJob<T> &job);
+    };
+
+} // namespace clapfft
+
+#endif // CLAPFFT_BATCH_FFT_HPP
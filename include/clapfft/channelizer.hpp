@@ -0,0 +1,94 @@
+#ifndef CLAPFFT_CHANNELIZER_HPP
+#define CLAPFFT_CHANNELIZER_HPP
+
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "fft_flags.hpp"
+
+namespace clapfft
+{
+    enum class ChannelizerMode
+    {
+        Critical,    // one output block every channels() input samples
+        Oversampled, // one every channels() / 2: twice the output rate
+    };
+
+    // Polyphase FFT channelizer: splits a wideband stream into M =
+    // channels() equally spaced channels, channel k centred on k / M
+    // cycles per sample, each mixed down to baseband, low-pass filtered by
+    // the prototype h and decimated by D = decimation():
+    //
+    //     y_k[m] = sum_j h[j] x[m D - j] exp(-2 pi i k (m D - j) / M),
+    //
+    // with x[t < 0] = 0. Block m is complete once x[m D] has arrived.
+    //
+    // Per block, the last taps() samples are weighted by the (reversed)
+    // prototype and folded into M sums in contiguous passes of M samples,
+    // which the compiler vectorises; the sums are rotated by m D mod M,
+    // which keeps the oversampled mode's channel phases continuous, and
+    // written as one column of a batch. Up to max_batch columns then go
+    // through one cached in-place many_dft plan from PlanCache<T> in a
+    // single call.
+    //
+    // One instance is not safe to use from several threads at once.
+    template <typename T>
+    class Channelizer
+    {
+    public:
+        // The prototype is zero-padded to a multiple of `channels` taps.
+        // Invalid (see valid()) if channels or max_batch is 0, the
+        // prototype is empty, or the mode is Oversampled and channels is
+        // odd.
+        Channelizer(std::size_t channels, const std::vector<T> &prototype,
+                    ChannelizerMode mode = ChannelizerMode::Critical, std::size_t max_batch = 32,
+                    fft_flags flags = CLAP_FFT_DEFAULT);
+
+        // With design_prototype(channels, taps_per_channel).
+        Channelizer(std::size_t channels, std::size_t taps_per_channel = 12,
+                    ChannelizerMode mode = ChannelizerMode::Critical, std::size_t max_batch = 32,
+                    fft_flags flags = CLAP_FFT_DEFAULT);
+
+        Channelizer();
+        ~Channelizer();
+        Channelizer(Channelizer &&other);
+        Channelizer &operator=(Channelizer &&other);
+
+        Channelizer(const Channelizer &) = delete;
+        Channelizer &operator=(const Channelizer &) = delete;
+
+        bool valid() const;
+
+        std::size_t channels() const;
+        ChannelizerMode mode() const;
+        std::size_t decimation() const;
+        // Prototype length after padding.
+        std::size_t taps() const;
+
+        // Output blocks the next push of `count` samples will write.
+        std::size_t output_ready(std::size_t count) const;
+
+        // Feeds `count` samples and writes output_ready(count) blocks of
+        // channels() values to out, block-major (out[b * channels() + k]).
+        // Returns that number.
+        std::size_t push(const std::complex<T> *in, std::size_t count, std::complex<T> *out);
+        std::size_t push(const T *in, std::size_t count, std::complex<T> *out);
+
+        // Drops the history; the next sample is x[0] again.
+        void reset();
+
+        // Windowed-sinc low-pass (Blackman window), cutoff at the channel
+        // edge 1 / (2 channels), channels * taps_per_channel taps, unit DC
+        // gain: a tone at a channel centre comes out at its own amplitude.
+        static std::vector<T> design_prototype(std::size_t channels, std::size_t taps_per_channel);
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> impl;
+    };
+
+} // namespace clapfft
+
+#endif // CLAPFFT_CHANNELIZER_HPP
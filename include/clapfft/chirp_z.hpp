@@ -0,0 +1,86 @@
+#ifndef CLAPFFT_CHIRP_Z_HPP
+#define CLAPFFT_CHIRP_Z_HPP
+
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "fft_flags.hpp"
+
+namespace clapfft
+{
+    // Chirp-Z transform on the unit circle: m DFT bins of an n-point
+    // input at arbitrary, evenly spaced frequencies,
+    //
+    //     X[k] = sum_j x[j] exp(-2 pi i (start + k * step) j),   0 <= k < m
+    //
+    // with start and step in cycles per sample (fractions of the sample
+    // rate; step = 1 / n, start = 0, m = n is the plain DFT). A narrow
+    // band is resolved as finely as a zero-padded FFT of size 1 / step
+    // would, at the cost of transforms of size next_fast_size(n + m - 1).
+    //
+    // Computed by Bluestein's algorithm as a convolution with a chirp. The
+    // chirp tables (input and output twiddles, and the chirp's spectrum
+    // with the 1 / L normalisation folded in) depend only on (n, m, start,
+    // step) and are shared by every ChirpZ of that configuration through
+    // a process-wide cache. Each transform is then one forward and one
+    // backward in-place c2c FFT from PlanCache<T> plus two pointwise
+    // products.
+    //
+    // One instance is not safe to use from several threads at once; give
+    // each thread its own, they share the tables.
+    template <typename T>
+    class ChirpZ
+    {
+    public:
+        // Invalid (see valid()) if n or m is 0, step or start is not
+        // finite, or the FFT size does not fit FFTW's int sizes.
+        ChirpZ(std::size_t n, std::size_t m, double start, double step, fft_flags flags = CLAP_FFT_DEFAULT);
+
+        ChirpZ();
+        ~ChirpZ();
+        ChirpZ(ChirpZ &&other);
+        ChirpZ &operator=(ChirpZ &&other);
+
+        ChirpZ(const ChirpZ &) = delete;
+        ChirpZ &operator=(const ChirpZ &) = delete;
+
+        bool valid() const;
+
+        std::size_t input_size() const;
+        std::size_t output_size() const;
+        // The Bluestein convolution length.
+        std::size_t fft_size() const;
+
+        // Frequency of output k in cycles per sample.
+        double frequency(std::size_t k) const;
+
+        // Reads input_size() values and writes output_size(); in and out
+        // may not overlap. Returns false if the instance is invalid.
+        bool transform(const std::complex<T> *in, std::complex<T> *out);
+        bool transform(const T *in, std::complex<T> *out);
+
+        // Drops every cached chirp table no ChirpZ is using.
+        static void clear_cache();
+
+    private:
+        struct Tables;
+        struct Impl;
+        std::unique_ptr<Impl> impl;
+    };
+
+    // One-shot forms through the shared table cache; empty on invalid
+    // sizes.
+    template <typename T>
+    std::vector<std::complex<T>> chirp_z(const std::vector<std::complex<T>> &x, std::size_t m, double start,
+                                         double step);
+
+    // m bins evenly covering [f_start, f_stop) in cycles per sample:
+    // step = (f_stop - f_start) / m.
+    template <typename T>
+    std::vector<std::complex<T>> zoom_fft(const std::vector<T> &x, double f_start, double f_stop, std::size_t m);
+
+} // namespace clapfft
+
+#endif // CLAPFFT_CHIRP_Z_HPP
@@ -0,0 +1,60 @@
+#ifndef CLAPFFT_COALESCING_FFT_HPP
+#define CLAPFFT_COALESCING_FFT_HPP
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+
+#include "fft_flags.hpp"
+
+namespace clapfft
+{
+    struct CoalescingOptions
+    {
+        std::size_t max_batch = 16; // requests packed into one execution
+        long window_us = 50;        // longest a batch waits for more requests
+    };
+
+    struct CoalescingStats
+    {
+        std::uint64_t requests = 0;
+        std::uint64_t batches = 0;
+
+        double average_batch() const
+        {
+            return batches == 0 ? 0.0 : static_cast<double>(requests) / static_cast<double>(batches);
+        }
+    };
+
+    // Opt-in micro-batching of concurrent 1D c2c transforms. The first
+    // caller for a given (precision, n, sign, flags) opens a batch and
+    // waits up to window_us for others to join, or until max_batch
+    // requests are in. Every caller copies its input into the batch, one
+    // cached many_dft plan transforms them all at once, and each caller
+    // copies its own result back out. This trades up to window_us of
+    // latency for fewer, wider executions.
+    //
+    // While enabled, FFT::c2c_1d routes single-threaded calls through it.
+    class CoalescingFFT
+    {
+    public:
+        static void set_enabled(bool enabled);
+        static bool enabled();
+
+        // Applies to batches opened afterwards.
+        static void set_options(const CoalescingOptions &options);
+        static CoalescingOptions options();
+
+        // Same result as an unbatched c2c transform of n points; in == out
+        // is allowed. Returns false if the batch could not be planned.
+        template <typename T>
+        static bool c2c_1d(const std::complex<T> *in, std::complex<T> *out, int n, int sign,
+                           fft_flags flags = CLAP_FFT_DEFAULT);
+
+        static CoalescingStats stats();
+        static void reset_stats();
+    };
+
+} // namespace clapfft
+
+#endif // CLAPFFT_COALESCING_FFT_HPP
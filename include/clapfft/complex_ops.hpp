@@ -0,0 +1,34 @@
+#ifndef CLAPFFT_COMPLEX_OPS_HPP
+#define CLAPFFT_COMPLEX_OPS_HPP
+
+#include <complex>
+#include <cstddef>
+
+namespace clapfft
+{
+    // Element-wise kernels for spectra (pointwise products between a
+    // forward and an inverse transform). float and double use SSE2 where
+    // the compiler targets it, two or one complex values per vector; long
+    // double and other targets use a plain loop. None of them follow the
+    // C99 Annex G inf/NaN rules that std::complex's operator* does, which
+    // is what keeps them vectorisable.
+    struct ComplexOps
+    {
+        // out[i] = a[i] * b[i]; out may alias a or b.
+        template <typename T>
+        static void multiply(const std::complex<T> *a, const std::complex<T> *b, std::complex<T> *out,
+                             std::size_t count);
+
+        // acc[i] += a[i] * b[i]; acc must not alias a or b.
+        template <typename T>
+        static void multiply_add(const std::complex<T> *a, const std::complex<T> *b, std::complex<T> *acc,
+                                 std::size_t count);
+
+        // acc[i] += |a[i]|^2.
+        template <typename T>
+        static void norm_add(const std::complex<T> *a, T *acc, std::size_t count);
+    };
+
+} // namespace clapfft
+
+#endif // CLAPFFT_COMPLEX_OPS_HPP
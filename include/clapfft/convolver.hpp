@@ -0,0 +1,95 @@
+#ifndef CLAPFFT_CONVOLVER_HPP
+#define CLAPFFT_CONVOLVER_HPP
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "fft_flags.hpp"
+
+namespace clapfft
+{
+    // Streaming FIR filter by FFT overlap-save. Each block transforms the
+    // last taps() - 1 input samples plus block_size() new ones
+    // (fft_size() = block_size() + taps() - 1 points) r2c, multiplies by
+    // the kernel spectrum, transforms back c2r and keeps the block_size()
+    // samples free of circular wrap-around. The kernel spectrum (with the
+    // 1 / fft_size() normalisation folded in) is computed once, on
+    // construction.
+    //
+    // All channels share the kernel and are transformed together through
+    // one cached many_dft_r2c / many_dft_c2r pair, so a block costs one
+    // plan execution each way whatever the channel count.
+    //
+    // Output is the causal convolution y[t] = sum_k h[k] x[t - k] with
+    // x[t < 0] = 0, produced one whole block at a time: push() returns how
+    // many samples per channel became available, and flush() pads with
+    // zeros to drain the rest, taps() - 1 samples of tail included.
+    //
+    // One instance is not safe to use from several threads at once.
+    template <typename T>
+    class Convolver
+    {
+    public:
+        // block_size = 0 picks the FFT size with the lowest estimated cost
+        // per output sample (see choose_fft_size); otherwise the FFT size
+        // is the next power of two holding block_size + taps - 1 points,
+        // and block_size() may come out larger than asked. Invalid (see
+        // valid()) if the kernel is empty or there are no channels.
+        Convolver(const std::vector<T> &kernel, std::size_t channels = 1, std::size_t block_size = 0,
+                  fft_flags flags = CLAP_FFT_DEFAULT);
+
+        Convolver();
+        ~Convolver();
+        Convolver(Convolver &&other);
+        Convolver &operator=(Convolver &&other);
+
+        Convolver(const Convolver &) = delete;
+        Convolver &operator=(const Convolver &) = delete;
+
+        bool valid() const;
+
+        std::size_t taps() const;
+        std::size_t channels() const;
+        std::size_t block_size() const;
+        std::size_t fft_size() const;
+
+        // Samples per channel the next push of `count` samples will write.
+        std::size_t output_ready(std::size_t count) const;
+
+        // Feeds `count` samples to every channel (in[c], out[c] per channel)
+        // and writes output_ready(count) samples per channel. Returns that
+        // number.
+        std::size_t push(const T *const *in, std::size_t count, T *const *out);
+
+        // Single-channel forms.
+        std::size_t push(const T *in, std::size_t count, T *out);
+        std::size_t push(const std::vector<T> &in, std::vector<T> &out);
+
+        // One vector per channel, all of the same length; appends.
+        std::size_t push(const std::vector<std::vector<T>> &in, std::vector<std::vector<T>> &out);
+
+        // Ends the stream: writes the samples still owed per channel (the
+        // buffered partial block plus the taps() - 1 sample tail; at most
+        // block_size() + taps() - 1), then starts over as after reset().
+        // Returns that number, 0 if nothing was pushed.
+        std::size_t flush(T *const *out);
+        std::size_t flush(T *out);
+        std::size_t flush(std::vector<T> &out);
+        std::size_t flush(std::vector<std::vector<T>> &out);
+
+        // Drops buffered input and history.
+        void reset();
+
+        // FFT size for a kernel of `taps` taps: the power of two, at least
+        // 2 * taps, minimising (log2(N) + 1) * N / (N - taps + 1).
+        static std::size_t choose_fft_size(std::size_t taps);
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> impl;
+    };
+
+} // namespace clapfft
+
+#endif // CLAPFFT_CONVOLVER_HPP
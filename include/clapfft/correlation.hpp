@@ -0,0 +1,124 @@
+#ifndef CLAPFFT_CORRELATION_HPP
+#define CLAPFFT_CORRELATION_HPP
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "fft_flags.hpp"
+
+namespace clapfft
+{
+    // Smallest n' >= n whose only prime factors are 2, 3, 5 and 7, the
+    // radices FFTW has fast codelets for.
+    std::size_t next_fast_size(std::size_t n);
+
+    struct CorrelationOptions
+    {
+        // Write the Pearson correlation coefficient of the overlapping
+        // samples at each lag (zero-normalised cross-correlation, in
+        // [-1, 1]) instead of the plain sum of products.
+        bool normalize;
+        // With normalize, lags whose overlap covers less than this
+        // fraction of the smaller array's elements, or where either side
+        // is constant over the overlap, are written as 0. The extreme lags
+        // overlap in one or two samples, where the coefficient is a
+        // meaningless +-1, so some floor is needed to pick a peak.
+        double min_overlap;
+        // Signals transformed per batched plan execution.
+        std::size_t max_batch;
+        fft_flags flags;
+
+        CorrelationOptions() : normalize(false), min_overlap(0.5), max_batch(8), flags(CLAP_FFT_DEFAULT) {}
+    };
+
+    // Full linear cross-correlation of real 1D, 2D or 3D arrays by FFT,
+    //
+    //     r[l] = sum_t x[t + l] * y[t],   -(ny - 1) <= l <= nx - 1
+    //
+    // per axis, for signals x of signal_dims against a fixed template y of
+    // template_dims (row-major, same rank). Output element k along an axis
+    // is lag k - (ny - 1) on that axis, so the output is nx + ny - 1 long
+    // per axis and lag 0 sits at index ny - 1: numpy.correlate(x, y,
+    // "full") in 1D.
+    //
+    // Each axis is zero-padded to next_fast_size(nx + ny - 1). The
+    // template spectrum (conjugated, with the c2r normalisation folded in)
+    // is computed once; apply() then costs one r2c, one pointwise product
+    // and one c2r per signal, run options.max_batch signals at a time
+    // through cached many_dft_r2c / many_dft_c2r plans, with scratch kept
+    // between calls.
+    //
+    // Constructed without a template, apply() writes each signal's own
+    // autocorrelation (template_dims = signal_dims, y = x), from a single
+    // forward transform.
+    //
+    // With options.normalize the means and energies of both sides over
+    // each lag's overlap come from summed-area tables built alongside the
+    // transforms, so the normalised result costs O(1) extra per output
+    // element.
+    //
+    // One instance is not safe to use from several threads at once.
+    template <typename T>
+    class Correlator
+    {
+    public:
+        // Invalid (see valid()) unless 1 <= rank <= 3 and every extent is
+        // positive, or if the padded sizes do not fit FFTW's int sizes.
+        Correlator(int rank, const int *signal_dims, const int *template_dims, const T *templ,
+                   const CorrelationOptions &options = CorrelationOptions());
+
+        // Autocorrelation of signals of `dims`.
+        Correlator(int rank, const int *dims, const CorrelationOptions &options = CorrelationOptions());
+
+        Correlator();
+        ~Correlator();
+        Correlator(Correlator &&other);
+        Correlator &operator=(Correlator &&other);
+
+        Correlator(const Correlator &) = delete;
+        Correlator &operator=(const Correlator &) = delete;
+
+        bool valid() const;
+
+        int rank() const;
+        // Elements per signal and per output.
+        std::size_t signal_size() const;
+        std::size_t output_size() const;
+        // nx + ny - 1 per axis.
+        std::vector<int> output_dims() const;
+        // The zero-padded transform size per axis.
+        std::vector<int> fft_dims() const;
+
+        // Correlates `batch` signals stored back to back (signal_size()
+        // apart) and writes their outputs back to back (output_size()
+        // apart). Returns false if the instance is invalid.
+        bool apply(const T *signals, std::size_t batch, T *out);
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> impl;
+    };
+
+    // One-shot forms. Plans come from PlanCache<T> either way; for many
+    // signals against one template, keep a Correlator instead, which also
+    // keeps the template spectrum and scratch. Return false (or an empty
+    // vector) on invalid sizes.
+    template <typename T>
+    bool correlate(int rank, const int *signal_dims, const T *signal, const int *template_dims, const T *templ,
+                   T *out, const CorrelationOptions &options = CorrelationOptions());
+
+    template <typename T>
+    bool autocorrelate(int rank, const int *dims, const T *signal, T *out,
+                       const CorrelationOptions &options = CorrelationOptions());
+
+    template <typename T>
+    std::vector<T> correlate(const std::vector<T> &signal, const std::vector<T> &templ,
+                             const CorrelationOptions &options = CorrelationOptions());
+
+    template <typename T>
+    std::vector<T> autocorrelate(const std::vector<T> &signal, const CorrelationOptions &options = CorrelationOptions());
+
+} // namespace clapfft
+
+#endif // CLAPFFT_CORRELATION_HPP
@@ -16,4 +16,9 @@ namespace clapfft
     extern const fft_flags CLAP_FFT_PATIENT;
     extern const fft_flags CLAP_FFT_EXHAUSTIVE;
     extern const fft_flags CLAP_FFT_UNALIGNED;
+
+    // Not an FFTW flag: asks for the runtime PlanningPolicy of the
+    // precision and transform kind (see planning_policy.hpp). Other bits
+    // passed along with it are kept.
+    extern const fft_flags CLAP_FFT_DEFAULT;
 } // namespace clapfft
@@ -1,10 +1,16 @@
 #pragma once
 #include <clapfft/fft_traits.hpp>
 #include "fft_flags.hpp" // planning flag definitions
+#include "plan_key.hpp"
+#include "planning_policy.hpp"
 #include <unordered_map>
+#include <utility>
 #include <memory>
 #include <mutex>
+#include <atomic>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <complex>
 
@@ -25,47 +31,69 @@ namespace clapfft
         FFT_RODFT10 = 9,
         FFT_RODFT11 = 10
     };
-    enum class TransformKind
+    const int transform_kind_count = 4;
+
+    // Counters for one transform kind of one precision. Times are in
+    // nanoseconds of steady_clock.
+    struct PlanCacheKindStats
     {
-        C2C,
-        C2R,
-        R2C,
-        R2R
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        std::uint64_t planning_ns = 0;
+        std::uint64_t executions = 0;
+        std::uint64_t execute_ns = 0;
+        std::size_t plans = 0;           // plans currently in the cache
+        std::size_t estimated_bytes = 0; // heuristic, see PlanCache::estimate_bytes
+
+        double hit_rate() const
+        {
+            const std::uint64_t lookups = hits + misses;
+            return lookups == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(lookups);
+        }
+
+        PlanCacheKindStats &operator+=(const PlanCacheKindStats &o)
+        {
+            hits += o.hits;
+            misses += o.misses;
+            planning_ns += o.planning_ns;
+            executions += o.executions;
+            execute_ns += o.execute_ns;
+            plans += o.plans;
+            estimated_bytes += o.estimated_bytes;
+            return *this;
+        }
     };
 
-    struct PlanKey
+    struct PlanCacheStats
     {
-        TransformKind kind;
-        int dim;
-        int n0, n1, n2;
-        int sign;
-        int k0, k1, k2;
-        fft_flags flags; // planning options (measure/estimate/etc.)
+        PlanCacheKindStats kinds[transform_kind_count];
 
-        bool operator==(const PlanKey &o) const
+        const PlanCacheKindStats &operator[](TransformKind kind) const
         {
-            return kind == o.kind && dim == o.dim && n0 == o.n0 && n1 == o.n1 &&
-                   n2 == o.n2 && sign == o.sign && k0 == o.k0 && k1 == o.k1 && k2 == o.k2 &&
-                   flags == o.flags;
+            return kinds[static_cast<int>(kind)];
+        }
+
+        PlanCacheKindStats total() const
+        {
+            PlanCacheKindStats sum;
+            for (int i = 0; i < transform_kind_count; ++i)
+            {
+                sum += kinds[i];
+            }
+            return sum;
         }
     };
 
-    struct PlanKeyHash
+    // Snapshot of one cached plan, as returned by PlanCache<T>::entries().
+    struct PlanCacheEntry
     {
-        size_t operator()(const PlanKey &k) const
-        {
-            size_t h = std::hash<int>()(static_cast<int>(k.kind));
-            h ^= std::hash<int>()(k.dim) << 1;
-            h ^= std::hash<int>()(k.n0) << 2;
-            h ^= std::hash<int>()(k.n1) << 3;
-            h ^= std::hash<int>()(k.n2) << 4;
-            h ^= std::hash<int>()(k.sign) << 5;
-            h ^= std::hash<int>()(k.k0) << 6;
-            h ^= std::hash<int>()(k.k1) << 7;
-            h ^= std::hash<int>()(k.k2) << 8;
-            h ^= std::hash<fft_flags>()(k.flags) << 9;
-            return h;
-        }
+        PlanKey key;
+        std::uint64_t hits;
+        std::uint64_t planning_ns;
+        std::uint64_t executions;
+        std::uint64_t execute_ns;
+        std::size_t estimated_bytes;
+        long use_count; // references held outside the cache
     };
 
     template <typename T>
@@ -79,38 +107,155 @@ namespace clapfft
         {
             plan_type plan;
             std::mutex exec_mutex;
+
+            PlanKey key;
+            std::uint64_t planning_ns;
+            std::size_t estimated_bytes;
+            std::atomic<std::uint64_t> hits;
+            std::atomic<std::uint64_t> executions;
+            std::atomic<std::uint64_t> execute_ns;
+            std::atomic<bool> evicted; // set once the global cache has dropped this plan
+
+            Wrapper() : plan(nullptr), key(), planning_ns(0), estimated_bytes(0), hits(0), executions(0), execute_ns(0), evicted(false) {}
+
+            // The plan is released together with the last reference, so a
+            // thread still executing through its shared_ptr keeps it alive
+            // after cleanup() or shrink_to() dropped it from the cache.
+            ~Wrapper()
+            {
+                Counters &c = counters[static_cast<int>(key.kind)];
+                c.hits.fetch_add(hits.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                c.executions.fetch_add(executions.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                c.execute_ns.fetch_add(execute_ns.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                if (plan != nullptr)
+                {
+                    std::lock_guard<std::mutex> planner_lock(planner_mutex);
+                    traits::destroy_plan(plan);
+                }
+            }
+
+            // Executes `fn(plan)` under exec_mutex and records its duration.
+            template <typename Fn>
+            void run(Fn fn)
+            {
+                std::lock_guard<std::mutex> lock(exec_mutex);
+                run_concurrent(fn);
+            }
+
+            // Same without exec_mutex, for callers that only use FFTW's
+            // new-array execute functions, which may run concurrently on
+            // one plan as long as the arrays differ.
+            template <typename Fn>
+            void run_concurrent(Fn fn)
+            {
+                const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                fn(plan);
+                const std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+                executions.fetch_add(1, std::memory_order_relaxed);
+                execute_ns.fetch_add(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+                                     std::memory_order_relaxed);
+            }
+
+            Wrapper(const Wrapper &) = delete;
+            Wrapper &operator=(const Wrapper &) = delete;
         };
 
     private:
+        using map_type = std::unordered_map<PlanKey, std::shared_ptr<Wrapper>, PlanKeyHash>;
+
+        static const std::size_t local_slot_count = 8;
+
+        struct LocalSlot
+        {
+            PlanKey key;
+            std::shared_ptr<Wrapper> wrapper;
+        };
+
+        // Direct-mapped per-thread front-end of the global map. A slot is
+        // only trusted while its wrapper has not been marked evicted, so
+        // cleanup() and shrink_to() invalidate every thread's copy without
+        // having to visit it.
+        struct LocalCache
+        {
+            bool enabled = false;
+            LocalSlot slots[local_slot_count];
+        };
+
+        static LocalCache &local_cache()
+        {
+            thread_local LocalCache local;
+            return local;
+        }
+
         template <typename Factory>
         static std::shared_ptr<Wrapper> get_or_create(const PlanKey &key, Factory &&factory)
+        {
+            LocalCache &local = local_cache();
+            if (!local.enabled)
+            {
+                return lookup_or_create(key, std::forward<Factory>(factory));
+            }
+
+            LocalSlot &slot = local.slots[PlanKeyHash()(key) % local_slot_count];
+            if (slot.wrapper && slot.key == key)
+            {
+                if (!slot.wrapper->evicted.load(std::memory_order_acquire))
+                {
+                    slot.wrapper->hits.fetch_add(1, std::memory_order_relaxed);
+                    return slot.wrapper;
+                }
+            }
+            slot.wrapper = lookup_or_create(key, std::forward<Factory>(factory));
+            slot.key = key;
+            return slot.wrapper;
+        }
+
+        template <typename Factory>
+        static std::shared_ptr<Wrapper> lookup_or_create(const PlanKey &key, Factory &&factory)
         {
             {
                 std::lock_guard<std::mutex> lock(cache_mutex);
                 auto it = cache.find(key);
                 if (it != cache.end())
                 {
+                    it->second->hits.fetch_add(1, std::memory_order_relaxed);
                     return it->second;
                 }
             }
 
             auto wrapper = std::make_shared<Wrapper>();
+            wrapper->key = key;
+            wrapper->estimated_bytes = estimate_bytes(key);
             {
                 std::lock_guard<std::mutex> planner_lock(planner_mutex);
+                // The thread count is planner-global state in FFTW, so it is
+                // set under the same lock as the planning call it applies to
+                // and put back to 1 before the lock is released; plans made
+                // outside the cache stay single-threaded.
+                const bool threaded = threads_available();
+                if (threaded)
+                {
+                    traits::plan_with_nthreads(key.nthreads);
+                }
+                const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
                 wrapper->plan = factory();
+                wrapper->planning_ns = static_cast<std::uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+                if (threaded && key.nthreads != 1)
+                {
+                    traits::plan_with_nthreads(1);
+                }
             }
+            Counters &c = counters[static_cast<int>(key.kind)];
+            c.misses.fetch_add(1, std::memory_order_relaxed);
+            c.planning_ns.fetch_add(wrapper->planning_ns, std::memory_order_relaxed);
 
             {
                 std::lock_guard<std::mutex> lock(cache_mutex);
-                std::pair<typename std::unordered_map<PlanKey, std::shared_ptr<Wrapper>, PlanKeyHash>::iterator, bool> result = cache.emplace(key, wrapper);
-                auto it = result.first;
-                bool inserted = result.second;
-                if (!inserted)
-                {
-                    traits::destroy_plan(wrapper->plan);
-                    return it->second;
-                }
-                return wrapper;
+                std::pair<typename map_type::iterator, bool> result = cache.emplace(key, wrapper);
+                // A concurrent caller may have won the race; our duplicate plan
+                // is destroyed by ~Wrapper once `wrapper` goes out of scope.
+                return result.first->second;
             }
         }
 
@@ -127,20 +272,206 @@ namespace clapfft
             return static_cast<std::size_t>(n0) * static_cast<std::size_t>(n1) * static_cast<std::size_t>(n2);
         }
 
-        static std::unordered_map<
-            PlanKey,
-            std::shared_ptr<Wrapper>,
-            PlanKeyHash>
-            cache;
+        static PlanKey basic_key(TransformKind kind, int dim, int n0, int n1, int n2, fft_flags flags, int nthreads)
+        {
+            const int dims[3] = {n0, n1, n2};
+            PlanKey key(kind, dim, dims, flags);
+            key.nthreads = effective_threads(nthreads);
+            return key;
+        }
+
+        // Requests for more than one thread collapse to 1 when the threads
+        // libraries are missing, so they share the single-threaded plan.
+        static int effective_threads(int nthreads)
+        {
+            if (nthreads <= 1 || !threads_available())
+            {
+                return 1;
+            }
+            return nthreads;
+        }
+
+        static std::size_t points(const PlanKey &key)
+        {
+            std::size_t total = 1;
+            for (int i = 0; i < key.rank; ++i)
+            {
+                total *= static_cast<std::size_t>(key.n[i]);
+            }
+            return total;
+        }
+
+        // FFTW does not report plan sizes; assume twiddles and scratch of
+        // roughly one complex value per point on top of the wrapper itself.
+        static std::size_t estimate_bytes(const PlanKey &key)
+        {
+            return sizeof(Wrapper) + points(key) * sizeof(std::complex<T>);
+        }
+
+        // Number of elements an array must hold to be addressed with the
+        // given logical shape, embedding, stride and batch distance.
+        static std::size_t layout_extent(int rank, const int *shape, const int *embed,
+                                         int howmany, int stride, int dist)
+        {
+            std::size_t last = 0;
+            std::size_t pitch = 1;
+            for (int i = rank - 1; i >= 0; --i)
+            {
+                last += static_cast<std::size_t>(shape[i] - 1) * pitch;
+                pitch *= static_cast<std::size_t>(embed[i] > 0 ? embed[i] : shape[i]);
+            }
+            return static_cast<std::size_t>(howmany - 1) * static_cast<std::size_t>(dist) +
+                   last * static_cast<std::size_t>(stride) + 1;
+        }
+
+        // Byte buffer whose start honours the alignment a plan is keyed for.
+        struct PlanningBuffer
+        {
+            std::vector<unsigned char> storage;
+            void *data;
+
+            PlanningBuffer(std::size_t bytes, int alignment) : storage(bytes + static_cast<std::size_t>(alignment > 0 ? alignment : 1)), data(nullptr)
+            {
+                std::size_t offset = 0;
+                if (alignment > 0)
+                {
+                    const std::size_t address = reinterpret_cast<std::size_t>(storage.data());
+                    offset = (static_cast<std::size_t>(alignment) - address % static_cast<std::size_t>(alignment)) % static_cast<std::size_t>(alignment);
+                }
+                data = storage.data() + offset;
+            }
+        };
+
+        // Plans any key through FFTW's advanced interface on scratch arrays
+        // laid out like the key describes.
+        static plan_type plan_from_key(const PlanKey &key)
+        {
+            int shape_in[PlanKey::max_rank];
+            int shape_out[PlanKey::max_rank];
+            for (int i = 0; i < key.rank; ++i)
+            {
+                shape_in[i] = key.n[i];
+                shape_out[i] = key.n[i];
+            }
+            if (key.kind == TransformKind::R2C)
+            {
+                shape_out[key.rank - 1] = key.n[key.rank - 1] / 2 + 1;
+            }
+            else if (key.kind == TransformKind::C2R)
+            {
+                shape_in[key.rank - 1] = key.n[key.rank - 1] / 2 + 1;
+            }
+
+            const std::size_t real_size = sizeof(T);
+            const std::size_t complex_size = sizeof(std::complex<T>);
+            const std::size_t in_elem = (key.kind == TransformKind::C2C || key.kind == TransformKind::C2R) ? complex_size : real_size;
+            const std::size_t out_elem = (key.kind == TransformKind::C2C || key.kind == TransformKind::R2C) ? complex_size : real_size;
+            const std::size_t in_bytes = layout_extent(key.rank, shape_in, key.inembed, key.howmany, key.istride, key.idist) * in_elem;
+            const std::size_t out_bytes = layout_extent(key.rank, shape_out, key.onembed, key.howmany, key.ostride, key.odist) * out_elem;
+
+            PlanningBuffer in_buffer(key.in_place ? (in_bytes > out_bytes ? in_bytes : out_bytes) : in_bytes, key.alignment);
+            PlanningBuffer out_buffer(key.in_place ? 0 : out_bytes, key.alignment);
+            void *in = in_buffer.data;
+            void *out = key.in_place ? in_buffer.data : out_buffer.data;
+
+            const int *inembed = key.inembed[key.rank - 1] > 0 ? key.inembed : nullptr;
+            const int *onembed = key.onembed[key.rank - 1] > 0 ? key.onembed : nullptr;
+            const fft_flags flags = key.alignment > 0 ? key.flags : (key.flags | CLAP_FFT_UNALIGNED);
+
+            switch (key.kind)
+            {
+            case TransformKind::C2C:
+                return traits::plan_many_dft(key.rank, key.n, key.howmany,
+                                             static_cast<typename traits::complex_type *>(in), inembed, key.istride, key.idist,
+                                             static_cast<typename traits::complex_type *>(out), onembed, key.ostride, key.odist,
+                                             key.sign, flags);
+            case TransformKind::R2C:
+                return traits::plan_many_dft_r2c(key.rank, key.n, key.howmany,
+                                                 static_cast<T *>(in), inembed, key.istride, key.idist,
+                                                 static_cast<typename traits::complex_type *>(out), onembed, key.ostride, key.odist,
+                                                 flags);
+            case TransformKind::C2R:
+                return traits::plan_many_dft_c2r(key.rank, key.n, key.howmany,
+                                                 static_cast<typename traits::complex_type *>(in), inembed, key.istride, key.idist,
+                                                 static_cast<T *>(out), onembed, key.ostride, key.odist,
+                                                 flags);
+            case TransformKind::R2R:
+            {
+                fftw_r2r_kind kinds[PlanKey::max_rank];
+                for (int i = 0; i < key.rank; ++i)
+                {
+                    kinds[i] = static_cast<fftw_r2r_kind>(key.r2r_kind[i]);
+                }
+                return traits::plan_many_r2r(key.rank, key.n, key.howmany,
+                                             static_cast<T *>(in), inembed, key.istride, key.idist,
+                                             static_cast<T *>(out), onembed, key.ostride, key.odist,
+                                             kinds, flags);
+            }
+            }
+            return nullptr;
+        }
+
+        // Per TransformKind. hits/executions/execute_ns only hold the share of
+        // plans already released; live plans keep their own counters.
+        struct Counters
+        {
+            std::atomic<std::uint64_t> hits;
+            std::atomic<std::uint64_t> misses;
+            std::atomic<std::uint64_t> planning_ns;
+            std::atomic<std::uint64_t> executions;
+            std::atomic<std::uint64_t> execute_ns;
+        };
+
+        static Counters counters[transform_kind_count];
 
         static std::mutex cache_mutex;
         static std::mutex planner_mutex;
 
+        static map_type cache;
+
     public:
+        // Serialises FFTW's planner for this precision. Code that creates or
+        // destroys plans outside the cache (GuruFFT) takes it too, so it
+        // neither races the cache's planning nor sees its thread count.
+        static std::mutex &planner_lock()
+        {
+            return planner_mutex;
+        }
+
+        // True when FFTW's threads support is linked in and initialised;
+        // initialisation happens on the first call, before any plan of this
+        // precision is made through the cache.
+        static bool threads_available()
+        {
+            static const bool available = traits::init_threads();
+            return available;
+        }
+
+        // Returns the plan for an arbitrary descriptor (batched, strided,
+        // embedded, in-place or aligned). Keys produced by the get_* helpers
+        // below resolve to the same cache entries. CLAP_FFT_DEFAULT in the
+        // key's flags is replaced by the configured planning policy, and the
+        // key is normalized, so equivalent descriptors share one plan.
+        static std::shared_ptr<Wrapper> get(const PlanKey &requested)
+        {
+            if (requested.rank <= 0 || requested.howmany <= 0)
+            {
+                return std::shared_ptr<Wrapper>();
+            }
+            PlanKey key = requested;
+            key.normalize();
+            key.flags = PlanningPolicy::resolve<T>(key.kind, key.flags);
+            key.nthreads = effective_threads(key.nthreads);
+            return get_or_create(key, [key]()
+                                 { return plan_from_key(key); });
+        }
+
         static std::shared_ptr<Wrapper> get_c2c_1d(int n, int sign,
-                                                   fft_flags flags = CLAP_FFT_ESTIMATE)
+                                                   fft_flags flags = CLAP_FFT_DEFAULT, int nthreads = 1)
         {
-            PlanKey key{TransformKind::C2C, 1, n, 1, 1, sign, 0, 0, 0, flags};
+            flags = PlanningPolicy::resolve<T>(TransformKind::C2C, flags);
+            PlanKey key = basic_key(TransformKind::C2C, 1, n, 1, 1, flags, nthreads);
+            key.sign = sign;
             return get_or_create(key, [n, sign, flags]()
                                  {
             std::vector<std::complex<T>> dummy_in(static_cast<std::size_t>(n));
@@ -151,9 +482,11 @@ namespace clapfft
         }
 
         static std::shared_ptr<Wrapper> get_c2c_2d(int n0, int n1, int sign,
-                                                   fft_flags flags = CLAP_FFT_ESTIMATE)
+                                                   fft_flags flags = CLAP_FFT_DEFAULT, int nthreads = 1)
         {
-            PlanKey key{TransformKind::C2C, 2, n0, n1, 1, sign, 0, 0, 0, flags};
+            flags = PlanningPolicy::resolve<T>(TransformKind::C2C, flags);
+            PlanKey key = basic_key(TransformKind::C2C, 2, n0, n1, 1, flags, nthreads);
+            key.sign = sign;
             return get_or_create(key, [n0, n1, sign, flags]()
                                  {
             std::vector<std::complex<T>> dummy_in(element_count(2, n0, n1, 1));
@@ -164,9 +497,11 @@ namespace clapfft
         }
 
         static std::shared_ptr<Wrapper> get_c2c_3d(int n0, int n1, int n2, int sign,
-                                                   fft_flags flags = CLAP_FFT_ESTIMATE)
+                                                   fft_flags flags = CLAP_FFT_DEFAULT, int nthreads = 1)
         {
-            PlanKey key{TransformKind::C2C, 3, n0, n1, n2, sign, 0, 0, 0, flags};
+            flags = PlanningPolicy::resolve<T>(TransformKind::C2C, flags);
+            PlanKey key = basic_key(TransformKind::C2C, 3, n0, n1, n2, flags, nthreads);
+            key.sign = sign;
             return get_or_create(key, [n0, n1, n2, sign, flags]()
                                  {
             std::vector<std::complex<T>> dummy_in(element_count(3, n0, n1, n2));
@@ -177,9 +512,10 @@ namespace clapfft
         }
 
         static std::shared_ptr<Wrapper> get_r2c_1d(int n,
-                                                   fft_flags flags = CLAP_FFT_ESTIMATE)
+                                                   fft_flags flags = CLAP_FFT_DEFAULT, int nthreads = 1)
         {
-            PlanKey key{TransformKind::R2C, 1, n, 1, 1, 0, 0, 0, 0, flags};
+            flags = PlanningPolicy::resolve<T>(TransformKind::R2C, flags);
+            PlanKey key = basic_key(TransformKind::R2C, 1, n, 1, 1, flags, nthreads);
             return get_or_create(key, [n, flags]()
                                  {
             std::vector<T> real_dummy(static_cast<std::size_t>(n));
@@ -190,9 +526,10 @@ namespace clapfft
         }
 
         static std::shared_ptr<Wrapper> get_r2c_2d(int n0, int n1,
-                                                   fft_flags flags = CLAP_FFT_ESTIMATE)
+                                                   fft_flags flags = CLAP_FFT_DEFAULT, int nthreads = 1)
         {
-            PlanKey key{TransformKind::R2C, 2, n0, n1, 1, 0, 0, 0, 0, flags};
+            flags = PlanningPolicy::resolve<T>(TransformKind::R2C, flags);
+            PlanKey key = basic_key(TransformKind::R2C, 2, n0, n1, 1, flags, nthreads);
             return get_or_create(key, [n0, n1, flags]()
                                  {
             std::vector<T> real_dummy(element_count(2, n0, n1, 1));
@@ -203,9 +540,10 @@ namespace clapfft
         }
 
         static std::shared_ptr<Wrapper> get_r2c_3d(int n0, int n1, int n2,
-                                                   fft_flags flags = CLAP_FFT_ESTIMATE)
+                                                   fft_flags flags = CLAP_FFT_DEFAULT, int nthreads = 1)
         {
-            PlanKey key{TransformKind::R2C, 3, n0, n1, n2, 0, 0, 0, 0, flags};
+            flags = PlanningPolicy::resolve<T>(TransformKind::R2C, flags);
+            PlanKey key = basic_key(TransformKind::R2C, 3, n0, n1, n2, flags, nthreads);
             return get_or_create(key, [n0, n1, n2, flags]()
                                  {
             std::vector<T> real_dummy(element_count(3, n0, n1, n2));
@@ -216,9 +554,10 @@ namespace clapfft
         }
 
         static std::shared_ptr<Wrapper> get_c2r_1d(int n,
-                                                   fft_flags flags = CLAP_FFT_ESTIMATE)
+                                                   fft_flags flags = CLAP_FFT_DEFAULT, int nthreads = 1)
         {
-            PlanKey key{TransformKind::C2R, 1, n, 1, 1, 0, 0, 0, 0, flags};
+            flags = PlanningPolicy::resolve<T>(TransformKind::C2R, flags);
+            PlanKey key = basic_key(TransformKind::C2R, 1, n, 1, 1, flags, nthreads);
             return get_or_create(key, [n, flags]()
                                  {
             std::vector<std::complex<T>> complex_dummy(static_cast<std::size_t>(n / 2 + 1));
@@ -229,9 +568,10 @@ namespace clapfft
         }
 
         static std::shared_ptr<Wrapper> get_c2r_2d(int n0, int n1,
-                                                   fft_flags flags = CLAP_FFT_ESTIMATE)
+                                                   fft_flags flags = CLAP_FFT_DEFAULT, int nthreads = 1)
         {
-            PlanKey key{TransformKind::C2R, 2, n0, n1, 1, 0, 0, 0, 0, flags};
+            flags = PlanningPolicy::resolve<T>(TransformKind::C2R, flags);
+            PlanKey key = basic_key(TransformKind::C2R, 2, n0, n1, 1, flags, nthreads);
             return get_or_create(key, [n0, n1, flags]()
                                  {
             std::vector<std::complex<T>> complex_dummy(static_cast<std::size_t>(n0) * static_cast<std::size_t>(n1 / 2 + 1));
@@ -242,9 +582,10 @@ namespace clapfft
         }
 
         static std::shared_ptr<Wrapper> get_c2r_3d(int n0, int n1, int n2,
-                                                   fft_flags flags = CLAP_FFT_ESTIMATE)
+                                                   fft_flags flags = CLAP_FFT_DEFAULT, int nthreads = 1)
         {
-            PlanKey key{TransformKind::C2R, 3, n0, n1, n2, 0, 0, 0, 0, flags};
+            flags = PlanningPolicy::resolve<T>(TransformKind::C2R, flags);
+            PlanKey key = basic_key(TransformKind::C2R, 3, n0, n1, n2, flags, nthreads);
             return get_or_create(key, [n0, n1, n2, flags]()
                                  {
             std::vector<std::complex<T>> complex_dummy(static_cast<std::size_t>(n0) * static_cast<std::size_t>(n1) * static_cast<std::size_t>(n2 / 2 + 1));
@@ -255,9 +596,11 @@ namespace clapfft
         }
 
         static std::shared_ptr<Wrapper> get_r2r_1d(int n, fftw_r2r_kind kind,
-                                                   fft_flags flags = CLAP_FFT_ESTIMATE)
+                                                   fft_flags flags = CLAP_FFT_DEFAULT, int nthreads = 1)
         {
-            PlanKey key{TransformKind::R2R, 1, n, 1, 1, 0, static_cast<int>(kind), 0, 0, flags};
+            flags = PlanningPolicy::resolve<T>(TransformKind::R2R, flags);
+            PlanKey key = basic_key(TransformKind::R2R, 1, n, 1, 1, flags, nthreads);
+            key.r2r_kind[0] = static_cast<int>(kind);
             return get_or_create(key, [n, kind, flags]()
                                  {
             std::vector<T> real_dummy_in(static_cast<std::size_t>(n));
@@ -266,9 +609,12 @@ namespace clapfft
         }
 
         static std::shared_ptr<Wrapper> get_r2r_2d(int n0, int n1, fftw_r2r_kind kind0, fftw_r2r_kind kind1,
-                                                   fft_flags flags = CLAP_FFT_ESTIMATE)
+                                                   fft_flags flags = CLAP_FFT_DEFAULT, int nthreads = 1)
         {
-            PlanKey key{TransformKind::R2R, 2, n0, n1, 1, 0, static_cast<int>(kind0), static_cast<int>(kind1), 0, flags};
+            flags = PlanningPolicy::resolve<T>(TransformKind::R2R, flags);
+            PlanKey key = basic_key(TransformKind::R2R, 2, n0, n1, 1, flags, nthreads);
+            key.r2r_kind[0] = static_cast<int>(kind0);
+            key.r2r_kind[1] = static_cast<int>(kind1);
             return get_or_create(key, [n0, n1, kind0, kind1, flags]()
                                  {
             std::vector<T> real_dummy_in(element_count(2, n0, n1, 1));
@@ -277,9 +623,13 @@ namespace clapfft
         }
 
         static std::shared_ptr<Wrapper> get_r2r_3d(int n0, int n1, int n2, fftw_r2r_kind kind0, fftw_r2r_kind kind1, fftw_r2r_kind kind2,
-                                                   fft_flags flags = CLAP_FFT_ESTIMATE)
+                                                   fft_flags flags = CLAP_FFT_DEFAULT, int nthreads = 1)
         {
-            PlanKey key{TransformKind::R2R, 3, n0, n1, n2, 0, static_cast<int>(kind0), static_cast<int>(kind1), static_cast<int>(kind2), flags};
+            flags = PlanningPolicy::resolve<T>(TransformKind::R2R, flags);
+            PlanKey key = basic_key(TransformKind::R2R, 3, n0, n1, n2, flags, nthreads);
+            key.r2r_kind[0] = static_cast<int>(kind0);
+            key.r2r_kind[1] = static_cast<int>(kind1);
+            key.r2r_kind[2] = static_cast<int>(kind2);
             return get_or_create(key, [n0, n1, n2, kind0, kind1, kind2, flags]()
                                  {
             std::vector<T> real_dummy_in(element_count(3, n0, n1, n2));
@@ -287,23 +637,151 @@ namespace clapfft
             return traits::plan_r2r_3d(n0, n1, n2, real_dummy_in.data(), real_dummy_out.data(), kind0, kind1, kind2, flags | CLAP_FFT_UNALIGNED); });
         }
 
+        // Drops every cached plan. Safe to call while other threads execute:
+        // plans still referenced elsewhere are destroyed by their last owner.
         static void cleanup()
         {
+            map_type retired;
+            {
+                std::lock_guard<std::mutex> lock(cache_mutex);
+                retired.swap(cache);
+            }
+            for (typename map_type::iterator it = retired.begin(); it != retired.end(); ++it)
+            {
+                it->second->evicted.store(true, std::memory_order_release);
+            }
+            // `retired` is released here, outside cache_mutex.
+        }
+
+        // Evicts plans until at most max_plans remain, preferring plans that
+        // are not currently held outside the cache. Like cleanup(), it never
+        // waits for in-flight executions.
+        static void shrink_to(std::size_t max_plans)
+        {
+            std::vector<std::shared_ptr<Wrapper>> retired;
+            {
+                std::lock_guard<std::mutex> lock(cache_mutex);
+                for (int pass = 0; pass < 2 && cache.size() > max_plans; ++pass)
+                {
+                    for (typename map_type::iterator it = cache.begin(); it != cache.end() && cache.size() > max_plans;)
+                    {
+                        if (pass == 0 && it->second.use_count() > 1)
+                        {
+                            ++it;
+                            continue;
+                        }
+                        retired.push_back(std::move(it->second));
+                        it = cache.erase(it);
+                    }
+                }
+            }
+            for (std::size_t i = 0; i < retired.size(); ++i)
+            {
+                retired[i]->evicted.store(true, std::memory_order_release);
+            }
+        }
+
+        // Opts the calling thread in or out of a small direct-mapped cache in
+        // front of the shared map. Steady-state lookups then take no lock.
+        // Disabling releases the thread's references.
+        static void set_thread_local_cache(bool enabled)
+        {
+            LocalCache &local = local_cache();
+            local.enabled = enabled;
+            if (!enabled)
+            {
+                clear_thread_local_cache();
+            }
+        }
+
+        // Drops the calling thread's cached references, letting evicted plans
+        // be reclaimed before the thread next looks them up or exits.
+        static void clear_thread_local_cache()
+        {
+            LocalCache &local = local_cache();
+            for (std::size_t i = 0; i < local_slot_count; ++i)
+            {
+                local.slots[i].wrapper.reset();
+            }
+        }
+
+        static std::size_t size()
+        {
+            std::lock_guard<std::mutex> lock(cache_mutex);
+            return cache.size();
+        }
+
+        // Cumulative counters per transform kind since start (or the last
+        // reset_stats()). Plans unlinked from the cache but still referenced
+        // elsewhere are folded in once their last reference is released.
+        static PlanCacheStats stats()
+        {
+            PlanCacheStats result;
+            for (int i = 0; i < transform_kind_count; ++i)
+            {
+                PlanCacheKindStats &k = result.kinds[i];
+                k.hits = counters[i].hits.load(std::memory_order_relaxed);
+                k.misses = counters[i].misses.load(std::memory_order_relaxed);
+                k.planning_ns = counters[i].planning_ns.load(std::memory_order_relaxed);
+                k.executions = counters[i].executions.load(std::memory_order_relaxed);
+                k.execute_ns = counters[i].execute_ns.load(std::memory_order_relaxed);
+            }
+
+            std::lock_guard<std::mutex> lock(cache_mutex);
+            for (typename map_type::const_iterator it = cache.begin(); it != cache.end(); ++it)
+            {
+                const Wrapper &w = *it->second;
+                PlanCacheKindStats &k = result.kinds[static_cast<int>(w.key.kind)];
+                k.hits += w.hits.load(std::memory_order_relaxed);
+                k.executions += w.executions.load(std::memory_order_relaxed);
+                k.execute_ns += w.execute_ns.load(std::memory_order_relaxed);
+                k.plans += 1;
+                k.estimated_bytes += w.estimated_bytes;
+            }
+            return result;
+        }
+
+        // One snapshot per cached plan, e.g. to find the shapes worth prewarming.
+        static std::vector<PlanCacheEntry> entries()
+        {
+            std::vector<PlanCacheEntry> result;
             std::lock_guard<std::mutex> lock(cache_mutex);
-            for (typename std::unordered_map<PlanKey, std::shared_ptr<Wrapper>, PlanKeyHash>::iterator it = cache.begin(); it != cache.end(); ++it)
+            result.reserve(cache.size());
+            for (typename map_type::const_iterator it = cache.begin(); it != cache.end(); ++it)
             {
-                traits::destroy_plan(it->second->plan);
+                const Wrapper &w = *it->second;
+                PlanCacheEntry e;
+                e.key = w.key;
+                e.hits = w.hits.load(std::memory_order_relaxed);
+                e.planning_ns = w.planning_ns;
+                e.executions = w.executions.load(std::memory_order_relaxed);
+                e.execute_ns = w.execute_ns.load(std::memory_order_relaxed);
+                e.estimated_bytes = w.estimated_bytes;
+                e.use_count = it->second.use_count() - 1;
+                result.push_back(e);
             }
-            cache.clear();
+            return result;
         }
-    };
 
-    template <typename T>
-    std::unordered_map<
-        PlanKey,
-        std::shared_ptr<typename PlanCache<T>::Wrapper>,
-        PlanKeyHash>
-        PlanCache<T>::cache;
+        static void reset_stats()
+        {
+            for (int i = 0; i < transform_kind_count; ++i)
+            {
+                counters[i].hits.store(0, std::memory_order_relaxed);
+                counters[i].misses.store(0, std::memory_order_relaxed);
+                counters[i].planning_ns.store(0, std::memory_order_relaxed);
+                counters[i].executions.store(0, std::memory_order_relaxed);
+                counters[i].execute_ns.store(0, std::memory_order_relaxed);
+            }
+            std::lock_guard<std::mutex> lock(cache_mutex);
+            for (typename map_type::iterator it = cache.begin(); it != cache.end(); ++it)
+            {
+                it->second->hits.store(0, std::memory_order_relaxed);
+                it->second->executions.store(0, std::memory_order_relaxed);
+                it->second->execute_ns.store(0, std::memory_order_relaxed);
+            }
+        }
+    };
 
     template <typename T>
     std::mutex PlanCache<T>::cache_mutex;
@@ -311,4 +789,15 @@ namespace clapfft
     template <typename T>
     std::mutex PlanCache<T>::planner_mutex;
 
+    template <typename T>
+    typename PlanCache<T>::Counters PlanCache<T>::counters[transform_kind_count];
+
+    template <typename T>
+    const std::size_t PlanCache<T>::local_slot_count;
+
+    // Defined after the mutexes so cached wrappers are destroyed before them
+    // at exit; ~Wrapper takes planner_mutex.
+    template <typename T>
+    typename PlanCache<T>::map_type PlanCache<T>::cache;
+
 }
\ No newline at end of file
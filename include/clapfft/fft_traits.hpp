@@ -92,6 +92,9 @@ namespace clapfft
         static char *export_wisdom_to_string();
         static int import_wisdom_from_string(const char *input_string);
         static void destroy_plan(plan_type plan);
+        // False when clapfft was built without the FFTW threads libraries.
+        static bool init_threads();
+        static void plan_with_nthreads(int nthreads);
     };
 
     template <>
@@ -360,6 +363,9 @@ namespace clapfft
         static char *export_wisdom_to_string();
         static int import_wisdom_from_string(const char *input_string);
         static void destroy_plan(plan_type plan);
+        // False when clapfft was built without the FFTW threads libraries.
+        static bool init_threads();
+        static void plan_with_nthreads(int nthreads);
     };
 
     template <>
@@ -416,6 +422,9 @@ namespace clapfft
         static char *export_wisdom_to_string();
         static int import_wisdom_from_string(const char *input_string);
         static void destroy_plan(plan_type plan);
+        // False when clapfft was built without the FFTW threads libraries.
+        static bool init_threads();
+        static void plan_with_nthreads(int nthreads);
     };
 
 } // namespace clapfft
@@ -0,0 +1,44 @@
+#ifndef CLAPFFT_NESTED_COPY_HPP
+#define CLAPFFT_NESTED_COPY_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace clapfft
+{
+    // Copies between the nested std::vector layout of the FFT:: 2D and 3D
+    // entry points and the contiguous row-major arrays FFTW works on. Each
+    // row moves as one block: memcpy, or for volumes of at least
+    // streaming_copy_bytes, SSE2 non-temporal stores that do not push the
+    // rest of the working set out of cache. With threads > 1 and at least
+    // parallel_copy_bytes to move, the outermost dimension is split across
+    // ThreadPool::global().
+    //
+    // Input rows shorter than the row length are padded with zeros.
+    struct NestedCopy
+    {
+        static const std::size_t parallel_copy_bytes = std::size_t(1) << 18;
+        static const std::size_t streaming_copy_bytes = std::size_t(16) << 20;
+
+        template <typename V>
+        static void flatten(const std::vector<std::vector<V>> &in, std::size_t n1, V *out, int threads = 1);
+
+        template <typename V>
+        static void flatten(const std::vector<std::vector<std::vector<V>>> &in, std::size_t n1, std::size_t n2,
+                            V *out, int threads = 1);
+
+        // Reshape `out` to n0 x n1 (x n2) and fill it from `in`. Rows that
+        // already have the right length are overwritten in place; new rows
+        // are built straight from `in` instead of being zero-filled first.
+        template <typename V>
+        static void unflatten(const V *in, std::size_t n0, std::size_t n1, std::vector<std::vector<V>> &out,
+                              int threads = 1);
+
+        template <typename V>
+        static void unflatten(const V *in, std::size_t n0, std::size_t n1, std::size_t n2,
+                              std::vector<std::vector<std::vector<V>>> &out, int threads = 1);
+    };
+
+} // namespace clapfft
+
+#endif // CLAPFFT_NESTED_COPY_HPP
@@ -0,0 +1,104 @@
+#ifndef CLAPFFT_NUFFT_HPP
+#define CLAPFFT_NUFFT_HPP
+
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "fft_flags.hpp"
+#include "thread_pool.hpp"
+
+namespace clapfft
+{
+    enum class NufftType
+    {
+        Type1, // nonuniform points to uniform modes
+        Type2, // uniform modes to nonuniform points
+    };
+
+    struct NufftOptions
+    {
+        // Target relative error; sets the kernel width, 2 to 16 grid
+        // points per axis. Clamped to about 1e-14 (1e-6 for float).
+        double tolerance;
+        // Fine grid points per mode per axis; more than 1.
+        double upsampling;
+        // Most points one spreading task handles; each task spreads into
+        // a private subgrid covering its points and adds that to the grid.
+        std::size_t max_subproblem;
+        fft_flags flags;
+
+        NufftOptions() : tolerance(1e-6), upsampling(2.0), max_subproblem(10000), flags(CLAP_FFT_DEFAULT) {}
+    };
+
+    // Nonuniform FFT in 1, 2 or 3 dimensions, for points x_j in R^rank
+    // (any real coordinates, taken modulo 2 pi) and modes k with
+    // -floor(N_d / 2) <= k_d < ceil(N_d / 2):
+    //
+    //     Type1:  f_k = sum_j c_j exp(i sign k . x_j)
+    //     Type2:  c_j = sum_k f_k exp(i sign k . x_j)
+    //
+    // Modes are stored row-major (last axis fastest), k_d = -floor(N_d / 2)
+    // first. Neither direction is normalised; with opposite signs, type 2
+    // is the adjoint of type 1.
+    //
+    // Type 1 spreads each c_j onto an upsampling() times finer grid with
+    // the exponential-of-semicircle kernel exp(beta (sqrt(1 - z^2) - 1)),
+    // transforms the grid in place with a cached c2c plan of its rank, and
+    // divides each kept mode by the kernel's Fourier transform (computed
+    // once, by Gauss-Legendre quadrature). Type 2 runs the same steps
+    // backwards: correct, transform, interpolate.
+    //
+    // set_points() sorts the points into small grid bins, so consecutive
+    // points touch neighbouring grid cells. Spreading runs on the pool in
+    // tasks of consecutive sorted points, each into a private subgrid
+    // that is then added to the shared grid under a lock; interpolation
+    // only reads the grid and needs no lock.
+    //
+    // One instance is not safe to use from several threads at once.
+    template <typename T>
+    class Nufft
+    {
+    public:
+        // modes holds rank mode counts. Invalid (see valid()) if rank is
+        // not 1, 2 or 3, a mode count is 0, sign is not +1 or -1, or the
+        // options are out of range.
+        Nufft(NufftType type, std::size_t rank, const std::size_t *modes, int sign,
+              const NufftOptions &options = NufftOptions(), ThreadPool &pool = ThreadPool::global());
+
+        Nufft();
+        ~Nufft();
+        Nufft(Nufft &&other);
+        Nufft &operator=(Nufft &&other);
+
+        Nufft(const Nufft &) = delete;
+        Nufft &operator=(const Nufft &) = delete;
+
+        bool valid() const;
+
+        NufftType type() const;
+        std::size_t rank() const;
+        const std::vector<std::size_t> &modes() const;
+        // Fine grid size per axis.
+        const std::vector<std::size_t> &grid_dims() const;
+        std::size_t kernel_width() const;
+        std::size_t point_count() const;
+
+        // Takes `count` points, one coordinate array per axis (y for rank
+        // 2 and 3, z for rank 3), and sorts them. The arrays are not kept.
+        bool set_points(std::size_t count, const T *x, const T *y = nullptr, const T *z = nullptr);
+
+        // Type1: in holds point_count() strengths, out the modes.
+        // Type2: in holds the modes, out point_count() values.
+        // Returns false if the instance is invalid.
+        bool execute(const std::complex<T> *in, std::complex<T> *out);
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> impl;
+    };
+
+} // namespace clapfft
+
+#endif // CLAPFFT_NUFFT_HPP
@@ -0,0 +1,58 @@
+#ifndef CLAPFFT_NUMA_HPP
+#define CLAPFFT_NUMA_HPP
+
+#include <string>
+#include <vector>
+
+namespace clapfft
+{
+    struct NumaNode
+    {
+        int id;
+        std::vector<int> cpus; // sorted logical CPU numbers
+    };
+
+    // NUMA layout of the machine as the kernel reports it under
+    // /sys/devices/system/node; no libnuma needed. Where that directory is
+    // missing (non-NUMA kernels, other systems) the machine is one node 0
+    // holding every CPU.
+    class NumaTopology
+    {
+    public:
+        // The running machine, restricted to the CPUs this process may run
+        // on; nodes left without CPUs are dropped. Read once.
+        static const NumaTopology &system();
+
+        // Reads `node_dir`/node<N>/cpulist for every node<N> entry.
+        static NumaTopology discover(const std::string &node_dir = "/sys/devices/system/node");
+
+        const std::vector<NumaNode> &nodes() const;
+        std::size_t node_count() const;
+
+        // Id of the node owning `cpu`, or -1.
+        int node_of_cpu(int cpu) const;
+
+        // Parses the kernel's cpulist format ("0-3,8,10-11") into `cpus`,
+        // sorted. Returns false on malformed input.
+        static bool parse_cpu_list(const std::string &list, std::vector<int> &cpus);
+
+        // Node holding the page at `address` (faulting it in if needed), or
+        // -1 if the kernel cannot tell, e.g. without NUMA support or when
+        // get_mempolicy is filtered out.
+        static int node_of_address(const void *address);
+
+        // Node of the CPU the calling thread is running on, or -1.
+        static int current_node();
+
+        // Restricts the calling thread to `cpus`. Returns false if that is
+        // unsupported or none of them is usable.
+        static bool pin_current_thread(const std::vector<int> &cpus);
+
+    private:
+        static NumaTopology load_system();
+
+        std::vector<NumaNode> node_list;
+    };
+} // namespace clapfft
+
+#endif // CLAPFFT_NUMA_HPP
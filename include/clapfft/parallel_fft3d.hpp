@@ -0,0 +1,55 @@
+#ifndef CLAPFFT_PARALLEL_FFT3D_HPP
+#define CLAPFFT_PARALLEL_FFT3D_HPP
+
+#include <complex>
+#include <memory>
+#include <vector>
+
+#include "fft_flags.hpp"
+#include "thread_pool.hpp"
+
+namespace clapfft
+{
+    // Slab-decomposed c2c transform of a row-major n0 x n1 x n2 volume,
+    // run on a ThreadPool instead of FFTW's internal threads:
+    //
+    //   1. every z-slab (an n1 x n2 plane) gets a 2D transform, slabs spread
+    //      across workers;
+    //   2. the volume is transposed to (n1*n2) x n0 in cache-sized tiles,
+    //      tiles spread across workers;
+    //   3. the n0-point transforms run as batched 1D pencils on contiguous
+    //      rows, writing straight back to the original layout through the
+    //      plan's output stride.
+    //
+    // All plans come from PlanCache<T> and are fetched once, at
+    // construction. The transpose buffer is owned by the engine, so one
+    // instance must not execute from several threads at once.
+    template <typename T>
+    class ParallelFFT3D
+    {
+    public:
+        ParallelFFT3D(int n0, int n1, int n2, int sign,
+                      ThreadPool &pool = ThreadPool::global(),
+                      fft_flags flags = CLAP_FFT_DEFAULT);
+        ~ParallelFFT3D();
+
+        ParallelFFT3D(const ParallelFFT3D &) = delete;
+        ParallelFFT3D &operator=(const ParallelFFT3D &) = delete;
+
+        // False if the shape was invalid or a plan could not be made.
+        bool valid() const;
+
+        // `in` and `out` hold n0 * n1 * n2 values; in == out is allowed.
+        bool execute(const std::complex<T> *in, std::complex<T> *out);
+
+        // Resizes `output` to the input size.
+        bool execute(const std::vector<std::complex<T>> &input, std::vector<std::complex<T>> &output);
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> impl;
+    };
+
+} // namespace clapfft
+
+#endif // CLAPFFT_PARALLEL_FFT3D_HPP
@@ -0,0 +1,90 @@
+#ifndef CLAPFFT_PARTITIONED_CONVOLVER_HPP
+#define CLAPFFT_PARTITIONED_CONVOLVER_HPP
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "fft_flags.hpp"
+
+namespace clapfft
+{
+    // Low-latency FIR filter for long kernels (reverb impulse responses)
+    // by uniformly partitioned overlap-save. The kernel is cut into
+    // partitions() pieces of block_size() taps, each transformed once to a
+    // 2 * block_size() point spectrum. Every block of block_size() input
+    // samples is transformed r2c into a frequency-domain delay line that
+    // holds the last partitions() input spectra; the output spectrum is
+    // the sum over partitions of piece p times the input spectrum from p
+    // blocks ago, transformed back c2r.
+    //
+    // Latency is one block rather than the kernel length, and every block
+    // costs the same: one r2c and one c2r of 2 * block_size() points plus
+    // partitions() spectral multiply-accumulates (ComplexOps::multiply_add)
+    // per channel. Channels share the kernel and their transforms run as
+    // one many_dft_r2c / many_dft_c2r from PlanCache<T>.
+    //
+    // Output and flush() behave as for Convolver: push() writes whole
+    // blocks of y[t] = sum_k h[k] x[t - k] as they complete, flush() drains
+    // the rest including the taps() - 1 sample tail.
+    //
+    // One instance is not safe to use from several threads at once.
+    template <typename T>
+    class PartitionedConvolver
+    {
+    public:
+        // Invalid (see valid()) if the kernel is empty, there are no
+        // channels, or block_size is 0.
+        PartitionedConvolver(const std::vector<T> &kernel, std::size_t channels = 1, std::size_t block_size = 128,
+                             fft_flags flags = CLAP_FFT_DEFAULT);
+
+        PartitionedConvolver();
+        ~PartitionedConvolver();
+        PartitionedConvolver(PartitionedConvolver &&other);
+        PartitionedConvolver &operator=(PartitionedConvolver &&other);
+
+        PartitionedConvolver(const PartitionedConvolver &) = delete;
+        PartitionedConvolver &operator=(const PartitionedConvolver &) = delete;
+
+        bool valid() const;
+
+        std::size_t taps() const;
+        std::size_t channels() const;
+        std::size_t block_size() const;
+        std::size_t partitions() const;
+
+        // Samples per channel the next push of `count` samples will write.
+        std::size_t output_ready(std::size_t count) const;
+
+        // Feeds `count` samples to every channel (in[c], out[c] per channel)
+        // and writes output_ready(count) samples per channel. Returns that
+        // number.
+        std::size_t push(const T *const *in, std::size_t count, T *const *out);
+
+        // Single-channel forms.
+        std::size_t push(const T *in, std::size_t count, T *out);
+        std::size_t push(const std::vector<T> &in, std::vector<T> &out);
+
+        // One vector per channel, all of the same length; appends.
+        std::size_t push(const std::vector<std::vector<T>> &in, std::vector<std::vector<T>> &out);
+
+        // Ends the stream: writes the samples still owed per channel (the
+        // buffered partial block plus the taps() - 1 sample tail), then
+        // starts over as after reset(). Returns that number, 0 if nothing
+        // was pushed.
+        std::size_t flush(T *const *out);
+        std::size_t flush(T *out);
+        std::size_t flush(std::vector<T> &out);
+        std::size_t flush(std::vector<std::vector<T>> &out);
+
+        // Clears the delay line and buffered input.
+        void reset();
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> impl;
+    };
+
+} // namespace clapfft
+
+#endif // CLAPFFT_PARTITIONED_CONVOLVER_HPP
@@ -0,0 +1,188 @@
+#pragma once
+#include "fft_flags.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace clapfft
+{
+
+    enum class TransformKind
+    {
+        C2C,
+        C2R,
+        R2C,
+        R2R
+    };
+
+    // Full description of an FFTW plan: logical sizes plus the memory layout
+    // the plan is allowed to be executed on. Two descriptors that compare
+    // equal can share one plan, so everything that changes what FFTW would
+    // build (batching, strides, embedding, in-place, alignment, threads,
+    // planner flags) is part of the key.
+    struct PlanKey
+    {
+        static const int max_rank = 8;
+
+        TransformKind kind;
+        int rank;
+        int n[max_rank];
+        int inembed[max_rank]; // 0 = tightly packed along that dimension
+        int onembed[max_rank];
+        int r2r_kind[max_rank]; // R2R only
+        int sign;               // C2C only
+        int howmany;
+        int istride;
+        int idist;
+        int ostride;
+        int odist;
+        int alignment; // byte alignment guaranteed for both arrays, 0 = unaligned
+        int nthreads;
+        bool in_place;
+        fft_flags flags; // planning options (measure/estimate/etc.)
+
+        PlanKey()
+            : kind(TransformKind::C2C), rank(0), sign(0), howmany(1), istride(1), idist(0),
+              ostride(1), odist(0), alignment(0), nthreads(1), in_place(false), flags(0)
+        {
+            for (int i = 0; i < max_rank; ++i)
+            {
+                n[i] = 0;
+                inembed[i] = 0;
+                onembed[i] = 0;
+                r2r_kind[i] = 0;
+            }
+        }
+
+        // A single tightly packed, out-of-place, unaligned transform; the
+        // layout used by the FFT:: entry points.
+        PlanKey(TransformKind k, int r, const int *dims, fft_flags f)
+            : PlanKey()
+        {
+            kind = k;
+            rank = r;
+            if (rank < 0)
+            {
+                rank = 0;
+            }
+            if (rank > max_rank)
+            {
+                rank = max_rank;
+            }
+            for (int i = 0; i < rank; ++i)
+            {
+                n[i] = dims[i];
+            }
+            flags = f;
+        }
+
+        // Canonicalises fields that do not change the plan, so equivalent
+        // descriptors share a cache entry: batch distances of a single
+        // transform and embeddings equal to the tightly packed layout.
+        void normalize()
+        {
+            if (howmany == 1)
+            {
+                idist = 0;
+                odist = 0;
+            }
+            bool in_tight = true;
+            bool out_tight = true;
+            for (int i = 1; i < rank; ++i)
+            {
+                int in_shape = n[i];
+                int out_shape = n[i];
+                if (i == rank - 1 && kind == TransformKind::C2R)
+                {
+                    in_shape = n[i] / 2 + 1;
+                }
+                if (i == rank - 1 && kind == TransformKind::R2C)
+                {
+                    out_shape = n[i] / 2 + 1;
+                }
+                in_tight = in_tight && (inembed[i] == 0 || inembed[i] == in_shape);
+                out_tight = out_tight && (onembed[i] == 0 || onembed[i] == out_shape);
+            }
+            for (int i = 0; i < rank; ++i)
+            {
+                if (in_tight)
+                {
+                    inembed[i] = 0;
+                }
+                if (out_tight)
+                {
+                    onembed[i] = 0;
+                }
+            }
+        }
+
+        bool operator==(const PlanKey &o) const
+        {
+            if (kind != o.kind || rank != o.rank || sign != o.sign || howmany != o.howmany ||
+                istride != o.istride || idist != o.idist || ostride != o.ostride || odist != o.odist ||
+                alignment != o.alignment || nthreads != o.nthreads || in_place != o.in_place || flags != o.flags)
+            {
+                return false;
+            }
+            for (int i = 0; i < rank; ++i)
+            {
+                if (n[i] != o.n[i] || inembed[i] != o.inembed[i] || onembed[i] != o.onembed[i] ||
+                    r2r_kind[i] != o.r2r_kind[i])
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool operator!=(const PlanKey &o) const
+        {
+            return !(*this == o);
+        }
+    };
+
+    // Mixes every field through a 64-bit multiply-rotate round and finishes
+    // with the murmur3 avalanche, so neighbouring sizes and swapped
+    // dimensions land in unrelated buckets.
+    struct PlanKeyHash
+    {
+        static std::uint64_t round(std::uint64_t h, std::uint64_t v)
+        {
+            h ^= v * 0x9e3779b97f4a7c15ULL;
+            h = (h << 31) | (h >> 33);
+            return h * 0xc2b2ae3d27d4eb4fULL;
+        }
+
+        static std::uint64_t avalanche(std::uint64_t h)
+        {
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdULL;
+            h ^= h >> 33;
+            h *= 0xc4ceb9fe1a85ec53ULL;
+            h ^= h >> 33;
+            return h;
+        }
+
+        static std::uint64_t word(int v)
+        {
+            return static_cast<std::uint64_t>(static_cast<std::uint32_t>(v));
+        }
+
+        size_t operator()(const PlanKey &k) const
+        {
+            std::uint64_t h = 0x27d4eb2f165667c5ULL;
+            h = round(h, word(static_cast<int>(k.kind)) | (word(k.rank) << 32));
+            for (int i = 0; i < k.rank; ++i)
+            {
+                h = round(h, word(k.n[i]) | (word(k.r2r_kind[i]) << 32));
+                h = round(h, word(k.inembed[i]) | (word(k.onembed[i]) << 32));
+            }
+            h = round(h, word(k.sign) | (word(k.howmany) << 32));
+            h = round(h, word(k.istride) | (word(k.idist) << 32));
+            h = round(h, word(k.ostride) | (word(k.odist) << 32));
+            h = round(h, word(k.alignment) | (word(k.nthreads) << 32));
+            h = round(h, static_cast<std::uint64_t>(k.flags) | (static_cast<std::uint64_t>(k.in_place) << 32));
+            return static_cast<size_t>(avalanche(h));
+        }
+    };
+
+}
@@ -0,0 +1,52 @@
+#ifndef CLAPFFT_PLANNING_POLICY_HPP
+#define CLAPFFT_PLANNING_POLICY_HPP
+
+#include <string>
+
+#include "fft_flags.hpp"
+#include "plan_key.hpp"
+
+namespace clapfft
+{
+    // Planner flags used when a caller passes CLAP_FFT_DEFAULT (the default
+    // argument of the FFT, AdvancedFFT and PlanCache entry points), chosen
+    // per precision and transform kind at runtime. Everything starts out as
+    // CLAP_FFT_ESTIMATE.
+    //
+    // On first use the policy reads the CLAPFFT_PLANNING_POLICY environment
+    // variable, then the file named by CLAPFFT_PLANNING_POLICY_FILE. Both
+    // use the syntax accepted by load_from_string, e.g.
+    //
+    //     double.c2c=measure; long_double.*=estimate; *.r2r=patient
+    //
+    // Entries are separated by ';', ',' or newlines; '#' starts a comment.
+    // Precisions are float, double, long_double (or "long double") and *;
+    // kinds are c2c, r2c, c2r, r2r and *, and a bare precision means all
+    // kinds. Policies are estimate, measure, patient and exhaustive.
+    struct PlanningPolicy
+    {
+        template <typename T>
+        static void set(TransformKind kind, fft_flags flags);
+
+        template <typename T>
+        static void set_all(fft_flags flags);
+
+        template <typename T>
+        static fft_flags get(TransformKind kind);
+
+        // `requested` unchanged unless it carries CLAP_FFT_DEFAULT, in which
+        // case that bit is replaced by the configured policy.
+        template <typename T>
+        static fft_flags resolve(TransformKind kind, fft_flags requested);
+
+        // Applies every valid entry; returns false if any entry was malformed.
+        static bool load_from_string(const std::string &spec);
+        static bool load_from_file(const std::string &filename);
+        static bool load_from_environment();
+
+        // Back to CLAP_FFT_ESTIMATE everywhere.
+        static void reset();
+    };
+} // namespace clapfft
+
+#endif // CLAPFFT_PLANNING_POLICY_HPP
@@ -0,0 +1,94 @@
+#ifndef CLAPFFT_PRUNED_DFT_HPP
+#define CLAPFFT_PRUNED_DFT_HPP
+
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "fft_flags.hpp"
+
+namespace clapfft
+{
+    enum class PruningMethod
+    {
+        Goertzel,      // one second-order recurrence per bin
+        Decomposition, // factor-point FFTs, then one Q-term sum per bin
+    };
+
+    // A few bins of the n-point DFT of a real signal,
+    //
+    //     X[k] = sum_j x[j] exp(-2 pi i k j / n),   k in bins,
+    //
+    // without computing the whole spectrum. Two methods:
+    //
+    //  - Goertzel: X[k] from s[j] = x[j] + 2 cos(w) s[j - 1] - s[j - 2],
+    //    about one multiply and two adds per sample and bin. Bins run
+    //    eight at a time with their state in SSE2 registers where
+    //    available, accumulating in at least double precision. Its
+    //    rounding error grows with n for bins near 0 and n / 2, so it is
+    //    the less accurate of the two there.
+    //  - Decomposition with n = P * Q (P = factor()): Q strided P-point
+    //    r2c transforms, one batched plan from PlanCache<T>, give every
+    //    subsequence x[q], x[q + Q], ... at all k mod P; each requested
+    //    bin is then a Q-term twiddled sum. P = n is the plain full r2c.
+    //
+    // The default choice minimises estimated_cost() over both methods and
+    // every divisor P of n. Its weights are rough per-operation ratios;
+    // benchmark_pruned_dft measures the real crossovers on a machine,
+    // next to the full r2c. Under the model a power-of-two n always
+    // decomposes (P grows with the bin count, reaching n only past about
+    // n / 5 bins), while Goertzel, which needs no plan or n-entry table,
+    // takes requests of a dozen or two bins when large prime factors of n
+    // leave FFTW without fast codelets.
+    //
+    // One instance is not safe to use from several threads at once.
+    template <typename T>
+    class PrunedDFT
+    {
+    public:
+        // Picks the cheapest method and factor by estimated_cost(). bins
+        // are indices in [0, n). Invalid (see valid()) if n is 0, bins is
+        // empty or out of range, or n does not fit FFTW's int sizes.
+        PrunedDFT(std::size_t n, const std::vector<std::size_t> &bins, fft_flags flags = CLAP_FFT_DEFAULT);
+
+        // Forces a method. For Decomposition, factor must be a divisor of
+        // n greater than 1 (0 picks the cheapest); it is ignored for
+        // Goertzel.
+        PrunedDFT(std::size_t n, const std::vector<std::size_t> &bins, PruningMethod method, std::size_t factor = 0,
+                  fft_flags flags = CLAP_FFT_DEFAULT);
+
+        PrunedDFT();
+        ~PrunedDFT();
+        PrunedDFT(PrunedDFT &&other);
+        PrunedDFT &operator=(PrunedDFT &&other);
+
+        PrunedDFT(const PrunedDFT &) = delete;
+        PrunedDFT &operator=(const PrunedDFT &) = delete;
+
+        bool valid() const;
+
+        std::size_t size() const;
+        const std::vector<std::size_t> &bins() const;
+        PruningMethod method() const;
+        // P of the decomposition; 0 for Goertzel.
+        std::size_t factor() const;
+
+        // Reads size() samples and writes bins().size() values, out[i] =
+        // X[bins()[i]]. Returns false if the instance is invalid.
+        bool transform(const T *in, std::complex<T> *out);
+
+        // Relative cost of `bin_count` bins by `method`, in units of one
+        // Goertzel step (one sample for one bin). Infinite for a
+        // Decomposition factor that is not a divisor of n above 1.
+        static double estimated_cost(std::size_t n, std::size_t bin_count, PruningMethod method,
+                                     std::size_t factor);
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> impl;
+    };
+
+} // namespace clapfft
+
+#endif // CLAPFFT_PRUNED_DFT_HPP
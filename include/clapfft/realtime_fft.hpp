@@ -0,0 +1,104 @@
+#ifndef CLAPFFT_REALTIME_FFT_HPP
+#define CLAPFFT_REALTIME_FFT_HPP
+
+#include <complex>
+#include <cstddef>
+#include <memory>
+
+#include "aligned_buffer.hpp"
+#include "fft_flags.hpp"
+
+namespace clapfft
+{
+    // Byte alignment RealtimeFFT plans are made for and expect from the
+    // arrays they execute on.
+    const std::size_t realtime_alignment = buffer_alignment;
+
+    // A transform planned ahead of time for use on a real-time thread such
+    // as an audio callback. Creating one plans (or fetches the plan from
+    // PlanCache<T>) and allocates everything it will ever need, so do that
+    // during setup. execute() then takes no lock, allocates nothing and
+    // makes no system call: it only runs FFTW's new-array execute on the
+    // caller's arrays. The handle keeps its plan alive even if the cache
+    // drops it.
+    //
+    // Arrays must be realtime_alignment-aligned (AlignedBuffer is) and hold
+    // input_size() and output_size() elements. A handle may execute from
+    // several threads at once, except c2r handles, which stage their input
+    // in a scratch buffer of their own so it survives.
+    template <typename T>
+    class RealtimeFFT
+    {
+    public:
+        static RealtimeFFT c2c(int rank, const int *n, int sign, bool in_place = false,
+                               fft_flags flags = CLAP_FFT_DEFAULT);
+        static RealtimeFFT r2c(int rank, const int *n, fft_flags flags = CLAP_FFT_DEFAULT);
+        static RealtimeFFT c2r(int rank, const int *n, fft_flags flags = CLAP_FFT_DEFAULT);
+        static RealtimeFFT r2r(int rank, const int *n, const int *kinds, bool in_place = false,
+                               fft_flags flags = CLAP_FFT_DEFAULT);
+
+        RealtimeFFT();
+        ~RealtimeFFT();
+        RealtimeFFT(RealtimeFFT &&other);
+        RealtimeFFT &operator=(RealtimeFFT &&other);
+
+        RealtimeFFT(const RealtimeFFT &) = delete;
+        RealtimeFFT &operator=(const RealtimeFFT &) = delete;
+
+        // False if the shape was invalid or planning failed.
+        bool valid() const;
+
+        // Elements of the input and output arrays.
+        std::size_t input_size() const;
+        std::size_t output_size() const;
+
+        // One overload per transform kind. Returns false without touching
+        // `out` if the overload does not match the handle's kind, an array
+        // is misaligned, or in-place use differs from what was planned.
+        bool execute(const std::complex<T> *in, std::complex<T> *out) const; // c2c
+        bool execute(const T *in, std::complex<T> *out) const;               // r2c
+        bool execute(const std::complex<T> *in, T *out);                     // c2r
+        bool execute(const T *in, T *out) const;                             // r2r
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> impl;
+    };
+
+    // Debug support for code that must stay real-time safe. When clapfft is
+    // built with the CMake option CLAPFFT_REALTIME_CHECKS, it interposes
+    // operator new and delete (plain, and the aligned forms when built as
+    // C++17), pthread_mutex_lock and pthread_cond_wait, and on glibc also
+    // malloc, calloc, realloc, free, posix_memalign, aligned_alloc and
+    // memalign, which is how FFTW allocates. Any of them called on a thread
+    // inside a RealtimeScope is reported to the violation handler;
+    // RealtimeFFT::execute runs inside one. Other blocking calls (sleeps,
+    // I/O, other lock types) and, off glibc, the C allocator go unchecked.
+    // Without the option, scopes cost nothing and nothing is reported.
+    struct RealtimeChecks
+    {
+        using Handler = void (*)(const char *what);
+
+        // Whether the checks were compiled in.
+        static bool available();
+
+        // The default handler prints `what` to stderr and aborts. The handler
+        // runs outside the scope, so it may allocate itself; nullptr
+        // restores the default.
+        static void set_handler(Handler handler);
+    };
+
+    // Marks the calling thread as real-time while it is alive; scopes nest.
+    class RealtimeScope
+    {
+    public:
+        RealtimeScope();
+        ~RealtimeScope();
+
+        RealtimeScope(const RealtimeScope &) = delete;
+        RealtimeScope &operator=(const RealtimeScope &) = delete;
+    };
+
+} // namespace clapfft
+
+#endif // CLAPFFT_REALTIME_FFT_HPP
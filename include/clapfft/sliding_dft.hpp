@@ -0,0 +1,87 @@
+#ifndef CLAPFFT_SLIDING_DFT_HPP
+#define CLAPFFT_SLIDING_DFT_HPP
+
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "fft_flags.hpp"
+
+namespace clapfft
+{
+    // Sliding DFT: selected bins of the n-point DFT of the last n samples,
+    //
+    //     X_k = sum_j x[t - n + 1 + j] exp(-2 pi i k j / n),
+    //
+    // updated after every sample in O(bins) per channel instead of a full
+    // transform per hop. Samples before the first push count as zeros.
+    //
+    // The update is the modulated form (mSDFT): each bin accumulates
+    // (x[t] - x[t - n]) times a twiddle read from an exact table at index
+    // k * t mod n, and is demodulated when read. Unlike the textbook
+    // recurrence X_k <- (X_k + x[t] - x[t - n]) * exp(2 pi i k / n) there
+    // is no rounded pole on the unit circle, so errors do not grow
+    // geometrically; what remains (rounding in the running sums) is
+    // cleared every resync_interval() samples by recomputing the window
+    // with one batched c2c FFT from PlanCache<T>.
+    //
+    // Bins are stored per channel as separate real and imaginary arrays,
+    // so the per-sample update is a contiguous multiply-add over bins the
+    // compiler vectorises, run once per channel.
+    //
+    // One instance is not safe to use from several threads at once.
+    template <typename T>
+    class SlidingDFT
+    {
+    public:
+        // bins are DFT indices in [0, n). resync_interval = 0 picks n,
+        // which costs O(log n) per sample amortised. Invalid (see valid())
+        // if n or channels is 0, bins is empty or out of range, or n does
+        // not fit FFTW's int sizes.
+        SlidingDFT(std::size_t n, const std::vector<std::size_t> &bins, std::size_t channels = 1,
+                   std::size_t resync_interval = 0, fft_flags flags = CLAP_FFT_DEFAULT);
+
+        SlidingDFT();
+        ~SlidingDFT();
+        SlidingDFT(SlidingDFT &&other);
+        SlidingDFT &operator=(SlidingDFT &&other);
+
+        SlidingDFT(const SlidingDFT &) = delete;
+        SlidingDFT &operator=(const SlidingDFT &) = delete;
+
+        bool valid() const;
+
+        std::size_t window_size() const;
+        std::size_t channels() const;
+        std::size_t resync_interval() const;
+        const std::vector<std::size_t> &bins() const;
+
+        // Feeds `count` samples to every channel (in[c] per channel). If
+        // out is not null, the spectrum after every sample is written
+        // there: count x channels() x bins().size() values, sample-major.
+        // Returns false if the instance is invalid.
+        bool push(const std::complex<T> *const *in, std::size_t count, std::complex<T> *out = nullptr);
+        bool push(const T *const *in, std::size_t count, std::complex<T> *out = nullptr);
+
+        // Single-channel forms.
+        bool push(const std::complex<T> *in, std::size_t count, std::complex<T> *out = nullptr);
+        bool push(const T *in, std::size_t count, std::complex<T> *out = nullptr);
+
+        // Current spectrum, channels() x bins().size() values.
+        void spectrum(std::complex<T> *out) const;
+
+        // Recomputes the bins from the buffered window now.
+        void resync();
+
+        // Back to an all-zero window.
+        void reset();
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> impl;
+    };
+
+} // namespace clapfft
+
+#endif // CLAPFFT_SLIDING_DFT_HPP
@@ -0,0 +1,140 @@
+#ifndef CLAPFFT_STFT_HPP
+#define CLAPFFT_STFT_HPP
+
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "fft_flags.hpp"
+
+namespace clapfft
+{
+    // Periodic Hann window of n points; at hop n / 2 (or n / 4, ...) its
+    // shifted copies sum to a constant.
+    template <typename T>
+    std::vector<T> hann_window(std::size_t n);
+
+    // Streaming short-time Fourier transform. Samples arrive in chunks of
+    // any size; every frame of window.size() samples, frames hop apart,
+    // is multiplied by the window and transformed r2c, and its bins() =
+    // frame_size() / 2 + 1 values are written out frame after frame, so a
+    // run of frames forms one contiguous frames x bins row-major array.
+    //
+    // Frames are windowed straight into a staging block and transformed up
+    // to max_batch at a time through one cached many_dft_r2c plan. Only the
+    // last frame_size() - 1 samples are kept between pushes. Results go
+    // directly into the caller's array when a batch starts
+    // buffer_alignment-aligned (AlignedBuffer), otherwise via a copy.
+    //
+    // One instance is not safe to use from several threads at once.
+    template <typename T>
+    class STFT
+    {
+    public:
+        // Invalid (see valid()) if the window is empty or hop is 0 or
+        // larger than the window.
+        STFT(const std::vector<T> &window, std::size_t hop, std::size_t max_batch = 32,
+             fft_flags flags = CLAP_FFT_DEFAULT);
+
+        STFT();
+        ~STFT();
+        STFT(STFT &&other);
+        STFT &operator=(STFT &&other);
+
+        STFT(const STFT &) = delete;
+        STFT &operator=(const STFT &) = delete;
+
+        bool valid() const;
+
+        std::size_t frame_size() const;
+        std::size_t hop() const;
+        std::size_t bins() const;
+
+        // Frames the next push of `count` samples will produce.
+        std::size_t frames_ready(std::size_t count) const;
+
+        // Feeds `count` samples and writes frames_ready(count) * bins()
+        // values to `out`. Returns the number of frames written.
+        std::size_t push(const T *samples, std::size_t count, std::complex<T> *out);
+
+        // Same, appending the frames to `out`.
+        std::size_t push(const std::vector<T> &samples, std::vector<std::complex<T>> &out);
+
+        // Ends the stream: if pushed samples are not yet part of any frame,
+        // writes one last frame, zero-padded, to `out` (room for bins()
+        // values). Then starts over as after reset(). Returns 0 or 1.
+        std::size_t flush(std::complex<T> *out);
+        std::size_t flush(std::vector<std::complex<T>> &out);
+
+        // Drops the buffered samples.
+        void reset();
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> impl;
+    };
+
+    // Streaming inverse of STFT by weighted overlap-add. Each frame of
+    // bins() = frame_size() / 2 + 1 values is transformed c2r (batched
+    // through a cached many_dft_c2r plan, up to max_batch frames at a
+    // time), multiplied by the synthesis window and added into an
+    // overlap buffer. The hop samples no later frame reaches are then
+    // divided by the sum of the squared window over the frames that
+    // covered them, and written out.
+    //
+    // Fed the frames of an STFT with the same window and hop, this
+    // reproduces its input wherever that sum is nonzero, whether or not
+    // the window satisfies COLA; zero-weight samples come out as 0. Once
+    // every overlapping frame is in, the sum is periodic in the hop and is
+    // applied as a precomputed gain.
+    //
+    // One instance is not safe to use from several threads at once.
+    template <typename T>
+    class ISTFT
+    {
+    public:
+        // Invalid (see valid()) if the window is empty or hop is 0 or
+        // larger than the window.
+        ISTFT(const std::vector<T> &window, std::size_t hop, std::size_t max_batch = 32,
+              fft_flags flags = CLAP_FFT_DEFAULT);
+
+        ISTFT();
+        ~ISTFT();
+        ISTFT(ISTFT &&other);
+        ISTFT &operator=(ISTFT &&other);
+
+        ISTFT(const ISTFT &) = delete;
+        ISTFT &operator=(const ISTFT &) = delete;
+
+        bool valid() const;
+
+        std::size_t frame_size() const;
+        std::size_t hop() const;
+        std::size_t bins() const;
+
+        // Consumes `frame_count` frames (frame_count * bins() values) and
+        // writes frame_count * hop() samples to `out`. Returns the number
+        // of samples written.
+        std::size_t push(const std::complex<T> *frames, std::size_t frame_count, T *out);
+
+        // Same, taking every whole frame in `frames` and appending to `out`.
+        std::size_t push(const std::vector<std::complex<T>> &frames, std::vector<T> &out);
+
+        // Ends the stream: writes the frame_size() - hop() samples still in
+        // the overlap buffer (none if no frame came in), then starts over as
+        // after reset(). Returns the number of samples written.
+        std::size_t flush(T *out);
+        std::size_t flush(std::vector<T> &out);
+
+        // Drops the overlap buffer.
+        void reset();
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> impl;
+    };
+
+} // namespace clapfft
+
+#endif // CLAPFFT_STFT_HPP
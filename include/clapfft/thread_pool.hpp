@@ -0,0 +1,104 @@
+#ifndef CLAPFFT_THREAD_POOL_HPP
+#define CLAPFFT_THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace clapfft
+{
+    // Fixed set of worker threads with one task deque each. A worker takes
+    // work from the back of its own deque and, when that runs dry, steals
+    // from the front of the others, so uneven batches still keep every core
+    // busy. The thread that submits a batch works on it too until it is
+    // done, which also makes nested parallel_for calls from inside a task
+    // safe.
+    //
+    // A pool built with pin_to_nodes spreads its workers round-robin over
+    // the NUMA nodes of NumaTopology::system() and binds each to the CPUs
+    // of its node. parallel_for_by_node then queues work on workers of the
+    // node that owns its data, and idle workers steal from their own node
+    // before crossing to another.
+    class ThreadPool
+    {
+    public:
+        using Task = std::function<void(std::size_t index, unsigned worker)>;
+
+        // `threads` counts the submitting thread, so threads - 1 background
+        // workers are started; 0 uses std::thread::hardware_concurrency().
+        explicit ThreadPool(unsigned threads = 0, bool pin_to_nodes = false);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        // Threads working on a batch. Worker ids passed to tasks are in
+        // [0, size()); size() - 1 stands for whichever thread submitted the
+        // batch, so state indexed by it is only private with one submitter.
+        unsigned size() const;
+
+        // Calls task(i, worker) for every i in [0, count) and returns once
+        // all calls have finished. `grain` consecutive indices form one
+        // stealable unit; 0 picks a grain that gives each worker a few units.
+        void parallel_for(std::size_t count, const Task &task, std::size_t grain = 0);
+
+        // parallel_for with one index per unit, where index i is queued on a
+        // worker pinned to node nodes[i] if there is one (-1 means any). It
+        // is a placement hint only: stealing still balances the load.
+        void parallel_for_by_node(std::size_t count, const Task &task, const std::vector<int> &nodes);
+
+        // Distinct NUMA nodes the workers are pinned to; 0 for an unpinned
+        // pool.
+        std::size_t pinned_nodes() const;
+
+        // Node `worker` is pinned to, or -1 (unpinned pools, the submitter).
+        int node_of(unsigned worker) const;
+
+        // Shared pool sized to the machine, created on first use. Its
+        // workers are pinned when the machine has more than one NUMA node.
+        static ThreadPool &global();
+
+    private:
+        struct Batch;
+
+        struct Range
+        {
+            Batch *batch;
+            std::size_t begin;
+            std::size_t end;
+        };
+
+        struct Queue
+        {
+            std::mutex mutex;
+            std::deque<Range> ranges;
+        };
+
+        bool pop(unsigned worker, Range &range);
+        bool steal(unsigned thief, Range &range);
+        void run_range(const Range &range, unsigned worker);
+        void finish(Batch &batch, unsigned self);
+        void worker_loop(unsigned worker, const std::vector<int> *cpus);
+
+        std::vector<std::unique_ptr<Queue>> queues; // one per worker plus the submitter's
+        std::vector<std::thread> threads;
+
+        std::vector<int> worker_node;                    // per queue, -1 if unpinned
+        std::vector<std::vector<unsigned>> steal_order;  // per queue, same node first
+        std::vector<int> node_ids;                       // nodes that have pinned workers
+        std::vector<std::vector<unsigned>> node_workers; // parallel to node_ids
+
+        std::mutex wake_mutex;
+        std::condition_variable wake;
+        std::atomic<std::size_t> queued;
+        bool stopping;
+    };
+} // namespace clapfft
+
+#endif // CLAPFFT_THREAD_POOL_HPP
@@ -0,0 +1,109 @@
+#ifndef CLAPFFT_WELCH_HPP
+#define CLAPFFT_WELCH_HPP
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "fft_flags.hpp"
+
+namespace clapfft
+{
+    enum class PsdScaling
+    {
+        Density,  // power per Hz: |X|^2 / (fs sum w^2)
+        Spectrum, // power of a bin-centred tone: |X|^2 / (sum w)^2
+    };
+
+    struct WelchOptions
+    {
+        // Samples between segment starts; 0 picks half the window.
+        std::size_t hop;
+        PsdScaling scaling;
+        // Subtract each segment's mean before windowing, as
+        // scipy.signal.welch's default detrend="constant" does.
+        bool detrend;
+        // Segments per many_dft_r2c execution, channels counted
+        // separately.
+        std::size_t max_batch;
+        fft_flags flags;
+
+        WelchOptions() : hop(0), scaling(PsdScaling::Density), detrend(false), max_batch(32), flags(CLAP_FFT_DEFAULT) {}
+    };
+
+    // Welch power spectral density of real multi-channel streams: the
+    // mean, over every complete segment of window.size() samples (hop()
+    // apart, starting at the first sample), of the one-sided periodogram
+    // of the windowed segment. Bins 1 to (n - 1) / 2 are doubled to fold
+    // in the negative frequencies, so the PSD integrates to the signal's
+    // power. Matches scipy.signal.welch with average="mean",
+    // return_onesided=True; a trailing partial segment is left out.
+    //
+    // Samples arrive in chunks of any size; only the last window.size()
+    // - 1 per channel are kept between pushes, so an hour-long recording
+    // streams in bounded memory. Segments of all channels are windowed
+    // into one staging block and transformed max_batch at a time through
+    // a cached many_dft_r2c plan. |X|^2 is summed per batch in T by an
+    // SSE2 kernel (ComplexOps::norm_add) and the batch sums added to
+    // running totals held in at least double precision.
+    //
+    // One instance is not safe to use from several threads at once.
+    template <typename T>
+    class Welch
+    {
+    public:
+        // Invalid (see valid()) if channels is 0, the window is empty or
+        // all zero, the hop is larger than the window, or sample_rate is
+        // not positive.
+        Welch(std::size_t channels, const std::vector<T> &window, double sample_rate,
+              const WelchOptions &options = WelchOptions());
+
+        Welch();
+        ~Welch();
+        Welch(Welch &&other);
+        Welch &operator=(Welch &&other);
+
+        Welch(const Welch &) = delete;
+        Welch &operator=(const Welch &) = delete;
+
+        bool valid() const;
+
+        std::size_t channels() const;
+        std::size_t segment_size() const;
+        std::size_t hop() const;
+        // window.size() / 2 + 1.
+        std::size_t bins() const;
+        // Segments averaged so far, per channel.
+        std::size_t segments() const;
+
+        // Feeds `count` samples to every channel (in[c] per channel).
+        // Returns the number of segments completed per channel.
+        std::size_t push(const T *const *in, std::size_t count);
+
+        // Single-channel form.
+        std::size_t push(const T *in, std::size_t count);
+
+        // The current estimate, channels() x bins() values, channel-major
+        // (zeros before the first segment). Returns segments().
+        std::size_t psd(T *out) const;
+
+        // Bin frequencies k * sample_rate / segment_size(), in Hz.
+        std::vector<T> frequencies() const;
+
+        // Drops the buffered samples and the accumulated power.
+        void reset();
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> impl;
+    };
+
+    // One-shot single-channel PSD, bins() values; empty if the estimator
+    // would be invalid or x holds less than one segment.
+    template <typename T>
+    std::vector<T> welch(const std::vector<T> &x, const std::vector<T> &window, double sample_rate,
+                         const WelchOptions &options = WelchOptions());
+
+} // namespace clapfft
+
+#endif // CLAPFFT_WELCH_HPP
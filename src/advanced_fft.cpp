@@ -1,14 +1,69 @@
 #include <clapfft/advanced_fft.hpp>
 #include <fftw3.h>
 #include <clapfft/fft_traits.hpp>
+#include <clapfft/fft_plan_cache.hpp>
 #include <mutex>
+#include <vector>
 
 namespace clapfft
 {
 
     namespace
     {
-        std::mutex planner_mutex;
+        // Describes an advanced-interface call as a cache key. Plans are made
+        // on scratch arrays, so they only depend on the layout, never on the
+        // caller's pointers beyond whether the call is in-place.
+        PlanKey many_key(TransformKind kind, int rank, const int *n, int howmany,
+                         const int *inembed, int istride, int idist,
+                         const int *onembed, int ostride, int odist,
+                         bool in_place, fft_flags flags, int nthreads)
+        {
+            PlanKey key(kind, rank, n, flags);
+            key.nthreads = nthreads;
+            key.howmany = howmany;
+            key.istride = istride;
+            key.idist = idist;
+            key.ostride = ostride;
+            key.odist = odist;
+            key.in_place = in_place;
+            for (int i = 0; i < key.rank; ++i)
+            {
+                key.inembed[i] = inembed != nullptr ? inembed[i] : 0;
+                key.onembed[i] = onembed != nullptr ? onembed[i] : 0;
+            }
+            key.normalize();
+            return key;
+        }
+
+        // Ranks beyond PlanKey::max_rank do not fit a cache key. They are
+        // planned on the caller's arrays, executed once and destroyed, under
+        // the cache's planner lock and thread-count handling.
+        template <typename T, typename Plan, typename Execute>
+        void run_uncached(int nthreads, Plan plan, Execute execute)
+        {
+            using traits = fft_trait<T>;
+            typename traits::plan_type p;
+            {
+                std::lock_guard<std::mutex> lock(PlanCache<T>::planner_lock());
+                const bool threaded = nthreads > 1 && PlanCache<T>::threads_available();
+                if (threaded)
+                {
+                    traits::plan_with_nthreads(nthreads);
+                }
+                p = plan();
+                if (threaded)
+                {
+                    traits::plan_with_nthreads(1);
+                }
+            }
+            if (p == nullptr)
+            {
+                return;
+            }
+            execute(p);
+            std::lock_guard<std::mutex> lock(PlanCache<T>::planner_lock());
+            traits::destroy_plan(p);
+        }
     }
 
     template <typename T>
@@ -18,7 +73,7 @@ namespace clapfft
                                std::complex<T> *out, const int *onembed,
                                int ostride, int odist,
                                int sign,
-                               fft_flags flags)
+                               fft_flags flags, int nthreads)
     {
         if (rank <= 0 || n == nullptr || in == nullptr || out == nullptr || howmany <= 0)
         {
@@ -29,22 +84,29 @@ namespace clapfft
         auto in_ptr = reinterpret_cast<typename traits::complex_type *>(in);
         auto out_ptr = reinterpret_cast<typename traits::complex_type *>(out);
 
-        typename traits::plan_type plan;
+        if (rank > PlanKey::max_rank)
         {
-            std::lock_guard<std::mutex> lock(planner_mutex);
-            plan = traits::plan_many_dft(rank, n, howmany,
-                                         in_ptr, inembed, istride, idist,
-                                         out_ptr, onembed, ostride, odist,
-                                         sign, flags);
+            const fft_flags resolved = PlanningPolicy::resolve<T>(TransformKind::C2C, flags);
+            run_uncached<T>(nthreads, [&]()
+                            { return traits::plan_many_dft(rank, n, howmany, in_ptr, inembed, istride, idist,
+                                                           out_ptr, onembed, ostride, odist, sign, resolved); },
+                            [&](typename traits::plan_type plan)
+                            { traits::execute_dft(plan, in_ptr, out_ptr); });
+            return;
         }
 
-        if (plan == nullptr)
+        PlanKey key = many_key(TransformKind::C2C, rank, n, howmany,
+                               inembed, istride, idist, onembed, ostride, odist,
+                               static_cast<void *>(in) == static_cast<void *>(out), flags, nthreads);
+        key.sign = sign;
+        auto wrapper = PlanCache<T>::get(key);
+        if (!wrapper || wrapper->plan == nullptr)
         {
             return;
         }
 
-        traits::execute_dft(plan, in_ptr, out_ptr);
-        traits::destroy_plan(plan);
+        wrapper->run([&](typename traits::plan_type plan)
+                     { traits::execute_dft(plan, in_ptr, out_ptr); });
     }
 
     template <typename T>
@@ -53,7 +115,7 @@ namespace clapfft
                                    int istride, int idist,
                                    std::complex<T> *out, const int *onembed,
                                    int ostride, int odist,
-                                   fft_flags flags)
+                                   fft_flags flags, int nthreads)
     {
         if (rank <= 0 || n == nullptr || in == nullptr || out == nullptr || howmany <= 0)
         {
@@ -63,22 +125,28 @@ namespace clapfft
         using traits = fft_trait<T>;
         auto out_ptr = reinterpret_cast<typename traits::complex_type *>(out);
 
-        typename traits::plan_type plan;
+        if (rank > PlanKey::max_rank)
         {
-            std::lock_guard<std::mutex> lock(planner_mutex);
-            plan = traits::plan_many_dft_r2c(rank, n, howmany,
-                                             in, inembed, istride, idist,
-                                             out_ptr, onembed, ostride, odist,
-                                             flags);
+            const fft_flags resolved = PlanningPolicy::resolve<T>(TransformKind::R2C, flags);
+            run_uncached<T>(nthreads, [&]()
+                            { return traits::plan_many_dft_r2c(rank, n, howmany, in, inembed, istride, idist,
+                                                               out_ptr, onembed, ostride, odist, resolved); },
+                            [&](typename traits::plan_type plan)
+                            { traits::execute_dft_r2c(plan, in, out_ptr); });
+            return;
         }
 
-        if (plan == nullptr)
+        const PlanKey key = many_key(TransformKind::R2C, rank, n, howmany,
+                                     inembed, istride, idist, onembed, ostride, odist,
+                                     static_cast<void *>(in) == static_cast<void *>(out), flags, nthreads);
+        auto wrapper = PlanCache<T>::get(key);
+        if (!wrapper || wrapper->plan == nullptr)
         {
             return;
         }
 
-        traits::execute_dft_r2c(plan, in, out_ptr);
-        traits::destroy_plan(plan);
+        wrapper->run([&](typename traits::plan_type plan)
+                     { traits::execute_dft_r2c(plan, in, out_ptr); });
     }
 
     template <typename T>
@@ -87,7 +155,7 @@ namespace clapfft
                                    int istride, int idist,
                                    T *out, const int *onembed,
                                    int ostride, int odist,
-                                   fft_flags flags)
+                                   fft_flags flags, int nthreads)
     {
         if (rank <= 0 || n == nullptr || in == nullptr || out == nullptr || howmany <= 0)
         {
@@ -97,22 +165,28 @@ namespace clapfft
         using traits = fft_trait<T>;
         auto in_ptr = reinterpret_cast<typename traits::complex_type *>(in);
 
-        typename traits::plan_type plan;
+        if (rank > PlanKey::max_rank)
         {
-            std::lock_guard<std::mutex> lock(planner_mutex);
-            plan = traits::plan_many_dft_c2r(rank, n, howmany,
-                                             in_ptr, inembed, istride, idist,
-                                             out, onembed, ostride, odist,
-                                             flags);
+            const fft_flags resolved = PlanningPolicy::resolve<T>(TransformKind::C2R, flags);
+            run_uncached<T>(nthreads, [&]()
+                            { return traits::plan_many_dft_c2r(rank, n, howmany, in_ptr, inembed, istride, idist,
+                                                               out, onembed, ostride, odist, resolved); },
+                            [&](typename traits::plan_type plan)
+                            { traits::execute_dft_c2r(plan, in_ptr, out); });
+            return;
         }
 
-        if (plan == nullptr)
+        const PlanKey key = many_key(TransformKind::C2R, rank, n, howmany,
+                                     inembed, istride, idist, onembed, ostride, odist,
+                                     static_cast<void *>(in) == static_cast<void *>(out), flags, nthreads);
+        auto wrapper = PlanCache<T>::get(key);
+        if (!wrapper || wrapper->plan == nullptr)
         {
             return;
         }
 
-        traits::execute_dft_c2r(plan, in_ptr, out);
-        traits::destroy_plan(plan);
+        wrapper->run([&](typename traits::plan_type plan)
+                     { traits::execute_dft_c2r(plan, in_ptr, out); });
     }
 
     template <typename T>
@@ -122,7 +196,7 @@ namespace clapfft
                                T *out, const int *onembed,
                                int ostride, int odist,
                                const int *kind,
-                               fft_flags flags)
+                               fft_flags flags, int nthreads)
     {
         if (rank <= 0 || n == nullptr || in == nullptr || out == nullptr || kind == nullptr || howmany <= 0)
         {
@@ -131,22 +205,37 @@ namespace clapfft
 
         using traits = fft_trait<T>;
 
-        typename traits::plan_type plan;
+        if (rank > PlanKey::max_rank)
         {
-            std::lock_guard<std::mutex> lock(planner_mutex);
-            plan = traits::plan_many_r2r(rank, n, howmany,
-                                         in, inembed, istride, idist,
-                                         out, onembed, ostride, odist,
-                                         reinterpret_cast<const fftw_r2r_kind*>(kind), flags);
+            const fft_flags resolved = PlanningPolicy::resolve<T>(TransformKind::R2R, flags);
+            std::vector<fftw_r2r_kind> kinds(static_cast<std::size_t>(rank));
+            for (int i = 0; i < rank; ++i)
+            {
+                kinds[static_cast<std::size_t>(i)] = static_cast<fftw_r2r_kind>(kind[i]);
+            }
+            run_uncached<T>(nthreads, [&]()
+                            { return traits::plan_many_r2r(rank, n, howmany, in, inembed, istride, idist,
+                                                           out, onembed, ostride, odist, kinds.data(), resolved); },
+                            [&](typename traits::plan_type plan)
+                            { traits::execute_r2r(plan, in, out); });
+            return;
         }
 
-        if (plan == nullptr)
+        PlanKey key = many_key(TransformKind::R2R, rank, n, howmany,
+                               inembed, istride, idist, onembed, ostride, odist,
+                               in == out, flags, nthreads);
+        for (int i = 0; i < key.rank; ++i)
+        {
+            key.r2r_kind[i] = kind[i];
+        }
+        auto wrapper = PlanCache<T>::get(key);
+        if (!wrapper || wrapper->plan == nullptr)
         {
             return;
         }
 
-        traits::execute_r2r(plan, in, out);
-        traits::destroy_plan(plan);
+        wrapper->run([&](typename traits::plan_type plan)
+                     { traits::execute_r2r(plan, in, out); });
     }
 
     template void AdvancedFFT::many_dft<float>(int, const int *, int,
@@ -154,69 +243,69 @@ namespace clapfft
                                                int, int,
                                                std::complex<float> *, const int *,
                                                int, int,
-                                               int, fft_flags);
+                                               int, fft_flags, int);
     template void AdvancedFFT::many_dft<double>(int, const int *, int,
                                                 std::complex<double> *, const int *,
                                                 int, int,
                                                 std::complex<double> *, const int *,
                                                 int, int,
-                                                int, fft_flags);
+                                                int, fft_flags, int);
     template void AdvancedFFT::many_dft<long double>(int, const int *, int,
                                                      std::complex<long double> *, const int *,
                                                      int, int,
                                                      std::complex<long double> *, const int *,
                                                      int, int,
-                                                     int, fft_flags);
+                                                     int, fft_flags, int);
 
     template void AdvancedFFT::many_dft_r2c<float>(int, const int *, int,
                                                    float *, const int *,
                                                    int, int,
                                                    std::complex<float> *, const int *,
-                                                   int, int, fft_flags);
+                                                   int, int, fft_flags, int);
     template void AdvancedFFT::many_dft_r2c<double>(int, const int *, int,
                                                     double *, const int *,
                                                     int, int,
                                                     std::complex<double> *, const int *,
-                                                    int, int, fft_flags);
+                                                    int, int, fft_flags, int);
     template void AdvancedFFT::many_dft_r2c<long double>(int, const int *, int,
                                                          long double *, const int *,
                                                          int, int,
                                                          std::complex<long double> *, const int *,
-                                                         int, int, fft_flags);
+                                                         int, int, fft_flags, int);
 
     template void AdvancedFFT::many_dft_c2r<float>(int, const int *, int,
                                                    std::complex<float> *, const int *,
                                                    int, int,
                                                    float *, const int *,
-                                                   int, int, fft_flags);
+                                                   int, int, fft_flags, int);
     template void AdvancedFFT::many_dft_c2r<double>(int, const int *, int,
                                                     std::complex<double> *, const int *,
                                                     int, int,
                                                     double *, const int *,
-                                                    int, int, fft_flags);
+                                                    int, int, fft_flags, int);
     template void AdvancedFFT::many_dft_c2r<long double>(int, const int *, int,
                                                          std::complex<long double> *, const int *,
                                                          int, int,
                                                          long double *, const int *,
-                                                         int, int, fft_flags);
+                                                         int, int, fft_flags, int);
 
     template void AdvancedFFT::many_r2r<float>(int, const int *, int,
                                                float *, const int *,
                                                int, int,
                                                float *, const int *,
                                                int, int,
-                                               const int *, fft_flags);
+                                               const int *, fft_flags, int);
     template void AdvancedFFT::many_r2r<double>(int, const int *, int,
                                                 double *, const int *,
                                                 int, int,
                                                 double *, const int *,
                                                 int, int,
-                                                const int *, fft_flags);
+                                                const int *, fft_flags, int);
     template void AdvancedFFT::many_r2r<long double>(int, const int *, int,
                                                      long double *, const int *,
                                                      int, int,
                                                      long double *, const int *,
                                                      int, int,
-                                                     const int *, fft_flags);
+                                                     const int *, fft_flags, int);
 
 } // namespace clapfft
@@ -0,0 +1,159 @@
+#include <clapfft/async_fft.hpp>
+
+namespace clapfft
+{
+    AsyncFFT::AsyncFFT(unsigned thread_count, std::size_t capacity_limit)
+        : queue_capacity(capacity_limit > 0 ? capacity_limit : 1), running(0), stopping(false)
+    {
+        if (thread_count == 0)
+        {
+            thread_count = std::thread::hardware_concurrency();
+            if (thread_count == 0)
+            {
+                thread_count = 1;
+            }
+        }
+        threads.reserve(thread_count);
+        for (unsigned i = 0; i < thread_count; ++i)
+        {
+            threads.emplace_back([this]()
+                                 { worker_loop(); });
+        }
+    }
+
+    AsyncFFT::~AsyncFFT()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        not_empty.notify_all();
+        not_full.notify_all();
+        for (std::size_t i = 0; i < threads.size(); ++i)
+        {
+            threads[i].join();
+        }
+    }
+
+    AsyncFFT &AsyncFFT::global()
+    {
+        static AsyncFFT executor;
+        return executor;
+    }
+
+    std::size_t AsyncFFT::pending() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return queue.size();
+    }
+
+    std::size_t AsyncFFT::capacity() const
+    {
+        return queue_capacity;
+    }
+
+    unsigned AsyncFFT::size() const
+    {
+        return static_cast<unsigned>(threads.size());
+    }
+
+    void AsyncFFT::wait_idle()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        idle.wait(lock, [this]()
+                  { return queue.empty() && running == 0; });
+    }
+
+    bool AsyncFFT::enqueue(Task &task, bool wait)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (wait)
+            {
+                not_full.wait(lock, [this]()
+                              { return stopping || queue.size() < queue_capacity; });
+            }
+            if (stopping || queue.size() >= queue_capacity)
+            {
+                return false;
+            }
+            queue.push_back(std::move(task));
+        }
+        not_empty.notify_one();
+        return true;
+    }
+
+    void AsyncFFT::worker_loop()
+    {
+        for (;;)
+        {
+            Task task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                not_empty.wait(lock, [this]()
+                               { return stopping || !queue.empty(); });
+                if (queue.empty())
+                {
+                    return; // stopping and drained
+                }
+                task = std::move(queue.front());
+                queue.pop_front();
+                ++running;
+            }
+            not_full.notify_one();
+
+            task();
+
+            bool now_idle = false;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                --running;
+                now_idle = queue.empty() && running == 0;
+            }
+            if (now_idle)
+            {
+                idle.notify_all();
+            }
+        }
+    }
+
+    template <typename T>
+    std::future<bool> AsyncFFT::submit(const TransformJob<T> &job)
+    {
+        Task task([job]()
+                  { return BatchFFT::execute(job); });
+        std::future<bool> result = task.get_future();
+        if (!enqueue(task, true))
+        {
+            // Only reachable while the executor is being destroyed.
+            std::promise<bool> failed;
+            failed.set_value(false);
+            return failed.get_future();
+        }
+        return result;
+    }
+
+    template <typename T>
+    bool AsyncFFT::try_submit(const TransformJob<T> &job, std::future<bool> &result)
+    {
+        Task task([job]()
+                  { return BatchFFT::execute(job); });
+        std::future<bool> future = task.get_future();
+        if (!enqueue(task, false))
+        {
+            return false;
+        }
+        result = std::move(future);
+        return true;
+    }
+
+    // Explicit instantiations
+    template std::future<bool> AsyncFFT::submit<float>(const TransformJob<float> &);
+    template std::future<bool> AsyncFFT::submit<double>(const TransformJob<double> &);
+    template std::future<bool> AsyncFFT::submit<long double>(const TransformJob<long double> &);
+
+    template bool AsyncFFT::try_submit<float>(const TransformJob<float> &, std::future<bool> &);
+    template bool AsyncFFT::try_submit<double>(const TransformJob<double> &, std::future<bool> &);
+    template bool AsyncFFT::try_submit<long double>(const TransformJob<long double> &, std::future<bool> &);
+
+} // namespace clapfft
@@ -0,0 +1,508 @@
+#include <clapfft/batch_fft.hpp>
+#include <fftw3.h>
+#include <clapfft/fft_traits.hpp>
+#include <clapfft/fft_plan_cache.hpp>
+#include <clapfft/numa.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+
+namespace clapfft
+{
+    namespace
+    {
+        template <typename T>
+        using WrapperPtr = std::shared_ptr<typename PlanCache<T>::Wrapper>;
+
+        // Per-thread state of a pool worker: the last plan it used, so runs
+        // of same-shape jobs skip the cache lookup, and a scratch buffer that
+        // only grows. Both are created by the worker itself, so on a pinned
+        // pool the scratch pages are first touched on the worker's node.
+        template <typename T>
+        struct WorkerState
+        {
+            PlanKey key;
+            WrapperPtr<T> wrapper;
+            std::vector<std::complex<T>> scratch;
+            std::vector<unsigned char> packed_in; // transform_batch gather buffers
+            std::vector<unsigned char> packed_out;
+        };
+
+        // Packed transform_batch buffers are aligned to this, so their plans
+        // may use aligned SIMD loads.
+        const int packed_alignment = 64;
+
+        // Jobs per transform_batch task: about this many tasks per worker.
+        const std::size_t batch_tasks_per_worker = 4;
+
+        // Upper bound on the input plus output bytes one packed task gathers.
+        const std::size_t max_packed_bytes = std::size_t(8) << 20;
+
+        template <typename T>
+        WorkerState<T> &worker_state()
+        {
+            thread_local WorkerState<T> state;
+            return state;
+        }
+
+        std::size_t complex_input_points(const PlanKey &key)
+        {
+            std::size_t total = 1;
+            for (int i = 0; i < key.rank; ++i)
+            {
+                const int extent = i == key.rank - 1 ? key.n[i] / 2 + 1 : key.n[i];
+                total *= static_cast<std::size_t>(extent);
+            }
+            return total;
+        }
+
+        // Elements the job's input array spans: every transform of the
+        // batch under its own stride, embedding and distance.
+        std::size_t input_extent(const PlanKey &key)
+        {
+            std::size_t last = 0;
+            std::size_t pitch = 1;
+            for (int i = key.rank - 1; i >= 0; --i)
+            {
+                const int extent = i == key.rank - 1 && key.kind == TransformKind::C2R ? key.n[i] / 2 + 1 : key.n[i];
+                last += static_cast<std::size_t>(extent - 1) * pitch;
+                pitch *= static_cast<std::size_t>(key.inembed[i] > 0 ? key.inembed[i] : extent);
+            }
+            return static_cast<std::size_t>(key.howmany - 1) * static_cast<std::size_t>(key.idist) +
+                   last * static_cast<std::size_t>(key.istride) + 1;
+        }
+
+        bool valid_job(const PlanKey &key, const void *in, const void *out)
+        {
+            if (in == nullptr || out == nullptr || key.rank <= 0 || key.rank > PlanKey::max_rank)
+            {
+                return false;
+            }
+            for (int i = 0; i < key.rank; ++i)
+            {
+                if (key.n[i] <= 0)
+                {
+                    return false;
+                }
+            }
+            // c2r inputs are copied by input_extent(), which needs a forward
+            // layout.
+            if (key.kind == TransformKind::C2R && (key.howmany <= 0 || key.istride <= 0 || key.idist < 0))
+            {
+                return false;
+            }
+            const bool in_place = in == out;
+            return !in_place || key.kind == TransformKind::C2C || key.kind == TransformKind::R2R;
+        }
+
+        template <typename T>
+        void execute_plan(typename PlanCache<T>::Wrapper &wrapper, TransformKind kind, void *in, void *out)
+        {
+            using traits = fft_trait<T>;
+            using complex_type = typename traits::complex_type;
+            switch (kind)
+            {
+            case TransformKind::C2C:
+                wrapper.run_concurrent([&](typename traits::plan_type plan)
+                                       { traits::execute_dft(plan, static_cast<complex_type *>(in), static_cast<complex_type *>(out)); });
+                break;
+            case TransformKind::R2C:
+                wrapper.run_concurrent([&](typename traits::plan_type plan)
+                                       { traits::execute_dft_r2c(plan, static_cast<T *>(in), static_cast<complex_type *>(out)); });
+                break;
+            case TransformKind::C2R:
+                wrapper.run_concurrent([&](typename traits::plan_type plan)
+                                       { traits::execute_dft_c2r(plan, static_cast<complex_type *>(in), static_cast<T *>(out)); });
+                break;
+            case TransformKind::R2R:
+                wrapper.run_concurrent([&](typename traits::plan_type plan)
+                                       { traits::execute_r2r(plan, static_cast<T *>(in), static_cast<T *>(out)); });
+                break;
+            }
+        }
+
+        // Element counts and sizes of one job's input and output arrays.
+        template <typename T>
+        struct JobLayout
+        {
+            std::size_t in_count;
+            std::size_t out_count;
+            std::size_t in_size;
+            std::size_t out_size;
+
+            explicit JobLayout(const PlanKey &key)
+            {
+                std::size_t full = 1;
+                for (int i = 0; i < key.rank; ++i)
+                {
+                    full *= static_cast<std::size_t>(key.n[i]);
+                }
+                const std::size_t half = complex_input_points(key);
+                const std::size_t real = sizeof(T);
+                const std::size_t complex = sizeof(std::complex<T>);
+                const bool complex_in = key.kind == TransformKind::C2C || key.kind == TransformKind::C2R;
+                const bool complex_out = key.kind == TransformKind::C2C || key.kind == TransformKind::R2C;
+                in_count = key.kind == TransformKind::C2R ? half : full;
+                out_count = key.kind == TransformKind::R2C ? half : full;
+                in_size = complex_in ? complex : real;
+                out_size = complex_out ? complex : real;
+            }
+
+            std::size_t bytes() const
+            {
+                return in_count * in_size + out_count * out_size;
+            }
+        };
+
+        // Single tightly packed transforms are what transform_batch merges;
+        // anything else runs on its own.
+        bool mergeable(const PlanKey &key)
+        {
+            if (key.howmany != 1 || key.istride != 1 || key.ostride != 1)
+            {
+                return false;
+            }
+            for (int i = 0; i < key.rank; ++i)
+            {
+                if (key.inembed[i] != 0 || key.onembed[i] != 0)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Start of a `bytes`-long region of `buffer` aligned to `alignment`.
+        unsigned char *aligned_region(std::vector<unsigned char> &buffer, std::size_t bytes, std::size_t alignment)
+        {
+            if (buffer.size() < bytes + alignment)
+            {
+                buffer.resize(bytes + alignment);
+            }
+            const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(buffer.data());
+            return buffer.data() + (alignment - address % alignment) % alignment;
+        }
+
+        // Distance between consecutive arrays, in elements of `size` bytes,
+        // if `ptrs` are evenly spaced at least `count` elements apart.
+        bool even_spacing(const std::vector<const unsigned char *> &ptrs, std::size_t size, std::size_t count, int &dist)
+        {
+            const std::ptrdiff_t step = ptrs[1] - ptrs[0];
+            if (step <= 0 || static_cast<std::size_t>(step) % size != 0 ||
+                static_cast<std::size_t>(step) / size < count ||
+                static_cast<std::size_t>(step) / size > static_cast<std::size_t>(std::numeric_limits<int>::max()))
+            {
+                return false;
+            }
+            for (std::size_t j = 2; j < ptrs.size(); ++j)
+            {
+                if (ptrs[j] - ptrs[j - 1] != step)
+                {
+                    return false;
+                }
+            }
+            dist = static_cast<int>(static_cast<std::size_t>(step) / size);
+            return true;
+        }
+
+        template <typename T>
+        bool run_job(const TransformJob<T> &job)
+        {
+            if (!valid_job(job.key, job.in, job.out))
+            {
+                return false;
+            }
+            PlanKey key = job.key;
+            key.in_place = job.in == job.out;
+            key.flags = PlanningPolicy::resolve<T>(key.kind, key.flags);
+            key.normalize();
+
+            WorkerState<T> &state = worker_state<T>();
+            if (!state.wrapper || state.key != key || state.wrapper->evicted.load(std::memory_order_acquire))
+            {
+                state.wrapper = PlanCache<T>::get(key);
+                state.key = key;
+            }
+            const WrapperPtr<T> wrapper = state.wrapper;
+            if (!wrapper || wrapper->plan == nullptr)
+            {
+                return false;
+            }
+
+            void *in = const_cast<void *>(job.in);
+            if (key.kind == TransformKind::C2R)
+            {
+                // The plan may overwrite its input, which the caller keeps;
+                // copy the whole batch, strides and gaps included.
+                const std::size_t points = input_extent(key);
+                if (state.scratch.size() < points)
+                {
+                    state.scratch.resize(points);
+                }
+                const std::complex<T> *src = static_cast<const std::complex<T> *>(job.in);
+                std::copy(src, src + points, state.scratch.begin());
+                in = state.scratch.data();
+            }
+            execute_plan<T>(*wrapper, key.kind, in, job.out);
+            return true;
+        }
+
+        // Runs `count` jobs that share `group_key` as one many-plan: straight
+        // on the caller's arrays when they are evenly spaced, otherwise on
+        // packed copies in this worker's gather buffers.
+        template <typename T>
+        bool run_group(const TransformJob<T> *jobs, const PlanKey &group_key, const std::size_t *members, std::size_t count)
+        {
+            if (count == 1)
+            {
+                return run_job(jobs[members[0]]);
+            }
+            const JobLayout<T> layout(group_key);
+            PlanKey key = group_key;
+            key.howmany = static_cast<int>(count);
+
+            // c2r plans may overwrite their input, which the caller keeps.
+            if (key.kind != TransformKind::C2R)
+            {
+                std::vector<const unsigned char *> ins(count);
+                std::vector<const unsigned char *> outs(count);
+                for (std::size_t j = 0; j < count; ++j)
+                {
+                    ins[j] = static_cast<const unsigned char *>(jobs[members[j]].in);
+                    outs[j] = static_cast<const unsigned char *>(jobs[members[j]].out);
+                }
+                if (even_spacing(ins, layout.in_size, layout.in_count, key.idist) &&
+                    even_spacing(outs, layout.out_size, layout.out_count, key.odist))
+                {
+                    key.normalize();
+                    const WrapperPtr<T> wrapper = PlanCache<T>::get(key);
+                    if (!wrapper || wrapper->plan == nullptr)
+                    {
+                        return false;
+                    }
+                    execute_plan<T>(*wrapper, key.kind, const_cast<unsigned char *>(ins[0]), const_cast<unsigned char *>(outs[0]));
+                    return true;
+                }
+            }
+
+            const std::size_t in_bytes = layout.in_count * layout.in_size;
+            const std::size_t out_bytes = layout.out_count * layout.out_size;
+            key.idist = static_cast<int>(layout.in_count);
+            key.odist = static_cast<int>(layout.out_count);
+            key.in_place = false;
+            key.alignment = packed_alignment;
+            key.normalize();
+            const WrapperPtr<T> wrapper = PlanCache<T>::get(key);
+            if (!wrapper || wrapper->plan == nullptr)
+            {
+                return false;
+            }
+            WorkerState<T> &state = worker_state<T>();
+            unsigned char *in = aligned_region(state.packed_in, count * in_bytes, packed_alignment);
+            unsigned char *out = aligned_region(state.packed_out, count * out_bytes, packed_alignment);
+            for (std::size_t j = 0; j < count; ++j)
+            {
+                std::memcpy(in + j * in_bytes, jobs[members[j]].in, in_bytes);
+            }
+            execute_plan<T>(*wrapper, key.kind, in, out);
+            for (std::size_t j = 0; j < count; ++j)
+            {
+                std::memcpy(jobs[members[j]].out, out + j * out_bytes, out_bytes);
+            }
+            return true;
+        }
+    }
+
+    template <typename T>
+    bool BatchFFT::execute(const TransformJob<T> *jobs, std::size_t count, ThreadPool &pool)
+    {
+        if (count == 0)
+        {
+            return true;
+        }
+        if (jobs == nullptr)
+        {
+            return false;
+        }
+        std::atomic<bool> ok(true);
+        const ThreadPool::Task task = [&](std::size_t i, unsigned)
+        {
+            if (!run_job(jobs[i]))
+            {
+                ok.store(false, std::memory_order_relaxed);
+            }
+        };
+        if (pool.pinned_nodes() > 1)
+        {
+            // Run each job next to its input.
+            std::vector<int> nodes(count);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                nodes[i] = NumaTopology::node_of_address(jobs[i].in);
+            }
+            pool.parallel_for_by_node(count, task, nodes);
+        }
+        else
+        {
+            pool.parallel_for(count, task);
+        }
+        return ok.load();
+    }
+
+    template <typename T>
+    bool BatchFFT::execute(const std::vector<TransformJob<T>> &jobs, ThreadPool &pool)
+    {
+        return execute(jobs.data(), jobs.size(), pool);
+    }
+
+    template <typename T>
+    bool BatchFFT::execute(const TransformJob<T> &job)
+    {
+        return run_job(job);
+    }
+
+    template <typename T>
+    bool BatchFFT::transform_batch(const TransformJob<T> *jobs, std::size_t count, ThreadPool &pool)
+    {
+        if (count == 0)
+        {
+            return true;
+        }
+        if (jobs == nullptr)
+        {
+            return false;
+        }
+
+        // Group by the single-transform plan key, in order of first use;
+        // jobs that cannot be merged form groups of their own.
+        bool ok = true;
+        std::vector<PlanKey> keys;
+        std::vector<std::vector<std::size_t>> members;
+        std::unordered_map<PlanKey, std::size_t, PlanKeyHash> index;
+        std::size_t merged = 0;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const TransformJob<T> &job = jobs[i];
+            if (!valid_job(job.key, job.in, job.out))
+            {
+                ok = false;
+                continue;
+            }
+            PlanKey key = job.key;
+            key.in_place = job.in == job.out;
+            key.flags = PlanningPolicy::resolve<T>(key.kind, key.flags);
+            key.normalize();
+            if (!mergeable(key))
+            {
+                keys.push_back(key);
+                members.push_back(std::vector<std::size_t>(1, i));
+                continue;
+            }
+            const auto found = index.find(key);
+            if (found == index.end())
+            {
+                index.emplace(key, keys.size());
+                keys.push_back(key);
+                members.push_back(std::vector<std::size_t>(1, i));
+            }
+            else
+            {
+                members[found->second].push_back(i);
+            }
+            ++merged;
+        }
+
+        // Split groups into tasks of at most `share` jobs so that even a
+        // single large group keeps every worker busy. Sorting members by
+        // address lets evenly spaced arrays run without packing.
+        struct Task
+        {
+            std::size_t group;
+            std::size_t begin;
+            std::size_t end;
+            double cost;
+        };
+        const std::size_t target = static_cast<std::size_t>(pool.size()) * batch_tasks_per_worker;
+        const std::size_t share = std::max<std::size_t>(1, (merged + target - 1) / target);
+        std::vector<Task> tasks;
+        for (std::size_t g = 0; g < keys.size(); ++g)
+        {
+            std::vector<std::size_t> &group = members[g];
+            std::sort(group.begin(), group.end(), [&](std::size_t a, std::size_t b)
+                      { return std::less<const void *>()(jobs[a].in, jobs[b].in); });
+            const JobLayout<T> layout(keys[g]);
+            const std::size_t len = std::max<std::size_t>(1, std::min(share, max_packed_bytes / layout.bytes()));
+            const double points = static_cast<double>(std::max(layout.in_count, layout.out_count));
+            for (std::size_t b = 0; b < group.size(); b += len)
+            {
+                Task task;
+                task.group = g;
+                task.begin = b;
+                task.end = std::min(b + len, group.size());
+                task.cost = static_cast<double>(task.end - task.begin) * points * std::log2(points + 1.0);
+                tasks.push_back(task);
+            }
+        }
+        // Largest first, so the tail of the batch is made of small tasks.
+        std::sort(tasks.begin(), tasks.end(), [](const Task &a, const Task &b)
+                  { return a.cost > b.cost; });
+
+        std::atomic<bool> all_ok(ok);
+        const ThreadPool::Task run = [&](std::size_t t, unsigned)
+        {
+            const Task &task = tasks[t];
+            if (!run_group(jobs, keys[task.group], members[task.group].data() + task.begin, task.end - task.begin))
+            {
+                all_ok.store(false, std::memory_order_relaxed);
+            }
+        };
+        if (pool.pinned_nodes() > 1)
+        {
+            std::vector<int> nodes(tasks.size());
+            for (std::size_t t = 0; t < tasks.size(); ++t)
+            {
+                nodes[t] = NumaTopology::node_of_address(jobs[members[tasks[t].group][tasks[t].begin]].in);
+            }
+            pool.parallel_for_by_node(tasks.size(), run, nodes);
+        }
+        else
+        {
+            pool.parallel_for(tasks.size(), run, 1);
+        }
+        return all_ok.load();
+    }
+
+    template <typename T>
+    bool BatchFFT::transform_batch(const std::vector<TransformJob<T>> &jobs, ThreadPool &pool)
+    {
+        return transform_batch(jobs.data(), jobs.size(), pool);
+    }
+
+    // Explicit instantiations
+    template bool BatchFFT::execute<float>(const TransformJob<float> *, std::size_t, ThreadPool &);
+    template bool BatchFFT::execute<double>(const TransformJob<double> *, std::size_t, ThreadPool &);
+    template bool BatchFFT::execute<long double>(const TransformJob<long double> *, std::size_t, ThreadPool &);
+
+    template bool BatchFFT::execute<float>(const std::vector<TransformJob<float>> &, ThreadPool &);
+    template bool BatchFFT::execute<double>(const std::vector<TransformJob<double>> &, ThreadPool &);
+    template bool BatchFFT::execute<long double>(const std::vector<TransformJob<long double>> &, ThreadPool &);
+
+    template bool BatchFFT::execute<float>(const TransformJob<float> &);
+    template bool BatchFFT::execute<double>(const TransformJob<double> &);
+    template bool BatchFFT::execute<long double>(const TransformJob<long double> &);
+
+    template bool BatchFFT::transform_batch<float>(const TransformJob<float> *, std::size_t, ThreadPool &);
+    template bool BatchFFT::transform_batch<double>(const TransformJob<double> *, std::size_t, ThreadPool &);
+    template bool BatchFFT::transform_batch<long double>(const TransformJob<long double> *, std::size_t, ThreadPool &);
+
+    template bool BatchFFT::transform_batch<float>(const std::vector<TransformJob<float>> &, ThreadPool &);
+    template bool BatchFFT::transform_batch<double>(const std::vector<TransformJob<double>> &, ThreadPool &);
+    template bool BatchFFT::transform_batch<long double>(const std::vector<TransformJob<long double>> &, ThreadPool &);
+
+} // namespace clapfft
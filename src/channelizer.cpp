@@ -0,0 +1,331 @@
+#include <clapfft/channelizer.hpp>
+#include <fftw3.h>
+#include <clapfft/aligned_buffer.hpp>
+#include <clapfft/fft_traits.hpp>
+#include <clapfft/fft_plan_cache.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace clapfft
+{
+    template <typename T>
+    struct Channelizer<T>::Impl
+    {
+        using traits = fft_trait<T>;
+        using complex_type = typename traits::complex_type;
+        using wrapper_type = typename PlanCache<T>::Wrapper;
+
+        std::size_t M;
+        std::size_t D;
+        std::size_t L;
+        std::size_t batch;
+        std::size_t pitch;  // M rounded up to keep every column aligned
+        ChannelizerMode mode;
+        AlignedBuffer<T> window;             // 2 L: h reversed, each tap twice (re, im)
+        AlignedBuffer<std::complex<T>> line; // L - 1 + batch D samples, oldest first
+        std::size_t filled;                  // samples held in line
+        std::size_t next;                    // line index of the next block's newest sample
+        std::size_t phase;                   // m D mod M of the next block
+        AlignedBuffer<std::complex<T>> folded;  // M
+        AlignedBuffer<std::complex<T>> columns; // batch x pitch
+        std::shared_ptr<wrapper_type> batch_plan;
+        std::shared_ptr<wrapper_type> single_plan;
+
+        // Weights the L samples ending at line[end] and folds them into M
+        // sums; column b receives them rotated by the block's phase.
+        void fold(std::size_t end, std::size_t b)
+        {
+            const T *seg = reinterpret_cast<const T *>(line.data() + (end + 1 - L));
+            const T *w = window.data();
+            T *acc = reinterpret_cast<T *>(folded.data());
+            const std::size_t width = 2 * M;
+            for (std::size_t q = 0; q < width; ++q)
+            {
+                acc[q] = w[q] * seg[q];
+            }
+            for (std::size_t p = width; p < 2 * L; p += width)
+            {
+                for (std::size_t q = 0; q < width; ++q)
+                {
+                    acc[q] += w[p + q] * seg[p + q];
+                }
+            }
+
+            // folded[M - 1 - r] = sum over j = r mod M of h[j] x[t - j];
+            // the column holds u[(s + phase) mod M].
+            std::complex<T> *column = columns.data() + b * pitch;
+            for (std::size_t s = 0; s < M - phase; ++s)
+            {
+                column[s] = folded[M - 1 - phase - s];
+            }
+            for (std::size_t s = M - phase; s < M; ++s)
+            {
+                column[s] = folded[2 * M - 1 - phase - s];
+            }
+        }
+
+        void flush(std::size_t blocks, std::complex<T> *out)
+        {
+            if (blocks == batch)
+            {
+                complex_type *data = reinterpret_cast<complex_type *>(columns.data());
+                batch_plan->run_concurrent([&](typename traits::plan_type p)
+                                           { traits::execute_dft(p, data, data); });
+            }
+            else
+            {
+                for (std::size_t b = 0; b < blocks; ++b)
+                {
+                    complex_type *data = reinterpret_cast<complex_type *>(columns.data() + b * pitch);
+                    single_plan->run_concurrent([&](typename traits::plan_type p)
+                                                { traits::execute_dft(p, data, data); });
+                }
+            }
+            for (std::size_t b = 0; b < blocks; ++b)
+            {
+                std::copy(columns.data() + b * pitch, columns.data() + b * pitch + M, out + b * M);
+            }
+        }
+
+        std::size_t ready(std::size_t count) const
+        {
+            const std::size_t end = filled + count;
+            return next < end ? (end - 1 - next) / D + 1 : 0;
+        }
+
+        template <typename Sample>
+        std::size_t push(const Sample *in, std::size_t count, std::complex<T> *out)
+        {
+            const std::size_t capacity = L - 1 + batch * D;
+            std::size_t written = 0;
+            while (count > 0)
+            {
+                const std::size_t take = std::min(count, capacity - filled);
+                for (std::size_t i = 0; i < take; ++i)
+                {
+                    line[filled + i] = std::complex<T>(in[i]);
+                }
+                filled += take;
+                in += take;
+                count -= take;
+
+                // The line holds at most batch blocks' worth past its history.
+                std::size_t blocks = 0;
+                for (; next < filled; next += D, ++blocks)
+                {
+                    fold(next, blocks);
+                    phase = (phase + D) % M;
+                }
+                flush(blocks, out + written * M);
+                written += blocks;
+
+                // Keep what the next block still reaches back to.
+                const std::size_t shift = next - (L - 1);
+                if (shift > 0)
+                {
+                    std::copy(line.data() + shift, line.data() + filled, line.data());
+                    filled -= shift;
+                    next -= shift;
+                }
+            }
+            return written;
+        }
+
+        void reset()
+        {
+            std::fill(line.data(), line.data() + (L - 1), std::complex<T>());
+            filled = L - 1;
+            next = L - 1;
+            phase = 0;
+        }
+    };
+
+    template <typename T>
+    Channelizer<T>::Channelizer(std::size_t channels, const std::vector<T> &prototype, ChannelizerMode mode,
+                                std::size_t max_batch, fft_flags flags)
+    {
+        const std::size_t limit = static_cast<std::size_t>(std::numeric_limits<int>::max());
+        if (channels == 0 || channels > limit || max_batch == 0 || prototype.empty())
+        {
+            return;
+        }
+        if (mode == ChannelizerMode::Oversampled && channels % 2 != 0)
+        {
+            return;
+        }
+        const std::size_t M = channels;
+        const std::size_t D = mode == ChannelizerMode::Oversampled ? M / 2 : M;
+        const std::size_t L = (prototype.size() + M - 1) / M * M;
+        if (L > limit)
+        {
+            return;
+        }
+        const bool aligned = buffer_alignment % sizeof(std::complex<T>) == 0;
+        const std::size_t line_width = aligned ? buffer_alignment / sizeof(std::complex<T>) : 1;
+        const std::size_t pitch = (M + line_width - 1) / line_width * line_width;
+        if (max_batch > limit / pitch || max_batch > (limit - L) / D)
+        {
+            return;
+        }
+
+        std::unique_ptr<Impl> state(new Impl());
+        state->M = M;
+        state->D = D;
+        state->L = L;
+        state->batch = max_batch;
+        state->pitch = pitch;
+        state->mode = mode;
+        state->window = AlignedBuffer<T>(2 * L);
+        for (std::size_t j = 0; j < prototype.size(); ++j)
+        {
+            state->window[2 * (L - 1 - j)] = prototype[j];
+            state->window[2 * (L - 1 - j) + 1] = prototype[j];
+        }
+        state->line = AlignedBuffer<std::complex<T>>(L - 1 + max_batch * D);
+        state->folded = AlignedBuffer<std::complex<T>>(M);
+        state->columns = AlignedBuffer<std::complex<T>>(max_batch * pitch);
+        state->reset();
+
+        // sum_s u[s] exp(+2 pi i k s / M): the backward transform.
+        const int dims = static_cast<int>(M);
+        PlanKey key(TransformKind::C2C, 1, &dims, flags);
+        key.sign = FFTW_BACKWARD;
+        key.in_place = true;
+        key.idist = static_cast<int>(pitch);
+        key.odist = static_cast<int>(pitch);
+        key.alignment = aligned ? static_cast<int>(buffer_alignment) : 0;
+        PlanKey single = key;
+        key.howmany = static_cast<int>(max_batch);
+        key.normalize();
+        single.normalize();
+        state->batch_plan = PlanCache<T>::get(key);
+        state->single_plan = PlanCache<T>::get(single);
+        if (!state->batch_plan || state->batch_plan->plan == nullptr || !state->single_plan ||
+            state->single_plan->plan == nullptr)
+        {
+            return;
+        }
+        impl = std::move(state);
+    }
+
+    template <typename T>
+    Channelizer<T>::Channelizer(std::size_t channels, std::size_t taps_per_channel, ChannelizerMode mode,
+                                std::size_t max_batch, fft_flags flags)
+        : Channelizer(channels, design_prototype(channels, taps_per_channel), mode, max_batch, flags)
+    {
+    }
+
+    template <typename T>
+    Channelizer<T>::Channelizer() = default;
+
+    template <typename T>
+    Channelizer<T>::~Channelizer() = default;
+
+    template <typename T>
+    Channelizer<T>::Channelizer(Channelizer &&other) = default;
+
+    template <typename T>
+    Channelizer<T> &Channelizer<T>::operator=(Channelizer &&other) = default;
+
+    template <typename T>
+    bool Channelizer<T>::valid() const
+    {
+        return impl != nullptr;
+    }
+
+    template <typename T>
+    std::size_t Channelizer<T>::channels() const
+    {
+        return impl ? impl->M : 0;
+    }
+
+    template <typename T>
+    ChannelizerMode Channelizer<T>::mode() const
+    {
+        return impl ? impl->mode : ChannelizerMode::Critical;
+    }
+
+    template <typename T>
+    std::size_t Channelizer<T>::decimation() const
+    {
+        return impl ? impl->D : 0;
+    }
+
+    template <typename T>
+    std::size_t Channelizer<T>::taps() const
+    {
+        return impl ? impl->L : 0;
+    }
+
+    template <typename T>
+    std::size_t Channelizer<T>::output_ready(std::size_t count) const
+    {
+        return impl ? impl->ready(count) : 0;
+    }
+
+    template <typename T>
+    std::size_t Channelizer<T>::push(const std::complex<T> *in, std::size_t count, std::complex<T> *out)
+    {
+        if (!impl || (count > 0 && (in == nullptr || out == nullptr)))
+        {
+            return 0;
+        }
+        return impl->push(in, count, out);
+    }
+
+    template <typename T>
+    std::size_t Channelizer<T>::push(const T *in, std::size_t count, std::complex<T> *out)
+    {
+        if (!impl || (count > 0 && (in == nullptr || out == nullptr)))
+        {
+            return 0;
+        }
+        return impl->push(in, count, out);
+    }
+
+    template <typename T>
+    void Channelizer<T>::reset()
+    {
+        if (impl)
+        {
+            impl->reset();
+        }
+    }
+
+    template <typename T>
+    std::vector<T> Channelizer<T>::design_prototype(std::size_t channels, std::size_t taps_per_channel)
+    {
+        const std::size_t L = channels * taps_per_channel;
+        if (channels == 0 || L / channels != taps_per_channel || L == 0)
+        {
+            return std::vector<T>();
+        }
+        const long double pi = 3.141592653589793238462643383279L;
+        const long double centre = static_cast<long double>(L - 1) / 2;
+        const long double span = L > 1 ? static_cast<long double>(L - 1) : 1.0L;
+        std::vector<long double> h(L);
+        long double sum = 0;
+        for (std::size_t j = 0; j < L; ++j)
+        {
+            const long double u = (static_cast<long double>(j) - centre) / static_cast<long double>(channels);
+            const long double sinc = u == 0 ? 1.0L : std::sin(pi * u) / (pi * u);
+            const long double phase = 2 * pi * static_cast<long double>(j) / span;
+            const long double blackman = L > 1 ? 0.42L - 0.5L * std::cos(phase) + 0.08L * std::cos(2 * phase) : 1.0L;
+            h[j] = sinc * blackman;
+            sum += h[j];
+        }
+        std::vector<T> prototype(L);
+        for (std::size_t j = 0; j < L; ++j)
+        {
+            prototype[j] = static_cast<T>(h[j] / sum);
+        }
+        return prototype;
+    }
+
+    // Explicit instantiations
+    template class Channelizer<float>;
+    template class Channelizer<double>;
+    template class Channelizer<long double>;
+
+} // namespace clapfft
@@ -0,0 +1,344 @@
+#include <clapfft/chirp_z.hpp>
+#include <fftw3.h>
+#include <clapfft/aligned_buffer.hpp>
+#include <clapfft/complex_ops.hpp>
+#include <clapfft/correlation.hpp>
+#include <clapfft/fft_traits.hpp>
+#include <clapfft/fft_plan_cache.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+namespace clapfft
+{
+    namespace
+    {
+        // Tables kept once nothing uses them, before unused ones are
+        // dropped on the next insertion.
+        const std::size_t max_cached_tables = 64;
+
+        // exp(-2 pi i cycles), with the whole turns removed in long double
+        // first so large arguments keep their fractional part.
+        template <typename T>
+        std::complex<T> turn(long double cycles)
+        {
+            const long double two_pi = 6.283185307179586476925286766559L;
+            cycles -= std::floor(cycles);
+            return std::complex<T>(static_cast<T>(std::cos(two_pi * cycles)), static_cast<T>(-std::sin(two_pi * cycles)));
+        }
+    }
+
+    template <typename T>
+    struct ChirpZ<T>::Tables
+    {
+        AlignedBuffer<std::complex<T>> pre;    // n: exp(-2 pi i (start j + step j^2 / 2))
+        AlignedBuffer<std::complex<T>> post;   // m: exp(-pi i step k^2)
+        AlignedBuffer<std::complex<T>> kernel; // l: spectrum of the conjugate chirp, over l
+    };
+
+    template <typename T>
+    struct ChirpZ<T>::Impl
+    {
+        using traits = fft_trait<T>;
+        using complex_type = typename traits::complex_type;
+        using wrapper_type = typename PlanCache<T>::Wrapper;
+        using key_type = std::tuple<std::size_t, std::size_t, double, double>;
+
+        struct Cache
+        {
+            std::mutex mutex;
+            std::map<key_type, std::shared_ptr<const Tables>> tables;
+        };
+
+        std::size_t n;
+        std::size_t m;
+        std::size_t l;
+        double start;
+        double step;
+        std::shared_ptr<const Tables> tables;
+        std::shared_ptr<wrapper_type> forward;
+        std::shared_ptr<wrapper_type> backward;
+        AlignedBuffer<std::complex<T>> work; // l
+
+        static Cache &cache()
+        {
+            static Cache instance;
+            return instance;
+        }
+
+        // Drops tables only the cache holds.
+        static void prune(Cache &c)
+        {
+            for (typename std::map<key_type, std::shared_ptr<const Tables>>::iterator it = c.tables.begin();
+                 it != c.tables.end();)
+            {
+                if (it->second.use_count() == 1)
+                {
+                    it = c.tables.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+        }
+
+        static std::shared_ptr<wrapper_type> plan(std::size_t size, int sign, fft_flags flags)
+        {
+            const int dims = static_cast<int>(size);
+            PlanKey key(TransformKind::C2C, 1, &dims, flags);
+            key.sign = sign;
+            key.in_place = true;
+            key.alignment = buffer_alignment % sizeof(std::complex<T>) == 0 ? static_cast<int>(buffer_alignment) : 0;
+            key.normalize();
+            return PlanCache<T>::get(key);
+        }
+
+        void run(const std::shared_ptr<wrapper_type> &wrapper)
+        {
+            complex_type *data = reinterpret_cast<complex_type *>(work.data());
+            wrapper->run_concurrent([&](typename traits::plan_type p)
+                                    { traits::execute_dft(p, data, data); });
+        }
+
+        std::shared_ptr<const Tables> build()
+        {
+            std::shared_ptr<Tables> t = std::make_shared<Tables>();
+            t->pre = AlignedBuffer<std::complex<T>>::uninitialized(n);
+            t->post = AlignedBuffer<std::complex<T>>::uninitialized(m);
+            t->kernel = AlignedBuffer<std::complex<T>>(l);
+            const long double f0 = start, df = step;
+            for (std::size_t j = 0; j < n; ++j)
+            {
+                const long double jj = static_cast<long double>(j);
+                t->pre[j] = turn<T>(f0 * jj + 0.5L * df * jj * jj);
+            }
+            for (std::size_t k = 0; k < m; ++k)
+            {
+                const long double kk = static_cast<long double>(k);
+                t->post[k] = turn<T>(0.5L * df * kk * kk);
+            }
+            // exp(+pi i step d^2) for the lags d = k - j in (-n, m), stored
+            // circularly.
+            for (std::size_t d = 0; d < std::max(n, m); ++d)
+            {
+                const long double dd = static_cast<long double>(d);
+                const std::complex<T> c = std::conj(turn<T>(0.5L * df * dd * dd));
+                if (d < m)
+                {
+                    t->kernel[d] = c;
+                }
+                if (d > 0 && d < n)
+                {
+                    t->kernel[l - d] = c;
+                }
+            }
+            std::copy(t->kernel.data(), t->kernel.data() + l, work.data());
+            run(forward);
+            const T scale = T(1) / static_cast<T>(l);
+            for (std::size_t i = 0; i < l; ++i)
+            {
+                t->kernel[i] = work[i] * scale;
+            }
+            return t;
+        }
+
+        std::shared_ptr<const Tables> lookup()
+        {
+            Cache &c = cache();
+            const key_type key(n, m, start, step);
+            {
+                std::lock_guard<std::mutex> lock(c.mutex);
+                typename std::map<key_type, std::shared_ptr<const Tables>>::const_iterator it = c.tables.find(key);
+                if (it != c.tables.end())
+                {
+                    return it->second;
+                }
+            }
+            // Built outside the lock; if another thread got there first,
+            // its tables win.
+            std::shared_ptr<const Tables> built = build();
+            std::lock_guard<std::mutex> lock(c.mutex);
+            if (c.tables.size() >= max_cached_tables)
+            {
+                prune(c);
+            }
+            return c.tables.insert(std::make_pair(key, built)).first->second;
+        }
+
+        void finish(std::complex<T> *out)
+        {
+            for (std::size_t j = n; j < l; ++j)
+            {
+                work[j] = std::complex<T>();
+            }
+            run(forward);
+            ComplexOps::multiply(work.data(), tables->kernel.data(), work.data(), l);
+            run(backward);
+            ComplexOps::multiply(work.data(), tables->post.data(), out, m);
+        }
+    };
+
+    template <typename T>
+    ChirpZ<T>::ChirpZ(std::size_t n, std::size_t m, double start, double step, fft_flags flags)
+    {
+        if (n == 0 || m == 0 || !std::isfinite(start) || !std::isfinite(step))
+        {
+            return;
+        }
+        const std::size_t limit = static_cast<std::size_t>(std::numeric_limits<int>::max());
+        if (n > limit || m > limit - n)
+        {
+            return;
+        }
+        std::unique_ptr<Impl> state(new Impl());
+        state->n = n;
+        state->m = m;
+        state->l = next_fast_size(n + m - 1);
+        state->start = start;
+        state->step = step;
+        if (state->l > limit)
+        {
+            return;
+        }
+        state->forward = Impl::plan(state->l, FFTW_FORWARD, flags);
+        state->backward = Impl::plan(state->l, FFTW_BACKWARD, flags);
+        if (!state->forward || state->forward->plan == nullptr || !state->backward ||
+            state->backward->plan == nullptr)
+        {
+            return;
+        }
+        state->work = AlignedBuffer<std::complex<T>>::uninitialized(state->l);
+        state->tables = state->lookup();
+        impl = std::move(state);
+    }
+
+    template <typename T>
+    ChirpZ<T>::ChirpZ() = default;
+
+    template <typename T>
+    ChirpZ<T>::~ChirpZ() = default;
+
+    template <typename T>
+    ChirpZ<T>::ChirpZ(ChirpZ &&other) = default;
+
+    template <typename T>
+    ChirpZ<T> &ChirpZ<T>::operator=(ChirpZ &&other) = default;
+
+    template <typename T>
+    bool ChirpZ<T>::valid() const
+    {
+        return impl != nullptr;
+    }
+
+    template <typename T>
+    std::size_t ChirpZ<T>::input_size() const
+    {
+        return impl ? impl->n : 0;
+    }
+
+    template <typename T>
+    std::size_t ChirpZ<T>::output_size() const
+    {
+        return impl ? impl->m : 0;
+    }
+
+    template <typename T>
+    std::size_t ChirpZ<T>::fft_size() const
+    {
+        return impl ? impl->l : 0;
+    }
+
+    template <typename T>
+    double ChirpZ<T>::frequency(std::size_t k) const
+    {
+        return impl ? impl->start + static_cast<double>(k) * impl->step : 0.0;
+    }
+
+    template <typename T>
+    bool ChirpZ<T>::transform(const std::complex<T> *in, std::complex<T> *out)
+    {
+        if (!impl || in == nullptr || out == nullptr)
+        {
+            return false;
+        }
+        ComplexOps::multiply(in, impl->tables->pre.data(), impl->work.data(), impl->n);
+        impl->finish(out);
+        return true;
+    }
+
+    template <typename T>
+    bool ChirpZ<T>::transform(const T *in, std::complex<T> *out)
+    {
+        if (!impl || in == nullptr || out == nullptr)
+        {
+            return false;
+        }
+        const std::complex<T> *pre = impl->tables->pre.data();
+        for (std::size_t j = 0; j < impl->n; ++j)
+        {
+            impl->work[j] = in[j] * pre[j];
+        }
+        impl->finish(out);
+        return true;
+    }
+
+    template <typename T>
+    void ChirpZ<T>::clear_cache()
+    {
+        typename Impl::Cache &c = Impl::cache();
+        std::lock_guard<std::mutex> lock(c.mutex);
+        Impl::prune(c);
+    }
+
+    template <typename T>
+    std::vector<std::complex<T>> chirp_z(const std::vector<std::complex<T>> &x, std::size_t m, double start,
+                                         double step)
+    {
+        ChirpZ<T> czt(x.size(), m, start, step);
+        std::vector<std::complex<T>> out(czt.output_size());
+        if (!czt.transform(x.data(), out.data()))
+        {
+            return std::vector<std::complex<T>>();
+        }
+        return out;
+    }
+
+    template <typename T>
+    std::vector<std::complex<T>> zoom_fft(const std::vector<T> &x, double f_start, double f_stop, std::size_t m)
+    {
+        if (m == 0)
+        {
+            return std::vector<std::complex<T>>();
+        }
+        ChirpZ<T> czt(x.size(), m, f_start, (f_stop - f_start) / static_cast<double>(m));
+        std::vector<std::complex<T>> out(czt.output_size());
+        if (!czt.transform(x.data(), out.data()))
+        {
+            return std::vector<std::complex<T>>();
+        }
+        return out;
+    }
+
+    // Explicit instantiations
+    template class ChirpZ<float>;
+    template class ChirpZ<double>;
+    template class ChirpZ<long double>;
+
+    template std::vector<std::complex<float>> chirp_z<float>(const std::vector<std::complex<float>> &, std::size_t,
+                                                             double, double);
+    template std::vector<std::complex<double>> chirp_z<double>(const std::vector<std::complex<double>> &, std::size_t,
+                                                               double, double);
+    template std::vector<std::complex<long double>> chirp_z<long double>(const std::vector<std::complex<long double>> &,
+                                                                         std::size_t, double, double);
+
+    template std::vector<std::complex<float>> zoom_fft<float>(const std::vector<float> &, double, double, std::size_t);
+    template std::vector<std::complex<double>> zoom_fft<double>(const std::vector<double> &, double, double,
+                                                                std::size_t);
+    template std::vector<std::complex<long double>> zoom_fft<long double>(const std::vector<long double> &, double,
+                                                                          double, std::size_t);
+
+} // namespace clapfft
@@ -0,0 +1,252 @@
+#include <clapfft/coalescing_fft.hpp>
+#include <fftw3.h>
+#include <clapfft/aligned_buffer.hpp>
+#include <clapfft/fft_traits.hpp>
+#include <clapfft/fft_plan_cache.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace clapfft
+{
+    namespace
+    {
+        std::atomic<bool> coalescing_enabled(false);
+        std::atomic<std::size_t> option_max_batch(CoalescingOptions().max_batch);
+        std::atomic<long> option_window_us(CoalescingOptions().window_us);
+        std::atomic<std::uint64_t> stat_requests(0);
+        std::atomic<std::uint64_t> stat_batches(0);
+
+        template <typename T>
+        struct Batch
+        {
+            std::size_t capacity;
+            AlignedBuffer<std::complex<T>> in;
+            AlignedBuffer<std::complex<T>> out;
+            std::size_t reserved; // slots handed out
+            std::size_t filled;   // slots whose input has been copied in
+            std::size_t released; // slots whose output has been copied out
+            bool done;
+            bool ok;
+
+            // Only the slots handed out are read, so the storage is left
+            // uninitialised.
+            Batch(int n, std::size_t slots)
+                : capacity(slots), in(AlignedBuffer<std::complex<T>>::uninitialized(static_cast<std::size_t>(n) * slots)),
+                  out(AlignedBuffer<std::complex<T>>::uninitialized(static_cast<std::size_t>(n) * slots)),
+                  reserved(0), filled(0), released(0), done(false), ok(false)
+            {
+            }
+
+            void reset()
+            {
+                reserved = 0;
+                filled = 0;
+                released = 0;
+                done = false;
+                ok = false;
+            }
+        };
+
+        // Released batches kept per group for reuse; a batch can be filling
+        // while the one before it executes, so two cover steady traffic.
+        const std::size_t max_spare_batches = 2;
+
+        // All requests sharing one transform descriptor. `open` is the batch
+        // new arrivals join; it is detached once full or once its leader
+        // stops waiting. `spare` holds finished batches whose buffers the
+        // next leader reuses.
+        template <typename T>
+        struct Group
+        {
+            std::mutex mutex;
+            std::condition_variable changed;
+            std::shared_ptr<Batch<T>> open;
+            std::vector<std::shared_ptr<Batch<T>>> spare;
+
+            // Called with `mutex` held.
+            std::shared_ptr<Batch<T>> acquire(int n, std::size_t capacity)
+            {
+                while (!spare.empty())
+                {
+                    std::shared_ptr<Batch<T>> batch = spare.back();
+                    spare.pop_back();
+                    // max_batch may have changed since it was made.
+                    if (batch->capacity == capacity)
+                    {
+                        batch->reset();
+                        return batch;
+                    }
+                }
+                return std::make_shared<Batch<T>>(n, capacity);
+            }
+        };
+
+        // Groups live for the rest of the process; there is one per distinct
+        // (n, sign, flags) ever coalesced.
+        template <typename T>
+        Group<T> &group_for(const PlanKey &key)
+        {
+            static std::mutex registry_mutex;
+            static std::unordered_map<PlanKey, std::unique_ptr<Group<T>>, PlanKeyHash> registry;
+
+            std::lock_guard<std::mutex> lock(registry_mutex);
+            std::unique_ptr<Group<T>> &group = registry[key];
+            if (!group)
+            {
+                group.reset(new Group<T>());
+            }
+            return *group;
+        }
+
+        template <typename T>
+        bool execute_batch(const PlanKey &single, Batch<T> &batch, std::size_t count)
+        {
+            using traits = fft_trait<T>;
+            PlanKey key = single;
+            key.howmany = static_cast<int>(count);
+            key.idist = key.n[0];
+            key.odist = key.n[0];
+            key.alignment = static_cast<int>(buffer_alignment);
+            key.normalize();
+            auto wrapper = PlanCache<T>::get(key);
+            if (!wrapper || wrapper->plan == nullptr)
+            {
+                return false;
+            }
+            auto in_ptr = reinterpret_cast<typename traits::complex_type *>(batch.in.data());
+            auto out_ptr = reinterpret_cast<typename traits::complex_type *>(batch.out.data());
+            wrapper->run_concurrent([&](typename traits::plan_type plan)
+                                    { traits::execute_dft(plan, in_ptr, out_ptr); });
+            return true;
+        }
+    }
+
+    void CoalescingFFT::set_enabled(bool enabled)
+    {
+        coalescing_enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool CoalescingFFT::enabled()
+    {
+        return coalescing_enabled.load(std::memory_order_relaxed);
+    }
+
+    void CoalescingFFT::set_options(const CoalescingOptions &options)
+    {
+        option_max_batch.store(options.max_batch > 0 ? options.max_batch : 1, std::memory_order_relaxed);
+        option_window_us.store(options.window_us > 0 ? options.window_us : 0, std::memory_order_relaxed);
+    }
+
+    CoalescingOptions CoalescingFFT::options()
+    {
+        CoalescingOptions options;
+        options.max_batch = option_max_batch.load(std::memory_order_relaxed);
+        options.window_us = option_window_us.load(std::memory_order_relaxed);
+        return options;
+    }
+
+    CoalescingStats CoalescingFFT::stats()
+    {
+        CoalescingStats s;
+        s.requests = stat_requests.load(std::memory_order_relaxed);
+        s.batches = stat_batches.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    void CoalescingFFT::reset_stats()
+    {
+        stat_requests.store(0, std::memory_order_relaxed);
+        stat_batches.store(0, std::memory_order_relaxed);
+    }
+
+    template <typename T>
+    bool CoalescingFFT::c2c_1d(const std::complex<T> *in, std::complex<T> *out, int n, int sign, fft_flags flags)
+    {
+        if (in == nullptr || out == nullptr || n <= 0)
+        {
+            return false;
+        }
+        PlanKey key(TransformKind::C2C, 1, &n, PlanningPolicy::resolve<T>(TransformKind::C2C, flags));
+        key.sign = sign;
+        Group<T> &group = group_for<T>(key);
+        const std::size_t points = static_cast<std::size_t>(n);
+
+        std::unique_lock<std::mutex> lock(group.mutex);
+        const bool leader = !group.open;
+        if (leader)
+        {
+            group.open = group.acquire(n, option_max_batch.load(std::memory_order_relaxed));
+        }
+        const std::shared_ptr<Batch<T>> batch = group.open;
+        const std::size_t slot = batch->reserved++;
+        if (batch->reserved == batch->capacity)
+        {
+            group.open.reset();
+            group.changed.notify_all();
+        }
+        lock.unlock();
+
+        std::copy(in, in + points, batch->in.data() + slot * points);
+
+        lock.lock();
+        ++batch->filled;
+        group.changed.notify_all();
+        if (leader)
+        {
+            const std::chrono::steady_clock::time_point deadline =
+                std::chrono::steady_clock::now() + std::chrono::microseconds(option_window_us.load(std::memory_order_relaxed));
+            group.changed.wait_until(lock, deadline, [&]()
+                                     { return group.open != batch; });
+            if (group.open == batch)
+            {
+                group.open.reset();
+            }
+            group.changed.wait(lock, [&]()
+                               { return batch->filled == batch->reserved; });
+            const std::size_t count = batch->reserved;
+            lock.unlock();
+
+            const bool ok = execute_batch(key, *batch, count);
+            stat_batches.fetch_add(1, std::memory_order_relaxed);
+
+            lock.lock();
+            batch->ok = ok;
+            batch->done = true;
+            group.changed.notify_all();
+        }
+        else
+        {
+            group.changed.wait(lock, [&]()
+                               { return batch->done; });
+        }
+        const bool ok = batch->ok;
+        lock.unlock();
+
+        stat_requests.fetch_add(1, std::memory_order_relaxed);
+        if (ok)
+        {
+            const std::complex<T> *result = batch->out.data() + slot * points;
+            std::copy(result, result + points, out);
+        }
+
+        // The last member out hands the buffers back to the group.
+        lock.lock();
+        if (++batch->released == batch->reserved && group.spare.size() < max_spare_batches)
+        {
+            group.spare.push_back(batch);
+        }
+        return ok;
+    }
+
+    // Explicit instantiations
+    template bool CoalescingFFT::c2c_1d<float>(const std::complex<float> *, std::complex<float> *, int, int, fft_flags);
+    template bool CoalescingFFT::c2c_1d<double>(const std::complex<double> *, std::complex<double> *, int, int, fft_flags);
+    template bool CoalescingFFT::c2c_1d<long double>(const std::complex<long double> *, std::complex<long double> *, int, int, fft_flags);
+
+} // namespace clapfft
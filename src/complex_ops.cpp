@@ -0,0 +1,203 @@
+#include <clapfft/complex_ops.hpp>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace clapfft
+{
+    namespace
+    {
+        template <typename T>
+        void multiply_kernel(const std::complex<T> *a, const std::complex<T> *b, std::complex<T> *out,
+                             std::size_t count)
+        {
+            const T *x = reinterpret_cast<const T *>(a);
+            const T *y = reinterpret_cast<const T *>(b);
+            T *z = reinterpret_cast<T *>(out);
+            for (std::size_t i = 0; i < 2 * count; i += 2)
+            {
+                const T re = x[i] * y[i] - x[i + 1] * y[i + 1];
+                const T im = x[i] * y[i + 1] + x[i + 1] * y[i];
+                z[i] = re;
+                z[i + 1] = im;
+            }
+        }
+
+        template <typename T>
+        void multiply_add_kernel(const std::complex<T> *a, const std::complex<T> *b, std::complex<T> *acc,
+                                 std::size_t count)
+        {
+            const T *x = reinterpret_cast<const T *>(a);
+            const T *y = reinterpret_cast<const T *>(b);
+            T *z = reinterpret_cast<T *>(acc);
+            for (std::size_t i = 0; i < 2 * count; i += 2)
+            {
+                z[i] += x[i] * y[i] - x[i + 1] * y[i + 1];
+                z[i + 1] += x[i] * y[i + 1] + x[i + 1] * y[i];
+            }
+        }
+
+        template <typename T>
+        void norm_add_kernel(const std::complex<T> *a, T *acc, std::size_t count)
+        {
+            const T *x = reinterpret_cast<const T *>(a);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                acc[i] += x[2 * i] * x[2 * i] + x[2 * i + 1] * x[2 * i + 1];
+            }
+        }
+
+#if defined(__SSE2__)
+        // (ar, ai) * (br, bi) = ar * (br, bi) + ai * (-bi, br), lane by lane.
+        inline __m128d multiply_pd(__m128d a, __m128d b)
+        {
+            const __m128d negate_low = _mm_set_pd(0.0, -0.0);
+            const __m128d re = _mm_unpacklo_pd(a, a);
+            const __m128d im = _mm_unpackhi_pd(a, a);
+            const __m128d swapped = _mm_xor_pd(_mm_shuffle_pd(b, b, 1), negate_low);
+            return _mm_add_pd(_mm_mul_pd(re, b), _mm_mul_pd(im, swapped));
+        }
+
+        // The same for two complex floats per register.
+        inline __m128 multiply_ps(__m128 a, __m128 b)
+        {
+            const __m128 negate_even = _mm_set_ps(0.0f, -0.0f, 0.0f, -0.0f);
+            const __m128 re = _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 0, 0));
+            const __m128 im = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 1, 1));
+            const __m128 swapped = _mm_xor_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 3, 0, 1)), negate_even);
+            return _mm_add_ps(_mm_mul_ps(re, b), _mm_mul_ps(im, swapped));
+        }
+
+        void multiply_kernel(const std::complex<double> *a, const std::complex<double> *b, std::complex<double> *out,
+                             std::size_t count)
+        {
+            const double *x = reinterpret_cast<const double *>(a);
+            const double *y = reinterpret_cast<const double *>(b);
+            double *z = reinterpret_cast<double *>(out);
+            for (std::size_t i = 0; i < 2 * count; i += 2)
+            {
+                _mm_storeu_pd(z + i, multiply_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+            }
+        }
+
+        void multiply_kernel(const std::complex<float> *a, const std::complex<float> *b, std::complex<float> *out,
+                             std::size_t count)
+        {
+            const float *x = reinterpret_cast<const float *>(a);
+            const float *y = reinterpret_cast<const float *>(b);
+            float *z = reinterpret_cast<float *>(out);
+            std::size_t i = 0;
+            for (; i + 2 <= count; i += 2)
+            {
+                _mm_storeu_ps(z + 2 * i, multiply_ps(_mm_loadu_ps(x + 2 * i), _mm_loadu_ps(y + 2 * i)));
+            }
+            multiply_kernel<float>(a + i, b + i, out + i, count - i);
+        }
+
+        void multiply_add_kernel(const std::complex<double> *a, const std::complex<double> *b,
+                                 std::complex<double> *acc, std::size_t count)
+        {
+            const double *x = reinterpret_cast<const double *>(a);
+            const double *y = reinterpret_cast<const double *>(b);
+            double *z = reinterpret_cast<double *>(acc);
+            for (std::size_t i = 0; i < 2 * count; i += 2)
+            {
+                const __m128d product = multiply_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i));
+                _mm_storeu_pd(z + i, _mm_add_pd(_mm_loadu_pd(z + i), product));
+            }
+        }
+
+        void multiply_add_kernel(const std::complex<float> *a, const std::complex<float> *b,
+                                 std::complex<float> *acc, std::size_t count)
+        {
+            const float *x = reinterpret_cast<const float *>(a);
+            const float *y = reinterpret_cast<const float *>(b);
+            float *z = reinterpret_cast<float *>(acc);
+            std::size_t i = 0;
+            for (; i + 2 <= count; i += 2)
+            {
+                const __m128 product = multiply_ps(_mm_loadu_ps(x + 2 * i), _mm_loadu_ps(y + 2 * i));
+                _mm_storeu_ps(z + 2 * i, _mm_add_ps(_mm_loadu_ps(z + 2 * i), product));
+            }
+            multiply_add_kernel<float>(a + i, b + i, acc + i, count - i);
+        }
+
+        // Squares two complex doubles, then pairs up the real and the
+        // imaginary halves: (r0^2 + i0^2, r1^2 + i1^2).
+        void norm_add_kernel(const std::complex<double> *a, double *acc, std::size_t count)
+        {
+            const double *x = reinterpret_cast<const double *>(a);
+            std::size_t i = 0;
+            for (; i + 2 <= count; i += 2)
+            {
+                const __m128d v0 = _mm_loadu_pd(x + 2 * i);
+                const __m128d v1 = _mm_loadu_pd(x + 2 * i + 2);
+                const __m128d s0 = _mm_mul_pd(v0, v0);
+                const __m128d s1 = _mm_mul_pd(v1, v1);
+                const __m128d norms = _mm_add_pd(_mm_unpacklo_pd(s0, s1), _mm_unpackhi_pd(s0, s1));
+                _mm_storeu_pd(acc + i, _mm_add_pd(_mm_loadu_pd(acc + i), norms));
+            }
+            norm_add_kernel<double>(a + i, acc + i, count - i);
+        }
+
+        // The same for four complex floats.
+        void norm_add_kernel(const std::complex<float> *a, float *acc, std::size_t count)
+        {
+            const float *x = reinterpret_cast<const float *>(a);
+            std::size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128 v0 = _mm_loadu_ps(x + 2 * i);
+                const __m128 v1 = _mm_loadu_ps(x + 2 * i + 4);
+                const __m128 s0 = _mm_mul_ps(v0, v0);
+                const __m128 s1 = _mm_mul_ps(v1, v1);
+                const __m128 re = _mm_shuffle_ps(s0, s1, _MM_SHUFFLE(2, 0, 2, 0));
+                const __m128 im = _mm_shuffle_ps(s0, s1, _MM_SHUFFLE(3, 1, 3, 1));
+                _mm_storeu_ps(acc + i, _mm_add_ps(_mm_loadu_ps(acc + i), _mm_add_ps(re, im)));
+            }
+            norm_add_kernel<float>(a + i, acc + i, count - i);
+        }
+#endif
+    }
+
+    template <typename T>
+    void ComplexOps::multiply(const std::complex<T> *a, const std::complex<T> *b, std::complex<T> *out,
+                              std::size_t count)
+    {
+        multiply_kernel(a, b, out, count);
+    }
+
+    template <typename T>
+    void ComplexOps::multiply_add(const std::complex<T> *a, const std::complex<T> *b, std::complex<T> *acc,
+                                  std::size_t count)
+    {
+        multiply_add_kernel(a, b, acc, count);
+    }
+
+    template <typename T>
+    void ComplexOps::norm_add(const std::complex<T> *a, T *acc, std::size_t count)
+    {
+        norm_add_kernel(a, acc, count);
+    }
+
+    // Explicit instantiations
+    template void ComplexOps::multiply<float>(const std::complex<float> *, const std::complex<float> *,
+                                              std::complex<float> *, std::size_t);
+    template void ComplexOps::multiply<double>(const std::complex<double> *, const std::complex<double> *,
+                                               std::complex<double> *, std::size_t);
+    template void ComplexOps::multiply<long double>(const std::complex<long double> *, const std::complex<long double> *,
+                                                    std::complex<long double> *, std::size_t);
+
+    template void ComplexOps::multiply_add<float>(const std::complex<float> *, const std::complex<float> *,
+                                                  std::complex<float> *, std::size_t);
+    template void ComplexOps::multiply_add<double>(const std::complex<double> *, const std::complex<double> *,
+                                                   std::complex<double> *, std::size_t);
+    template void ComplexOps::multiply_add<long double>(const std::complex<long double> *, const std::complex<long double> *,
+                                                        std::complex<long double> *, std::size_t);
+
+    template void ComplexOps::norm_add<float>(const std::complex<float> *, float *, std::size_t);
+    template void ComplexOps::norm_add<double>(const std::complex<double> *, double *, std::size_t);
+    template void ComplexOps::norm_add<long double>(const std::complex<long double> *, long double *, std::size_t);
+
+} // namespace clapfft
@@ -0,0 +1,422 @@
+#include <clapfft/convolver.hpp>
+#include <fftw3.h>
+#include <clapfft/aligned_buffer.hpp>
+#include <clapfft/complex_ops.hpp>
+#include <clapfft/fft_traits.hpp>
+#include <clapfft/fft_plan_cache.hpp>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstring>
+#include <limits>
+
+namespace clapfft
+{
+    namespace
+    {
+        std::size_t next_power_of_two(std::size_t n)
+        {
+            std::size_t p = 1;
+            while (p < n)
+            {
+                p <<= 1;
+            }
+            return p;
+        }
+
+        // Largest FFT size considered; keeps the int plan dimensions and
+        // the per-channel buffers bounded.
+        const std::size_t max_fft_size = std::size_t(1) << 26;
+    }
+
+    template <typename T>
+    std::size_t Convolver<T>::choose_fft_size(std::size_t taps)
+    {
+        if (taps == 0)
+        {
+            return 0;
+        }
+        const std::size_t first = next_power_of_two(2 * taps);
+        std::size_t best = first;
+        double best_cost = std::numeric_limits<double>::max();
+        const std::size_t last = std::min(first << 6, std::max(first, max_fft_size));
+        for (std::size_t n = first; n <= last; n <<= 1)
+        {
+            const double size = static_cast<double>(n);
+            const double cost = (std::log2(size) + 1.0) * size / static_cast<double>(n - taps + 1);
+            if (cost < best_cost)
+            {
+                best_cost = cost;
+                best = n;
+            }
+        }
+        return best;
+    }
+
+    template <typename T>
+    struct Convolver<T>::Impl
+    {
+        using traits = fft_trait<T>;
+        using complex_type = typename traits::complex_type;
+        using wrapper_type = typename PlanCache<T>::Wrapper;
+
+        std::size_t m;       // taps
+        std::size_t n;       // FFT size
+        std::size_t block;   // n - m + 1 new samples per block
+        std::size_t bins;    // n / 2 + 1
+        std::size_t nchan;
+        std::size_t fill;    // new samples buffered in the current block
+        bool started;        // something was pushed since the last reset
+        AlignedBuffer<std::complex<T>> kernel;   // bins, scaled by 1 / n
+        AlignedBuffer<T> input;                  // nchan x n: history, then new samples
+        AlignedBuffer<T> history;                // nchan x (m - 1), saved before r2c
+        AlignedBuffer<std::complex<T>> spectrum; // nchan x bins
+        AlignedBuffer<T> output;                 // nchan x n
+        std::shared_ptr<wrapper_type> forward;
+        std::shared_ptr<wrapper_type> inverse;
+
+        static std::shared_ptr<wrapper_type> plan(TransformKind kind, std::size_t size, std::size_t howmany,
+                                                  fft_flags flags)
+        {
+            const int full = static_cast<int>(size);
+            const int half = static_cast<int>(size / 2 + 1);
+            PlanKey key(kind, 1, &full, flags);
+            key.howmany = static_cast<int>(howmany);
+            key.idist = kind == TransformKind::R2C ? full : half;
+            key.odist = kind == TransformKind::R2C ? half : full;
+            key.alignment = static_cast<int>(buffer_alignment);
+            key.normalize();
+            return PlanCache<T>::get(key);
+        }
+
+        // Transforms the n-point blocks in `input`, keeping samples m - 1 ..
+        // n - 1 of each result in `output`.
+        void run_block()
+        {
+            const std::size_t keep = m - 1;
+            for (std::size_t c = 0; c < nchan && keep > 0; ++c)
+            {
+                std::memcpy(history.data() + c * keep, input.data() + c * n + block, keep * sizeof(T));
+            }
+            T *in = input.data();
+            complex_type *freq = reinterpret_cast<complex_type *>(spectrum.data());
+            T *out = output.data();
+            forward->run_concurrent([&](typename traits::plan_type p)
+                                    { traits::execute_dft_r2c(p, in, freq); });
+            for (std::size_t c = 0; c < nchan; ++c)
+            {
+                std::complex<T> *row = spectrum.data() + c * bins;
+                ComplexOps::multiply(row, kernel.data(), row, bins);
+            }
+            inverse->run_concurrent([&](typename traits::plan_type p)
+                                    { traits::execute_dft_c2r(p, freq, out); });
+            for (std::size_t c = 0; c < nchan && keep > 0; ++c)
+            {
+                std::memcpy(input.data() + c * n, history.data() + c * keep, keep * sizeof(T));
+            }
+            fill = 0;
+        }
+
+        void emit(T *const *out, std::size_t offset, std::size_t count) const
+        {
+            for (std::size_t c = 0; c < nchan; ++c)
+            {
+                std::memcpy(out[c] + offset, output.data() + c * n + m - 1, count * sizeof(T));
+            }
+        }
+
+        std::size_t ready(std::size_t count) const
+        {
+            return (fill + count) / block * block;
+        }
+
+        std::size_t push(const T *const *in, std::size_t count, T *const *out)
+        {
+            std::size_t consumed = 0;
+            std::size_t produced = 0;
+            started = started || count > 0;
+            while (consumed < count)
+            {
+                const std::size_t take = std::min(block - fill, count - consumed);
+                for (std::size_t c = 0; c < nchan; ++c)
+                {
+                    std::memcpy(input.data() + c * n + m - 1 + fill, in[c] + consumed, take * sizeof(T));
+                }
+                fill += take;
+                consumed += take;
+                if (fill == block)
+                {
+                    run_block();
+                    emit(out, produced, block);
+                    produced += block;
+                }
+            }
+            return produced;
+        }
+
+        std::size_t flush(T *const *out)
+        {
+            if (!started)
+            {
+                return 0;
+            }
+            const std::size_t owed = fill + m - 1;
+            std::size_t produced = 0;
+            while (produced < owed)
+            {
+                for (std::size_t c = 0; c < nchan; ++c)
+                {
+                    T *row = input.data() + c * n + m - 1;
+                    std::fill(row + fill, row + block, T(0));
+                }
+                run_block();
+                const std::size_t count = std::min(block, owed - produced);
+                emit(out, produced, count);
+                produced += count;
+            }
+            reset();
+            return owed;
+        }
+
+        void reset()
+        {
+            std::fill(input.data(), input.data() + nchan * n, T(0));
+            fill = 0;
+            started = false;
+        }
+    };
+
+    template <typename T>
+    Convolver<T>::Convolver(const std::vector<T> &kernel, std::size_t channels, std::size_t block_size, fft_flags flags)
+    {
+        const std::size_t m = kernel.size();
+        if (m == 0 || channels == 0 || m > max_fft_size / 2 ||
+            (block_size > 0 && block_size > max_fft_size - m + 1))
+        {
+            return;
+        }
+        const std::size_t n = block_size > 0 ? next_power_of_two(block_size + m - 1) : choose_fft_size(m);
+
+        std::unique_ptr<Impl> state(new Impl());
+        state->m = m;
+        state->n = n;
+        state->block = n - m + 1;
+        state->bins = n / 2 + 1;
+        state->nchan = channels;
+        state->input = AlignedBuffer<T>(channels * n);
+        state->history = AlignedBuffer<T>(channels * (m - 1));
+        state->spectrum = AlignedBuffer<std::complex<T>>(channels * state->bins);
+        state->output = AlignedBuffer<T>(channels * n);
+        state->kernel = AlignedBuffer<std::complex<T>>(state->bins);
+        state->fill = 0;
+        state->started = false;
+
+        state->forward = Impl::plan(TransformKind::R2C, n, channels, flags);
+        state->inverse = Impl::plan(TransformKind::C2R, n, channels, flags);
+        const std::shared_ptr<typename Impl::wrapper_type> single = Impl::plan(TransformKind::R2C, n, 1, flags);
+        if (!state->forward || state->forward->plan == nullptr || !state->inverse ||
+            state->inverse->plan == nullptr || !single || single->plan == nullptr)
+        {
+            return;
+        }
+
+        // Kernel spectrum, with the c2r normalisation folded in.
+        AlignedBuffer<T> padded(n);
+        std::copy(kernel.begin(), kernel.end(), padded.data());
+        T *src = padded.data();
+        typename Impl::complex_type *dst = reinterpret_cast<typename Impl::complex_type *>(state->kernel.data());
+        single->run_concurrent([&](typename Impl::traits::plan_type p)
+                               { Impl::traits::execute_dft_r2c(p, src, dst); });
+        const T scale = T(1) / static_cast<T>(n);
+        for (std::size_t k = 0; k < state->bins; ++k)
+        {
+            state->kernel[k] *= scale;
+        }
+        impl = std::move(state);
+    }
+
+    template <typename T>
+    Convolver<T>::Convolver() = default;
+
+    template <typename T>
+    Convolver<T>::~Convolver() = default;
+
+    template <typename T>
+    Convolver<T>::Convolver(Convolver &&other) = default;
+
+    template <typename T>
+    Convolver<T> &Convolver<T>::operator=(Convolver &&other) = default;
+
+    template <typename T>
+    bool Convolver<T>::valid() const
+    {
+        return impl != nullptr;
+    }
+
+    template <typename T>
+    std::size_t Convolver<T>::taps() const
+    {
+        return impl ? impl->m : 0;
+    }
+
+    template <typename T>
+    std::size_t Convolver<T>::channels() const
+    {
+        return impl ? impl->nchan : 0;
+    }
+
+    template <typename T>
+    std::size_t Convolver<T>::block_size() const
+    {
+        return impl ? impl->block : 0;
+    }
+
+    template <typename T>
+    std::size_t Convolver<T>::fft_size() const
+    {
+        return impl ? impl->n : 0;
+    }
+
+    template <typename T>
+    std::size_t Convolver<T>::output_ready(std::size_t count) const
+    {
+        return impl ? impl->ready(count) : 0;
+    }
+
+    template <typename T>
+    std::size_t Convolver<T>::push(const T *const *in, std::size_t count, T *const *out)
+    {
+        if (!impl || (count > 0 && (in == nullptr || out == nullptr)))
+        {
+            return 0;
+        }
+        return impl->push(in, count, out);
+    }
+
+    template <typename T>
+    std::size_t Convolver<T>::push(const T *in, std::size_t count, T *out)
+    {
+        if (!impl || impl->nchan != 1)
+        {
+            return 0;
+        }
+        return push(&in, count, &out);
+    }
+
+    template <typename T>
+    std::size_t Convolver<T>::push(const std::vector<T> &in, std::vector<T> &out)
+    {
+        if (!impl || impl->nchan != 1)
+        {
+            return 0;
+        }
+        const std::size_t old_size = out.size();
+        out.resize(old_size + impl->ready(in.size()));
+        const T *src = in.data();
+        T *dst = out.data() + old_size;
+        return impl->push(&src, in.size(), &dst);
+    }
+
+    template <typename T>
+    std::size_t Convolver<T>::push(const std::vector<std::vector<T>> &in, std::vector<std::vector<T>> &out)
+    {
+        if (!impl || in.size() != impl->nchan)
+        {
+            return 0;
+        }
+        const std::size_t count = in[0].size();
+        for (std::size_t c = 1; c < in.size(); ++c)
+        {
+            if (in[c].size() != count)
+            {
+                return 0;
+            }
+        }
+        const std::size_t produced = impl->ready(count);
+        out.resize(impl->nchan);
+        std::vector<const T *> src(impl->nchan);
+        std::vector<T *> dst(impl->nchan);
+        for (std::size_t c = 0; c < impl->nchan; ++c)
+        {
+            const std::size_t old_size = out[c].size();
+            out[c].resize(old_size + produced);
+            src[c] = in[c].data();
+            dst[c] = out[c].data() + old_size;
+        }
+        return impl->push(src.data(), count, dst.data());
+    }
+
+    template <typename T>
+    std::size_t Convolver<T>::flush(T *const *out)
+    {
+        if (!impl || out == nullptr)
+        {
+            return 0;
+        }
+        return impl->flush(out);
+    }
+
+    template <typename T>
+    std::size_t Convolver<T>::flush(T *out)
+    {
+        if (!impl || impl->nchan != 1)
+        {
+            return 0;
+        }
+        return impl->flush(&out);
+    }
+
+    template <typename T>
+    std::size_t Convolver<T>::flush(std::vector<T> &out)
+    {
+        if (!impl || impl->nchan != 1)
+        {
+            return 0;
+        }
+        const std::size_t old_size = out.size();
+        out.resize(old_size + impl->fill + impl->m - 1);
+        T *dst = out.data() + old_size;
+        const std::size_t produced = impl->flush(&dst);
+        out.resize(old_size + produced);
+        return produced;
+    }
+
+    template <typename T>
+    std::size_t Convolver<T>::flush(std::vector<std::vector<T>> &out)
+    {
+        if (!impl)
+        {
+            return 0;
+        }
+        out.resize(impl->nchan);
+        std::vector<std::size_t> old_sizes(impl->nchan);
+        std::vector<T *> dst(impl->nchan);
+        for (std::size_t c = 0; c < impl->nchan; ++c)
+        {
+            old_sizes[c] = out[c].size();
+            out[c].resize(old_sizes[c] + impl->fill + impl->m - 1);
+            dst[c] = out[c].data() + old_sizes[c];
+        }
+        const std::size_t produced = impl->flush(dst.data());
+        for (std::size_t c = 0; c < impl->nchan; ++c)
+        {
+            out[c].resize(old_sizes[c] + produced);
+        }
+        return produced;
+    }
+
+    template <typename T>
+    void Convolver<T>::reset()
+    {
+        if (impl)
+        {
+            impl->reset();
+        }
+    }
+
+    // Explicit instantiations
+    template class Convolver<float>;
+    template class Convolver<double>;
+    template class Convolver<long double>;
+
+} // namespace clapfft
@@ -0,0 +1,556 @@
+#include <clapfft/correlation.hpp>
+#include <fftw3.h>
+#include <clapfft/aligned_buffer.hpp>
+#include <clapfft/complex_ops.hpp>
+#include <clapfft/fft_traits.hpp>
+#include <clapfft/fft_plan_cache.hpp>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace clapfft
+{
+    std::size_t next_fast_size(std::size_t n)
+    {
+        for (std::size_t m = std::max<std::size_t>(n, 1);; ++m)
+        {
+            std::size_t rest = m;
+            const std::size_t radices[] = {2, 3, 5, 7};
+            for (std::size_t r = 0; r < 4; ++r)
+            {
+                while (rest % radices[r] == 0)
+                {
+                    rest /= radices[r];
+                }
+            }
+            if (rest == 1)
+            {
+                return m;
+            }
+        }
+    }
+
+    template <typename T>
+    struct Correlator<T>::Impl
+    {
+        using traits = fft_trait<T>;
+        using complex_type = typename traits::complex_type;
+        using wrapper_type = typename PlanCache<T>::Wrapper;
+        // Running sums for the normalisation; at least double precision.
+        using sum_type = typename std::common_type<T, double>::type;
+
+        // Extents are kept as 3D, with leading axes of 1 for lower ranks.
+        int r;
+        std::size_t nx[3];
+        std::size_t ny[3];
+        std::size_t no[3];
+        std::size_t np[3];
+        std::size_t xsize;
+        std::size_t osize;
+        std::size_t psize;  // real elements of one padded transform
+        std::size_t csize;  // complex elements of its half spectrum
+        std::size_t ipitch; // psize rounded up to keep every batch slot aligned
+        std::size_t opitch; // the same for csize
+        std::size_t min_count; // smallest overlap normalised
+        bool aligned;
+        bool autocorrelation;
+        CorrelationOptions options;
+        AlignedBuffer<std::complex<T>> pattern; // conj(template spectrum) / psize
+        AlignedBuffer<T> real;                  // max_batch x ipitch: padded signals, then results
+        AlignedBuffer<std::complex<T>> spectra; // max_batch x opitch
+        std::shared_ptr<wrapper_type> full_forward;
+        std::shared_ptr<wrapper_type> full_inverse;
+        // Per axis and output index: the circular index holding that lag,
+        // and the overlapping ranges in signal and template coordinates.
+        std::vector<std::size_t> source[3];
+        std::vector<std::size_t> xlo[3], xhi[3], ylo[3], yhi[3];
+        // Summed-area tables of value and value^2, (n + 1) per axis.
+        std::vector<sum_type> xsum, xsq, ysum, ysq;
+
+        std::shared_ptr<wrapper_type> plan(TransformKind kind, std::size_t howmany) const
+        {
+            if (howmany == options.max_batch)
+            {
+                const std::shared_ptr<wrapper_type> &cached = kind == TransformKind::R2C ? full_forward : full_inverse;
+                if (cached)
+                {
+                    return cached;
+                }
+            }
+            int dims[PlanKey::max_rank] = {0};
+            for (int i = 0; i < r; ++i)
+            {
+                dims[i] = static_cast<int>(np[3 - r + i]);
+            }
+            PlanKey key(kind, r, dims, options.flags);
+            key.howmany = static_cast<int>(howmany);
+            key.idist = static_cast<int>(kind == TransformKind::R2C ? ipitch : opitch);
+            key.odist = static_cast<int>(kind == TransformKind::R2C ? opitch : ipitch);
+            key.alignment = aligned ? static_cast<int>(buffer_alignment) : 0;
+            key.normalize();
+            return PlanCache<T>::get(key);
+        }
+
+        // Copies an array of extents n into a padded slot, zeroing the rest.
+        void pack(const T *x, const std::size_t n[3], T *dst) const
+        {
+            for (std::size_t i = 0; i < np[0]; ++i)
+            {
+                for (std::size_t j = 0; j < np[1]; ++j)
+                {
+                    T *row = dst + (i * np[1] + j) * np[2];
+                    std::size_t filled = 0;
+                    if (i < n[0] && j < n[1])
+                    {
+                        std::memcpy(row, x + (i * n[1] + j) * n[2], n[2] * sizeof(T));
+                        filled = n[2];
+                    }
+                    std::fill(row + filled, row + np[2], T(0));
+                }
+            }
+        }
+
+        bool forward(T *in, std::complex<T> *out, std::size_t howmany) const
+        {
+            const std::shared_ptr<wrapper_type> wrapper = plan(TransformKind::R2C, howmany);
+            if (!wrapper || wrapper->plan == nullptr)
+            {
+                return false;
+            }
+            complex_type *freq = reinterpret_cast<complex_type *>(out);
+            wrapper->run_concurrent([&](typename traits::plan_type p)
+                                    { traits::execute_dft_r2c(p, in, freq); });
+            return true;
+        }
+
+        static void build_table(const T *v, const std::size_t n[3], std::vector<sum_type> &sum,
+                                std::vector<sum_type> &sq)
+        {
+            const std::size_t s1 = n[1] + 1, s2 = n[2] + 1;
+            sum.assign((n[0] + 1) * s1 * s2, sum_type(0));
+            sq.assign(sum.size(), sum_type(0));
+            for (std::size_t i = 0; i < n[0]; ++i)
+            {
+                for (std::size_t j = 0; j < n[1]; ++j)
+                {
+                    const T *row = v + (i * n[1] + j) * n[2];
+                    const std::size_t base = ((i + 1) * s1 + j + 1) * s2 + 1;
+                    for (std::size_t k = 0; k < n[2]; ++k)
+                    {
+                        const sum_type value = static_cast<sum_type>(row[k]);
+                        sum[base + k] = value;
+                        sq[base + k] = value * value;
+                    }
+                }
+            }
+            // Prefix sums along each axis in turn.
+            const std::size_t steps[3] = {s1 * s2, s2, 1};
+            const std::size_t extents[3] = {n[0] + 1, s1, s2};
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                const std::size_t step = steps[axis];
+                for (std::size_t idx = 0; idx < sum.size(); ++idx)
+                {
+                    if ((idx / step) % extents[axis] != 0)
+                    {
+                        sum[idx] += sum[idx - step];
+                        sq[idx] += sq[idx - step];
+                    }
+                }
+            }
+        }
+
+        // Sum over lo[a] <= t[a] < hi[a] from a table of extents n.
+        static sum_type box(const std::vector<sum_type> &table, const std::size_t n[3], const std::size_t lo[3],
+                            const std::size_t hi[3])
+        {
+            const std::size_t s1 = n[1] + 1, s2 = n[2] + 1;
+            sum_type total = 0;
+            for (int corner = 0; corner < 8; ++corner)
+            {
+                const std::size_t i = corner & 4 ? lo[0] : hi[0];
+                const std::size_t j = corner & 2 ? lo[1] : hi[1];
+                const std::size_t k = corner & 1 ? lo[2] : hi[2];
+                const sum_type v = table[(i * s1 + j) * s2 + k];
+                const int low_count = ((corner >> 2) & 1) + ((corner >> 1) & 1) + (corner & 1);
+                total += low_count % 2 == 0 ? v : -v;
+            }
+            return total;
+        }
+
+        // Writes the lags of one signal from its circular correlation.
+        void extract(const T *circular, const T *x, T *out)
+        {
+            const std::vector<sum_type> *sx = &xsum, *sxx = &xsq, *sy = &ysum, *syy = &ysq;
+            if (options.normalize)
+            {
+                build_table(x, nx, xsum, xsq);
+                if (autocorrelation)
+                {
+                    sy = &xsum;
+                    syy = &xsq;
+                }
+            }
+            const sum_type tolerance = 64 * static_cast<sum_type>(std::numeric_limits<T>::epsilon());
+            for (std::size_t i = 0; i < no[0]; ++i)
+            {
+                for (std::size_t j = 0; j < no[1]; ++j)
+                {
+                    const T *src = circular + (source[0][i] * np[1] + source[1][j]) * np[2];
+                    T *dst = out + (i * no[1] + j) * no[2];
+                    if (!options.normalize)
+                    {
+                        for (std::size_t k = 0; k < no[2]; ++k)
+                        {
+                            dst[k] = src[source[2][k]];
+                        }
+                        continue;
+                    }
+                    for (std::size_t k = 0; k < no[2]; ++k)
+                    {
+                        const std::size_t xl[3] = {xlo[0][i], xlo[1][j], xlo[2][k]};
+                        const std::size_t xh[3] = {xhi[0][i], xhi[1][j], xhi[2][k]};
+                        const std::size_t yl[3] = {ylo[0][i], ylo[1][j], ylo[2][k]};
+                        const std::size_t yh[3] = {yhi[0][i], yhi[1][j], yhi[2][k]};
+                        const std::size_t count = (xh[0] - xl[0]) * (xh[1] - xl[1]) * (xh[2] - xl[2]);
+                        if (count < min_count)
+                        {
+                            dst[k] = T(0);
+                            continue;
+                        }
+                        const sum_type n = static_cast<sum_type>(count);
+                        const sum_type mx = box(*sx, nx, xl, xh), my = box(*sy, ny, yl, yh);
+                        const sum_type ex = box(*sxx, nx, xl, xh), ey = box(*syy, ny, yl, yh);
+                        const sum_type vx = ex - mx * mx / n, vy = ey - my * my / n;
+                        if (vx <= tolerance * ex || vy <= tolerance * ey)
+                        {
+                            dst[k] = T(0);
+                            continue;
+                        }
+                        const sum_type num = static_cast<sum_type>(src[source[2][k]]) - mx * my / n;
+                        const sum_type coefficient = num / std::sqrt(vx * vy);
+                        dst[k] = static_cast<T>(std::max(sum_type(-1), std::min(sum_type(1), coefficient)));
+                    }
+                }
+            }
+        }
+
+        bool apply(const T *signals, std::size_t batch, T *out)
+        {
+            const T scale = T(1) / static_cast<T>(psize);
+            for (std::size_t done = 0; done < batch;)
+            {
+                const std::size_t count = std::min(options.max_batch, batch - done);
+                for (std::size_t b = 0; b < count; ++b)
+                {
+                    pack(signals + (done + b) * xsize, nx, real.data() + b * ipitch);
+                }
+                const std::shared_ptr<wrapper_type> inverse = plan(TransformKind::C2R, count);
+                if (!inverse || inverse->plan == nullptr || !forward(real.data(), spectra.data(), count))
+                {
+                    return false;
+                }
+                for (std::size_t b = 0; b < count; ++b)
+                {
+                    std::complex<T> *s = spectra.data() + b * opitch;
+                    if (autocorrelation)
+                    {
+                        for (std::size_t i = 0; i < csize; ++i)
+                        {
+                            s[i] = std::complex<T>(std::norm(s[i]) * scale, T(0));
+                        }
+                    }
+                    else
+                    {
+                        ComplexOps::multiply(s, pattern.data(), s, csize);
+                    }
+                }
+                complex_type *freq = reinterpret_cast<complex_type *>(spectra.data());
+                T *result = real.data();
+                inverse->run_concurrent([&](typename traits::plan_type p)
+                                        { traits::execute_dft_c2r(p, freq, result); });
+                for (std::size_t b = 0; b < count; ++b)
+                {
+                    extract(real.data() + b * ipitch, signals + (done + b) * xsize, out + (done + b) * osize);
+                }
+                done += count;
+            }
+            return true;
+        }
+
+        static std::unique_ptr<Impl> create(int rank, const int *signal_dims, const int *template_dims, const T *templ,
+                                            const CorrelationOptions &options)
+        {
+            if (rank < 1 || rank > 3 || signal_dims == nullptr || template_dims == nullptr)
+            {
+                return nullptr;
+            }
+            std::unique_ptr<Impl> state(new Impl());
+            state->r = rank;
+            state->autocorrelation = templ == nullptr;
+            state->options = options;
+            state->options.max_batch = std::max<std::size_t>(1, options.max_batch);
+            const std::size_t limit = static_cast<std::size_t>(std::numeric_limits<int>::max());
+            state->psize = 1;
+            state->xsize = 1;
+            state->osize = 1;
+            std::size_t ysize = 1;
+            for (int a = 0; a < 3; ++a)
+            {
+                const int d = a - (3 - rank);
+                const int x = d < 0 ? 1 : signal_dims[d];
+                const int y = d < 0 ? 1 : template_dims[d];
+                if (x <= 0 || y <= 0)
+                {
+                    return nullptr;
+                }
+                state->nx[a] = static_cast<std::size_t>(x);
+                state->ny[a] = static_cast<std::size_t>(y);
+                state->no[a] = state->nx[a] + state->ny[a] - 1;
+                state->np[a] = next_fast_size(state->no[a]);
+                if (state->np[a] > limit || state->psize > limit / state->np[a])
+                {
+                    return nullptr;
+                }
+                state->psize *= state->np[a];
+                state->xsize *= state->nx[a];
+                state->osize *= state->no[a];
+                ysize *= state->ny[a];
+            }
+            const double smaller = static_cast<double>(std::min(state->xsize, ysize));
+            const double fraction = std::max(0.0, std::min(1.0, options.min_overlap));
+            state->min_count = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(fraction * smaller)));
+            state->csize = state->psize / state->np[2] * (state->np[2] / 2 + 1);
+            state->aligned = buffer_alignment % sizeof(std::complex<T>) == 0;
+            const std::size_t real_line = state->aligned ? buffer_alignment / sizeof(T) : 1;
+            const std::size_t complex_line = state->aligned ? buffer_alignment / sizeof(std::complex<T>) : 1;
+            state->ipitch = (state->psize + real_line - 1) / real_line * real_line;
+            state->opitch = (state->csize + complex_line - 1) / complex_line * complex_line;
+            if (state->ipitch > limit || state->opitch > limit)
+            {
+                return nullptr;
+            }
+
+            for (int a = 0; a < 3; ++a)
+            {
+                const std::ptrdiff_t nxa = static_cast<std::ptrdiff_t>(state->nx[a]);
+                const std::ptrdiff_t nya = static_cast<std::ptrdiff_t>(state->ny[a]);
+                const std::ptrdiff_t npa = static_cast<std::ptrdiff_t>(state->np[a]);
+                for (std::size_t k = 0; k < state->no[a]; ++k)
+                {
+                    const std::ptrdiff_t lag = static_cast<std::ptrdiff_t>(k) - (nya - 1);
+                    state->source[a].push_back(static_cast<std::size_t>((lag + npa) % npa));
+                    state->xlo[a].push_back(static_cast<std::size_t>(std::max<std::ptrdiff_t>(0, lag)));
+                    state->xhi[a].push_back(static_cast<std::size_t>(std::min(nxa, lag + nya)));
+                    state->ylo[a].push_back(static_cast<std::size_t>(std::max<std::ptrdiff_t>(0, -lag)));
+                    state->yhi[a].push_back(static_cast<std::size_t>(std::min(nya, nxa - lag)));
+                }
+            }
+
+            const std::size_t batch = state->options.max_batch;
+            state->real = AlignedBuffer<T>::uninitialized(batch * state->ipitch);
+            state->spectra = AlignedBuffer<std::complex<T>>::uninitialized(batch * state->opitch);
+            state->full_forward = state->plan(TransformKind::R2C, batch);
+            state->full_inverse = state->plan(TransformKind::C2R, batch);
+            if (!state->full_forward || state->full_forward->plan == nullptr || !state->full_inverse ||
+                state->full_inverse->plan == nullptr)
+            {
+                return nullptr;
+            }
+
+            if (templ != nullptr)
+            {
+                Impl &s = *state;
+                s.pack(templ, s.ny, s.real.data());
+                s.pattern = AlignedBuffer<std::complex<T>>::uninitialized(s.opitch);
+                if (!s.forward(s.real.data(), s.pattern.data(), 1))
+                {
+                    return nullptr;
+                }
+                const T scale = T(1) / static_cast<T>(s.psize);
+                for (std::size_t i = 0; i < s.csize; ++i)
+                {
+                    s.pattern[i] = std::conj(s.pattern[i]) * scale;
+                }
+                if (options.normalize)
+                {
+                    build_table(templ, s.ny, s.ysum, s.ysq);
+                }
+            }
+            return state;
+        }
+    };
+
+    template <typename T>
+    Correlator<T>::Correlator(int rank, const int *signal_dims, const int *template_dims, const T *templ,
+                              const CorrelationOptions &options)
+    {
+        if (templ != nullptr)
+        {
+            impl = Impl::create(rank, signal_dims, template_dims, templ, options);
+        }
+    }
+
+    template <typename T>
+    Correlator<T>::Correlator(int rank, const int *dims, const CorrelationOptions &options)
+        : impl(Impl::create(rank, dims, dims, nullptr, options))
+    {
+    }
+
+    template <typename T>
+    Correlator<T>::Correlator() = default;
+
+    template <typename T>
+    Correlator<T>::~Correlator() = default;
+
+    template <typename T>
+    Correlator<T>::Correlator(Correlator &&other) = default;
+
+    template <typename T>
+    Correlator<T> &Correlator<T>::operator=(Correlator &&other) = default;
+
+    template <typename T>
+    bool Correlator<T>::valid() const
+    {
+        return impl != nullptr;
+    }
+
+    template <typename T>
+    int Correlator<T>::rank() const
+    {
+        return impl ? impl->r : 0;
+    }
+
+    template <typename T>
+    std::size_t Correlator<T>::signal_size() const
+    {
+        return impl ? impl->xsize : 0;
+    }
+
+    template <typename T>
+    std::size_t Correlator<T>::output_size() const
+    {
+        return impl ? impl->osize : 0;
+    }
+
+    template <typename T>
+    std::vector<int> Correlator<T>::output_dims() const
+    {
+        std::vector<int> dims;
+        for (int a = impl ? 3 - impl->r : 3; a < 3; ++a)
+        {
+            dims.push_back(static_cast<int>(impl->no[a]));
+        }
+        return dims;
+    }
+
+    template <typename T>
+    std::vector<int> Correlator<T>::fft_dims() const
+    {
+        std::vector<int> dims;
+        for (int a = impl ? 3 - impl->r : 3; a < 3; ++a)
+        {
+            dims.push_back(static_cast<int>(impl->np[a]));
+        }
+        return dims;
+    }
+
+    template <typename T>
+    bool Correlator<T>::apply(const T *signals, std::size_t batch, T *out)
+    {
+        if (!impl || (batch > 0 && (signals == nullptr || out == nullptr)))
+        {
+            return false;
+        }
+        return impl->apply(signals, batch, out);
+    }
+
+    template <typename T>
+    bool correlate(int rank, const int *signal_dims, const T *signal, const int *template_dims, const T *templ,
+                   T *out, const CorrelationOptions &options)
+    {
+        CorrelationOptions single = options;
+        single.max_batch = 1;
+        Correlator<T> correlator(rank, signal_dims, template_dims, templ, single);
+        return correlator.apply(signal, 1, out);
+    }
+
+    template <typename T>
+    bool autocorrelate(int rank, const int *dims, const T *signal, T *out, const CorrelationOptions &options)
+    {
+        CorrelationOptions single = options;
+        single.max_batch = 1;
+        Correlator<T> correlator(rank, dims, single);
+        return correlator.apply(signal, 1, out);
+    }
+
+    template <typename T>
+    std::vector<T> correlate(const std::vector<T> &signal, const std::vector<T> &templ,
+                             const CorrelationOptions &options)
+    {
+        const std::size_t limit = static_cast<std::size_t>(std::numeric_limits<int>::max());
+        if (signal.empty() || templ.empty() || signal.size() > limit || templ.size() > limit)
+        {
+            return std::vector<T>();
+        }
+        const int nx = static_cast<int>(signal.size());
+        const int ny = static_cast<int>(templ.size());
+        std::vector<T> out(signal.size() + templ.size() - 1);
+        if (!correlate(1, &nx, signal.data(), &ny, templ.data(), out.data(), options))
+        {
+            return std::vector<T>();
+        }
+        return out;
+    }
+
+    template <typename T>
+    std::vector<T> autocorrelate(const std::vector<T> &signal, const CorrelationOptions &options)
+    {
+        const std::size_t limit = static_cast<std::size_t>(std::numeric_limits<int>::max());
+        if (signal.empty() || signal.size() > limit)
+        {
+            return std::vector<T>();
+        }
+        const int n = static_cast<int>(signal.size());
+        std::vector<T> out(2 * signal.size() - 1);
+        if (!autocorrelate(1, &n, signal.data(), out.data(), options))
+        {
+            return std::vector<T>();
+        }
+        return out;
+    }
+
+    // Explicit instantiations
+    template class Correlator<float>;
+    template class Correlator<double>;
+    template class Correlator<long double>;
+
+    template bool correlate<float>(int, const int *, const float *, const int *, const float *, float *,
+                                   const CorrelationOptions &);
+    template bool correlate<double>(int, const int *, const double *, const int *, const double *, double *,
+                                    const CorrelationOptions &);
+    template bool correlate<long double>(int, const int *, const long double *, const int *, const long double *,
+                                         long double *, const CorrelationOptions &);
+
+    template bool autocorrelate<float>(int, const int *, const float *, float *, const CorrelationOptions &);
+    template bool autocorrelate<double>(int, const int *, const double *, double *, const CorrelationOptions &);
+    template bool autocorrelate<long double>(int, const int *, const long double *, long double *,
+                                             const CorrelationOptions &);
+
+    template std::vector<float> correlate<float>(const std::vector<float> &, const std::vector<float> &,
+                                                 const CorrelationOptions &);
+    template std::vector<double> correlate<double>(const std::vector<double> &, const std::vector<double> &,
+                                                   const CorrelationOptions &);
+    template std::vector<long double> correlate<long double>(const std::vector<long double> &,
+                                                             const std::vector<long double> &,
+                                                             const CorrelationOptions &);
+
+    template std::vector<float> autocorrelate<float>(const std::vector<float> &, const CorrelationOptions &);
+    template std::vector<double> autocorrelate<double>(const std::vector<double> &, const CorrelationOptions &);
+    template std::vector<long double> autocorrelate<long double>(const std::vector<long double> &,
+                                                                 const CorrelationOptions &);
+
+} // namespace clapfft
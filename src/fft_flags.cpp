@@ -17,4 +17,5 @@ namespace clapfft
     const fft_flags CLAP_FFT_PATIENT = FFTW_PATIENT;
     const fft_flags CLAP_FFT_EXHAUSTIVE = FFTW_EXHAUSTIVE;
     const fft_flags CLAP_FFT_UNALIGNED = FFTW_UNALIGNED;
+    const fft_flags CLAP_FFT_DEFAULT = 1U << 30; // above every FFTW planner bit
 } // namespace clapfft
@@ -183,6 +183,24 @@ namespace clapfft
         fftwf_destroy_plan(plan);
     }
 
+    bool fft_trait<float>::init_threads()
+    {
+#ifdef CLAPFFT_HAVE_FFTW_THREADS
+        return fftwf_init_threads() != 0;
+#else
+        return false;
+#endif
+    }
+
+    void fft_trait<float>::plan_with_nthreads(int nthreads)
+    {
+#ifdef CLAPFFT_HAVE_FFTW_THREADS
+        fftwf_plan_with_nthreads(nthreads);
+#else
+        (void)nthreads;
+#endif
+    }
+
     // Double trait implementations
     fftw_plan fft_trait<double>::plan_dft_1d(int n, fftw_complex *in, fftw_complex *out, int sign, unsigned flags)
     {
@@ -489,6 +507,24 @@ namespace clapfft
         fftw_destroy_plan(plan);
     }
 
+    bool fft_trait<double>::init_threads()
+    {
+#ifdef CLAPFFT_HAVE_FFTW_THREADS
+        return fftw_init_threads() != 0;
+#else
+        return false;
+#endif
+    }
+
+    void fft_trait<double>::plan_with_nthreads(int nthreads)
+    {
+#ifdef CLAPFFT_HAVE_FFTW_THREADS
+        fftw_plan_with_nthreads(nthreads);
+#else
+        (void)nthreads;
+#endif
+    }
+
     // Long double trait implementations
     fftwl_plan fft_trait<long double>::plan_dft_1d(int n, fftwl_complex *in, fftwl_complex *out, int sign, unsigned flags)
     {
@@ -668,4 +704,22 @@ namespace clapfft
         fftwl_destroy_plan(plan);
     }
 
+    bool fft_trait<long double>::init_threads()
+    {
+#ifdef CLAPFFT_HAVE_FFTW_THREADS
+        return fftwl_init_threads() != 0;
+#else
+        return false;
+#endif
+    }
+
+    void fft_trait<long double>::plan_with_nthreads(int nthreads)
+    {
+#ifdef CLAPFFT_HAVE_FFTW_THREADS
+        fftwl_plan_with_nthreads(nthreads);
+#else
+        (void)nthreads;
+#endif
+    }
+
 } // namespace clapfft
\ No newline at end of file
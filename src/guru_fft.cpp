@@ -1,11 +1,10 @@
 #include <clapfft/guru_fft.hpp>
 #include <clapfft/fft_traits.hpp>
+#include <clapfft/fft_plan_cache.hpp>
 #include <mutex>
 
 namespace
 {
-    std::mutex planner_mutex;
-
     bool has_valid_howmany(int howmany_rank, const void *howmany_dims)
     {
         if (howmany_rank < 0)
@@ -34,7 +33,7 @@ namespace clapfft
         }
 
         using traits = fft_trait<double>;
-        std::lock_guard<std::mutex> lock(planner_mutex);
+        std::lock_guard<std::mutex> lock(PlanCache<double>::planner_lock());
         return traits::plan_guru_dft(rank, dims, howmany_rank, howmany_dims, in, out, sign, flags);
     }
 
@@ -50,7 +49,7 @@ namespace clapfft
         }
 
         using traits = fft_trait<double>;
-        std::lock_guard<std::mutex> lock(planner_mutex);
+        std::lock_guard<std::mutex> lock(PlanCache<double>::planner_lock());
         return traits::plan_guru_split_dft(rank, dims, howmany_rank, howmany_dims, ri, ii, ro, io, flags);
     }
 
@@ -66,7 +65,7 @@ namespace clapfft
         }
 
         using traits = fft_trait<double>;
-        std::lock_guard<std::mutex> lock(planner_mutex);
+        std::lock_guard<std::mutex> lock(PlanCache<double>::planner_lock());
         return traits::plan_guru_dft_r2c(rank, dims, howmany_rank, howmany_dims, in, out, flags);
     }
 
@@ -82,7 +81,7 @@ namespace clapfft
         }
 
         using traits = fft_trait<double>;
-        std::lock_guard<std::mutex> lock(planner_mutex);
+        std::lock_guard<std::mutex> lock(PlanCache<double>::planner_lock());
         return traits::plan_guru_split_dft_r2c(rank, dims, howmany_rank, howmany_dims, in, ro, io, flags);
     }
 
@@ -98,7 +97,7 @@ namespace clapfft
         }
 
         using traits = fft_trait<double>;
-        std::lock_guard<std::mutex> lock(planner_mutex);
+        std::lock_guard<std::mutex> lock(PlanCache<double>::planner_lock());
         return traits::plan_guru_dft_c2r(rank, dims, howmany_rank, howmany_dims, in, out, flags);
     }
 
@@ -114,7 +113,7 @@ namespace clapfft
         }
 
         using traits = fft_trait<double>;
-        std::lock_guard<std::mutex> lock(planner_mutex);
+        std::lock_guard<std::mutex> lock(PlanCache<double>::planner_lock());
         return traits::plan_guru_split_dft_c2r(rank, dims, howmany_rank, howmany_dims, ri, ii, out, flags);
     }
 
@@ -132,7 +131,7 @@ namespace clapfft
         }
 
         using traits = fft_trait<double>;
-        std::lock_guard<std::mutex> lock(planner_mutex);
+        std::lock_guard<std::mutex> lock(PlanCache<double>::planner_lock());
         return traits::plan_guru_r2r(rank, dims, howmany_rank, howmany_dims, in, out, kind, flags);
     }
 
@@ -148,7 +147,7 @@ namespace clapfft
         }
 
         using traits = fft_trait<double>;
-        std::lock_guard<std::mutex> lock(planner_mutex);
+        std::lock_guard<std::mutex> lock(PlanCache<double>::planner_lock());
         return traits::plan_guru64_dft(rank, dims, howmany_rank, howmany_dims, in, out, sign, flags);
     }
 }
@@ -0,0 +1,229 @@
+#include <clapfft/nested_copy.hpp>
+#include <clapfft/thread_pool.hpp>
+#include <algorithm>
+#include <complex>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace clapfft
+{
+    const std::size_t NestedCopy::parallel_copy_bytes;
+    const std::size_t NestedCopy::streaming_copy_bytes;
+
+    namespace
+    {
+        // memcpy whose 16-byte-aligned middle part is written with
+        // non-temporal stores; pair with finish_streaming().
+        void stream_copy(void *dst, const void *src, std::size_t bytes)
+        {
+#if defined(__SSE2__)
+            unsigned char *d = static_cast<unsigned char *>(dst);
+            const unsigned char *s = static_cast<const unsigned char *>(src);
+            const std::size_t head = (16 - reinterpret_cast<std::uintptr_t>(d) % 16) % 16;
+            if (bytes < head + 64)
+            {
+                std::memcpy(d, s, bytes);
+                return;
+            }
+            std::memcpy(d, s, head);
+            d += head;
+            s += head;
+            bytes -= head;
+            for (; bytes >= 64; bytes -= 64, d += 64, s += 64)
+            {
+                const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s));
+                const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + 16));
+                const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + 32));
+                const __m128i e = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + 48));
+                _mm_stream_si128(reinterpret_cast<__m128i *>(d), a);
+                _mm_stream_si128(reinterpret_cast<__m128i *>(d + 16), b);
+                _mm_stream_si128(reinterpret_cast<__m128i *>(d + 32), c);
+                _mm_stream_si128(reinterpret_cast<__m128i *>(d + 48), e);
+            }
+            std::memcpy(d, s, bytes);
+#else
+            std::memcpy(dst, src, bytes);
+#endif
+        }
+
+        // Orders this thread's non-temporal stores before whatever follows.
+        void finish_streaming()
+        {
+#if defined(__SSE2__)
+            _mm_sfence();
+#endif
+        }
+
+        template <typename V>
+        void copy_row(V *dst, const V *src, std::size_t available, std::size_t n, bool stream)
+        {
+            const std::size_t count = available < n ? available : n;
+            if (count > 0)
+            {
+                if (stream)
+                {
+                    stream_copy(dst, src, count * sizeof(V));
+                }
+                else
+                {
+                    std::memcpy(static_cast<void *>(dst), src, count * sizeof(V));
+                }
+            }
+            std::fill(dst + count, dst + n, V());
+        }
+
+        template <typename V>
+        void fill_row(std::vector<V> &row, const V *src, std::size_t n, bool stream)
+        {
+            if (row.size() != n)
+            {
+                row.assign(src, src + n);
+            }
+            else
+            {
+                copy_row(row.data(), src, n, n, stream);
+            }
+        }
+
+        // Calls fn(first, last) on [0, n0), split into at most `threads`
+        // slices on the global pool when the copy is big enough.
+        template <typename Fn>
+        void partition(std::size_t n0, std::size_t bytes, int threads, bool stream, Fn fn)
+        {
+            const auto run = [&](std::size_t first, std::size_t last)
+            {
+                fn(first, last);
+                if (stream)
+                {
+                    finish_streaming();
+                }
+            };
+            if (threads <= 1 || n0 < 2 || bytes < NestedCopy::parallel_copy_bytes)
+            {
+                run(0, n0);
+                return;
+            }
+            const std::size_t parts = std::min(n0, static_cast<std::size_t>(threads));
+            const std::size_t step = (n0 + parts - 1) / parts;
+            ThreadPool::global().parallel_for(parts, [&](std::size_t p, unsigned)
+                                              {
+                const std::size_t first = p * step;
+                const std::size_t last = std::min(n0, first + step);
+                if (first < last)
+                {
+                    run(first, last);
+                } },
+                                              1);
+        }
+    }
+
+    template <typename V>
+    void NestedCopy::flatten(const std::vector<std::vector<V>> &in, std::size_t n1, V *out, int threads)
+    {
+        const std::size_t n0 = in.size();
+        const std::size_t bytes = n0 * n1 * sizeof(V);
+        const bool stream = bytes >= streaming_copy_bytes;
+        partition(n0, bytes, threads, stream, [&](std::size_t first, std::size_t last)
+                  {
+            for (std::size_t i = first; i < last; ++i)
+            {
+                copy_row(out + i * n1, in[i].data(), in[i].size(), n1, stream);
+            } });
+    }
+
+    template <typename V>
+    void NestedCopy::flatten(const std::vector<std::vector<std::vector<V>>> &in, std::size_t n1, std::size_t n2,
+                             V *out, int threads)
+    {
+        const std::size_t n0 = in.size();
+        const std::size_t bytes = n0 * n1 * n2 * sizeof(V);
+        const bool stream = bytes >= streaming_copy_bytes;
+        partition(n0, bytes, threads, stream, [&](std::size_t first, std::size_t last)
+                  {
+            for (std::size_t i = first; i < last; ++i)
+            {
+                const std::vector<std::vector<V>> &plane = in[i];
+                for (std::size_t j = 0; j < n1; ++j)
+                {
+                    V *dst = out + (i * n1 + j) * n2;
+                    if (j < plane.size())
+                    {
+                        copy_row(dst, plane[j].data(), plane[j].size(), n2, stream);
+                    }
+                    else
+                    {
+                        std::fill(dst, dst + n2, V());
+                    }
+                }
+            } });
+    }
+
+    template <typename V>
+    void NestedCopy::unflatten(const V *in, std::size_t n0, std::size_t n1, std::vector<std::vector<V>> &out,
+                               int threads)
+    {
+        out.resize(n0);
+        const std::size_t bytes = n0 * n1 * sizeof(V);
+        const bool stream = bytes >= streaming_copy_bytes;
+        partition(n0, bytes, threads, stream, [&](std::size_t first, std::size_t last)
+                  {
+            for (std::size_t i = first; i < last; ++i)
+            {
+                fill_row(out[i], in + i * n1, n1, stream);
+            } });
+    }
+
+    template <typename V>
+    void NestedCopy::unflatten(const V *in, std::size_t n0, std::size_t n1, std::size_t n2,
+                               std::vector<std::vector<std::vector<V>>> &out, int threads)
+    {
+        out.resize(n0);
+        const std::size_t bytes = n0 * n1 * n2 * sizeof(V);
+        const bool stream = bytes >= streaming_copy_bytes;
+        partition(n0, bytes, threads, stream, [&](std::size_t first, std::size_t last)
+                  {
+            for (std::size_t i = first; i < last; ++i)
+            {
+                std::vector<std::vector<V>> &plane = out[i];
+                plane.resize(n1);
+                for (std::size_t j = 0; j < n1; ++j)
+                {
+                    fill_row(plane[j], in + (i * n1 + j) * n2, n2, stream);
+                }
+            } });
+    }
+
+    // Explicit instantiations
+    template void NestedCopy::flatten<float>(const std::vector<std::vector<float>> &, std::size_t, float *, int);
+    template void NestedCopy::flatten<double>(const std::vector<std::vector<double>> &, std::size_t, double *, int);
+    template void NestedCopy::flatten<long double>(const std::vector<std::vector<long double>> &, std::size_t, long double *, int);
+    template void NestedCopy::flatten<std::complex<float>>(const std::vector<std::vector<std::complex<float>>> &, std::size_t, std::complex<float> *, int);
+    template void NestedCopy::flatten<std::complex<double>>(const std::vector<std::vector<std::complex<double>>> &, std::size_t, std::complex<double> *, int);
+    template void NestedCopy::flatten<std::complex<long double>>(const std::vector<std::vector<std::complex<long double>>> &, std::size_t, std::complex<long double> *, int);
+
+    template void NestedCopy::flatten<float>(const std::vector<std::vector<std::vector<float>>> &, std::size_t, std::size_t, float *, int);
+    template void NestedCopy::flatten<double>(const std::vector<std::vector<std::vector<double>>> &, std::size_t, std::size_t, double *, int);
+    template void NestedCopy::flatten<long double>(const std::vector<std::vector<std::vector<long double>>> &, std::size_t, std::size_t, long double *, int);
+    template void NestedCopy::flatten<std::complex<float>>(const std::vector<std::vector<std::vector<std::complex<float>>>> &, std::size_t, std::size_t, std::complex<float> *, int);
+    template void NestedCopy::flatten<std::complex<double>>(const std::vector<std::vector<std::vector<std::complex<double>>>> &, std::size_t, std::size_t, std::complex<double> *, int);
+    template void NestedCopy::flatten<std::complex<long double>>(const std::vector<std::vector<std::vector<std::complex<long double>>>> &, std::size_t, std::size_t, std::complex<long double> *, int);
+
+    template void NestedCopy::unflatten<float>(const float *, std::size_t, std::size_t, std::vector<std::vector<float>> &, int);
+    template void NestedCopy::unflatten<double>(const double *, std::size_t, std::size_t, std::vector<std::vector<double>> &, int);
+    template void NestedCopy::unflatten<long double>(const long double *, std::size_t, std::size_t, std::vector<std::vector<long double>> &, int);
+    template void NestedCopy::unflatten<std::complex<float>>(const std::complex<float> *, std::size_t, std::size_t, std::vector<std::vector<std::complex<float>>> &, int);
+    template void NestedCopy::unflatten<std::complex<double>>(const std::complex<double> *, std::size_t, std::size_t, std::vector<std::vector<std::complex<double>>> &, int);
+    template void NestedCopy::unflatten<std::complex<long double>>(const std::complex<long double> *, std::size_t, std::size_t, std::vector<std::vector<std::complex<long double>>> &, int);
+
+    template void NestedCopy::unflatten<float>(const float *, std::size_t, std::size_t, std::size_t, std::vector<std::vector<std::vector<float>>> &, int);
+    template void NestedCopy::unflatten<double>(const double *, std::size_t, std::size_t, std::size_t, std::vector<std::vector<std::vector<double>>> &, int);
+    template void NestedCopy::unflatten<long double>(const long double *, std::size_t, std::size_t, std::size_t, std::vector<std::vector<std::vector<long double>>> &, int);
+    template void NestedCopy::unflatten<std::complex<float>>(const std::complex<float> *, std::size_t, std::size_t, std::size_t, std::vector<std::vector<std::vector<std::complex<float>>>> &, int);
+    template void NestedCopy::unflatten<std::complex<double>>(const std::complex<double> *, std::size_t, std::size_t, std::size_t, std::vector<std::vector<std::vector<std::complex<double>>>> &, int);
+    template void NestedCopy::unflatten<std::complex<long double>>(const std::complex<long double> *, std::size_t, std::size_t, std::size_t, std::vector<std::vector<std::vector<std::complex<long double>>>> &, int);
+
+} // namespace clapfft
@@ -0,0 +1,581 @@
+#include <clapfft/nufft.hpp>
+#include <fftw3.h>
+#include <clapfft/aligned_buffer.hpp>
+#include <clapfft/correlation.hpp>
+#include <clapfft/fft_traits.hpp>
+#include <clapfft/fft_plan_cache.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <type_traits>
+
+namespace clapfft
+{
+    namespace
+    {
+        const std::size_t max_width = 16;
+
+        // Grid cells per sorting bin along each internal axis; the last,
+        // contiguous one gets the longest side.
+        const std::size_t bin_cells[3] = {4, 4, 16};
+
+        // Gauss-Legendre nodes and weights on [-1, 1], by Newton's method
+        // on P_q from the usual cosine guesses.
+        void gauss_legendre(std::size_t q, std::vector<double> &nodes, std::vector<double> &weights)
+        {
+            nodes.assign(q, 0.0);
+            weights.assign(q, 0.0);
+            const double pi = 3.14159265358979323846;
+            for (std::size_t i = 0; i < (q + 1) / 2; ++i)
+            {
+                double z = std::cos(pi * (static_cast<double>(i) + 0.75) / (static_cast<double>(q) + 0.5));
+                double derivative = 1.0;
+                for (int iter = 0; iter < 100; ++iter)
+                {
+                    double p0 = 1.0, p1 = 0.0;
+                    for (std::size_t k = 1; k <= q; ++k)
+                    {
+                        const double p2 = p1;
+                        p1 = p0;
+                        p0 = ((2.0 * k - 1.0) * z * p1 - (k - 1.0) * p2) / static_cast<double>(k);
+                    }
+                    derivative = static_cast<double>(q) * (z * p0 - p1) / (z * z - 1.0);
+                    const double step = p0 / derivative;
+                    z -= step;
+                    if (std::fabs(step) < 1e-16)
+                    {
+                        break;
+                    }
+                }
+                nodes[i] = -z;
+                nodes[q - 1 - i] = z;
+                weights[i] = 2.0 / ((1.0 - z * z) * derivative * derivative);
+                weights[q - 1 - i] = weights[i];
+            }
+        }
+
+        std::size_t wrap(std::ptrdiff_t i, std::size_t n)
+        {
+            const std::ptrdiff_t m = static_cast<std::ptrdiff_t>(n);
+            const std::ptrdiff_t r = i % m;
+            return static_cast<std::size_t>(r < 0 ? r + m : r);
+        }
+    }
+
+    template <typename T>
+    struct Nufft<T>::Impl
+    {
+        using traits = fft_trait<T>;
+        using complex_type = typename traits::complex_type;
+        using wrapper_type = typename PlanCache<T>::Wrapper;
+
+        NufftType type;
+        std::size_t dims;
+        std::vector<std::size_t> modes;
+        std::vector<std::size_t> grid_dims;
+        // Internally always three axes; the ones in front of a rank 1 or 2
+        // problem have one mode, one grid cell and a width 1 kernel.
+        std::size_t N[3];
+        std::size_t n[3];
+        std::size_t w[3];
+        std::size_t width;
+        T beta;
+        std::vector<T> correction[3]; // N[d]: 1 / kernel transform at k_d
+        AlignedBuffer<std::complex<T>> grid;
+        std::shared_ptr<wrapper_type> plan;
+        ThreadPool *pool;
+        std::size_t max_subproblem;
+        std::mutex grid_mutex;
+
+        // Points, in bin order: grid coordinates in [0, n[d]) and the
+        // caller's index.
+        std::size_t count;
+        std::vector<T> coord[3];
+        std::vector<std::size_t> order;
+
+        // The w[d] kernel values around grid coordinate g, starting at
+        // grid index first.
+        void kernel(std::size_t d, T g, std::ptrdiff_t &first, T *values) const
+        {
+            if (w[d] == 1)
+            {
+                first = 0;
+                values[0] = T(1);
+                return;
+            }
+            const T half = static_cast<T>(width) / 2;
+            first = static_cast<std::ptrdiff_t>(std::ceil(g - half));
+            for (std::size_t t = 0; t < width; ++t)
+            {
+                const T z = (static_cast<T>(first + static_cast<std::ptrdiff_t>(t)) - g) / half;
+                const T s = T(1) - z * z;
+                values[t] = s > T(0) ? std::exp(beta * (std::sqrt(s) - T(1))) : T(0);
+            }
+        }
+
+        std::size_t chunk_size() const
+        {
+            const std::size_t tasks = 2 * static_cast<std::size_t>(pool->size());
+            return std::max<std::size_t>(1, std::min(max_subproblem, (count + tasks - 1) / tasks));
+        }
+
+        void spread(const std::complex<T> *in)
+        {
+            std::fill(grid.data(), grid.data() + n[0] * n[1] * n[2], std::complex<T>());
+            const std::size_t chunk = chunk_size();
+            const std::size_t tasks = (count + chunk - 1) / chunk;
+            pool->parallel_for(tasks, [&](std::size_t task, unsigned)
+                               {
+                const std::size_t begin = task * chunk, end = std::min(count, begin + chunk);
+                // Bounding box of the task's kernel supports.
+                std::ptrdiff_t lo[3], hi[3];
+                for (std::size_t d = 0; d < 3; ++d)
+                {
+                    lo[d] = std::numeric_limits<std::ptrdiff_t>::max();
+                    hi[d] = std::numeric_limits<std::ptrdiff_t>::min();
+                    for (std::size_t p = begin; p < end; ++p)
+                    {
+                        const std::ptrdiff_t first =
+                            w[d] == 1 ? 0 : static_cast<std::ptrdiff_t>(std::ceil(coord[d][p] - static_cast<T>(width) / 2));
+                        lo[d] = std::min(lo[d], first);
+                        hi[d] = std::max(hi[d], first);
+                    }
+                }
+                std::size_t ext[3];
+                for (std::size_t d = 0; d < 3; ++d)
+                {
+                    ext[d] = static_cast<std::size_t>(hi[d] - lo[d]) + w[d];
+                }
+                AlignedBuffer<std::complex<T>> local(ext[0] * ext[1] * ext[2]);
+
+                T k0[max_width], k1[max_width], k2[max_width];
+                for (std::size_t p = begin; p < end; ++p)
+                {
+                    std::ptrdiff_t f0, f1, f2;
+                    kernel(0, coord[0][p], f0, k0);
+                    kernel(1, coord[1][p], f1, k1);
+                    kernel(2, coord[2][p], f2, k2);
+                    const std::complex<T> c = in[order[p]];
+                    for (std::size_t a = 0; a < w[0]; ++a)
+                    {
+                        const std::size_t plane = static_cast<std::size_t>(f0 - lo[0]) + a;
+                        for (std::size_t b = 0; b < w[1]; ++b)
+                        {
+                            const std::complex<T> cab = c * (k0[a] * k1[b]);
+                            std::complex<T> *row = local.data() +
+                                                   (plane * ext[1] + static_cast<std::size_t>(f1 - lo[1]) + b) * ext[2] +
+                                                   static_cast<std::size_t>(f2 - lo[2]);
+                            for (std::size_t t = 0; t < w[2]; ++t)
+                            {
+                                row[t] += cab * k2[t];
+                            }
+                        }
+                    }
+                }
+
+                // Periodic wrap while adding the subgrid to the grid.
+                std::vector<std::size_t> index[3];
+                for (std::size_t d = 0; d < 3; ++d)
+                {
+                    index[d].resize(ext[d]);
+                    for (std::size_t i = 0; i < ext[d]; ++i)
+                    {
+                        index[d][i] = wrap(lo[d] + static_cast<std::ptrdiff_t>(i), n[d]);
+                    }
+                }
+                std::lock_guard<std::mutex> lock(grid_mutex);
+                const std::complex<T> *src = local.data();
+                for (std::size_t a = 0; a < ext[0]; ++a)
+                {
+                    for (std::size_t b = 0; b < ext[1]; ++b)
+                    {
+                        std::complex<T> *row = grid.data() + (index[0][a] * n[1] + index[1][b]) * n[2];
+                        for (std::size_t t = 0; t < ext[2]; ++t)
+                        {
+                            row[index[2][t]] += *src++;
+                        }
+                    }
+                } }, 1);
+        }
+
+        void interpolate(std::complex<T> *out)
+        {
+            const std::size_t chunk = chunk_size();
+            const std::size_t tasks = (count + chunk - 1) / chunk;
+            pool->parallel_for(tasks, [&](std::size_t task, unsigned)
+                               {
+                const std::size_t begin = task * chunk, end = std::min(count, begin + chunk);
+                T k0[max_width], k1[max_width], k2[max_width];
+                std::size_t i0[max_width], i1[max_width], i2[max_width];
+                for (std::size_t p = begin; p < end; ++p)
+                {
+                    std::ptrdiff_t f0, f1, f2;
+                    kernel(0, coord[0][p], f0, k0);
+                    kernel(1, coord[1][p], f1, k1);
+                    kernel(2, coord[2][p], f2, k2);
+                    for (std::size_t t = 0; t < w[0]; ++t)
+                    {
+                        i0[t] = wrap(f0 + static_cast<std::ptrdiff_t>(t), n[0]);
+                    }
+                    for (std::size_t t = 0; t < w[1]; ++t)
+                    {
+                        i1[t] = wrap(f1 + static_cast<std::ptrdiff_t>(t), n[1]);
+                    }
+                    for (std::size_t t = 0; t < w[2]; ++t)
+                    {
+                        i2[t] = wrap(f2 + static_cast<std::ptrdiff_t>(t), n[2]);
+                    }
+                    std::complex<T> sum;
+                    for (std::size_t a = 0; a < w[0]; ++a)
+                    {
+                        for (std::size_t b = 0; b < w[1]; ++b)
+                        {
+                            const std::complex<T> *row = grid.data() + (i0[a] * n[1] + i1[b]) * n[2];
+                            std::complex<T> partial;
+                            for (std::size_t t = 0; t < w[2]; ++t)
+                            {
+                                partial += row[i2[t]] * k2[t];
+                            }
+                            sum += partial * (k0[a] * k1[b]);
+                        }
+                    }
+                    out[order[p]] = sum;
+                } }, 1);
+        }
+
+        void transform()
+        {
+            complex_type *data = reinterpret_cast<complex_type *>(grid.data());
+            plan->run_concurrent([&](typename traits::plan_type p)
+                                 { traits::execute_dft(p, data, data); });
+        }
+
+        // Visits every mode with its grid cell and correction: f(mode
+        // offset, grid offset, factor).
+        template <typename Fn>
+        void for_each_mode(Fn f) const
+        {
+            std::size_t mode = 0;
+            for (std::size_t a = 0; a < N[0]; ++a)
+            {
+                const std::size_t ga = wrap(static_cast<std::ptrdiff_t>(a) - static_cast<std::ptrdiff_t>(N[0] / 2), n[0]);
+                for (std::size_t b = 0; b < N[1]; ++b)
+                {
+                    const std::size_t gb = wrap(static_cast<std::ptrdiff_t>(b) - static_cast<std::ptrdiff_t>(N[1] / 2), n[1]);
+                    const T scale = correction[0][a] * correction[1][b];
+                    const std::size_t row = (ga * n[1] + gb) * n[2];
+                    for (std::size_t c = 0; c < N[2]; ++c, ++mode)
+                    {
+                        const std::size_t gc = wrap(static_cast<std::ptrdiff_t>(c) - static_cast<std::ptrdiff_t>(N[2] / 2), n[2]);
+                        f(mode, row + gc, scale * correction[2][c]);
+                    }
+                }
+            }
+        }
+
+        void execute(const std::complex<T> *in, std::complex<T> *out)
+        {
+            if (type == NufftType::Type1)
+            {
+                spread(in);
+                transform();
+                for_each_mode([&](std::size_t mode, std::size_t cell, T factor)
+                              { out[mode] = grid[cell] * factor; });
+            }
+            else
+            {
+                std::fill(grid.data(), grid.data() + n[0] * n[1] * n[2], std::complex<T>());
+                for_each_mode([&](std::size_t mode, std::size_t cell, T factor)
+                              { grid[cell] = in[mode] * factor; });
+                transform();
+                interpolate(out);
+            }
+        }
+    };
+
+    template <typename T>
+    Nufft<T>::Nufft(NufftType type, std::size_t rank, const std::size_t *modes, int sign,
+                    const NufftOptions &options, ThreadPool &pool)
+    {
+        if (rank < 1 || rank > 3 || modes == nullptr || (sign != 1 && sign != -1))
+        {
+            return;
+        }
+        if (!(options.upsampling > 1.0) || !(options.upsampling <= 16.0) || !(options.tolerance > 0.0) ||
+            options.max_subproblem == 0)
+        {
+            return;
+        }
+
+        // Kernel width and shape for the tolerance, as in FINUFFT.
+        const double finest = std::is_same<T, float>::value ? 1e-6 : 1e-14;
+        const double tolerance = std::max(options.tolerance, finest);
+        const double sigma = options.upsampling;
+        const double pi = 3.14159265358979323846;
+        const double exact_width = sigma == 2.0 ? std::ceil(-std::log10(tolerance / 10.0))
+                                          : std::ceil(-std::log(tolerance) / (pi * std::sqrt(1.0 - 1.0 / sigma)));
+        const std::size_t width =
+            static_cast<std::size_t>(std::min(static_cast<double>(max_width), std::max(2.0, exact_width)));
+        const double beta = 0.97 * pi * (1.0 - 1.0 / (2.0 * sigma)) * static_cast<double>(width);
+
+        std::unique_ptr<Impl> state(new Impl());
+        state->type = type;
+        state->dims = rank;
+        state->width = width;
+        state->beta = static_cast<T>(beta);
+        state->pool = &pool;
+        state->max_subproblem = options.max_subproblem;
+        state->count = 0;
+        const std::size_t limit = static_cast<std::size_t>(std::numeric_limits<int>::max());
+        std::size_t total = 1;
+        for (std::size_t d = 0; d < 3; ++d)
+        {
+            const std::size_t axis = d + rank;
+            if (axis < 3)
+            {
+                state->N[d] = 1;
+                state->n[d] = 1;
+                state->w[d] = 1;
+                continue;
+            }
+            const std::size_t Nd = modes[axis - 3];
+            if (Nd == 0 || Nd > limit / 16)
+            {
+                return;
+            }
+            // An even, FFTW-friendly size holding sigma N points and the
+            // kernel twice over.
+            std::size_t nd = std::max(static_cast<std::size_t>(std::ceil(sigma * static_cast<double>(Nd))), 2 * width);
+            nd = next_fast_size(nd);
+            while (nd % 2 != 0)
+            {
+                nd = next_fast_size(nd + 1);
+            }
+            if (nd > limit / total)
+            {
+                return;
+            }
+            total *= nd;
+            state->N[d] = Nd;
+            state->n[d] = nd;
+            state->w[d] = width;
+            state->modes.push_back(Nd);
+            state->grid_dims.push_back(nd);
+        }
+
+        // 1 / phi_hat(k) per axis, with phi_hat(k) = (w / 2) int_{-1}^{1}
+        // phi(z) cos(pi k w z / n) dz.
+        std::vector<double> nodes, weights;
+        gauss_legendre(2 * width + 16, nodes, weights);
+        std::vector<double> phi(nodes.size());
+        for (std::size_t i = 0; i < nodes.size(); ++i)
+        {
+            phi[i] = std::exp(beta * (std::sqrt(1.0 - nodes[i] * nodes[i]) - 1.0));
+        }
+        for (std::size_t d = 0; d < 3; ++d)
+        {
+            state->correction[d].assign(state->N[d], T(1));
+            if (state->w[d] == 1)
+            {
+                continue;
+            }
+            for (std::size_t a = 0; a < state->N[d]; ++a)
+            {
+                const double k = static_cast<double>(a) - static_cast<double>(state->N[d] / 2);
+                const double omega = pi * k * static_cast<double>(width) / static_cast<double>(state->n[d]);
+                double sum = 0.0;
+                for (std::size_t i = 0; i < nodes.size(); ++i)
+                {
+                    sum += weights[i] * phi[i] * std::cos(omega * nodes[i]);
+                }
+                state->correction[d][a] = static_cast<T>(2.0 / (static_cast<double>(width) * sum));
+            }
+        }
+
+        state->grid = AlignedBuffer<std::complex<T>>(total);
+        int fft_dims[PlanKey::max_rank] = {0};
+        for (std::size_t d = 0; d < rank; ++d)
+        {
+            fft_dims[d] = static_cast<int>(state->grid_dims[d]);
+        }
+        PlanKey key(TransformKind::C2C, static_cast<int>(rank), fft_dims, options.flags);
+        key.sign = sign > 0 ? FFTW_BACKWARD : FFTW_FORWARD;
+        key.in_place = true;
+        key.alignment = buffer_alignment % sizeof(std::complex<T>) == 0 ? static_cast<int>(buffer_alignment) : 0;
+        key.normalize();
+        state->plan = PlanCache<T>::get(key);
+        if (!state->plan || state->plan->plan == nullptr)
+        {
+            return;
+        }
+        impl = std::move(state);
+    }
+
+    template <typename T>
+    Nufft<T>::Nufft() = default;
+
+    template <typename T>
+    Nufft<T>::~Nufft() = default;
+
+    template <typename T>
+    Nufft<T>::Nufft(Nufft &&other) = default;
+
+    template <typename T>
+    Nufft<T> &Nufft<T>::operator=(Nufft &&other) = default;
+
+    template <typename T>
+    bool Nufft<T>::valid() const
+    {
+        return impl != nullptr;
+    }
+
+    template <typename T>
+    NufftType Nufft<T>::type() const
+    {
+        return impl ? impl->type : NufftType::Type1;
+    }
+
+    template <typename T>
+    std::size_t Nufft<T>::rank() const
+    {
+        return impl ? impl->dims : 0;
+    }
+
+    template <typename T>
+    const std::vector<std::size_t> &Nufft<T>::modes() const
+    {
+        static const std::vector<std::size_t> none;
+        return impl ? impl->modes : none;
+    }
+
+    template <typename T>
+    const std::vector<std::size_t> &Nufft<T>::grid_dims() const
+    {
+        static const std::vector<std::size_t> none;
+        return impl ? impl->grid_dims : none;
+    }
+
+    template <typename T>
+    std::size_t Nufft<T>::kernel_width() const
+    {
+        return impl ? impl->width : 0;
+    }
+
+    template <typename T>
+    std::size_t Nufft<T>::point_count() const
+    {
+        return impl ? impl->count : 0;
+    }
+
+    template <typename T>
+    bool Nufft<T>::set_points(std::size_t count, const T *x, const T *y, const T *z)
+    {
+        if (!impl)
+        {
+            return false;
+        }
+        Impl &s = *impl;
+        // Caller's arrays per internal axis; the leading ones are unused
+        // below rank 3.
+        const T *axes[3] = {nullptr, nullptr, nullptr};
+        const T *given[3] = {x, y, z};
+        for (std::size_t d = 0; d < s.dims; ++d)
+        {
+            if (count > 0 && given[d] == nullptr)
+            {
+                return false;
+            }
+            axes[3 - s.dims + d] = given[d];
+        }
+
+        const long double two_pi = 6.283185307179586476925286766559L;
+        std::size_t nbins[3], total_bins = 1;
+        for (std::size_t d = 0; d < 3; ++d)
+        {
+            nbins[d] = (s.n[d] + bin_cells[d] - 1) / bin_cells[d];
+            total_bins *= nbins[d];
+        }
+        std::vector<T> raw[3];
+        std::vector<std::size_t> bin(count);
+        for (std::size_t d = 0; d < 3; ++d)
+        {
+            raw[d].assign(count, T(0));
+            if (axes[d] == nullptr)
+            {
+                continue;
+            }
+            const long double scale = static_cast<long double>(s.n[d]) / two_pi;
+            for (std::size_t j = 0; j < count; ++j)
+            {
+                const long double v = static_cast<long double>(axes[d][j]);
+                if (!std::isfinite(v))
+                {
+                    return false;
+                }
+                long double g = (v - two_pi * std::floor(v / two_pi)) * scale;
+                if (g >= static_cast<long double>(s.n[d]) || g < 0)
+                {
+                    g = 0;
+                }
+                raw[d][j] = static_cast<T>(g);
+                if (raw[d][j] >= static_cast<T>(s.n[d]))
+                {
+                    raw[d][j] = T(0);
+                }
+            }
+        }
+        for (std::size_t j = 0; j < count; ++j)
+        {
+            std::size_t key = 0;
+            for (std::size_t d = 0; d < 3; ++d)
+            {
+                key = key * nbins[d] + static_cast<std::size_t>(raw[d][j]) / bin_cells[d];
+            }
+            bin[j] = key;
+        }
+
+        // Counting sort by bin.
+        std::vector<std::size_t> start(total_bins + 1, 0);
+        for (std::size_t j = 0; j < count; ++j)
+        {
+            ++start[bin[j] + 1];
+        }
+        for (std::size_t b = 0; b < total_bins; ++b)
+        {
+            start[b + 1] += start[b];
+        }
+        s.order.assign(count, 0);
+        for (std::size_t j = 0; j < count; ++j)
+        {
+            s.order[start[bin[j]]++] = j;
+        }
+        for (std::size_t d = 0; d < 3; ++d)
+        {
+            s.coord[d].resize(count);
+            for (std::size_t p = 0; p < count; ++p)
+            {
+                s.coord[d][p] = raw[d][s.order[p]];
+            }
+        }
+        s.count = count;
+        return true;
+    }
+
+    template <typename T>
+    bool Nufft<T>::execute(const std::complex<T> *in, std::complex<T> *out)
+    {
+        if (!impl || in == nullptr || out == nullptr)
+        {
+            return false;
+        }
+        impl->execute(in, out);
+        return true;
+    }
+
+    // Explicit instantiations
+    template class Nufft<float>;
+    template class Nufft<double>;
+    template class Nufft<long double>;
+
+} // namespace clapfft
@@ -0,0 +1,266 @@
+#include <clapfft/numa.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace clapfft
+{
+    namespace
+    {
+        // get_mempolicy flags from <numaif.h>, which ships with libnuma.
+        const unsigned long mpol_f_node = 1UL << 0;
+        const unsigned long mpol_f_addr = 1UL << 1;
+
+        bool parse_number(const std::string &text, std::size_t &pos, int &value)
+        {
+            const std::size_t start = pos;
+            long v = 0;
+            while (pos < text.size() && std::isdigit(static_cast<unsigned char>(text[pos])))
+            {
+                v = v * 10 + (text[pos] - '0');
+                if (v > 1L << 20)
+                {
+                    return false;
+                }
+                ++pos;
+            }
+            value = static_cast<int>(v);
+            return pos > start;
+        }
+
+        std::vector<int> allowed_cpus()
+        {
+            std::vector<int> cpus;
+#ifdef __linux__
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            if (sched_getaffinity(0, sizeof(set), &set) == 0)
+            {
+                for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+                {
+                    if (CPU_ISSET(cpu, &set))
+                    {
+                        cpus.push_back(cpu);
+                    }
+                }
+            }
+#endif
+            if (cpus.empty())
+            {
+                const unsigned count = std::max(1U, std::thread::hardware_concurrency());
+                for (unsigned cpu = 0; cpu < count; ++cpu)
+                {
+                    cpus.push_back(static_cast<int>(cpu));
+                }
+            }
+            return cpus;
+        }
+    }
+
+    NumaTopology NumaTopology::load_system()
+    {
+        const NumaTopology found = discover();
+        const std::vector<int> allowed = allowed_cpus();
+        NumaTopology topology;
+        for (std::size_t i = 0; i < found.node_list.size(); ++i)
+        {
+            NumaNode node;
+            node.id = found.node_list[i].id;
+            const std::vector<int> &cpus = found.node_list[i].cpus;
+            std::set_intersection(cpus.begin(), cpus.end(), allowed.begin(), allowed.end(),
+                                  std::back_inserter(node.cpus));
+            if (!node.cpus.empty())
+            {
+                topology.node_list.push_back(node);
+            }
+        }
+        if (topology.node_list.empty())
+        {
+            NumaNode node;
+            node.id = 0;
+            node.cpus = allowed;
+            topology.node_list.push_back(node);
+        }
+        return topology;
+    }
+
+    const NumaTopology &NumaTopology::system()
+    {
+        static const NumaTopology topology = load_system();
+        return topology;
+    }
+
+    NumaTopology NumaTopology::discover(const std::string &node_dir)
+    {
+        NumaTopology topology;
+#ifdef __linux__
+        DIR *dir = opendir(node_dir.c_str());
+        if (dir != nullptr)
+        {
+            while (dirent *entry = readdir(dir))
+            {
+                const std::string name = entry->d_name;
+                std::size_t pos = 4;
+                int id = 0;
+                if (name.compare(0, 4, "node") != 0 || !parse_number(name, pos, id) || pos != name.size())
+                {
+                    continue;
+                }
+                std::ifstream file((node_dir + "/" + name + "/cpulist").c_str());
+                std::string list;
+                NumaNode node;
+                node.id = id;
+                if (file && std::getline(file, list) && parse_cpu_list(list, node.cpus))
+                {
+                    topology.node_list.push_back(node);
+                }
+            }
+            closedir(dir);
+        }
+#else
+        (void)node_dir;
+#endif
+        if (topology.node_list.empty())
+        {
+            NumaNode node;
+            node.id = 0;
+            node.cpus = allowed_cpus();
+            topology.node_list.push_back(node);
+        }
+        std::sort(topology.node_list.begin(), topology.node_list.end(),
+                  [](const NumaNode &a, const NumaNode &b)
+                  { return a.id < b.id; });
+        return topology;
+    }
+
+    const std::vector<NumaNode> &NumaTopology::nodes() const
+    {
+        return node_list;
+    }
+
+    std::size_t NumaTopology::node_count() const
+    {
+        return node_list.size();
+    }
+
+    int NumaTopology::node_of_cpu(int cpu) const
+    {
+        for (std::size_t i = 0; i < node_list.size(); ++i)
+        {
+            if (std::binary_search(node_list[i].cpus.begin(), node_list[i].cpus.end(), cpu))
+            {
+                return node_list[i].id;
+            }
+        }
+        return -1;
+    }
+
+    bool NumaTopology::parse_cpu_list(const std::string &list, std::vector<int> &cpus)
+    {
+        std::vector<int> parsed;
+        std::size_t pos = 0;
+        std::size_t end = list.size();
+        while (end > 0 && std::isspace(static_cast<unsigned char>(list[end - 1])))
+        {
+            --end;
+        }
+        const std::string text = list.substr(0, end);
+        while (pos < text.size())
+        {
+            int first = 0;
+            if (!parse_number(text, pos, first))
+            {
+                return false;
+            }
+            int last = first;
+            if (pos < text.size() && text[pos] == '-')
+            {
+                ++pos;
+                if (!parse_number(text, pos, last) || last < first)
+                {
+                    return false;
+                }
+            }
+            for (int cpu = first; cpu <= last; ++cpu)
+            {
+                parsed.push_back(cpu);
+            }
+            if (pos < text.size())
+            {
+                if (text[pos] != ',' || pos + 1 == text.size())
+                {
+                    return false;
+                }
+                ++pos;
+            }
+        }
+        std::sort(parsed.begin(), parsed.end());
+        parsed.erase(std::unique(parsed.begin(), parsed.end()), parsed.end());
+        cpus.swap(parsed);
+        return true;
+    }
+
+    int NumaTopology::node_of_address(const void *address)
+    {
+#if defined(__linux__) && defined(SYS_get_mempolicy)
+        if (address == nullptr)
+        {
+            return -1;
+        }
+        int node = -1;
+        if (syscall(SYS_get_mempolicy, &node, nullptr, 0UL, const_cast<void *>(address), mpol_f_node | mpol_f_addr) == 0)
+        {
+            return node;
+        }
+#else
+        (void)address;
+        (void)mpol_f_node;
+        (void)mpol_f_addr;
+#endif
+        return -1;
+    }
+
+    int NumaTopology::current_node()
+    {
+#ifdef __linux__
+        const int cpu = sched_getcpu();
+        if (cpu >= 0)
+        {
+            return system().node_of_cpu(cpu);
+        }
+#endif
+        return -1;
+    }
+
+    bool NumaTopology::pin_current_thread(const std::vector<int> &cpus)
+    {
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        bool any = false;
+        for (std::size_t i = 0; i < cpus.size(); ++i)
+        {
+            if (cpus[i] >= 0 && cpus[i] < CPU_SETSIZE)
+            {
+                CPU_SET(cpus[i], &set);
+                any = true;
+            }
+        }
+        return any && pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+        (void)cpus;
+        return false;
+#endif
+    }
+} // namespace clapfft
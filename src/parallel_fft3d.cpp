@@ -0,0 +1,278 @@
+#include <clapfft/parallel_fft3d.hpp>
+#include <fftw3.h>
+#include <clapfft/fft_traits.hpp>
+#include <clapfft/fft_plan_cache.hpp>
+#include <clapfft/numa.hpp>
+#include <new>
+
+namespace clapfft
+{
+    namespace
+    {
+        // Complex values per tile edge of the transpose; a tile of long
+        // double values (32 KiB) still fits in L1 on current cores.
+        const int transpose_block = 32;
+
+        // Row batches per worker in step 3, so stealing can even out load.
+        const int row_chunks_per_worker = 4;
+    }
+
+    template <typename T>
+    struct ParallelFFT3D<T>::Impl
+    {
+        using traits = fft_trait<T>;
+        using complex_type = typename traits::complex_type;
+        using WrapperPtr = std::shared_ptr<typename PlanCache<T>::Wrapper>;
+
+        int n0;
+        int n1;
+        int n2;
+        int sign;
+        fft_flags flags;
+        ThreadPool &pool;
+
+        WrapperPtr slab_plan;          // n1 x n2, out-of-place
+        WrapperPtr slab_plan_in_place; // fetched on first in-place call
+        WrapperPtr row_plan;           // row_chunk pencils of n0 points
+        WrapperPtr tail_plan;          // the remaining rows, if any
+        std::size_t row_chunk;
+        std::size_t row_tail;
+
+        struct ReleaseStorage
+        {
+            void operator()(std::complex<T> *p) const { ::operator delete(static_cast<void *>(p)); }
+        };
+        std::unique_ptr<std::complex<T>, ReleaseStorage> transposed; // allocated on first execute
+        std::vector<int> chunk_nodes;                                // node of each row chunk, pinned pools only
+
+        Impl(int a, int b, int c, int s, ThreadPool &p, fft_flags f)
+            : n0(a), n1(b), n2(c), sign(s), flags(f), pool(p), row_chunk(0), row_tail(0)
+        {
+        }
+
+        std::size_t plane() const
+        {
+            return static_cast<std::size_t>(n1) * static_cast<std::size_t>(n2);
+        }
+
+        WrapperPtr get_slab_plan(bool in_place) const
+        {
+            const int dims[2] = {n1, n2};
+            PlanKey key(TransformKind::C2C, 2, dims, flags);
+            key.sign = sign;
+            key.in_place = in_place;
+            key.normalize();
+            return PlanCache<T>::get(key);
+        }
+
+        // `rows` pencils read as contiguous rows of the transposed volume and
+        // written back with stride n1 * n2, i.e. into the original layout.
+        WrapperPtr get_row_plan(std::size_t rows) const
+        {
+            PlanKey key(TransformKind::C2C, 1, &n0, flags);
+            key.sign = sign;
+            key.howmany = static_cast<int>(rows);
+            key.istride = 1;
+            key.idist = n0;
+            key.ostride = static_cast<int>(plane());
+            key.odist = 1;
+            key.normalize();
+            return PlanCache<T>::get(key);
+        }
+
+        bool plan()
+        {
+            slab_plan = get_slab_plan(false);
+            if (!slab_plan || slab_plan->plan == nullptr)
+            {
+                return false;
+            }
+            if (n0 == 1)
+            {
+                return true;
+            }
+            const std::size_t rows = plane();
+            std::size_t chunks = static_cast<std::size_t>(pool.size()) * row_chunks_per_worker;
+            row_chunk = (rows + chunks - 1) / chunks;
+            row_tail = rows % row_chunk;
+            row_plan = get_row_plan(row_chunk);
+            if (!row_plan || row_plan->plan == nullptr)
+            {
+                return false;
+            }
+            if (row_tail > 0)
+            {
+                tail_plan = get_row_plan(row_tail);
+                if (!tail_plan || tail_plan->plan == nullptr)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        void transform_slabs(const std::complex<T> *in, std::complex<T> *out, const WrapperPtr &wrapper)
+        {
+            const std::size_t stride = plane();
+            pool.parallel_for(static_cast<std::size_t>(n0), [&](std::size_t i, unsigned)
+                              {
+                complex_type *src = reinterpret_cast<complex_type *>(const_cast<std::complex<T> *>(in + i * stride));
+                complex_type *dst = reinterpret_cast<complex_type *>(out + i * stride);
+                wrapper->run_concurrent([&](typename traits::plan_type p)
+                                        { traits::execute_dft(p, src, dst); }); },
+                              1);
+        }
+
+        // dst[j][i] = src[i][j] for src of n0 rows by n1 * n2 columns.
+        void transpose(const std::complex<T> *src, std::complex<T> *dst)
+        {
+            const std::size_t rows = static_cast<std::size_t>(n0);
+            const std::size_t cols = plane();
+            const std::size_t block = transpose_block;
+            const std::size_t tile_rows = (rows + block - 1) / block;
+            const std::size_t tile_cols = (cols + block - 1) / block;
+            pool.parallel_for(tile_rows * tile_cols, [&](std::size_t tile, unsigned)
+                              {
+                const std::size_t r0 = (tile / tile_cols) * block;
+                const std::size_t c0 = (tile % tile_cols) * block;
+                const std::size_t r1 = r0 + block < rows ? r0 + block : rows;
+                const std::size_t c1 = c0 + block < cols ? c0 + block : cols;
+                for (std::size_t r = r0; r < r1; ++r)
+                {
+                    const std::complex<T> *row = src + r * cols;
+                    for (std::size_t c = c0; c < c1; ++c)
+                    {
+                        dst[c * rows + r] = row[c];
+                    }
+                } });
+        }
+
+        std::size_t row_tasks() const
+        {
+            return plane() / row_chunk + (row_tail > 0 ? 1 : 0);
+        }
+
+        // The transpose buffer is left uninitialised by the allocation and
+        // then constructed chunk by chunk on the workers, so each row chunk
+        // is first touched, and thus placed, on a worker's NUMA node. On a
+        // pinned pool step 3 later sends every chunk back to that node.
+        void allocate_transposed()
+        {
+            const std::size_t total = static_cast<std::size_t>(n0) * plane();
+            transposed.reset(static_cast<std::complex<T> *>(::operator new(total * sizeof(std::complex<T>))));
+            std::complex<T> *base = transposed.get();
+            const std::size_t chunk = row_chunk * static_cast<std::size_t>(n0);
+            const std::size_t tasks = row_tasks();
+            pool.parallel_for(tasks, [&](std::size_t t, unsigned)
+                              {
+                const std::size_t end = (t + 1) * chunk < total ? (t + 1) * chunk : total;
+                for (std::size_t i = t * chunk; i < end; ++i)
+                {
+                    new (base + i) std::complex<T>();
+                } },
+                              1);
+            if (pool.pinned_nodes() > 1)
+            {
+                chunk_nodes.resize(tasks);
+                for (std::size_t t = 0; t < tasks; ++t)
+                {
+                    chunk_nodes[t] = NumaTopology::node_of_address(base + t * chunk);
+                }
+            }
+        }
+
+        void transform_rows(std::complex<T> *out)
+        {
+            const std::size_t full = plane() / row_chunk;
+            const ThreadPool::Task task = [&](std::size_t t, unsigned)
+            {
+                const std::size_t first = t * row_chunk;
+                const WrapperPtr &wrapper = t < full ? row_plan : tail_plan;
+                complex_type *src = reinterpret_cast<complex_type *>(transposed.get() + first * static_cast<std::size_t>(n0));
+                complex_type *dst = reinterpret_cast<complex_type *>(out + first);
+                wrapper->run_concurrent([&](typename traits::plan_type p)
+                                        { traits::execute_dft(p, src, dst); });
+            };
+            if (!chunk_nodes.empty())
+            {
+                pool.parallel_for_by_node(row_tasks(), task, chunk_nodes);
+            }
+            else
+            {
+                pool.parallel_for(row_tasks(), task, 1);
+            }
+        }
+    };
+
+    template <typename T>
+    ParallelFFT3D<T>::ParallelFFT3D(int n0, int n1, int n2, int sign, ThreadPool &pool, fft_flags flags)
+        : impl(new Impl(n0, n1, n2, sign, pool, flags))
+    {
+        if (n0 <= 0 || n1 <= 0 || n2 <= 0 || !impl->plan())
+        {
+            impl.reset();
+        }
+    }
+
+    template <typename T>
+    ParallelFFT3D<T>::~ParallelFFT3D() = default;
+
+    template <typename T>
+    bool ParallelFFT3D<T>::valid() const
+    {
+        return impl != nullptr;
+    }
+
+    template <typename T>
+    bool ParallelFFT3D<T>::execute(const std::complex<T> *in, std::complex<T> *out)
+    {
+        if (!impl || in == nullptr || out == nullptr)
+        {
+            return false;
+        }
+        Impl &d = *impl;
+        const bool in_place = static_cast<const void *>(in) == static_cast<const void *>(out);
+        if (in_place && !d.slab_plan_in_place)
+        {
+            d.slab_plan_in_place = d.get_slab_plan(true);
+        }
+        const typename Impl::WrapperPtr &slabs = in_place ? d.slab_plan_in_place : d.slab_plan;
+        if (!slabs || slabs->plan == nullptr)
+        {
+            return false;
+        }
+
+        d.transform_slabs(in, out, slabs);
+        if (d.n0 == 1)
+        {
+            return true;
+        }
+        if (!d.transposed)
+        {
+            d.allocate_transposed();
+        }
+        d.transpose(out, d.transposed.get());
+        d.transform_rows(out);
+        return true;
+    }
+
+    template <typename T>
+    bool ParallelFFT3D<T>::execute(const std::vector<std::complex<T>> &input, std::vector<std::complex<T>> &output)
+    {
+        if (!impl || input.size() != static_cast<std::size_t>(impl->n0) * impl->plane())
+        {
+            return false;
+        }
+        if (&input != &output)
+        {
+            output.resize(input.size());
+        }
+        return execute(input.data(), output.data());
+    }
+
+    // Explicit instantiations
+    template class ParallelFFT3D<float>;
+    template class ParallelFFT3D<double>;
+    template class ParallelFFT3D<long double>;
+
+} // namespace clapfft
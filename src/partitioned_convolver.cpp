@@ -0,0 +1,414 @@
+#include <clapfft/partitioned_convolver.hpp>
+#include <fftw3.h>
+#include <clapfft/aligned_buffer.hpp>
+#include <clapfft/complex_ops.hpp>
+#include <clapfft/fft_traits.hpp>
+#include <clapfft/fft_plan_cache.hpp>
+#include <algorithm>
+#include <complex>
+#include <cstring>
+#include <limits>
+
+namespace clapfft
+{
+    template <typename T>
+    struct PartitionedConvolver<T>::Impl
+    {
+        using traits = fft_trait<T>;
+        using complex_type = typename traits::complex_type;
+        using wrapper_type = typename PlanCache<T>::Wrapper;
+
+        std::size_t m;      // taps
+        std::size_t b;      // block size
+        std::size_t n;      // FFT size, 2 * b
+        std::size_t bins;   // b + 1
+        std::size_t stride; // bins rounded up so every spectrum starts aligned
+        std::size_t parts;
+        std::size_t nchan;
+        std::size_t fill;   // new samples buffered in the current block
+        std::size_t head;   // delay-line slot of the newest spectrum
+        bool started;       // something was pushed since the last reset
+        AlignedBuffer<std::complex<T>> kernel; // parts x stride, scaled by 1 / n
+        AlignedBuffer<std::complex<T>> delay;  // nchan x parts x stride
+        AlignedBuffer<std::complex<T>> acc;    // nchan x stride
+        AlignedBuffer<T> input;                // nchan x n: previous block, then new samples
+        AlignedBuffer<T> previous;             // nchan x b
+        AlignedBuffer<T> output;               // nchan x n
+        std::shared_ptr<wrapper_type> forward;
+        std::shared_ptr<wrapper_type> inverse;
+
+        static std::shared_ptr<wrapper_type> plan(TransformKind kind, std::size_t size, std::size_t howmany,
+                                                  std::size_t idist, std::size_t odist, bool aligned, fft_flags flags)
+        {
+            const int dims = static_cast<int>(size);
+            PlanKey key(kind, 1, &dims, flags);
+            key.howmany = static_cast<int>(howmany);
+            key.idist = static_cast<int>(idist);
+            key.odist = static_cast<int>(odist);
+            key.alignment = aligned ? static_cast<int>(buffer_alignment) : 0;
+            key.normalize();
+            return PlanCache<T>::get(key);
+        }
+
+        void run_block()
+        {
+            for (std::size_t c = 0; c < nchan; ++c)
+            {
+                T *row = input.data() + c * n;
+                T *prev = previous.data() + c * b;
+                std::memcpy(row, prev, b * sizeof(T));
+                std::memcpy(prev, row + b, b * sizeof(T));
+            }
+            head = head + 1 == parts ? 0 : head + 1;
+
+            T *in = input.data();
+            complex_type *slot = reinterpret_cast<complex_type *>(delay.data() + head * stride);
+            forward->run_concurrent([&](typename traits::plan_type p)
+                                    { traits::execute_dft_r2c(p, in, slot); });
+
+            for (std::size_t c = 0; c < nchan; ++c)
+            {
+                std::complex<T> *sum = acc.data() + c * stride;
+                const std::complex<T> *line = delay.data() + c * parts * stride;
+                ComplexOps::multiply(kernel.data(), line + head * stride, sum, bins);
+                for (std::size_t p = 1; p < parts; ++p)
+                {
+                    const std::size_t age = head >= p ? head - p : head + parts - p;
+                    ComplexOps::multiply_add(kernel.data() + p * stride, line + age * stride, sum, bins);
+                }
+            }
+
+            complex_type *freq = reinterpret_cast<complex_type *>(acc.data());
+            T *out = output.data();
+            inverse->run_concurrent([&](typename traits::plan_type p)
+                                    { traits::execute_dft_c2r(p, freq, out); });
+            fill = 0;
+        }
+
+        void emit(T *const *out, std::size_t offset, std::size_t count) const
+        {
+            for (std::size_t c = 0; c < nchan; ++c)
+            {
+                std::memcpy(out[c] + offset, output.data() + c * n + b, count * sizeof(T));
+            }
+        }
+
+        std::size_t ready(std::size_t count) const
+        {
+            return (fill + count) / b * b;
+        }
+
+        std::size_t push(const T *const *in, std::size_t count, T *const *out)
+        {
+            std::size_t consumed = 0;
+            std::size_t produced = 0;
+            started = started || count > 0;
+            while (consumed < count)
+            {
+                const std::size_t take = std::min(b - fill, count - consumed);
+                for (std::size_t c = 0; c < nchan; ++c)
+                {
+                    std::memcpy(input.data() + c * n + b + fill, in[c] + consumed, take * sizeof(T));
+                }
+                fill += take;
+                consumed += take;
+                if (fill == b)
+                {
+                    run_block();
+                    emit(out, produced, b);
+                    produced += b;
+                }
+            }
+            return produced;
+        }
+
+        std::size_t flush(T *const *out)
+        {
+            if (!started)
+            {
+                return 0;
+            }
+            const std::size_t owed = fill + m - 1;
+            std::size_t produced = 0;
+            while (produced < owed)
+            {
+                for (std::size_t c = 0; c < nchan; ++c)
+                {
+                    T *row = input.data() + c * n + b;
+                    std::fill(row + fill, row + b, T(0));
+                }
+                run_block();
+                const std::size_t count = std::min(b, owed - produced);
+                emit(out, produced, count);
+                produced += count;
+            }
+            reset();
+            return owed;
+        }
+
+        void reset()
+        {
+            std::fill(delay.data(), delay.data() + nchan * parts * stride, std::complex<T>());
+            std::fill(previous.data(), previous.data() + nchan * b, T(0));
+            fill = 0;
+            head = 0;
+            started = false;
+        }
+    };
+
+    template <typename T>
+    PartitionedConvolver<T>::PartitionedConvolver(const std::vector<T> &kernel, std::size_t channels,
+                                                  std::size_t block_size, fft_flags flags)
+    {
+        const std::size_t m = kernel.size();
+        if (m == 0 || channels == 0 || block_size == 0)
+        {
+            return;
+        }
+        const std::size_t b = block_size;
+        const std::size_t parts = (m + b - 1) / b;
+        const std::size_t bins = b + 1;
+        const bool aligned = buffer_alignment % sizeof(std::complex<T>) == 0;
+        const std::size_t line = aligned ? buffer_alignment / sizeof(std::complex<T>) : 1;
+        const std::size_t stride = (bins + line - 1) / line * line;
+        const std::size_t limit = static_cast<std::size_t>(std::numeric_limits<int>::max());
+        if (b > limit / 2 || parts > limit / stride || channels > limit / (parts * stride))
+        {
+            return;
+        }
+
+        std::unique_ptr<Impl> state(new Impl());
+        state->m = m;
+        state->b = b;
+        state->n = 2 * b;
+        state->bins = bins;
+        state->stride = stride;
+        state->parts = parts;
+        state->nchan = channels;
+        state->kernel = AlignedBuffer<std::complex<T>>(parts * stride);
+        state->delay = AlignedBuffer<std::complex<T>>(channels * parts * stride);
+        state->acc = AlignedBuffer<std::complex<T>>(channels * stride);
+        state->input = AlignedBuffer<T>(channels * state->n);
+        state->previous = AlignedBuffer<T>(channels * b);
+        state->output = AlignedBuffer<T>(channels * state->n);
+        state->fill = 0;
+        state->head = 0;
+        state->started = false;
+
+        state->forward = Impl::plan(TransformKind::R2C, state->n, channels, state->n, parts * stride, aligned, flags);
+        state->inverse = Impl::plan(TransformKind::C2R, state->n, channels, stride, state->n, aligned, flags);
+        const std::shared_ptr<typename Impl::wrapper_type> pieces =
+            Impl::plan(TransformKind::R2C, state->n, parts, state->n, stride, aligned, flags);
+        if (!state->forward || state->forward->plan == nullptr || !state->inverse ||
+            state->inverse->plan == nullptr || !pieces || pieces->plan == nullptr)
+        {
+            return;
+        }
+
+        // All partition spectra in one batch, with the c2r normalisation
+        // folded in.
+        AlignedBuffer<T> padded(parts * state->n);
+        for (std::size_t p = 0; p < parts; ++p)
+        {
+            const std::size_t first = p * b;
+            const std::size_t count = std::min(b, m - first);
+            std::copy(kernel.begin() + static_cast<std::ptrdiff_t>(first),
+                      kernel.begin() + static_cast<std::ptrdiff_t>(first + count), padded.data() + p * state->n);
+        }
+        T *src = padded.data();
+        typename Impl::complex_type *dst = reinterpret_cast<typename Impl::complex_type *>(state->kernel.data());
+        pieces->run_concurrent([&](typename Impl::traits::plan_type p)
+                               { Impl::traits::execute_dft_r2c(p, src, dst); });
+        const T scale = T(1) / static_cast<T>(state->n);
+        for (std::size_t i = 0; i < parts * stride; ++i)
+        {
+            state->kernel[i] *= scale;
+        }
+        impl = std::move(state);
+    }
+
+    template <typename T>
+    PartitionedConvolver<T>::PartitionedConvolver() = default;
+
+    template <typename T>
+    PartitionedConvolver<T>::~PartitionedConvolver() = default;
+
+    template <typename T>
+    PartitionedConvolver<T>::PartitionedConvolver(PartitionedConvolver &&other) = default;
+
+    template <typename T>
+    PartitionedConvolver<T> &PartitionedConvolver<T>::operator=(PartitionedConvolver &&other) = default;
+
+    template <typename T>
+    bool PartitionedConvolver<T>::valid() const
+    {
+        return impl != nullptr;
+    }
+
+    template <typename T>
+    std::size_t PartitionedConvolver<T>::taps() const
+    {
+        return impl ? impl->m : 0;
+    }
+
+    template <typename T>
+    std::size_t PartitionedConvolver<T>::channels() const
+    {
+        return impl ? impl->nchan : 0;
+    }
+
+    template <typename T>
+    std::size_t PartitionedConvolver<T>::block_size() const
+    {
+        return impl ? impl->b : 0;
+    }
+
+    template <typename T>
+    std::size_t PartitionedConvolver<T>::partitions() const
+    {
+        return impl ? impl->parts : 0;
+    }
+
+    template <typename T>
+    std::size_t PartitionedConvolver<T>::output_ready(std::size_t count) const
+    {
+        return impl ? impl->ready(count) : 0;
+    }
+
+    template <typename T>
+    std::size_t PartitionedConvolver<T>::push(const T *const *in, std::size_t count, T *const *out)
+    {
+        if (!impl || (count > 0 && (in == nullptr || out == nullptr)))
+        {
+            return 0;
+        }
+        return impl->push(in, count, out);
+    }
+
+    template <typename T>
+    std::size_t PartitionedConvolver<T>::push(const T *in, std::size_t count, T *out)
+    {
+        if (!impl || impl->nchan != 1)
+        {
+            return 0;
+        }
+        return push(&in, count, &out);
+    }
+
+    template <typename T>
+    std::size_t PartitionedConvolver<T>::push(const std::vector<T> &in, std::vector<T> &out)
+    {
+        if (!impl || impl->nchan != 1)
+        {
+            return 0;
+        }
+        const std::size_t old_size = out.size();
+        out.resize(old_size + impl->ready(in.size()));
+        const T *src = in.data();
+        T *dst = out.data() + old_size;
+        return impl->push(&src, in.size(), &dst);
+    }
+
+    template <typename T>
+    std::size_t PartitionedConvolver<T>::push(const std::vector<std::vector<T>> &in, std::vector<std::vector<T>> &out)
+    {
+        if (!impl || in.size() != impl->nchan)
+        {
+            return 0;
+        }
+        const std::size_t count = in[0].size();
+        for (std::size_t c = 1; c < in.size(); ++c)
+        {
+            if (in[c].size() != count)
+            {
+                return 0;
+            }
+        }
+        const std::size_t produced = impl->ready(count);
+        out.resize(impl->nchan);
+        std::vector<const T *> src(impl->nchan);
+        std::vector<T *> dst(impl->nchan);
+        for (std::size_t c = 0; c < impl->nchan; ++c)
+        {
+            const std::size_t old_size = out[c].size();
+            out[c].resize(old_size + produced);
+            src[c] = in[c].data();
+            dst[c] = out[c].data() + old_size;
+        }
+        return impl->push(src.data(), count, dst.data());
+    }
+
+    template <typename T>
+    std::size_t PartitionedConvolver<T>::flush(T *const *out)
+    {
+        if (!impl || out == nullptr)
+        {
+            return 0;
+        }
+        return impl->flush(out);
+    }
+
+    template <typename T>
+    std::size_t PartitionedConvolver<T>::flush(T *out)
+    {
+        if (!impl || impl->nchan != 1)
+        {
+            return 0;
+        }
+        return impl->flush(&out);
+    }
+
+    template <typename T>
+    std::size_t PartitionedConvolver<T>::flush(std::vector<T> &out)
+    {
+        if (!impl || impl->nchan != 1)
+        {
+            return 0;
+        }
+        const std::size_t old_size = out.size();
+        out.resize(old_size + impl->fill + impl->m - 1);
+        T *dst = out.data() + old_size;
+        const std::size_t produced = impl->flush(&dst);
+        out.resize(old_size + produced);
+        return produced;
+    }
+
+    template <typename T>
+    std::size_t PartitionedConvolver<T>::flush(std::vector<std::vector<T>> &out)
+    {
+        if (!impl)
+        {
+            return 0;
+        }
+        out.resize(impl->nchan);
+        std::vector<std::size_t> old_sizes(impl->nchan);
+        std::vector<T *> dst(impl->nchan);
+        for (std::size_t c = 0; c < impl->nchan; ++c)
+        {
+            old_sizes[c] = out[c].size();
+            out[c].resize(old_sizes[c] + impl->fill + impl->m - 1);
+            dst[c] = out[c].data() + old_sizes[c];
+        }
+        const std::size_t produced = impl->flush(dst.data());
+        for (std::size_t c = 0; c < impl->nchan; ++c)
+        {
+            out[c].resize(old_sizes[c] + produced);
+        }
+        return produced;
+    }
+
+    template <typename T>
+    void PartitionedConvolver<T>::reset()
+    {
+        if (impl)
+        {
+            impl->reset();
+        }
+    }
+
+    // Explicit instantiations
+    template class PartitionedConvolver<float>;
+    template class PartitionedConvolver<double>;
+    template class PartitionedConvolver<long double>;
+
+} // namespace clapfft
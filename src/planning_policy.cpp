@@ -0,0 +1,270 @@
+#include <clapfft/planning_policy.hpp>
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+
+namespace clapfft
+{
+    namespace
+    {
+        const int precision_count = 3;
+        const int kind_count = 4;
+
+        template <typename T>
+        struct precision_index;
+
+        template <>
+        struct precision_index<float>
+        {
+            static const int value = 0;
+        };
+
+        template <>
+        struct precision_index<double>
+        {
+            static const int value = 1;
+        };
+
+        template <>
+        struct precision_index<long double>
+        {
+            static const int value = 2;
+        };
+
+        std::atomic<unsigned> table[precision_count][kind_count];
+        std::once_flag init_once;
+
+        void fill(int precision, int kind, fft_flags flags)
+        {
+            for (int p = 0; p < precision_count; ++p)
+            {
+                if (precision >= 0 && p != precision)
+                    continue;
+                for (int k = 0; k < kind_count; ++k)
+                {
+                    if (kind >= 0 && k != kind)
+                        continue;
+                    table[p][k].store(flags, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        std::string trim(const std::string &s)
+        {
+            std::size_t b = 0;
+            std::size_t e = s.size();
+            while (b < e && std::isspace(static_cast<unsigned char>(s[b])))
+                ++b;
+            while (e > b && std::isspace(static_cast<unsigned char>(s[e - 1])))
+                --e;
+            return s.substr(b, e - b);
+        }
+
+        std::string lower(std::string s)
+        {
+            for (std::size_t i = 0; i < s.size(); ++i)
+            {
+                s[i] = static_cast<char>(std::tolower(static_cast<unsigned char>(s[i])));
+            }
+            return s;
+        }
+
+        bool parse_precision(const std::string &s, int &precision)
+        {
+            if (s == "*")
+                precision = -1;
+            else if (s == "float")
+                precision = 0;
+            else if (s == "double")
+                precision = 1;
+            else if (s == "long_double" || s == "long double" || s == "longdouble")
+                precision = 2;
+            else
+                return false;
+            return true;
+        }
+
+        bool parse_kind(const std::string &s, int &kind)
+        {
+            if (s.empty() || s == "*")
+                kind = -1;
+            else if (s == "c2c")
+                kind = static_cast<int>(TransformKind::C2C);
+            else if (s == "c2r")
+                kind = static_cast<int>(TransformKind::C2R);
+            else if (s == "r2c")
+                kind = static_cast<int>(TransformKind::R2C);
+            else if (s == "r2r")
+                kind = static_cast<int>(TransformKind::R2R);
+            else
+                return false;
+            return true;
+        }
+
+        bool parse_flags(const std::string &s, fft_flags &flags)
+        {
+            if (s == "estimate")
+                flags = CLAP_FFT_ESTIMATE;
+            else if (s == "measure")
+                flags = CLAP_FFT_MEASURE;
+            else if (s == "patient")
+                flags = CLAP_FFT_PATIENT;
+            else if (s == "exhaustive")
+                flags = CLAP_FFT_EXHAUSTIVE;
+            else
+                return false;
+            return true;
+        }
+
+        // One "precision[.kind]=policy" entry.
+        bool apply_entry(const std::string &entry)
+        {
+            const std::size_t eq = entry.find('=');
+            if (eq == std::string::npos)
+                return false;
+            const std::string target = lower(trim(entry.substr(0, eq)));
+            const std::string policy = lower(trim(entry.substr(eq + 1)));
+
+            const std::size_t dot = target.find('.');
+            const std::string precision_name = trim(target.substr(0, dot));
+            const std::string kind_name = dot == std::string::npos ? std::string() : trim(target.substr(dot + 1));
+
+            int precision = 0;
+            int kind = 0;
+            fft_flags flags = 0;
+            if (!parse_precision(precision_name, precision) || !parse_kind(kind_name, kind) || !parse_flags(policy, flags))
+                return false;
+            fill(precision, kind, flags);
+            return true;
+        }
+
+        bool apply_spec(const std::string &spec)
+        {
+            bool ok = true;
+            std::string entry;
+            for (std::size_t i = 0; i <= spec.size(); ++i)
+            {
+                const char c = i < spec.size() ? spec[i] : ';';
+                if (c != ';' && c != ',' && c != '\n')
+                {
+                    entry += c;
+                    continue;
+                }
+                const std::size_t hash = entry.find('#');
+                if (hash != std::string::npos)
+                    entry.erase(hash);
+                entry = trim(entry);
+                if (!entry.empty() && !apply_entry(entry))
+                    ok = false;
+                entry.clear();
+            }
+            return ok;
+        }
+
+        bool apply_file(const std::string &filename)
+        {
+            std::ifstream file(filename.c_str());
+            if (!file)
+                return false;
+            std::stringstream contents;
+            contents << file.rdbuf();
+            return apply_spec(contents.str());
+        }
+
+        bool apply_environment()
+        {
+            bool ok = true;
+            const char *spec = std::getenv("CLAPFFT_PLANNING_POLICY");
+            if (spec != nullptr && !apply_spec(spec))
+                ok = false;
+            const char *file = std::getenv("CLAPFFT_PLANNING_POLICY_FILE");
+            if (file != nullptr && *file != '\0' && !apply_file(file))
+                ok = false;
+            return ok;
+        }
+
+        void ensure_initialized()
+        {
+            std::call_once(init_once, []()
+                           {
+                fill(-1, -1, CLAP_FFT_ESTIMATE);
+                apply_environment(); });
+        }
+    }
+
+    template <typename T>
+    void PlanningPolicy::set(TransformKind kind, fft_flags flags)
+    {
+        ensure_initialized();
+        fill(precision_index<T>::value, static_cast<int>(kind), flags & ~CLAP_FFT_DEFAULT);
+    }
+
+    template <typename T>
+    void PlanningPolicy::set_all(fft_flags flags)
+    {
+        ensure_initialized();
+        fill(precision_index<T>::value, -1, flags & ~CLAP_FFT_DEFAULT);
+    }
+
+    template <typename T>
+    fft_flags PlanningPolicy::get(TransformKind kind)
+    {
+        ensure_initialized();
+        return table[precision_index<T>::value][static_cast<int>(kind)].load(std::memory_order_relaxed);
+    }
+
+    template <typename T>
+    fft_flags PlanningPolicy::resolve(TransformKind kind, fft_flags requested)
+    {
+        if ((requested & CLAP_FFT_DEFAULT) == 0)
+        {
+            return requested;
+        }
+        return (requested & ~CLAP_FFT_DEFAULT) | get<T>(kind);
+    }
+
+    bool PlanningPolicy::load_from_string(const std::string &spec)
+    {
+        ensure_initialized();
+        return apply_spec(spec);
+    }
+
+    bool PlanningPolicy::load_from_file(const std::string &filename)
+    {
+        ensure_initialized();
+        return apply_file(filename);
+    }
+
+    bool PlanningPolicy::load_from_environment()
+    {
+        ensure_initialized();
+        return apply_environment();
+    }
+
+    void PlanningPolicy::reset()
+    {
+        ensure_initialized();
+        fill(-1, -1, CLAP_FFT_ESTIMATE);
+    }
+
+    // Explicit instantiations
+    template void PlanningPolicy::set<float>(TransformKind, fft_flags);
+    template void PlanningPolicy::set<double>(TransformKind, fft_flags);
+    template void PlanningPolicy::set<long double>(TransformKind, fft_flags);
+
+    template void PlanningPolicy::set_all<float>(fft_flags);
+    template void PlanningPolicy::set_all<double>(fft_flags);
+    template void PlanningPolicy::set_all<long double>(fft_flags);
+
+    template fft_flags PlanningPolicy::get<float>(TransformKind);
+    template fft_flags PlanningPolicy::get<double>(TransformKind);
+    template fft_flags PlanningPolicy::get<long double>(TransformKind);
+
+    template fft_flags PlanningPolicy::resolve<float>(TransformKind, fft_flags);
+    template fft_flags PlanningPolicy::resolve<double>(TransformKind, fft_flags);
+    template fft_flags PlanningPolicy::resolve<long double>(TransformKind, fft_flags);
+
+} // namespace clapfft
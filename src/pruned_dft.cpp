@@ -0,0 +1,391 @@
+#include <clapfft/pruned_dft.hpp>
+#include <fftw3.h>
+#include <clapfft/aligned_buffer.hpp>
+#include <clapfft/fft_traits.hpp>
+#include <clapfft/fft_plan_cache.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace clapfft
+{
+    namespace
+    {
+        // Relative costs behind estimated_cost(), in Goertzel steps (one
+        // sample for one bin of a full pass): an FFTW r2c of size P costs
+        // about fft_weight * P log2 P steps, with each prime factor above
+        // 7 (no hard-coded codelet; Rader or the generic O(p^2) solver)
+        // weighing prime_penalty times its share, and one term of the
+        // decomposition's twiddled sums, a table lookup and a complex
+        // multiply-add on a latency-bound accumulator, about sum_weight.
+        const double fft_weight = 0.5;
+        const double prime_penalty = 3.0;
+        const double sum_weight = 2.5;
+
+        // Bins per Goertzel pass: enough independent recurrences to hide
+        // the multiply-add latency, few enough to stay in registers.
+        const std::size_t goertzel_width = 8;
+
+        // s[j] = x[j] + coef * s[j - 1] - s[j - 2] for goertzel_width
+        // bins at once; s1 and s2 receive s[n - 1] and s[n - 2].
+        template <typename S, typename A>
+        void goertzel_pass(const S *x, std::size_t n, const A *coef, A *s1, A *s2)
+        {
+            A a[goertzel_width] = {}, b[goertzel_width] = {}, c[goertzel_width];
+            std::copy(coef, coef + goertzel_width, c);
+            for (std::size_t j = 0; j < n; ++j)
+            {
+                const A v = static_cast<A>(x[j]);
+                for (std::size_t i = 0; i < goertzel_width; ++i)
+                {
+                    const A t = (v - b[i]) + c[i] * a[i];
+                    b[i] = a[i];
+                    a[i] = t;
+                }
+            }
+            std::copy(a, a + goertzel_width, s1);
+            std::copy(b, b + goertzel_width, s2);
+        }
+
+#if defined(__SSE2__)
+        template <typename S>
+        void goertzel_pass(const S *x, std::size_t n, const double *coef, double *s1, double *s2)
+        {
+            const std::size_t lanes = goertzel_width / 2;
+            __m128d a[lanes], b[lanes], c[lanes];
+            for (std::size_t i = 0; i < lanes; ++i)
+            {
+                a[i] = _mm_setzero_pd();
+                b[i] = _mm_setzero_pd();
+                c[i] = _mm_loadu_pd(coef + 2 * i);
+            }
+            for (std::size_t j = 0; j < n; ++j)
+            {
+                const __m128d v = _mm_set1_pd(static_cast<double>(x[j]));
+                for (std::size_t i = 0; i < lanes; ++i)
+                {
+                    // x - s[j - 2] is off the critical path through s[j - 1].
+                    const __m128d t = _mm_add_pd(_mm_sub_pd(v, b[i]), _mm_mul_pd(c[i], a[i]));
+                    b[i] = a[i];
+                    a[i] = t;
+                }
+            }
+            for (std::size_t i = 0; i < lanes; ++i)
+            {
+                _mm_storeu_pd(s1 + 2 * i, a[i]);
+                _mm_storeu_pd(s2 + 2 * i, b[i]);
+            }
+        }
+#endif
+
+        double goertzel_cost(std::size_t n, std::size_t bin_count)
+        {
+            const std::size_t passes = (bin_count + goertzel_width - 1) / goertzel_width;
+            return static_cast<double>(passes * goertzel_width) * static_cast<double>(n);
+        }
+
+        double decomposition_cost(std::size_t n, std::size_t bin_count, std::size_t factor)
+        {
+            if (factor < 2 || n % factor != 0)
+            {
+                return std::numeric_limits<double>::infinity();
+            }
+            // log2 P, with the slow primes weighted up.
+            double depth = 0.0;
+            std::size_t rest = factor;
+            for (std::size_t f = 2; f <= rest / f; ++f)
+            {
+                for (; rest % f == 0; rest /= f)
+                {
+                    depth += std::log2(static_cast<double>(f)) * (f > 7 ? prime_penalty : 1.0);
+                }
+            }
+            if (rest > 1)
+            {
+                depth += std::log2(static_cast<double>(rest)) * (rest > 7 ? prime_penalty : 1.0);
+            }
+            const double P = static_cast<double>(factor);
+            const double Q = static_cast<double>(n / factor);
+            return fft_weight * Q * P * depth + sum_weight * static_cast<double>(bin_count) * Q;
+        }
+
+        // The divisor of n (> 1) with the cheapest decomposition, 0 if n < 2.
+        std::size_t best_factor(std::size_t n, std::size_t bin_count)
+        {
+            std::size_t best = 0;
+            double best_cost = std::numeric_limits<double>::infinity();
+            for (std::size_t d = 1; d <= n / d; ++d)
+            {
+                if (n % d != 0)
+                {
+                    continue;
+                }
+                const std::size_t candidates[2] = {d, n / d};
+                for (std::size_t i = 0; i < 2; ++i)
+                {
+                    const double cost = decomposition_cost(n, bin_count, candidates[i]);
+                    if (cost < best_cost)
+                    {
+                        best_cost = cost;
+                        best = candidates[i];
+                    }
+                }
+            }
+            return best;
+        }
+    }
+
+    template <typename T>
+    struct PrunedDFT<T>::Impl
+    {
+        using traits = fft_trait<T>;
+        using complex_type = typename traits::complex_type;
+        using wrapper_type = typename PlanCache<T>::Wrapper;
+        // Goertzel's pole sits on the unit circle; float state would lose
+        // the small bins of a long transform.
+        using accum_type = typename std::common_type<T, double>::type;
+
+        std::size_t n;
+        std::vector<std::size_t> bin;
+        PruningMethod method;
+        std::size_t P; // decomposition only
+        std::size_t Q;
+
+        // Goertzel: per bin 2 cos(w), cos(w) and sin(w), w = 2 pi k / n,
+        // padded to whole passes.
+        AlignedBuffer<accum_type> coef;
+        AlignedBuffer<accum_type> cos_w;
+        AlignedBuffer<accum_type> sin_w;
+        AlignedBuffer<accum_type> s1;
+        AlignedBuffer<accum_type> s2;
+
+        // Decomposition: Y[r * Q + q] = bin r of the P-point DFT of x[q],
+        // x[q + Q], ..., and exp(-2 pi i j / n) for the twiddled sums.
+        AlignedBuffer<std::complex<T>> spectra;
+        AlignedBuffer<T> cos_table;
+        AlignedBuffer<T> sin_table;
+        std::shared_ptr<wrapper_type> plan;
+
+        void goertzel(const T *in, std::complex<T> *out)
+        {
+            const std::size_t count = bin.size();
+            for (std::size_t first = 0; first < count; first += goertzel_width)
+            {
+                goertzel_pass(in, n, coef.data() + first, s1.data() + first, s2.data() + first);
+            }
+            // X_k = exp(i w) s[n - 1] - s[n - 2].
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                out[i] = std::complex<T>(static_cast<T>(cos_w[i] * s1[i] - s2[i]), static_cast<T>(sin_w[i] * s1[i]));
+            }
+        }
+
+        void decompose(const T *in, std::complex<T> *out)
+        {
+            // Out-of-place r2c plans leave the input alone.
+            T *src = const_cast<T *>(in);
+            complex_type *dst = reinterpret_cast<complex_type *>(spectra.data());
+            plan->run_concurrent([&](typename traits::plan_type p)
+                                 { traits::execute_dft_r2c(p, src, dst); });
+
+            // X[k] = sum_q W_n^(k q) Y_q[k mod P], with Y_q[r] =
+            // conj(Y_q[P - r]) for the half r2c leaves out.
+            for (std::size_t i = 0; i < bin.size(); ++i)
+            {
+                const std::size_t k = bin[i];
+                const std::size_t r = k % P;
+                const bool mirrored = r > P / 2;
+                const std::complex<T> *row = spectra.data() + (mirrored ? P - r : r) * Q;
+                const T sign = mirrored ? T(-1) : T(1);
+                T re = 0, im = 0;
+                std::size_t index = 0;
+                for (std::size_t q = 0; q < Q; ++q)
+                {
+                    const T yr = row[q].real(), yi = sign * row[q].imag();
+                    const T wr = cos_table[index], wi = sin_table[index];
+                    re += yr * wr - yi * wi;
+                    im += yr * wi + yi * wr;
+                    index += k;
+                    index -= index >= n ? n : 0;
+                }
+                out[i] = std::complex<T>(re, im);
+            }
+        }
+    };
+
+    template <typename T>
+    PrunedDFT<T>::PrunedDFT(std::size_t n, const std::vector<std::size_t> &bins, fft_flags flags)
+    {
+        const std::size_t factor = best_factor(n, bins.size());
+        const bool split = factor != 0 && decomposition_cost(n, bins.size(), factor) < goertzel_cost(n, bins.size());
+        *this = PrunedDFT(n, bins, split ? PruningMethod::Decomposition : PruningMethod::Goertzel, factor, flags);
+    }
+
+    template <typename T>
+    PrunedDFT<T>::PrunedDFT(std::size_t n, const std::vector<std::size_t> &bins, PruningMethod method,
+                            std::size_t factor, fft_flags flags)
+    {
+        const std::size_t limit = static_cast<std::size_t>(std::numeric_limits<int>::max());
+        if (n == 0 || n > limit || bins.empty())
+        {
+            return;
+        }
+        for (std::size_t i = 0; i < bins.size(); ++i)
+        {
+            if (bins[i] >= n)
+            {
+                return;
+            }
+        }
+
+        std::unique_ptr<Impl> state(new Impl());
+        state->n = n;
+        state->bin = bins;
+        state->method = method;
+        state->P = 0;
+        state->Q = 0;
+        const long double two_pi = 6.283185307179586476925286766559L;
+
+        if (method == PruningMethod::Goertzel)
+        {
+            using accum_type = typename Impl::accum_type;
+            const std::size_t padded = (bins.size() + goertzel_width - 1) / goertzel_width * goertzel_width;
+            state->coef = AlignedBuffer<accum_type>(padded);
+            state->cos_w = AlignedBuffer<accum_type>(padded);
+            state->sin_w = AlignedBuffer<accum_type>(padded);
+            state->s1 = AlignedBuffer<accum_type>(padded);
+            state->s2 = AlignedBuffer<accum_type>(padded);
+            for (std::size_t i = 0; i < bins.size(); ++i)
+            {
+                const long double angle = two_pi * static_cast<long double>(bins[i]) / static_cast<long double>(n);
+                state->coef[i] = static_cast<accum_type>(2.0L * std::cos(angle));
+                state->cos_w[i] = static_cast<accum_type>(std::cos(angle));
+                state->sin_w[i] = static_cast<accum_type>(std::sin(angle));
+            }
+            impl = std::move(state);
+            return;
+        }
+
+        if (factor == 0)
+        {
+            factor = best_factor(n, bins.size());
+        }
+        if (factor < 2 || n % factor != 0)
+        {
+            return;
+        }
+        const std::size_t P = factor, Q = n / factor;
+        state->P = P;
+        state->Q = Q;
+        state->spectra = AlignedBuffer<std::complex<T>>::uninitialized((P / 2 + 1) * Q);
+        state->cos_table = AlignedBuffer<T>::uninitialized(n);
+        state->sin_table = AlignedBuffer<T>::uninitialized(n);
+        for (std::size_t j = 0; j < n; ++j)
+        {
+            const long double angle = two_pi * static_cast<long double>(j) / static_cast<long double>(n);
+            state->cos_table[j] = static_cast<T>(std::cos(angle));
+            state->sin_table[j] = static_cast<T>(-std::sin(angle));
+        }
+
+        // Q interleaved subsequences in, Q interleaved half spectra out.
+        const int dims = static_cast<int>(P);
+        PlanKey key(TransformKind::R2C, 1, &dims, flags);
+        key.howmany = static_cast<int>(Q);
+        key.istride = static_cast<int>(Q);
+        key.idist = 1;
+        key.ostride = static_cast<int>(Q);
+        key.odist = 1;
+        // transform() takes the caller's buffer as is.
+        key.alignment = 0;
+        key.normalize();
+        state->plan = PlanCache<T>::get(key);
+        if (!state->plan || state->plan->plan == nullptr)
+        {
+            return;
+        }
+        impl = std::move(state);
+    }
+
+    template <typename T>
+    PrunedDFT<T>::PrunedDFT() = default;
+
+    template <typename T>
+    PrunedDFT<T>::~PrunedDFT() = default;
+
+    template <typename T>
+    PrunedDFT<T>::PrunedDFT(PrunedDFT &&other) = default;
+
+    template <typename T>
+    PrunedDFT<T> &PrunedDFT<T>::operator=(PrunedDFT &&other) = default;
+
+    template <typename T>
+    bool PrunedDFT<T>::valid() const
+    {
+        return impl != nullptr;
+    }
+
+    template <typename T>
+    std::size_t PrunedDFT<T>::size() const
+    {
+        return impl ? impl->n : 0;
+    }
+
+    template <typename T>
+    const std::vector<std::size_t> &PrunedDFT<T>::bins() const
+    {
+        static const std::vector<std::size_t> none;
+        return impl ? impl->bin : none;
+    }
+
+    template <typename T>
+    PruningMethod PrunedDFT<T>::method() const
+    {
+        return impl ? impl->method : PruningMethod::Goertzel;
+    }
+
+    template <typename T>
+    std::size_t PrunedDFT<T>::factor() const
+    {
+        return impl ? impl->P : 0;
+    }
+
+    template <typename T>
+    bool PrunedDFT<T>::transform(const T *in, std::complex<T> *out)
+    {
+        if (!impl || in == nullptr || out == nullptr)
+        {
+            return false;
+        }
+        if (impl->method == PruningMethod::Goertzel)
+        {
+            impl->goertzel(in, out);
+        }
+        else
+        {
+            impl->decompose(in, out);
+        }
+        return true;
+    }
+
+    template <typename T>
+    double PrunedDFT<T>::estimated_cost(std::size_t n, std::size_t bin_count, PruningMethod method,
+                                        std::size_t factor)
+    {
+        if (method == PruningMethod::Goertzel)
+        {
+            return goertzel_cost(n, bin_count);
+        }
+        return decomposition_cost(n, bin_count, factor);
+    }
+
+    // Explicit instantiations
+    template class PrunedDFT<float>;
+    template class PrunedDFT<double>;
+    template class PrunedDFT<long double>;
+
+} // namespace clapfft
@@ -0,0 +1,505 @@
+#include <clapfft/realtime_fft.hpp>
+#include <fftw3.h>
+#include <clapfft/fft_traits.hpp>
+#include <clapfft/fft_plan_cache.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef CLAPFFT_REALTIME_CHECKS
+#include <cerrno>
+#include <new>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+namespace clapfft
+{
+    namespace
+    {
+        bool aligned(const void *p)
+        {
+            return reinterpret_cast<std::uintptr_t>(p) % realtime_alignment == 0;
+        }
+
+        std::atomic<RealtimeChecks::Handler> violation_handler(nullptr);
+
+#ifdef CLAPFFT_REALTIME_CHECKS
+        // initial-exec: reading it from inside malloc must not itself
+        // allocate, as lazily set up dynamic TLS would.
+        thread_local int realtime_depth __attribute__((tls_model("initial-exec"))) = 0;
+
+        void default_violation(const char *what)
+        {
+            static const char prefix[] = "clapfft: real-time violation: ";
+            ssize_t ignored = write(2, prefix, sizeof(prefix) - 1);
+            ignored = write(2, what, std::strlen(what));
+            ignored = write(2, "\n", 1);
+            (void)ignored;
+            std::abort();
+        }
+#endif
+    }
+
+#ifdef CLAPFFT_REALTIME_CHECKS
+    // Called by the interposed functions below; they live outside the
+    // namespace, so this cannot be in the unnamed one.
+    void report_realtime_violation(const char *what)
+    {
+        if (realtime_depth == 0)
+        {
+            return;
+        }
+        const int depth = realtime_depth;
+        realtime_depth = 0;
+        const RealtimeChecks::Handler handler = violation_handler.load(std::memory_order_acquire);
+        (handler != nullptr ? handler : default_violation)(what);
+        realtime_depth = depth;
+    }
+#endif
+
+    bool RealtimeChecks::available()
+    {
+#ifdef CLAPFFT_REALTIME_CHECKS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void RealtimeChecks::set_handler(Handler handler)
+    {
+        violation_handler.store(handler, std::memory_order_release);
+    }
+
+    RealtimeScope::RealtimeScope()
+    {
+#ifdef CLAPFFT_REALTIME_CHECKS
+        ++realtime_depth;
+#endif
+    }
+
+    RealtimeScope::~RealtimeScope()
+    {
+#ifdef CLAPFFT_REALTIME_CHECKS
+        --realtime_depth;
+#endif
+    }
+
+    template <typename T>
+    struct RealtimeFFT<T>::Impl
+    {
+        using traits = fft_trait<T>;
+        using complex_type = typename traits::complex_type;
+
+        std::shared_ptr<typename PlanCache<T>::Wrapper> wrapper;
+        TransformKind kind;
+        bool in_place;
+        std::size_t in_count;
+        std::size_t out_count;
+        AlignedBuffer<std::complex<T>> scratch; // c2r only
+
+        bool accepts(TransformKind k, const void *in, const void *out) const
+        {
+            return k == kind && in != nullptr && out != nullptr && aligned(in) && aligned(out) &&
+                   (in == out) == in_place;
+        }
+
+        static RealtimeFFT create(TransformKind kind, int rank, const int *n, int sign, const int *kinds,
+                                  bool in_place, fft_flags flags)
+        {
+            RealtimeFFT handle;
+            if (n == nullptr || rank <= 0 || rank > PlanKey::max_rank)
+            {
+                return handle;
+            }
+            std::size_t full = 1;
+            for (int i = 0; i < rank; ++i)
+            {
+                if (n[i] <= 0)
+                {
+                    return handle;
+                }
+                full *= static_cast<std::size_t>(n[i]);
+            }
+            const std::size_t half = full / static_cast<std::size_t>(n[rank - 1]) * static_cast<std::size_t>(n[rank - 1] / 2 + 1);
+
+            PlanKey key(kind, rank, n, PlanningPolicy::resolve<T>(kind, flags));
+            key.sign = sign;
+            for (int i = 0; i < rank && kinds != nullptr; ++i)
+            {
+                key.r2r_kind[i] = kinds[i];
+            }
+            key.in_place = in_place;
+            key.alignment = static_cast<int>(realtime_alignment);
+            key.normalize();
+
+            std::unique_ptr<Impl> impl(new Impl());
+            impl->wrapper = PlanCache<T>::get(key);
+            if (!impl->wrapper || impl->wrapper->plan == nullptr)
+            {
+                return handle;
+            }
+            impl->kind = kind;
+            impl->in_place = in_place;
+            impl->in_count = kind == TransformKind::C2R ? half : full;
+            impl->out_count = kind == TransformKind::R2C ? half : full;
+            if (kind == TransformKind::C2R)
+            {
+                impl->scratch = AlignedBuffer<std::complex<T>>(half);
+            }
+            handle.impl = std::move(impl);
+            return handle;
+        }
+    };
+
+    template <typename T>
+    RealtimeFFT<T> RealtimeFFT<T>::c2c(int rank, const int *n, int sign, bool in_place, fft_flags flags)
+    {
+        return Impl::create(TransformKind::C2C, rank, n, sign, nullptr, in_place, flags);
+    }
+
+    template <typename T>
+    RealtimeFFT<T> RealtimeFFT<T>::r2c(int rank, const int *n, fft_flags flags)
+    {
+        return Impl::create(TransformKind::R2C, rank, n, 0, nullptr, false, flags);
+    }
+
+    template <typename T>
+    RealtimeFFT<T> RealtimeFFT<T>::c2r(int rank, const int *n, fft_flags flags)
+    {
+        return Impl::create(TransformKind::C2R, rank, n, 0, nullptr, false, flags);
+    }
+
+    template <typename T>
+    RealtimeFFT<T> RealtimeFFT<T>::r2r(int rank, const int *n, const int *kinds, bool in_place, fft_flags flags)
+    {
+        return Impl::create(TransformKind::R2R, rank, n, 0, kinds, in_place, flags);
+    }
+
+    template <typename T>
+    RealtimeFFT<T>::RealtimeFFT() = default;
+
+    template <typename T>
+    RealtimeFFT<T>::~RealtimeFFT() = default;
+
+    template <typename T>
+    RealtimeFFT<T>::RealtimeFFT(RealtimeFFT &&other) = default;
+
+    template <typename T>
+    RealtimeFFT<T> &RealtimeFFT<T>::operator=(RealtimeFFT &&other) = default;
+
+    template <typename T>
+    bool RealtimeFFT<T>::valid() const
+    {
+        return impl != nullptr;
+    }
+
+    template <typename T>
+    std::size_t RealtimeFFT<T>::input_size() const
+    {
+        return impl ? impl->in_count : 0;
+    }
+
+    template <typename T>
+    std::size_t RealtimeFFT<T>::output_size() const
+    {
+        return impl ? impl->out_count : 0;
+    }
+
+    template <typename T>
+    bool RealtimeFFT<T>::execute(const std::complex<T> *in, std::complex<T> *out) const
+    {
+        using traits = typename Impl::traits;
+        using complex_type = typename Impl::complex_type;
+        if (!impl || !impl->accepts(TransformKind::C2C, in, out))
+        {
+            return false;
+        }
+        RealtimeScope scope;
+        complex_type *src = reinterpret_cast<complex_type *>(const_cast<std::complex<T> *>(in));
+        complex_type *dst = reinterpret_cast<complex_type *>(out);
+        impl->wrapper->run_concurrent([&](typename traits::plan_type plan)
+                                      { traits::execute_dft(plan, src, dst); });
+        return true;
+    }
+
+    template <typename T>
+    bool RealtimeFFT<T>::execute(const T *in, std::complex<T> *out) const
+    {
+        using traits = typename Impl::traits;
+        using complex_type = typename Impl::complex_type;
+        if (!impl || !impl->accepts(TransformKind::R2C, in, out))
+        {
+            return false;
+        }
+        RealtimeScope scope;
+        T *src = const_cast<T *>(in);
+        complex_type *dst = reinterpret_cast<complex_type *>(out);
+        impl->wrapper->run_concurrent([&](typename traits::plan_type plan)
+                                      { traits::execute_dft_r2c(plan, src, dst); });
+        return true;
+    }
+
+    template <typename T>
+    bool RealtimeFFT<T>::execute(const std::complex<T> *in, T *out)
+    {
+        using traits = typename Impl::traits;
+        using complex_type = typename Impl::complex_type;
+        if (!impl || !impl->accepts(TransformKind::C2R, in, out))
+        {
+            return false;
+        }
+        RealtimeScope scope;
+        // FFTW's c2r overwrites its input; the caller's stays intact.
+        std::memcpy(static_cast<void *>(impl->scratch.data()), in, impl->in_count * sizeof(std::complex<T>));
+        complex_type *src = reinterpret_cast<complex_type *>(impl->scratch.data());
+        impl->wrapper->run_concurrent([&](typename traits::plan_type plan)
+                                      { traits::execute_dft_c2r(plan, src, out); });
+        return true;
+    }
+
+    template <typename T>
+    bool RealtimeFFT<T>::execute(const T *in, T *out) const
+    {
+        using traits = typename Impl::traits;
+        if (!impl || !impl->accepts(TransformKind::R2R, in, out))
+        {
+            return false;
+        }
+        RealtimeScope scope;
+        T *src = const_cast<T *>(in);
+        impl->wrapper->run_concurrent([&](typename traits::plan_type plan)
+                                      { traits::execute_r2r(plan, src, out); });
+        return true;
+    }
+
+    // Explicit instantiations
+    template class RealtimeFFT<float>;
+    template class RealtimeFFT<double>;
+    template class RealtimeFFT<long double>;
+
+} // namespace clapfft
+
+#ifdef CLAPFFT_REALTIME_CHECKS
+// Replacements for the global allocation functions, the C allocator and
+// the blocking pthread calls. Being part of libclapfft they take
+// precedence over libstdc++ and libc for the whole process; outside a
+// RealtimeScope they only forward. FFTW allocates through fftw_malloc,
+// i.e. malloc or posix_memalign, and libstdc++'s aligned operator new
+// through aligned_alloc, so those are caught here too.
+
+#if defined(__GLIBC__)
+// glibc's own entry points, which forward without going back through the
+// replacements below (and, unlike dlsym, never allocate).
+extern "C"
+{
+    void *__libc_malloc(std::size_t size);
+    void *__libc_calloc(std::size_t count, std::size_t size);
+    void *__libc_realloc(void *p, std::size_t size);
+    void *__libc_memalign(std::size_t alignment, std::size_t size);
+    void __libc_free(void *p);
+}
+
+namespace
+{
+    void *raw_malloc(std::size_t size)
+    {
+        return __libc_malloc(size);
+    }
+
+#if defined(__cpp_aligned_new)
+    void *raw_aligned(std::size_t alignment, std::size_t size)
+    {
+        return __libc_memalign(alignment, size);
+    }
+#endif
+
+    void raw_free(void *p)
+    {
+        __libc_free(p);
+    }
+}
+
+extern "C" void *malloc(std::size_t size) noexcept
+{
+    clapfft::report_realtime_violation("malloc");
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(std::size_t count, std::size_t size) noexcept
+{
+    clapfft::report_realtime_violation("calloc");
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *p, std::size_t size) noexcept
+{
+    clapfft::report_realtime_violation("realloc");
+    return __libc_realloc(p, size);
+}
+
+extern "C" void free(void *p) noexcept
+{
+    if (p != nullptr)
+    {
+        clapfft::report_realtime_violation("free");
+    }
+    __libc_free(p);
+}
+
+extern "C" int posix_memalign(void **out, std::size_t alignment, std::size_t size) noexcept
+{
+    clapfft::report_realtime_violation("posix_memalign");
+    if (alignment == 0 || alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0)
+    {
+        return EINVAL;
+    }
+    void *p = __libc_memalign(alignment, size);
+    if (p == nullptr)
+    {
+        return ENOMEM;
+    }
+    *out = p;
+    return 0;
+}
+
+extern "C" void *aligned_alloc(std::size_t alignment, std::size_t size) noexcept
+{
+    clapfft::report_realtime_violation("aligned_alloc");
+    return __libc_memalign(alignment, size);
+}
+
+extern "C" void *memalign(std::size_t alignment, std::size_t size) noexcept
+{
+    clapfft::report_realtime_violation("memalign");
+    return __libc_memalign(alignment, size);
+}
+#else
+// Elsewhere only the C++ entry points and the pthread calls are checked.
+namespace
+{
+    void *raw_malloc(std::size_t size)
+    {
+        return std::malloc(size);
+    }
+
+#if defined(__cpp_aligned_new)
+    void *raw_aligned(std::size_t alignment, std::size_t size)
+    {
+        void *p = nullptr;
+        return posix_memalign(&p, alignment, size) == 0 ? p : nullptr;
+    }
+#endif
+
+    void raw_free(void *p)
+    {
+        std::free(p);
+    }
+}
+#endif
+
+namespace
+{
+    // The replaceable operator new loop: retry through the new_handler
+    // until it gives up.
+    template <typename Allocate>
+    void *checked_new(const char *what, Allocate allocate)
+    {
+        clapfft::report_realtime_violation(what);
+        for (;;)
+        {
+            void *p = allocate();
+            if (p != nullptr)
+            {
+                return p;
+            }
+            const std::new_handler handler = std::get_new_handler();
+            if (handler == nullptr)
+            {
+                throw std::bad_alloc();
+            }
+            handler();
+        }
+    }
+}
+
+void *operator new(std::size_t size)
+{
+    return checked_new("operator new", [size]()
+                       { return raw_malloc(size > 0 ? size : 1); });
+}
+
+void operator delete(void *p) noexcept
+{
+    if (p != nullptr)
+    {
+        clapfft::report_realtime_violation("operator delete");
+    }
+    raw_free(p);
+}
+
+#if defined(__cpp_sized_deallocation)
+void operator delete(void *p, std::size_t) noexcept
+{
+    operator delete(p);
+}
+#endif
+
+#if defined(__cpp_aligned_new)
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    const std::size_t align = static_cast<std::size_t>(alignment) < sizeof(void *) ? sizeof(void *) : static_cast<std::size_t>(alignment);
+    return checked_new("operator new (aligned)", [size, align]()
+                       { return raw_aligned(align, size > 0 ? size : 1); });
+}
+
+void operator delete(void *p, std::align_val_t) noexcept
+{
+    if (p != nullptr)
+    {
+        clapfft::report_realtime_violation("operator delete (aligned)");
+    }
+    raw_free(p);
+}
+
+void operator delete(void *p, std::size_t, std::align_val_t alignment) noexcept
+{
+    operator delete(p, alignment);
+}
+#endif
+
+namespace
+{
+    // Looked up on first use; no function-local statics, whose guards may
+    // themselves lock a mutex.
+    std::atomic<void *> next_mutex_lock(nullptr);
+    std::atomic<void *> next_cond_wait(nullptr);
+
+    void *next_symbol(std::atomic<void *> &slot, const char *name)
+    {
+        void *fn = slot.load(std::memory_order_acquire);
+        if (fn == nullptr)
+        {
+            fn = dlsym(RTLD_NEXT, name);
+            slot.store(fn, std::memory_order_release);
+        }
+        return fn;
+    }
+}
+
+extern "C" int pthread_mutex_lock(pthread_mutex_t *mutex) noexcept
+{
+    clapfft::report_realtime_violation("pthread_mutex_lock");
+    typedef int (*Fn)(pthread_mutex_t *);
+    return reinterpret_cast<Fn>(next_symbol(next_mutex_lock, "pthread_mutex_lock"))(mutex);
+}
+
+extern "C" int pthread_cond_wait(pthread_cond_t *cond, pthread_mutex_t *mutex)
+{
+    clapfft::report_realtime_violation("pthread_cond_wait");
+    typedef int (*Fn)(pthread_cond_t *, pthread_mutex_t *);
+    return reinterpret_cast<Fn>(next_symbol(next_cond_wait, "pthread_cond_wait"))(cond, mutex);
+}
+#endif
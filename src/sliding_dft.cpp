@@ -0,0 +1,329 @@
+#include <clapfft/sliding_dft.hpp>
+#include <fftw3.h>
+#include <clapfft/aligned_buffer.hpp>
+#include <clapfft/fft_traits.hpp>
+#include <clapfft/fft_plan_cache.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace clapfft
+{
+    template <typename T>
+    struct SlidingDFT<T>::Impl
+    {
+        using traits = fft_trait<T>;
+        using complex_type = typename traits::complex_type;
+        using wrapper_type = typename PlanCache<T>::Wrapper;
+
+        std::size_t n;
+        std::size_t nbins;
+        std::size_t nchan;
+        std::size_t interval;
+        std::size_t pitch;     // n rounded up to keep every channel's window aligned
+        std::size_t pos;       // t mod n: ring slot of the oldest sample
+        std::size_t since;     // samples since the last resync
+        std::vector<std::size_t> bin;
+        std::vector<std::size_t> phase; // bin * t mod n
+        AlignedBuffer<T> cos_table;     // n: Re exp(-2 pi i j / n)
+        AlignedBuffer<T> sin_table;     // n: Im exp(-2 pi i j / n)
+        AlignedBuffer<T> twiddle_re;    // nbins, this sample's modulation
+        AlignedBuffer<T> twiddle_im;
+        AlignedBuffer<T> acc_re;        // nchan x nbins, modulated sums
+        AlignedBuffer<T> acc_im;
+        AlignedBuffer<std::complex<T>> ring;    // nchan x n
+        AlignedBuffer<std::complex<T>> current; // nchan, the sample being pushed
+        AlignedBuffer<std::complex<T>> window;  // nchan x pitch, oldest first
+        AlignedBuffer<std::complex<T>> full;    // nchan x pitch
+        std::shared_ptr<wrapper_type> plan;
+
+        void step(const std::complex<T> *samples)
+        {
+            T *tr = twiddle_re.data();
+            T *ti = twiddle_im.data();
+            for (std::size_t i = 0; i < nbins; ++i)
+            {
+                tr[i] = cos_table[phase[i]];
+                ti[i] = sin_table[phase[i]];
+                phase[i] += bin[i];
+                phase[i] -= phase[i] >= n ? n : 0;
+            }
+            for (std::size_t c = 0; c < nchan; ++c)
+            {
+                std::complex<T> &oldest = ring[c * n + pos];
+                const T dr = samples[c].real() - oldest.real();
+                const T di = samples[c].imag() - oldest.imag();
+                oldest = samples[c];
+                T *yr = acc_re.data() + c * nbins;
+                T *yi = acc_im.data() + c * nbins;
+                for (std::size_t i = 0; i < nbins; ++i)
+                {
+                    yr[i] += dr * tr[i] - di * ti[i];
+                    yi[i] += dr * ti[i] + di * tr[i];
+                }
+            }
+            pos = pos + 1 == n ? 0 : pos + 1;
+            if (++since >= interval)
+            {
+                resync();
+            }
+        }
+
+        // X_k = Y_k * conj(W^(k t mod n)); phase already holds the index
+        // for the sample after the last one pushed.
+        void read(std::complex<T> *out) const
+        {
+            for (std::size_t c = 0; c < nchan; ++c)
+            {
+                const T *yr = acc_re.data() + c * nbins;
+                const T *yi = acc_im.data() + c * nbins;
+                for (std::size_t i = 0; i < nbins; ++i)
+                {
+                    const T wr = cos_table[phase[i]], wi = -sin_table[phase[i]];
+                    out[c * nbins + i] = std::complex<T>(yr[i] * wr - yi[i] * wi, yr[i] * wi + yi[i] * wr);
+                }
+            }
+        }
+
+        void resync()
+        {
+            since = 0;
+            for (std::size_t c = 0; c < nchan; ++c)
+            {
+                const std::complex<T> *src = ring.data() + c * n;
+                std::complex<T> *dst = window.data() + c * pitch;
+                std::copy(src + pos, src + n, dst);
+                std::copy(src, src + pos, dst + (n - pos));
+            }
+            complex_type *in = reinterpret_cast<complex_type *>(window.data());
+            complex_type *out = reinterpret_cast<complex_type *>(full.data());
+            plan->run_concurrent([&](typename traits::plan_type p)
+                                 { traits::execute_dft(p, in, out); });
+            for (std::size_t c = 0; c < nchan; ++c)
+            {
+                T *yr = acc_re.data() + c * nbins;
+                T *yi = acc_im.data() + c * nbins;
+                for (std::size_t i = 0; i < nbins; ++i)
+                {
+                    const std::complex<T> x = full[c * pitch + bin[i]];
+                    const T wr = cos_table[phase[i]], wi = sin_table[phase[i]];
+                    yr[i] = x.real() * wr - x.imag() * wi;
+                    yi[i] = x.real() * wi + x.imag() * wr;
+                }
+            }
+        }
+
+        template <typename Sample>
+        void push(const Sample *const *in, std::size_t count, std::complex<T> *out)
+        {
+            for (std::size_t s = 0; s < count; ++s)
+            {
+                for (std::size_t c = 0; c < nchan; ++c)
+                {
+                    current[c] = std::complex<T>(in[c][s]);
+                }
+                step(current.data());
+                if (out != nullptr)
+                {
+                    read(out + s * nchan * nbins);
+                }
+            }
+        }
+
+        void reset()
+        {
+            pos = 0;
+            since = 0;
+            std::fill(phase.begin(), phase.end(), std::size_t(0));
+            std::fill(ring.data(), ring.data() + nchan * n, std::complex<T>());
+            std::fill(acc_re.data(), acc_re.data() + nchan * nbins, T(0));
+            std::fill(acc_im.data(), acc_im.data() + nchan * nbins, T(0));
+        }
+    };
+
+    template <typename T>
+    SlidingDFT<T>::SlidingDFT(std::size_t n, const std::vector<std::size_t> &bins, std::size_t channels,
+                              std::size_t resync_interval, fft_flags flags)
+    {
+        const std::size_t limit = static_cast<std::size_t>(std::numeric_limits<int>::max());
+        if (n == 0 || n > limit || channels == 0 || bins.empty())
+        {
+            return;
+        }
+        for (std::size_t i = 0; i < bins.size(); ++i)
+        {
+            if (bins[i] >= n)
+            {
+                return;
+            }
+        }
+        const bool aligned = buffer_alignment % sizeof(std::complex<T>) == 0;
+        const std::size_t line = aligned ? buffer_alignment / sizeof(std::complex<T>) : 1;
+        const std::size_t pitch = (n + line - 1) / line * line;
+        if (channels > limit / pitch)
+        {
+            return;
+        }
+
+        std::unique_ptr<Impl> state(new Impl());
+        state->n = n;
+        state->nbins = bins.size();
+        state->nchan = channels;
+        state->interval = resync_interval == 0 ? n : resync_interval;
+        state->pitch = pitch;
+        state->bin = bins;
+        state->phase.assign(bins.size(), 0);
+        state->cos_table = AlignedBuffer<T>::uninitialized(n);
+        state->sin_table = AlignedBuffer<T>::uninitialized(n);
+        const long double two_pi = 6.283185307179586476925286766559L;
+        for (std::size_t j = 0; j < n; ++j)
+        {
+            const long double angle = two_pi * static_cast<long double>(j) / static_cast<long double>(n);
+            state->cos_table[j] = static_cast<T>(std::cos(angle));
+            state->sin_table[j] = static_cast<T>(-std::sin(angle));
+        }
+        state->twiddle_re = AlignedBuffer<T>(bins.size());
+        state->twiddle_im = AlignedBuffer<T>(bins.size());
+        state->acc_re = AlignedBuffer<T>(channels * bins.size());
+        state->acc_im = AlignedBuffer<T>(channels * bins.size());
+        state->ring = AlignedBuffer<std::complex<T>>(channels * n);
+        state->current = AlignedBuffer<std::complex<T>>(channels);
+        state->window = AlignedBuffer<std::complex<T>>(channels * pitch);
+        state->full = AlignedBuffer<std::complex<T>>(channels * pitch);
+        state->pos = 0;
+        state->since = 0;
+
+        const int dims = static_cast<int>(n);
+        PlanKey key(TransformKind::C2C, 1, &dims, flags);
+        key.sign = FFTW_FORWARD;
+        key.howmany = static_cast<int>(channels);
+        key.idist = static_cast<int>(pitch);
+        key.odist = static_cast<int>(pitch);
+        key.alignment = aligned ? static_cast<int>(buffer_alignment) : 0;
+        key.normalize();
+        state->plan = PlanCache<T>::get(key);
+        if (!state->plan || state->plan->plan == nullptr)
+        {
+            return;
+        }
+        impl = std::move(state);
+    }
+
+    template <typename T>
+    SlidingDFT<T>::SlidingDFT() = default;
+
+    template <typename T>
+    SlidingDFT<T>::~SlidingDFT() = default;
+
+    template <typename T>
+    SlidingDFT<T>::SlidingDFT(SlidingDFT &&other) = default;
+
+    template <typename T>
+    SlidingDFT<T> &SlidingDFT<T>::operator=(SlidingDFT &&other) = default;
+
+    template <typename T>
+    bool SlidingDFT<T>::valid() const
+    {
+        return impl != nullptr;
+    }
+
+    template <typename T>
+    std::size_t SlidingDFT<T>::window_size() const
+    {
+        return impl ? impl->n : 0;
+    }
+
+    template <typename T>
+    std::size_t SlidingDFT<T>::channels() const
+    {
+        return impl ? impl->nchan : 0;
+    }
+
+    template <typename T>
+    std::size_t SlidingDFT<T>::resync_interval() const
+    {
+        return impl ? impl->interval : 0;
+    }
+
+    template <typename T>
+    const std::vector<std::size_t> &SlidingDFT<T>::bins() const
+    {
+        static const std::vector<std::size_t> none;
+        return impl ? impl->bin : none;
+    }
+
+    template <typename T>
+    bool SlidingDFT<T>::push(const std::complex<T> *const *in, std::size_t count, std::complex<T> *out)
+    {
+        if (!impl || (count > 0 && in == nullptr))
+        {
+            return false;
+        }
+        impl->push(in, count, out);
+        return true;
+    }
+
+    template <typename T>
+    bool SlidingDFT<T>::push(const T *const *in, std::size_t count, std::complex<T> *out)
+    {
+        if (!impl || (count > 0 && in == nullptr))
+        {
+            return false;
+        }
+        impl->push(in, count, out);
+        return true;
+    }
+
+    template <typename T>
+    bool SlidingDFT<T>::push(const std::complex<T> *in, std::size_t count, std::complex<T> *out)
+    {
+        if (!impl || impl->nchan != 1)
+        {
+            return false;
+        }
+        return push(&in, count, out);
+    }
+
+    template <typename T>
+    bool SlidingDFT<T>::push(const T *in, std::size_t count, std::complex<T> *out)
+    {
+        if (!impl || impl->nchan != 1)
+        {
+            return false;
+        }
+        return push(&in, count, out);
+    }
+
+    template <typename T>
+    void SlidingDFT<T>::spectrum(std::complex<T> *out) const
+    {
+        if (impl && out != nullptr)
+        {
+            impl->read(out);
+        }
+    }
+
+    template <typename T>
+    void SlidingDFT<T>::resync()
+    {
+        if (impl)
+        {
+            impl->resync();
+        }
+    }
+
+    template <typename T>
+    void SlidingDFT<T>::reset()
+    {
+        if (impl)
+        {
+            impl->reset();
+        }
+    }
+
+    // Explicit instantiations
+    template class SlidingDFT<float>;
+    template class SlidingDFT<double>;
+    template class SlidingDFT<long double>;
+
+} // namespace clapfft
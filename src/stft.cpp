@@ -0,0 +1,561 @@
+#include <clapfft/stft.hpp>
+#include <fftw3.h>
+#include <clapfft/aligned_buffer.hpp>
+#include <clapfft/fft_traits.hpp>
+#include <clapfft/fft_plan_cache.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace clapfft
+{
+    template <typename T>
+    std::vector<T> hann_window(std::size_t n)
+    {
+        std::vector<T> window(n);
+        const long double step = 2.0L * std::acos(-1.0L) / static_cast<long double>(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            window[i] = static_cast<T>(0.5L - 0.5L * std::cos(step * static_cast<long double>(i)));
+        }
+        return window;
+    }
+
+    template <typename T>
+    struct STFT<T>::Impl
+    {
+        using traits = fft_trait<T>;
+        using complex_type = typename traits::complex_type;
+        using wrapper_type = typename PlanCache<T>::Wrapper;
+
+        std::size_t n;
+        std::size_t step;
+        std::size_t bin_count;
+        std::size_t max_batch;
+        fft_flags flags;
+        AlignedBuffer<T> window;
+        AlignedBuffer<T> frames;                 // max_batch x n, windowed
+        AlignedBuffer<std::complex<T>> spectra;  // max_batch x bin_count, for unaligned outputs
+        std::shared_ptr<wrapper_type> full_plan; // howmany = max_batch
+        std::vector<T> history;                  // samples from the next frame's start on
+        bool emitted;                            // a frame was written since the last reset
+
+        std::shared_ptr<wrapper_type> plan(std::size_t howmany) const
+        {
+            if (howmany == max_batch && full_plan)
+            {
+                return full_plan;
+            }
+            const int size = static_cast<int>(n);
+            PlanKey key(TransformKind::R2C, 1, &size, flags);
+            key.howmany = static_cast<int>(howmany);
+            key.idist = static_cast<int>(n);
+            key.odist = static_cast<int>(bin_count);
+            key.alignment = static_cast<int>(buffer_alignment);
+            key.normalize();
+            return PlanCache<T>::get(key);
+        }
+
+        // Windows frame `start` of history + samples (zeros past the end)
+        // into `dst`.
+        void gather(std::size_t start, const T *samples, std::size_t count, T *dst) const
+        {
+            const std::size_t kept = history.size();
+            const T *w = window.data();
+            std::size_t k = 0;
+            if (start < kept)
+            {
+                const std::size_t m = std::min(n, kept - start);
+                const T *src = history.data() + start;
+                for (; k < m; ++k)
+                {
+                    dst[k] = src[k] * w[k];
+                }
+            }
+            const std::size_t offset = start + k - kept;
+            if (k < n && offset < count)
+            {
+                const std::size_t m = std::min(n - k, count - offset);
+                const T *src = samples + offset;
+                for (std::size_t j = 0; j < m; ++j, ++k)
+                {
+                    dst[k] = src[j] * w[k];
+                }
+            }
+            std::fill(dst + k, dst + n, T(0));
+        }
+
+        // Transforms the first `frame_count` frames of history + samples,
+        // writing their spectra to `out`.
+        bool transform(std::size_t frame_count, const T *samples, std::size_t count,
+                       std::complex<T> *out)
+        {
+            for (std::size_t done = 0; done < frame_count;)
+            {
+                const std::size_t batch = std::min(max_batch, frame_count - done);
+                for (std::size_t f = 0; f < batch; ++f)
+                {
+                    gather((done + f) * step, samples, count, frames.data() + f * n);
+                }
+                const std::shared_ptr<wrapper_type> wrapper = plan(batch);
+                if (!wrapper || wrapper->plan == nullptr)
+                {
+                    return false;
+                }
+                std::complex<T> *dst = out + done * bin_count;
+                const bool direct = reinterpret_cast<std::uintptr_t>(dst) % buffer_alignment == 0;
+                complex_type *target = reinterpret_cast<complex_type *>(direct ? dst : spectra.data());
+                T *src = frames.data();
+                wrapper->run_concurrent([&](typename traits::plan_type p)
+                                        { traits::execute_dft_r2c(p, src, target); });
+                if (!direct)
+                {
+                    std::memcpy(static_cast<void *>(dst), spectra.data(), batch * bin_count * sizeof(std::complex<T>));
+                }
+                done += batch;
+            }
+            return true;
+        }
+
+        std::size_t ready(std::size_t count) const
+        {
+            const std::size_t total = history.size() + count;
+            return total < n ? 0 : (total - n) / step + 1;
+        }
+
+        std::size_t push(const T *samples, std::size_t count, std::complex<T> *out)
+        {
+            const std::size_t frame_count = ready(count);
+            if (frame_count > 0 && !transform(frame_count, samples, count, out))
+            {
+                return 0;
+            }
+            // Keep what the next frame needs; that is always under n samples.
+            const std::size_t consumed = frame_count * step;
+            if (consumed <= history.size())
+            {
+                history.erase(history.begin(), history.begin() + static_cast<std::ptrdiff_t>(consumed));
+                history.insert(history.end(), samples, samples + count);
+            }
+            else
+            {
+                history.assign(samples + (consumed - history.size()), samples + count);
+            }
+            emitted = emitted || frame_count > 0;
+            return frame_count;
+        }
+
+        std::size_t flush(std::complex<T> *out)
+        {
+            // The last frame already covered the first n - hop kept samples.
+            const std::size_t covered = emitted ? n - step : 0;
+            std::size_t written = 0;
+            if (history.size() > covered && transform(1, nullptr, 0, out))
+            {
+                written = 1;
+            }
+            reset();
+            return written;
+        }
+
+        void reset()
+        {
+            history.clear();
+            emitted = false;
+        }
+    };
+
+    template <typename T>
+    STFT<T>::STFT(const std::vector<T> &window, std::size_t hop, std::size_t max_batch, fft_flags flags)
+    {
+        const std::size_t n = window.size();
+        if (n == 0 || hop == 0 || hop > n || n > static_cast<std::size_t>(std::numeric_limits<int>::max()))
+        {
+            return;
+        }
+        std::unique_ptr<Impl> state(new Impl());
+        state->n = n;
+        state->step = hop;
+        state->bin_count = n / 2 + 1;
+        state->max_batch = std::max<std::size_t>(1, max_batch);
+        state->flags = flags;
+        state->window = AlignedBuffer<T>::uninitialized(n);
+        std::copy(window.begin(), window.end(), state->window.data());
+        state->frames = AlignedBuffer<T>(state->max_batch * n);
+        state->spectra = AlignedBuffer<std::complex<T>>(state->max_batch * state->bin_count);
+        state->history.reserve(n);
+        state->emitted = false;
+        state->full_plan = state->plan(state->max_batch);
+        if (!state->full_plan || state->full_plan->plan == nullptr)
+        {
+            return;
+        }
+        impl = std::move(state);
+    }
+
+    template <typename T>
+    STFT<T>::STFT() = default;
+
+    template <typename T>
+    STFT<T>::~STFT() = default;
+
+    template <typename T>
+    STFT<T>::STFT(STFT &&other) = default;
+
+    template <typename T>
+    STFT<T> &STFT<T>::operator=(STFT &&other) = default;
+
+    template <typename T>
+    bool STFT<T>::valid() const
+    {
+        return impl != nullptr;
+    }
+
+    template <typename T>
+    std::size_t STFT<T>::frame_size() const
+    {
+        return impl ? impl->n : 0;
+    }
+
+    template <typename T>
+    std::size_t STFT<T>::hop() const
+    {
+        return impl ? impl->step : 0;
+    }
+
+    template <typename T>
+    std::size_t STFT<T>::bins() const
+    {
+        return impl ? impl->bin_count : 0;
+    }
+
+    template <typename T>
+    std::size_t STFT<T>::frames_ready(std::size_t count) const
+    {
+        return impl ? impl->ready(count) : 0;
+    }
+
+    template <typename T>
+    std::size_t STFT<T>::push(const T *samples, std::size_t count, std::complex<T> *out)
+    {
+        if (!impl || (count > 0 && samples == nullptr))
+        {
+            return 0;
+        }
+        return impl->push(samples, count, out);
+    }
+
+    template <typename T>
+    std::size_t STFT<T>::push(const std::vector<T> &samples, std::vector<std::complex<T>> &out)
+    {
+        if (!impl)
+        {
+            return 0;
+        }
+        const std::size_t old_size = out.size();
+        out.resize(old_size + impl->ready(samples.size()) * impl->bin_count);
+        const std::size_t frame_count = impl->push(samples.data(), samples.size(), out.data() + old_size);
+        out.resize(old_size + frame_count * impl->bin_count);
+        return frame_count;
+    }
+
+    template <typename T>
+    std::size_t STFT<T>::flush(std::complex<T> *out)
+    {
+        return impl ? impl->flush(out) : 0;
+    }
+
+    template <typename T>
+    std::size_t STFT<T>::flush(std::vector<std::complex<T>> &out)
+    {
+        if (!impl)
+        {
+            return 0;
+        }
+        const std::size_t old_size = out.size();
+        out.resize(old_size + impl->bin_count);
+        const std::size_t frame_count = impl->flush(out.data() + old_size);
+        out.resize(old_size + frame_count * impl->bin_count);
+        return frame_count;
+    }
+
+    template <typename T>
+    void STFT<T>::reset()
+    {
+        if (impl)
+        {
+            impl->reset();
+        }
+    }
+
+    template <typename T>
+    struct ISTFT<T>::Impl
+    {
+        using traits = fft_trait<T>;
+        using complex_type = typename traits::complex_type;
+        using wrapper_type = typename PlanCache<T>::Wrapper;
+
+        std::size_t n;
+        std::size_t step;
+        std::size_t bin_count;
+        std::size_t max_batch;
+        std::size_t warm; // frames overlapping any one sample
+        fft_flags flags;
+        AlignedBuffer<T> window;
+        AlignedBuffer<T> gain;                   // 1 / (n * envelope) once warm, period step
+        AlignedBuffer<std::complex<T>> spectra;  // max_batch x bin_count; c2r overwrites it
+        AlignedBuffer<T> frames;                 // max_batch x n
+        AlignedBuffer<T> overlap;                // n, starting at the next output sample
+        std::shared_ptr<wrapper_type> full_plan; // howmany = max_batch
+        std::size_t seen;                        // frames since the last reset
+
+        std::shared_ptr<wrapper_type> plan(std::size_t howmany) const
+        {
+            if (howmany == max_batch && full_plan)
+            {
+                return full_plan;
+            }
+            const int size = static_cast<int>(n);
+            PlanKey key(TransformKind::C2R, 1, &size, flags);
+            key.howmany = static_cast<int>(howmany);
+            key.idist = static_cast<int>(bin_count);
+            key.odist = static_cast<int>(n);
+            key.alignment = static_cast<int>(buffer_alignment);
+            key.normalize();
+            return PlanCache<T>::get(key);
+        }
+
+        // Squared window summed at offsets start, start + step, ... over
+        // at most `count` frames.
+        T envelope(std::size_t start, std::size_t count) const
+        {
+            T sum = T(0);
+            for (std::size_t m = 0, pos = start; m < count && pos < n; ++m, pos += step)
+            {
+                sum += window[pos] * window[pos];
+            }
+            return sum;
+        }
+
+        // Folds FFTW's unnormalised c2r (a factor n) into the division.
+        T scale(T sum) const
+        {
+            return sum > std::numeric_limits<T>::epsilon() ? T(1) / (static_cast<T>(n) * sum) : T(0);
+        }
+
+        void overlap_add(const T *frame, T *out)
+        {
+            T *acc = overlap.data();
+            const T *w = window.data();
+            for (std::size_t k = 0; k < n; ++k)
+            {
+                acc[k] += frame[k] * w[k];
+            }
+            ++seen;
+            if (seen >= warm)
+            {
+                const T *g = gain.data();
+                for (std::size_t j = 0; j < step; ++j)
+                {
+                    out[j] = acc[j] * g[j];
+                }
+            }
+            else
+            {
+                for (std::size_t j = 0; j < step; ++j)
+                {
+                    out[j] = acc[j] * scale(envelope(j, seen));
+                }
+            }
+            std::memmove(acc, acc + step, (n - step) * sizeof(T));
+            std::fill(acc + n - step, acc + n, T(0));
+        }
+
+        std::size_t push(const std::complex<T> *in, std::size_t frame_count, T *out)
+        {
+            for (std::size_t done = 0; done < frame_count;)
+            {
+                const std::size_t batch = std::min(max_batch, frame_count - done);
+                const std::shared_ptr<wrapper_type> wrapper = plan(batch);
+                if (!wrapper || wrapper->plan == nullptr)
+                {
+                    return done * step;
+                }
+                std::memcpy(static_cast<void *>(spectra.data()), in + done * bin_count,
+                            batch * bin_count * sizeof(std::complex<T>));
+                complex_type *src = reinterpret_cast<complex_type *>(spectra.data());
+                T *dst = frames.data();
+                wrapper->run_concurrent([&](typename traits::plan_type p)
+                                        { traits::execute_dft_c2r(p, src, dst); });
+                for (std::size_t f = 0; f < batch; ++f)
+                {
+                    overlap_add(frames.data() + f * n, out + (done + f) * step);
+                }
+                done += batch;
+            }
+            return frame_count * step;
+        }
+
+        std::size_t flush(T *out)
+        {
+            std::size_t written = 0;
+            if (seen > 0)
+            {
+                // Sample j of the tail sits at offset j + step of the last frame.
+                written = n - step;
+                for (std::size_t j = 0; j < written; ++j)
+                {
+                    out[j] = overlap[j] * scale(envelope(j + step, seen));
+                }
+            }
+            reset();
+            return written;
+        }
+
+        void reset()
+        {
+            std::fill(overlap.data(), overlap.data() + n, T(0));
+            seen = 0;
+        }
+    };
+
+    template <typename T>
+    ISTFT<T>::ISTFT(const std::vector<T> &window, std::size_t hop, std::size_t max_batch, fft_flags flags)
+    {
+        const std::size_t n = window.size();
+        if (n == 0 || hop == 0 || hop > n || n > static_cast<std::size_t>(std::numeric_limits<int>::max()))
+        {
+            return;
+        }
+        std::unique_ptr<Impl> state(new Impl());
+        state->n = n;
+        state->step = hop;
+        state->bin_count = n / 2 + 1;
+        state->max_batch = std::max<std::size_t>(1, max_batch);
+        state->warm = (n + hop - 1) / hop;
+        state->flags = flags;
+        state->window = AlignedBuffer<T>::uninitialized(n);
+        std::copy(window.begin(), window.end(), state->window.data());
+        state->gain = AlignedBuffer<T>::uninitialized(hop);
+        for (std::size_t j = 0; j < hop; ++j)
+        {
+            state->gain[j] = state->scale(state->envelope(j, state->warm));
+        }
+        state->spectra = AlignedBuffer<std::complex<T>>(state->max_batch * state->bin_count);
+        state->frames = AlignedBuffer<T>(state->max_batch * n);
+        state->overlap = AlignedBuffer<T>(n);
+        state->seen = 0;
+        state->full_plan = state->plan(state->max_batch);
+        if (!state->full_plan || state->full_plan->plan == nullptr)
+        {
+            return;
+        }
+        impl = std::move(state);
+    }
+
+    template <typename T>
+    ISTFT<T>::ISTFT() = default;
+
+    template <typename T>
+    ISTFT<T>::~ISTFT() = default;
+
+    template <typename T>
+    ISTFT<T>::ISTFT(ISTFT &&other) = default;
+
+    template <typename T>
+    ISTFT<T> &ISTFT<T>::operator=(ISTFT &&other) = default;
+
+    template <typename T>
+    bool ISTFT<T>::valid() const
+    {
+        return impl != nullptr;
+    }
+
+    template <typename T>
+    std::size_t ISTFT<T>::frame_size() const
+    {
+        return impl ? impl->n : 0;
+    }
+
+    template <typename T>
+    std::size_t ISTFT<T>::hop() const
+    {
+        return impl ? impl->step : 0;
+    }
+
+    template <typename T>
+    std::size_t ISTFT<T>::bins() const
+    {
+        return impl ? impl->bin_count : 0;
+    }
+
+    template <typename T>
+    std::size_t ISTFT<T>::push(const std::complex<T> *frames, std::size_t frame_count, T *out)
+    {
+        if (!impl || (frame_count > 0 && (frames == nullptr || out == nullptr)))
+        {
+            return 0;
+        }
+        return impl->push(frames, frame_count, out);
+    }
+
+    template <typename T>
+    std::size_t ISTFT<T>::push(const std::vector<std::complex<T>> &frames, std::vector<T> &out)
+    {
+        if (!impl)
+        {
+            return 0;
+        }
+        const std::size_t frame_count = frames.size() / impl->bin_count;
+        const std::size_t old_size = out.size();
+        out.resize(old_size + frame_count * impl->step);
+        const std::size_t written = impl->push(frames.data(), frame_count, out.data() + old_size);
+        out.resize(old_size + written);
+        return written;
+    }
+
+    template <typename T>
+    std::size_t ISTFT<T>::flush(T *out)
+    {
+        return impl ? impl->flush(out) : 0;
+    }
+
+    template <typename T>
+    std::size_t ISTFT<T>::flush(std::vector<T> &out)
+    {
+        if (!impl)
+        {
+            return 0;
+        }
+        const std::size_t old_size = out.size();
+        out.resize(old_size + impl->n - impl->step);
+        const std::size_t written = impl->flush(out.data() + old_size);
+        out.resize(old_size + written);
+        return written;
+    }
+
+    template <typename T>
+    void ISTFT<T>::reset()
+    {
+        if (impl)
+        {
+            impl->reset();
+        }
+    }
+
+    // Explicit instantiations
+    template std::vector<float> hann_window<float>(std::size_t);
+    template std::vector<double> hann_window<double>(std::size_t);
+    template std::vector<long double> hann_window<long double>(std::size_t);
+
+    template class STFT<float>;
+    template class STFT<double>;
+    template class STFT<long double>;
+
+    template class ISTFT<float>;
+    template class ISTFT<double>;
+    template class ISTFT<long double>;
+
+} // namespace clapfft
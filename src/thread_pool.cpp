@@ -0,0 +1,277 @@
+#include <clapfft/thread_pool.hpp>
+#include <clapfft/numa.hpp>
+#include <algorithm>
+
+namespace clapfft
+{
+    struct ThreadPool::Batch
+    {
+        const Task *task;
+        std::atomic<std::size_t> pending; // ranges not finished yet
+        std::mutex mutex;
+        std::condition_variable done;
+
+        Batch(const Task *t, std::size_t ranges) : task(t), pending(ranges) {}
+    };
+
+    ThreadPool::ThreadPool(unsigned thread_count, bool pin_to_nodes) : queued(0), stopping(false)
+    {
+        if (thread_count == 0)
+        {
+            thread_count = std::thread::hardware_concurrency();
+            if (thread_count == 0)
+            {
+                thread_count = 1;
+            }
+        }
+        const NumaTopology &topology = NumaTopology::system();
+        const std::vector<NumaNode> &nodes = topology.nodes();
+        for (unsigned i = 0; i < thread_count; ++i)
+        {
+            queues.push_back(std::unique_ptr<Queue>(new Queue()));
+            const bool pinned = pin_to_nodes && i + 1 < thread_count;
+            const int node = pinned ? nodes[i % nodes.size()].id : -1;
+            worker_node.push_back(node);
+            if (pinned)
+            {
+                const std::size_t k = std::find(node_ids.begin(), node_ids.end(), node) - node_ids.begin();
+                if (k == node_ids.size())
+                {
+                    node_ids.push_back(node);
+                    node_workers.push_back(std::vector<unsigned>());
+                }
+                node_workers[k].push_back(i);
+            }
+        }
+        for (unsigned i = 0; i < thread_count; ++i)
+        {
+            std::vector<unsigned> order;
+            for (unsigned k = 1; k < thread_count; ++k)
+            {
+                order.push_back((i + k) % thread_count);
+            }
+            const int own = worker_node[i];
+            std::stable_partition(order.begin(), order.end(), [&](unsigned other)
+                                  { return own >= 0 && worker_node[other] == own; });
+            steal_order.push_back(order);
+        }
+
+        threads.reserve(thread_count - 1);
+        for (unsigned i = 0; i + 1 < thread_count; ++i)
+        {
+            const std::vector<int> *cpus = pin_to_nodes ? &nodes[i % nodes.size()].cpus : nullptr;
+            threads.emplace_back([this, i, cpus]()
+                                 { worker_loop(i, cpus); });
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::size_t i = 0; i < threads.size(); ++i)
+        {
+            threads[i].join();
+        }
+    }
+
+    unsigned ThreadPool::size() const
+    {
+        return static_cast<unsigned>(queues.size());
+    }
+
+    std::size_t ThreadPool::pinned_nodes() const
+    {
+        return node_ids.size();
+    }
+
+    int ThreadPool::node_of(unsigned worker) const
+    {
+        return worker < worker_node.size() ? worker_node[worker] : -1;
+    }
+
+    ThreadPool &ThreadPool::global()
+    {
+        static ThreadPool pool(0, NumaTopology::system().node_count() > 1);
+        return pool;
+    }
+
+    bool ThreadPool::pop(unsigned worker, Range &range)
+    {
+        Queue &q = *queues[worker];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.ranges.empty())
+        {
+            return false;
+        }
+        range = q.ranges.back();
+        q.ranges.pop_back();
+        queued.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool ThreadPool::steal(unsigned thief, Range &range)
+    {
+        const std::vector<unsigned> &order = steal_order[thief];
+        for (std::size_t k = 0; k < order.size(); ++k)
+        {
+            Queue &q = *queues[order[k]];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (!q.ranges.empty())
+            {
+                range = q.ranges.front();
+                q.ranges.pop_front();
+                queued.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void ThreadPool::run_range(const Range &range, unsigned worker)
+    {
+        Batch &batch = *range.batch;
+        for (std::size_t i = range.begin; i < range.end; ++i)
+        {
+            (*batch.task)(i, worker);
+        }
+        // The submitter only returns after observing pending == 0 under the
+        // batch mutex, so the batch cannot go away while we still touch it.
+        std::lock_guard<std::mutex> lock(batch.mutex);
+        if (batch.pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            batch.done.notify_all();
+        }
+    }
+
+    void ThreadPool::worker_loop(unsigned worker, const std::vector<int> *cpus)
+    {
+        // Pin before touching any memory, so per-thread scratch (allocated
+        // on first use) lands on this node.
+        if (cpus != nullptr)
+        {
+            NumaTopology::pin_current_thread(*cpus);
+        }
+        for (;;)
+        {
+            Range range;
+            if (pop(worker, range) || steal(worker, range))
+            {
+                run_range(range, worker);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(wake_mutex);
+            wake.wait(lock, [this]()
+                      { return stopping || queued.load(std::memory_order_relaxed) > 0; });
+            if (stopping && queued.load(std::memory_order_relaxed) == 0)
+            {
+                return;
+            }
+        }
+    }
+
+    void ThreadPool::parallel_for(std::size_t count, const Task &task, std::size_t grain)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+        const std::size_t slots = queues.size();
+        const unsigned self = static_cast<unsigned>(slots - 1);
+        if (grain == 0)
+        {
+            grain = count / (slots * 4);
+            if (grain == 0)
+            {
+                grain = 1;
+            }
+        }
+        if (threads.empty() || count <= grain)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                task(i, self);
+            }
+            return;
+        }
+
+        const std::size_t ranges = (count + grain - 1) / grain;
+        Batch batch(&task, ranges);
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex);
+            queued.fetch_add(ranges, std::memory_order_relaxed);
+        }
+        for (std::size_t r = 0; r < ranges; ++r)
+        {
+            Range range;
+            range.batch = &batch;
+            range.begin = r * grain;
+            range.end = range.begin + grain < count ? range.begin + grain : count;
+            Queue &q = *queues[r % slots];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            q.ranges.push_back(range);
+        }
+        wake.notify_all();
+        finish(batch, self);
+    }
+
+    void ThreadPool::parallel_for_by_node(std::size_t count, const Task &task, const std::vector<int> &nodes)
+    {
+        if (threads.empty() || node_ids.size() < 2 || nodes.size() < count)
+        {
+            parallel_for(count, task, 1);
+            return;
+        }
+        if (count == 0)
+        {
+            return;
+        }
+        const std::size_t slots = queues.size();
+        const unsigned self = static_cast<unsigned>(slots - 1);
+        Batch batch(&task, count);
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex);
+            queued.fetch_add(count, std::memory_order_relaxed);
+        }
+        std::vector<std::size_t> cursor(node_ids.size(), 0);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            std::size_t target = i % slots;
+            const std::size_t k = std::find(node_ids.begin(), node_ids.end(), nodes[i]) - node_ids.begin();
+            if (k < node_ids.size())
+            {
+                target = node_workers[k][cursor[k]++ % node_workers[k].size()];
+            }
+            Range range;
+            range.batch = &batch;
+            range.begin = i;
+            range.end = i + 1;
+            Queue &q = *queues[target];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            q.ranges.push_back(range);
+        }
+        wake.notify_all();
+        finish(batch, self);
+    }
+
+    void ThreadPool::finish(Batch &batch, unsigned self)
+    {
+        for (;;)
+        {
+            Range range;
+            if (pop(self, range) || steal(self, range))
+            {
+                run_range(range, self);
+                continue;
+            }
+            // Everything left of this batch is already running elsewhere.
+            std::unique_lock<std::mutex> lock(batch.mutex);
+            batch.done.wait(lock, [&batch]()
+                            { return batch.pending.load(std::memory_order_acquire) == 0; });
+            return;
+        }
+    }
+} // namespace clapfft
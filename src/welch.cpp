@@ -0,0 +1,389 @@
+#include <clapfft/welch.hpp>
+#include <fftw3.h>
+#include <clapfft/aligned_buffer.hpp>
+#include <clapfft/complex_ops.hpp>
+#include <clapfft/fft_traits.hpp>
+#include <clapfft/fft_plan_cache.hpp>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <type_traits>
+
+namespace clapfft
+{
+    template <typename T>
+    struct Welch<T>::Impl
+    {
+        using traits = fft_trait<T>;
+        using complex_type = typename traits::complex_type;
+        using wrapper_type = typename PlanCache<T>::Wrapper;
+        // Hours of segments would swamp a float running sum.
+        using accum_type = typename std::common_type<T, double>::type;
+
+        std::size_t nchan;
+        std::size_t n;
+        std::size_t step;
+        std::size_t bin_count;
+        std::size_t max_batch;
+        bool detrend;
+        fft_flags flags;
+        double scale;                              // scaling / segments comes on top
+        AlignedBuffer<T> window;
+        AlignedBuffer<T> frames;                   // max_batch x n, windowed
+        AlignedBuffer<std::complex<T>> spectra;    // max_batch x bin_count
+        AlignedBuffer<T> batch_power;              // nchan x bin_count, this batch's |X|^2
+        std::vector<accum_type> total;             // nchan x bin_count
+        std::vector<std::size_t> slot_channel;     // channel of each staged frame
+        std::shared_ptr<wrapper_type> full_plan;   // howmany = max_batch
+        std::vector<std::vector<T>> history;       // per channel, from the next segment's start on
+        std::size_t staged;
+        std::size_t count;                         // segments per channel so far
+        T sample_rate;
+
+        std::shared_ptr<wrapper_type> plan(std::size_t howmany) const
+        {
+            if (howmany == max_batch && full_plan)
+            {
+                return full_plan;
+            }
+            const int size = static_cast<int>(n);
+            PlanKey key(TransformKind::R2C, 1, &size, flags);
+            key.howmany = static_cast<int>(howmany);
+            key.idist = static_cast<int>(n);
+            key.odist = static_cast<int>(bin_count);
+            key.alignment = static_cast<int>(buffer_alignment);
+            key.normalize();
+            return PlanCache<T>::get(key);
+        }
+
+        // Segment `start` of channel c's history + samples, detrended and
+        // windowed, into `dst`; the segment lies within the two.
+        void gather(std::size_t c, std::size_t start, const T *samples, T *dst) const
+        {
+            const std::vector<T> &kept = history[c];
+            std::size_t k = 0;
+            if (start < kept.size())
+            {
+                const std::size_t m = std::min(n, kept.size() - start);
+                std::copy(kept.begin() + static_cast<std::ptrdiff_t>(start),
+                          kept.begin() + static_cast<std::ptrdiff_t>(start + m), dst);
+                k = m;
+            }
+            std::copy(samples + (start + k - kept.size()), samples + (start + n - kept.size()), dst + k);
+
+            T mean = T(0);
+            if (detrend)
+            {
+                accum_type sum = 0;
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    sum += dst[i];
+                }
+                mean = static_cast<T>(sum / static_cast<accum_type>(n));
+            }
+            const T *w = window.data();
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                dst[i] = (dst[i] - mean) * w[i];
+            }
+        }
+
+        // Transforms the staged frames and folds their power into the
+        // running totals.
+        bool flush()
+        {
+            if (staged == 0)
+            {
+                return true;
+            }
+            const std::shared_ptr<wrapper_type> wrapper = plan(staged);
+            if (!wrapper || wrapper->plan == nullptr)
+            {
+                return false;
+            }
+            T *src = frames.data();
+            complex_type *dst = reinterpret_cast<complex_type *>(spectra.data());
+            wrapper->run_concurrent([&](typename traits::plan_type p)
+                                    { traits::execute_dft_r2c(p, src, dst); });
+
+            std::fill(batch_power.data(), batch_power.data() + nchan * bin_count, T(0));
+            for (std::size_t f = 0; f < staged; ++f)
+            {
+                ComplexOps::norm_add(spectra.data() + f * bin_count, batch_power.data() + slot_channel[f] * bin_count,
+                                     bin_count);
+            }
+            for (std::size_t i = 0; i < nchan * bin_count; ++i)
+            {
+                total[i] += batch_power[i];
+            }
+            staged = 0;
+            return true;
+        }
+
+        std::size_t ready(std::size_t samples) const
+        {
+            const std::size_t available = history[0].size() + samples;
+            return available < n ? 0 : (available - n) / step + 1;
+        }
+
+        std::size_t push(const T *const *in, std::size_t samples)
+        {
+            const std::size_t segment_count = ready(samples);
+            for (std::size_t s = 0; s < segment_count; ++s)
+            {
+                for (std::size_t c = 0; c < nchan; ++c)
+                {
+                    gather(c, s * step, in[c], frames.data() + staged * n);
+                    slot_channel[staged] = c;
+                    if (++staged == max_batch && !flush())
+                    {
+                        return 0;
+                    }
+                }
+            }
+            if (!flush())
+            {
+                return 0;
+            }
+            count += segment_count;
+
+            // Keep what the next segment needs; that is always under n
+            // samples.
+            const std::size_t consumed = segment_count * step;
+            for (std::size_t c = 0; c < nchan; ++c)
+            {
+                std::vector<T> &kept = history[c];
+                if (consumed <= kept.size())
+                {
+                    kept.erase(kept.begin(), kept.begin() + static_cast<std::ptrdiff_t>(consumed));
+                    kept.insert(kept.end(), in[c], in[c] + samples);
+                }
+                else
+                {
+                    kept.assign(in[c] + (consumed - kept.size()), in[c] + samples);
+                }
+            }
+            return segment_count;
+        }
+
+        void psd(T *out) const
+        {
+            const accum_type norm = count > 0 ? static_cast<accum_type>(scale) / static_cast<accum_type>(count) : 0;
+            const std::size_t doubled = (n - 1) / 2;
+            for (std::size_t c = 0; c < nchan; ++c)
+            {
+                for (std::size_t k = 0; k < bin_count; ++k)
+                {
+                    const accum_type factor = k >= 1 && k <= doubled ? 2 * norm : norm;
+                    out[c * bin_count + k] = static_cast<T>(total[c * bin_count + k] * factor);
+                }
+            }
+        }
+
+        void reset()
+        {
+            for (std::size_t c = 0; c < nchan; ++c)
+            {
+                history[c].clear();
+            }
+            std::fill(total.begin(), total.end(), accum_type(0));
+            staged = 0;
+            count = 0;
+        }
+    };
+
+    template <typename T>
+    Welch<T>::Welch(std::size_t channels, const std::vector<T> &window, double sample_rate,
+                    const WelchOptions &options)
+    {
+        const std::size_t n = window.size();
+        const std::size_t hop = options.hop == 0 ? std::max<std::size_t>(1, n / 2) : options.hop;
+        if (channels == 0 || n == 0 || hop > n || !(sample_rate > 0.0) ||
+            n > static_cast<std::size_t>(std::numeric_limits<int>::max()))
+        {
+            return;
+        }
+        long double sum = 0, squares = 0;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            sum += window[i];
+            squares += static_cast<long double>(window[i]) * window[i];
+        }
+        if (squares == 0)
+        {
+            return;
+        }
+
+        std::unique_ptr<Impl> state(new Impl());
+        state->nchan = channels;
+        state->n = n;
+        state->step = hop;
+        state->bin_count = n / 2 + 1;
+        state->max_batch = std::max<std::size_t>(1, options.max_batch);
+        state->detrend = options.detrend;
+        state->flags = options.flags;
+        state->scale = static_cast<double>(options.scaling == PsdScaling::Density
+                                               ? 1.0L / (static_cast<long double>(sample_rate) * squares)
+                                               : 1.0L / (sum * sum));
+        state->sample_rate = static_cast<T>(sample_rate);
+        state->window = AlignedBuffer<T>::uninitialized(n);
+        std::copy(window.begin(), window.end(), state->window.data());
+        state->frames = AlignedBuffer<T>(state->max_batch * n);
+        state->spectra = AlignedBuffer<std::complex<T>>(state->max_batch * state->bin_count);
+        state->batch_power = AlignedBuffer<T>(channels * state->bin_count);
+        state->total.assign(channels * state->bin_count, 0);
+        state->slot_channel.assign(state->max_batch, 0);
+        state->history.assign(channels, std::vector<T>());
+        for (std::size_t c = 0; c < channels; ++c)
+        {
+            state->history[c].reserve(n);
+        }
+        state->staged = 0;
+        state->count = 0;
+        state->full_plan = state->plan(state->max_batch);
+        if (!state->full_plan || state->full_plan->plan == nullptr)
+        {
+            return;
+        }
+        impl = std::move(state);
+    }
+
+    template <typename T>
+    Welch<T>::Welch() = default;
+
+    template <typename T>
+    Welch<T>::~Welch() = default;
+
+    template <typename T>
+    Welch<T>::Welch(Welch &&other) = default;
+
+    template <typename T>
+    Welch<T> &Welch<T>::operator=(Welch &&other) = default;
+
+    template <typename T>
+    bool Welch<T>::valid() const
+    {
+        return impl != nullptr;
+    }
+
+    template <typename T>
+    std::size_t Welch<T>::channels() const
+    {
+        return impl ? impl->nchan : 0;
+    }
+
+    template <typename T>
+    std::size_t Welch<T>::segment_size() const
+    {
+        return impl ? impl->n : 0;
+    }
+
+    template <typename T>
+    std::size_t Welch<T>::hop() const
+    {
+        return impl ? impl->step : 0;
+    }
+
+    template <typename T>
+    std::size_t Welch<T>::bins() const
+    {
+        return impl ? impl->bin_count : 0;
+    }
+
+    template <typename T>
+    std::size_t Welch<T>::segments() const
+    {
+        return impl ? impl->count : 0;
+    }
+
+    template <typename T>
+    std::size_t Welch<T>::push(const T *const *in, std::size_t count)
+    {
+        if (!impl || count == 0 || in == nullptr)
+        {
+            return 0;
+        }
+        for (std::size_t c = 0; c < impl->nchan; ++c)
+        {
+            if (in[c] == nullptr)
+            {
+                return 0;
+            }
+        }
+        return impl->push(in, count);
+    }
+
+    template <typename T>
+    std::size_t Welch<T>::push(const T *in, std::size_t count)
+    {
+        if (!impl || impl->nchan != 1)
+        {
+            return 0;
+        }
+        return push(&in, count);
+    }
+
+    template <typename T>
+    std::size_t Welch<T>::psd(T *out) const
+    {
+        if (!impl || out == nullptr)
+        {
+            return 0;
+        }
+        impl->psd(out);
+        return impl->count;
+    }
+
+    template <typename T>
+    std::vector<T> Welch<T>::frequencies() const
+    {
+        std::vector<T> f;
+        if (impl)
+        {
+            f.resize(impl->bin_count);
+            for (std::size_t k = 0; k < impl->bin_count; ++k)
+            {
+                f[k] = static_cast<T>(k) * impl->sample_rate / static_cast<T>(impl->n);
+            }
+        }
+        return f;
+    }
+
+    template <typename T>
+    void Welch<T>::reset()
+    {
+        if (impl)
+        {
+            impl->reset();
+        }
+    }
+
+    template <typename T>
+    std::vector<T> welch(const std::vector<T> &x, const std::vector<T> &window, double sample_rate,
+                         const WelchOptions &options)
+    {
+        Welch<T> estimator(1, window, sample_rate, options);
+        if (!estimator.valid() || estimator.push(x.data(), x.size()) == 0)
+        {
+            return std::vector<T>();
+        }
+        std::vector<T> result(estimator.bins());
+        estimator.psd(result.data());
+        return result;
+    }
+
+    // Explicit instantiations
+    template class Welch<float>;
+    template class Welch<double>;
+    template class Welch<long double>;
+
+    template std::vector<float> welch<float>(const std::vector<float> &, const std::vector<float> &, double,
+                                             const WelchOptions &);
+    template std::vector<double> welch<double>(const std::vector<double> &, const std::vector<double> &, double,
+                                               const WelchOptions &);
+    template std::vector<long double> welch<long double>(const std::vector<long double> &,
+                                                         const std::vector<long double> &, double,
+                                                         const WelchOptions &);
+
+} // namespace clapfft
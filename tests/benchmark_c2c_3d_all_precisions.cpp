@@ -1,5 +1,6 @@
 #include <fftw3.h>
 #include <clapfft/clapfft_api.hpp>
+#include <clapfft/fft_plan_cache.hpp>
 
 #include <algorithm>
 #include <chrono>
@@ -10,6 +11,7 @@
 #include <iostream>
 #include <random>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace
@@ -21,6 +23,7 @@ namespace
         int n2 = 32;
         int warmup = 3;
         int iters = 50;
+        int max_threads = 1;
     };
 
     BenchmarkConfig parse_args(int argc, char **argv)
@@ -36,9 +39,23 @@ namespace
             cfg.iters = std::max(1, std::atoi(argv[4]));
         if (argc > 5)
             cfg.warmup = std::max(0, std::atoi(argv[5]));
+        const int hw = static_cast<int>(std::thread::hardware_concurrency());
+        cfg.max_threads = hw > 0 ? hw : 1;
+        if (argc > 6)
+            cfg.max_threads = std::max(1, std::atoi(argv[6]));
         return cfg;
     }
 
+    // 1, 2, 4, ... up to and including max_threads.
+    std::vector<int> thread_counts(const BenchmarkConfig &cfg)
+    {
+        std::vector<int> counts;
+        for (int t = 1; t < cfg.max_threads; t *= 2)
+            counts.push_back(t);
+        counts.push_back(cfg.max_threads);
+        return counts;
+    }
+
     template <typename T>
     struct FFTWTraits;
 
@@ -199,7 +216,8 @@ namespace
     }
 
     template <typename T>
-    double benchmark_clapfft(const std::vector<std::complex<T>> &input, const BenchmarkConfig &cfg, std::vector<std::complex<T>> &normalized_out)
+    double benchmark_clapfft(const std::vector<std::complex<T>> &input, const BenchmarkConfig &cfg, std::vector<std::complex<T>> &normalized_out,
+                             int nthreads = 1)
     {
         using clock = std::chrono::steady_clock;
 
@@ -209,15 +227,15 @@ namespace
 
         for (int i = 0; i < cfg.warmup; ++i)
         {
-            clapfft::FFT::c2c_3d(nested_input, spectrum, FFTW_FORWARD);
-            clapfft::FFT::c2c_3d(spectrum, recovered, FFTW_BACKWARD);
+            clapfft::FFT::c2c_3d(nested_input, spectrum, FFTW_FORWARD, clapfft::CLAP_FFT_DEFAULT, nthreads);
+            clapfft::FFT::c2c_3d(spectrum, recovered, FFTW_BACKWARD, clapfft::CLAP_FFT_DEFAULT, nthreads);
         }
 
         const auto start = clock::now();
         for (int i = 0; i < cfg.iters; ++i)
         {
-            clapfft::FFT::c2c_3d(nested_input, spectrum, FFTW_FORWARD);
-            clapfft::FFT::c2c_3d(spectrum, recovered, FFTW_BACKWARD);
+            clapfft::FFT::c2c_3d(nested_input, spectrum, FFTW_FORWARD, clapfft::CLAP_FFT_DEFAULT, nthreads);
+            clapfft::FFT::c2c_3d(spectrum, recovered, FFTW_BACKWARD, clapfft::CLAP_FFT_DEFAULT, nthreads);
         }
         const auto end = clock::now();
 
@@ -324,7 +342,24 @@ namespace
         std::cout << std::scientific << std::setprecision(4);
         std::cout << "max |clapfft - fftw| after normalization: " << static_cast<double>(err_cf) << "\n";
         std::cout << "max |clapfft - input| after normalization: " << static_cast<double>(err_ci) << "\n";
-        std::cout << "max |fftw   - input| after normalization: " << static_cast<double>(err_fi) << "\n\n";
+        std::cout << "max |fftw   - input| after normalization: " << static_cast<double>(err_fi) << "\n";
+
+        if (!clapfft::PlanCache<T>::threads_available())
+        {
+            std::cout << "threaded plans: unavailable (built without FFTW threads)\n\n";
+            return;
+        }
+        std::cout << std::fixed << std::setprecision(6);
+        for (int nthreads : thread_counts(cfg))
+        {
+            std::vector<std::complex<T>> threaded_out;
+            const double threaded_ms = nthreads == 1 ? clapfft_ms : benchmark_clapfft(input, cfg, threaded_out, nthreads);
+            const double speedup = threaded_ms > 0.0 ? clapfft_ms / threaded_ms : 0.0;
+            std::cout << "threads=" << nthreads
+                      << " per iter (ms): " << threaded_ms / static_cast<double>(cfg.iters)
+                      << ", speedup vs 1 thread: " << speedup << "x\n";
+        }
+        std::cout << "\n";
     }
 }
 
@@ -334,7 +369,8 @@ int main(int argc, char **argv)
 
     std::cout << "Benchmark: clapfft vs FFTW (c2c 3D, all precisions; forward+backward)\n";
     std::cout << "Dims=" << cfg.n0 << "x" << cfg.n1 << "x" << cfg.n2
-              << ", iterations=" << cfg.iters << ", warmup=" << cfg.warmup << "\n\n";
+              << ", iterations=" << cfg.iters << ", warmup=" << cfg.warmup
+              << ", max threads=" << cfg.max_threads << "\n\n";
 
     run_precision<float>("float", cfg);
     run_precision<double>("double", cfg);
@@ -0,0 +1,152 @@
+#include <fftw3.h>
+#include <clapfft/clapfft_api.hpp>
+#include <clapfft/coalescing_fft.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using Real = double;
+    using Complex = std::complex<Real>;
+
+    struct BenchmarkConfig
+    {
+        int n = 64;
+        int threads = 8;
+        int calls_per_thread = 2000;
+        int max_batch = 16;
+    };
+
+    BenchmarkConfig parse_args(int argc, char **argv)
+    {
+        BenchmarkConfig cfg;
+        if (argc > 1)
+            cfg.n = std::max(2, std::atoi(argv[1]));
+        if (argc > 2)
+            cfg.threads = std::max(1, std::atoi(argv[2]));
+        if (argc > 3)
+            cfg.calls_per_thread = std::max(1, std::atoi(argv[3]));
+        if (argc > 4)
+            cfg.max_batch = std::max(1, std::atoi(argv[4]));
+        return cfg;
+    }
+
+    struct RunResult
+    {
+        double wall_ms = 0.0;
+        double mean_us = 0.0;
+        double p50_us = 0.0;
+        double p99_us = 0.0;
+        double checksum = 0.0;
+    };
+
+    // Every thread issues back-to-back FFT::c2c_1d calls of the same size
+    // and records the latency of each.
+    RunResult run(const BenchmarkConfig &cfg)
+    {
+        using clock = std::chrono::steady_clock;
+        std::vector<std::vector<double>> latencies(static_cast<std::size_t>(cfg.threads));
+        std::vector<double> checksums(static_cast<std::size_t>(cfg.threads), 0.0);
+        std::vector<std::thread> pool;
+
+        const auto start = clock::now();
+        for (int t = 0; t < cfg.threads; ++t)
+        {
+            pool.emplace_back([&, t]()
+                              {
+                std::vector<Complex> in(static_cast<std::size_t>(cfg.n));
+                for (int i = 0; i < cfg.n; ++i)
+                {
+                    in[static_cast<std::size_t>(i)] = Complex(std::cos(0.1 * (i + t)), std::sin(0.2 * i));
+                }
+                std::vector<Complex> out;
+                std::vector<double> &lat = latencies[static_cast<std::size_t>(t)];
+                lat.reserve(static_cast<std::size_t>(cfg.calls_per_thread));
+                for (int c = 0; c < cfg.calls_per_thread; ++c)
+                {
+                    const auto call_start = clock::now();
+                    clapfft::FFT::c2c_1d(in, out, FFTW_FORWARD);
+                    const std::chrono::duration<double, std::micro> call = clock::now() - call_start;
+                    lat.push_back(call.count());
+                    checksums[static_cast<std::size_t>(t)] += out[static_cast<std::size_t>(c % cfg.n)].real();
+                } });
+        }
+        for (std::size_t i = 0; i < pool.size(); ++i)
+        {
+            pool[i].join();
+        }
+        const std::chrono::duration<double, std::milli> wall = clock::now() - start;
+
+        std::vector<double> all;
+        for (std::size_t t = 0; t < latencies.size(); ++t)
+        {
+            all.insert(all.end(), latencies[t].begin(), latencies[t].end());
+        }
+        std::sort(all.begin(), all.end());
+        RunResult r;
+        r.wall_ms = wall.count();
+        for (std::size_t i = 0; i < all.size(); ++i)
+        {
+            r.mean_us += all[i];
+        }
+        r.mean_us /= static_cast<double>(all.size());
+        r.p50_us = all[all.size() / 2];
+        r.p99_us = all[std::min(all.size() - 1, all.size() * 99 / 100)];
+        for (std::size_t t = 0; t < checksums.size(); ++t)
+        {
+            r.checksum += checksums[t];
+        }
+        return r;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const BenchmarkConfig cfg = parse_args(argc, argv);
+    const double total_calls = static_cast<double>(cfg.threads) * static_cast<double>(cfg.calls_per_thread);
+
+    std::cout << "Benchmark: coalesced c2c 1D (double, many threads, same n)\n";
+    std::cout << "N=" << cfg.n << ", threads=" << cfg.threads
+              << ", calls/thread=" << cfg.calls_per_thread
+              << ", max_batch=" << cfg.max_batch << "\n\n";
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "mode,window_us,calls_per_s,mean_latency_us,p50_latency_us,p99_latency_us,avg_batch\n";
+
+    clapfft::CoalescingFFT::set_enabled(false);
+    const RunResult baseline = run(cfg);
+    std::cout << "direct,0," << total_calls / (baseline.wall_ms / 1000.0) << ","
+              << baseline.mean_us << "," << baseline.p50_us << "," << baseline.p99_us << ",1.00\n";
+
+    const long windows[] = {5, 20, 50, 200};
+    for (std::size_t w = 0; w < sizeof(windows) / sizeof(windows[0]); ++w)
+    {
+        clapfft::CoalescingOptions options;
+        options.max_batch = static_cast<std::size_t>(cfg.max_batch);
+        options.window_us = windows[w];
+        clapfft::CoalescingFFT::set_options(options);
+        clapfft::CoalescingFFT::reset_stats();
+        clapfft::CoalescingFFT::set_enabled(true);
+        const RunResult r = run(cfg);
+        clapfft::CoalescingFFT::set_enabled(false);
+
+        std::cout << "coalesced," << windows[w] << "," << total_calls / (r.wall_ms / 1000.0) << ","
+                  << r.mean_us << "," << r.p50_us << "," << r.p99_us << ","
+                  << clapfft::CoalescingFFT::stats().average_batch() << "\n";
+
+        if (std::abs(r.checksum - baseline.checksum) > 1e-6 * std::max(1.0, std::abs(baseline.checksum)))
+        {
+            std::cerr << "Coalesced results differ from direct execution." << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include <fftw3.h>
+#include <clapfft/clapfft_api.hpp>
+#include <clapfft/aligned_buffer.hpp>
+#include <clapfft/nested_copy.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    using Real = double;
+    using Complex = std::complex<Real>;
+    using Volume = std::vector<std::vector<std::vector<Complex>>>;
+
+    struct BenchmarkConfig
+    {
+        int n0 = 128;
+        int n1 = 128;
+        int n2 = 128;
+        int repeats = 10;
+        int threads = 4;
+    };
+
+    BenchmarkConfig parse_args(int argc, char **argv)
+    {
+        BenchmarkConfig cfg;
+        if (argc > 1)
+            cfg.n0 = std::max(1, std::atoi(argv[1]));
+        if (argc > 2)
+            cfg.n1 = std::max(1, std::atoi(argv[2]));
+        if (argc > 3)
+            cfg.n2 = std::max(1, std::atoi(argv[3]));
+        if (argc > 4)
+            cfg.repeats = std::max(1, std::atoi(argv[4]));
+        if (argc > 5)
+            cfg.threads = std::max(1, std::atoi(argv[5]));
+        return cfg;
+    }
+
+    // The element-by-element copies FFT::c2c_3d used before NestedCopy,
+    // including the default-construct-then-overwrite output resize.
+    void legacy_round_trip(const Volume &input, Volume &output, int n0, int n1, int n2)
+    {
+        output.resize(n0, std::vector<std::vector<Complex>>(n1, std::vector<Complex>(n2)));
+        std::vector<Complex> flat(static_cast<std::size_t>(n0) * n1 * n2);
+        for (int i = 0; i < n0; ++i)
+            for (int j = 0; j < n1; ++j)
+                for (int k = 0; k < n2; ++k)
+                    flat[(static_cast<std::size_t>(i) * n1 + j) * n2 + k] = input[i][j][k];
+        for (int i = 0; i < n0; ++i)
+            for (int j = 0; j < n1; ++j)
+                for (int k = 0; k < n2; ++k)
+                    output[i][j][k] = flat[(static_cast<std::size_t>(i) * n1 + j) * n2 + k];
+    }
+
+    void nested_round_trip(const Volume &input, Volume &output, int n0, int n1, int n2, int threads)
+    {
+        clapfft::AlignedBuffer<Complex> flat =
+            clapfft::AlignedBuffer<Complex>::uninitialized(static_cast<std::size_t>(n0) * n1 * n2);
+        clapfft::NestedCopy::flatten(input, n1, n2, flat.data(), threads);
+        clapfft::NestedCopy::unflatten(flat.data(), n0, n1, n2, output, threads);
+    }
+
+    template <typename Fn>
+    double average_ms(int repeats, Fn fn)
+    {
+        using clock = std::chrono::steady_clock;
+        fn();
+        const auto start = clock::now();
+        for (int r = 0; r < repeats; ++r)
+        {
+            fn();
+        }
+        const std::chrono::duration<double, std::milli> elapsed = clock::now() - start;
+        return elapsed.count() / repeats;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const BenchmarkConfig cfg = parse_args(argc, argv);
+    const double mib = static_cast<double>(cfg.n0) * cfg.n1 * cfg.n2 * sizeof(Complex) / (1024.0 * 1024.0);
+
+    std::cout << "Benchmark: nested-vector flatten/unflatten (complex<double>)\n";
+    std::cout << "Size=" << cfg.n0 << "x" << cfg.n1 << "x" << cfg.n2 << " (" << std::fixed << std::setprecision(1)
+              << mib << " MiB), repeats=" << cfg.repeats << ", threads=" << cfg.threads << "\n\n";
+
+    Volume input(cfg.n0, std::vector<std::vector<Complex>>(cfg.n1, std::vector<Complex>(cfg.n2)));
+    for (int i = 0; i < cfg.n0; ++i)
+        for (int j = 0; j < cfg.n1; ++j)
+            for (int k = 0; k < cfg.n2; ++k)
+                input[i][j][k] = Complex(std::cos(0.01 * (i + j + k)), std::sin(0.02 * k));
+
+    std::cout << std::setprecision(3);
+    std::cout << "mode,round_trip_ms,GiB_per_s\n";
+    const double bytes = 2.0 * mib / 1024.0;
+
+    // Fresh outputs measure the resize path; reused ones the steady state.
+    const double legacy_fresh = average_ms(cfg.repeats, [&]()
+                                           { Volume out; legacy_round_trip(input, out, cfg.n0, cfg.n1, cfg.n2); });
+    std::cout << "legacy_fresh_output," << legacy_fresh << "," << bytes / (legacy_fresh / 1000.0) << "\n";
+    const double nested_fresh = average_ms(cfg.repeats, [&]()
+                                           { Volume out; nested_round_trip(input, out, cfg.n0, cfg.n1, cfg.n2, 1); });
+    std::cout << "nested_fresh_output," << nested_fresh << "," << bytes / (nested_fresh / 1000.0) << "\n";
+
+    Volume reused;
+    const double legacy = average_ms(cfg.repeats, [&]()
+                                     { legacy_round_trip(input, reused, cfg.n0, cfg.n1, cfg.n2); });
+    std::cout << "legacy_reused_output," << legacy << "," << bytes / (legacy / 1000.0) << "\n";
+    const double nested = average_ms(cfg.repeats, [&]()
+                                     { nested_round_trip(input, reused, cfg.n0, cfg.n1, cfg.n2, 1); });
+    std::cout << "nested_reused_output," << nested << "," << bytes / (nested / 1000.0) << "\n";
+    const double threaded = average_ms(cfg.repeats, [&]()
+                                       { nested_round_trip(input, reused, cfg.n0, cfg.n1, cfg.n2, cfg.threads); });
+    std::cout << "nested_reused_output_threads," << threaded << "," << bytes / (threaded / 1000.0) << "\n";
+    if (reused != input)
+    {
+        std::cerr << "Round trip changed the data." << std::endl;
+        return 1;
+    }
+
+    Volume spectrum;
+    const double fft = average_ms(cfg.repeats, [&]()
+                                  { clapfft::FFT::c2c_3d(input, spectrum, FFTW_FORWARD, clapfft::CLAP_FFT_DEFAULT, cfg.threads); });
+    std::cout << "fft_c2c_3d_end_to_end," << fft << ",\n";
+
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include <fftw3.h>
+#include <clapfft/batch_fft.hpp>
 #include <clapfft/clapfft_api.hpp>
 
 #include <algorithm>
@@ -197,6 +198,52 @@ namespace
         return elapsed.count();
     }
 
+    // Same amount of work as `threads` workers running clapfft_worker, but
+    // submitted as BatchFFT batches to a clapfft-owned pool. Jobs go out in
+    // waves so each job of a wave has its own output buffers.
+    double run_pool(int threads, const std::vector<Complex> &input, const BenchmarkConfig &cfg, double &combined_checksum)
+    {
+        using clock = std::chrono::steady_clock;
+
+        clapfft::ThreadPool pool(static_cast<unsigned>(threads));
+        const std::size_t total = static_cast<std::size_t>(threads) * static_cast<std::size_t>(cfg.jobs_per_thread);
+        const std::size_t wave = std::min<std::size_t>(total, static_cast<std::size_t>(threads) * 8);
+
+        std::vector<std::vector<Complex>> spectrum(wave, std::vector<Complex>(static_cast<std::size_t>(cfg.n)));
+        std::vector<std::vector<Complex>> recovered(wave, std::vector<Complex>(static_cast<std::size_t>(cfg.n)));
+        std::vector<clapfft::TransformJob<Real>> forward(wave);
+        std::vector<clapfft::TransformJob<Real>> backward(wave);
+        for (std::size_t j = 0; j < wave; ++j)
+        {
+            forward[j] = clapfft::TransformJob<Real>::c2c(1, &cfg.n, input.data(), spectrum[j].data(), FFTW_FORWARD);
+            backward[j] = clapfft::TransformJob<Real>::c2c(1, &cfg.n, spectrum[j].data(), recovered[j].data(), FFTW_BACKWARD);
+        }
+
+        for (int i = 0; i < cfg.warmup_jobs; ++i)
+        {
+            clapfft::BatchFFT::execute(forward, pool);
+            clapfft::BatchFFT::execute(backward, pool);
+        }
+
+        combined_checksum = 0.0;
+        const auto start = clock::now();
+        for (std::size_t done = 0; done < total; done += wave)
+        {
+            const std::size_t count = std::min(wave, total - done);
+            clapfft::BatchFFT::execute(forward.data(), count, pool);
+            clapfft::BatchFFT::execute(backward.data(), count, pool);
+            for (std::size_t j = 0; j < count; ++j)
+            {
+                normalize(recovered[j], cfg.n);
+                combined_checksum += recovered[j][(done + j) % static_cast<std::size_t>(cfg.n)].real();
+            }
+        }
+        const auto end = clock::now();
+
+        const std::chrono::duration<double, std::milli> elapsed = end - start;
+        return elapsed.count();
+    }
+
     void correctness_check(const std::vector<Complex> &input, int n)
     {
         std::vector<Complex> c_spec;
@@ -266,7 +313,7 @@ int main(int argc, char **argv)
     correctness_check(input, cfg.n);
 
     std::cout << std::fixed << std::setprecision(4);
-    std::cout << "threads,clapfft_ms,fftw_ms,clapfft_jobs_per_s,fftw_jobs_per_s,ratio_clapfft_over_fftw\n";
+    std::cout << "threads,clapfft_ms,fftw_ms,pool_ms,clapfft_jobs_per_s,fftw_jobs_per_s,pool_jobs_per_s,ratio_clapfft_over_fftw,ratio_pool_over_fftw\n";
 
     for (std::size_t i = 0; i < thread_counts.size(); ++i)
     {
@@ -281,16 +328,24 @@ int main(int argc, char **argv)
         const double fftw_ms = run_parallel(threads, fftw_worker, input, cfg, fftw_checksum);
         const double fftw_jobs_per_s = total_jobs / (fftw_ms / 1000.0);
 
+        double pool_checksum = 0.0;
+        const double pool_ms = run_pool(threads, input, cfg, pool_checksum);
+        const double pool_jobs_per_s = total_jobs / (pool_ms / 1000.0);
+
         const double ratio = (fftw_ms > 0.0) ? (clap_ms / fftw_ms) : 0.0;
+        const double pool_ratio = (fftw_ms > 0.0) ? (pool_ms / fftw_ms) : 0.0;
 
         std::cout << threads << ","
                   << clap_ms << ","
                   << fftw_ms << ","
+                  << pool_ms << ","
                   << clap_jobs_per_s << ","
                   << fftw_jobs_per_s << ","
-                  << ratio << "\n";
+                  << pool_jobs_per_s << ","
+                  << ratio << ","
+                  << pool_ratio << "\n";
 
-        if (std::isnan(clap_checksum) || std::isnan(fftw_checksum))
+        if (std::isnan(clap_checksum) || std::isnan(fftw_checksum) || std::isnan(pool_checksum))
         {
             std::cerr << "Unexpected NaN checksum during benchmark." << std::endl;
             return 1;
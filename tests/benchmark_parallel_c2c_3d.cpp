@@ -0,0 +1,185 @@
+#include <fftw3.h>
+#include <clapfft/clapfft_api.hpp>
+#include <clapfft/fft_plan_cache.hpp>
+#include <clapfft/parallel_fft3d.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using Real = double;
+    using Complex = std::complex<Real>;
+    using Volume = std::vector<std::vector<std::vector<Complex>>>;
+
+    struct BenchmarkConfig
+    {
+        int n0 = 64;
+        int n1 = 64;
+        int n2 = 64;
+        int iters = 10;
+        int warmup = 2;
+        int max_threads = 0;
+    };
+
+    BenchmarkConfig parse_args(int argc, char **argv)
+    {
+        BenchmarkConfig cfg;
+        if (argc > 1)
+            cfg.n0 = std::max(2, std::atoi(argv[1]));
+        if (argc > 2)
+            cfg.n1 = std::max(2, std::atoi(argv[2]));
+        if (argc > 3)
+            cfg.n2 = std::max(2, std::atoi(argv[3]));
+        if (argc > 4)
+            cfg.iters = std::max(1, std::atoi(argv[4]));
+        if (argc > 5)
+            cfg.warmup = std::max(0, std::atoi(argv[5]));
+        if (argc > 6)
+            cfg.max_threads = std::max(1, std::atoi(argv[6]));
+        return cfg;
+    }
+
+    std::size_t point_count(const BenchmarkConfig &cfg)
+    {
+        return static_cast<std::size_t>(cfg.n0) * static_cast<std::size_t>(cfg.n1) * static_cast<std::size_t>(cfg.n2);
+    }
+
+    std::vector<Complex> make_input(const BenchmarkConfig &cfg)
+    {
+        std::vector<Complex> input(point_count(cfg));
+        std::mt19937 rng(24680);
+        std::uniform_real_distribution<double> dist(-1.0, 1.0);
+        for (std::size_t i = 0; i < input.size(); ++i)
+        {
+            input[i] = Complex(dist(rng), dist(rng));
+        }
+        return input;
+    }
+
+    Volume to_nested(const std::vector<Complex> &flat, const BenchmarkConfig &cfg)
+    {
+        Volume v(static_cast<std::size_t>(cfg.n0),
+                 std::vector<std::vector<Complex>>(static_cast<std::size_t>(cfg.n1), std::vector<Complex>(static_cast<std::size_t>(cfg.n2))));
+        std::size_t idx = 0;
+        for (int i = 0; i < cfg.n0; ++i)
+            for (int j = 0; j < cfg.n1; ++j)
+                for (int k = 0; k < cfg.n2; ++k)
+                    v[static_cast<std::size_t>(i)][static_cast<std::size_t>(j)][static_cast<std::size_t>(k)] = flat[idx++];
+        return v;
+    }
+
+    std::vector<Complex> flatten(const Volume &v, const BenchmarkConfig &cfg)
+    {
+        std::vector<Complex> flat(point_count(cfg));
+        std::size_t idx = 0;
+        for (int i = 0; i < cfg.n0; ++i)
+            for (int j = 0; j < cfg.n1; ++j)
+                for (int k = 0; k < cfg.n2; ++k)
+                    flat[idx++] = v[static_cast<std::size_t>(i)][static_cast<std::size_t>(j)][static_cast<std::size_t>(k)];
+        return flat;
+    }
+
+    Real max_abs_diff(const std::vector<Complex> &a, const std::vector<Complex> &b)
+    {
+        Real err = 0.0;
+        for (std::size_t i = 0; i < std::min(a.size(), b.size()); ++i)
+        {
+            err = std::max(err, std::abs(a[i] - b[i]));
+        }
+        return err;
+    }
+
+    // FFT::c2c_3d per forward transform, including its nested-vector copies.
+    double time_fft_c2c_3d(const Volume &input, const BenchmarkConfig &cfg, int nthreads, std::vector<Complex> &result)
+    {
+        using clock = std::chrono::steady_clock;
+        Volume out;
+        for (int i = 0; i < cfg.warmup; ++i)
+            clapfft::FFT::c2c_3d(input, out, FFTW_FORWARD, clapfft::CLAP_FFT_DEFAULT, nthreads);
+        const auto start = clock::now();
+        for (int i = 0; i < cfg.iters; ++i)
+            clapfft::FFT::c2c_3d(input, out, FFTW_FORWARD, clapfft::CLAP_FFT_DEFAULT, nthreads);
+        const auto end = clock::now();
+        result = flatten(out, cfg);
+        const std::chrono::duration<double, std::milli> elapsed = end - start;
+        return elapsed.count() / static_cast<double>(cfg.iters);
+    }
+
+    double time_slab_engine(const std::vector<Complex> &input, const BenchmarkConfig &cfg, int threads, std::vector<Complex> &result)
+    {
+        using clock = std::chrono::steady_clock;
+        clapfft::ThreadPool pool(static_cast<unsigned>(threads));
+        clapfft::ParallelFFT3D<Real> engine(cfg.n0, cfg.n1, cfg.n2, FFTW_FORWARD, pool);
+        result.assign(input.size(), Complex());
+        for (int i = 0; i < cfg.warmup; ++i)
+            engine.execute(input.data(), result.data());
+        const auto start = clock::now();
+        for (int i = 0; i < cfg.iters; ++i)
+            engine.execute(input.data(), result.data());
+        const auto end = clock::now();
+        const std::chrono::duration<double, std::milli> elapsed = end - start;
+        return elapsed.count() / static_cast<double>(cfg.iters);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const BenchmarkConfig cfg = parse_args(argc, argv);
+    const std::vector<Complex> input = make_input(cfg);
+    const Volume nested = to_nested(input, cfg);
+
+    const int hw = static_cast<int>(std::thread::hardware_concurrency());
+    const int limit = std::max(1, cfg.max_threads > 0 ? cfg.max_threads : (hw > 0 ? hw : 4));
+    std::vector<int> thread_counts;
+    for (int t = 1; t < limit; t *= 2)
+        thread_counts.push_back(t);
+    thread_counts.push_back(limit);
+
+    std::cout << "Benchmark: parallel c2c 3D (slab engine vs FFT::c2c_3d and FFTW threads, double, forward)\n";
+    std::cout << "Dims=" << cfg.n0 << "x" << cfg.n1 << "x" << cfg.n2
+              << ", iterations=" << cfg.iters << ", warmup=" << cfg.warmup
+              << ", max_threads=" << limit
+              << ", fftw threads " << (clapfft::PlanCache<Real>::threads_available() ? "available" : "unavailable") << "\n\n";
+
+    std::vector<Complex> baseline;
+    const double baseline_ms = time_fft_c2c_3d(nested, cfg, 1, baseline);
+
+    std::cout << std::fixed << std::setprecision(4);
+    std::cout << "single-threaded FFT::c2c_3d per iter (ms): " << baseline_ms << "\n\n";
+    std::cout << "threads,fftw_threads_ms,slab_ms,fftw_threads_speedup,slab_speedup,slab_max_err\n";
+
+    for (std::size_t i = 0; i < thread_counts.size(); ++i)
+    {
+        const int threads = thread_counts[i];
+        std::vector<Complex> fftw_threaded;
+        const double fftw_ms = threads == 1 ? baseline_ms : time_fft_c2c_3d(nested, cfg, threads, fftw_threaded);
+        std::vector<Complex> slab;
+        const double slab_ms = time_slab_engine(input, cfg, threads, slab);
+        const Real err = max_abs_diff(slab, baseline);
+
+        std::cout << threads << ","
+                  << fftw_ms << ","
+                  << slab_ms << ","
+                  << (fftw_ms > 0.0 ? baseline_ms / fftw_ms : 0.0) << ","
+                  << (slab_ms > 0.0 ? baseline_ms / slab_ms : 0.0) << ","
+                  << std::scientific << std::setprecision(3) << static_cast<double>(err)
+                  << std::fixed << std::setprecision(4) << "\n";
+
+        if (std::isnan(err) || err > 1e-6 * static_cast<Real>(point_count(cfg)))
+        {
+            std::cerr << "Slab engine result differs from FFT::c2c_3d." << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
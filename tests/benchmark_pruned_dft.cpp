@@ -0,0 +1,145 @@
+#include <fftw3.h>
+#include <clapfft/clapfft_api.hpp>
+#include <clapfft/pruned_dft.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+    using Real = double;
+
+    struct BenchmarkConfig
+    {
+        int n = 65536;
+        int repeats = 20;
+    };
+
+    BenchmarkConfig parse_args(int argc, char **argv)
+    {
+        BenchmarkConfig cfg;
+        if (argc > 1)
+            cfg.n = std::max(2, std::atoi(argv[1]));
+        if (argc > 2)
+            cfg.repeats = std::max(1, std::atoi(argv[2]));
+        return cfg;
+    }
+
+    // Best of `repeats` calls, in microseconds.
+    template <typename Fn>
+    double best_us(int repeats, Fn fn)
+    {
+        fn();
+        double best = 0.0;
+        for (int r = 0; r < repeats; ++r)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            fn();
+            const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+            best = r == 0 ? elapsed.count() : std::min(best, elapsed.count());
+        }
+        return best;
+    }
+
+    double time_pruned(clapfft::PrunedDFT<Real> &dft, const std::vector<Real> &x, int repeats)
+    {
+        std::vector<std::complex<Real>> out(dft.bins().size());
+        return best_us(repeats, [&]()
+                       { dft.transform(x.data(), out.data()); });
+    }
+
+    const char *name(clapfft::PruningMethod method)
+    {
+        return method == clapfft::PruningMethod::Goertzel ? "goertzel" : "decomposition";
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const BenchmarkConfig cfg = parse_args(argc, argv);
+    const std::size_t n = static_cast<std::size_t>(cfg.n);
+
+    std::cout << "Benchmark: pruned-output real DFT (double), n=" << n << ", best of " << cfg.repeats << "\n\n";
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<Real> dist(-1.0, 1.0);
+    std::vector<Real> x(n);
+    for (std::size_t i = 0; i < n; ++i)
+        x[i] = dist(rng);
+
+    // The reference everything else has to beat: the whole spectrum.
+    std::vector<std::complex<Real>> spectrum;
+    const double r2c_us = best_us(cfg.repeats, [&]()
+                                  { clapfft::FFT::r2c_1d(x, spectrum); });
+    std::cout << "full r2c_1d: " << std::fixed << std::setprecision(1) << r2c_us << " us\n\n";
+
+    std::cout << "bins,goertzel_us,decomposition_us,factor,full_us,auto_method,auto_factor,auto_us,"
+                 "fastest,speedup_vs_r2c,max_abs_error\n";
+    std::size_t goertzel_until = 0, full_from = 0;
+    for (std::size_t count = 1; count <= n / 2; count *= 2)
+    {
+        // Spread over the whole spectrum, as a tone detector would ask.
+        std::vector<std::size_t> bins(count);
+        for (std::size_t i = 0; i < count; ++i)
+            bins[i] = (i * n / count + 11 * i + 1) % n;
+
+        clapfft::PrunedDFT<Real> goertzel(n, bins, clapfft::PruningMethod::Goertzel);
+        clapfft::PrunedDFT<Real> split(n, bins, clapfft::PruningMethod::Decomposition);
+        clapfft::PrunedDFT<Real> full(n, bins, clapfft::PruningMethod::Decomposition, n);
+        clapfft::PrunedDFT<Real> chosen(n, bins);
+        if (!goertzel.valid() || !full.valid() || !chosen.valid())
+        {
+            std::cerr << "Setup failed for " << count << " bins." << std::endl;
+            return 1;
+        }
+
+        // Goertzel is O(bins * n); past a few hundred bins it only slows
+        // the sweep down.
+        const double g_us = count <= 256 ? time_pruned(goertzel, x, cfg.repeats) : -1.0;
+        const double d_us = split.valid() ? time_pruned(split, x, cfg.repeats) : -1.0;
+        const double f_us = time_pruned(full, x, cfg.repeats);
+        const double a_us = time_pruned(chosen, x, cfg.repeats);
+
+        const char *fastest = "full";
+        double best = f_us;
+        if (d_us >= 0.0 && d_us < best && split.factor() != n)
+        {
+            fastest = "decomposition";
+            best = d_us;
+        }
+        if (g_us >= 0.0 && g_us < best)
+        {
+            fastest = "goertzel";
+            best = g_us;
+            goertzel_until = count;
+        }
+        if (full_from == 0 && best == f_us)
+            full_from = count;
+
+        std::vector<std::complex<Real>> out(count);
+        chosen.transform(x.data(), out.data());
+        double worst = 0.0;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const std::size_t k = bins[i];
+            const std::complex<Real> expected = k <= n / 2 ? spectrum[k] : std::conj(spectrum[n - k]);
+            worst = std::max(worst, std::abs(out[i] - expected));
+        }
+
+        std::cout << count << "," << std::setprecision(1) << g_us << "," << d_us << "," << split.factor() << ","
+                  << f_us << "," << name(chosen.method()) << "," << chosen.factor() << "," << a_us << ","
+                  << fastest << "," << std::setprecision(2) << r2c_us / a_us << "," << std::scientific
+                  << std::setprecision(2) << worst << std::fixed << "\n";
+    }
+
+    std::cout << "\nmeasured crossover: goertzel fastest up to " << goertzel_until
+              << " bins, full transform fastest from " << full_from << " bins (0 = never)\n";
+    return 0;
+}
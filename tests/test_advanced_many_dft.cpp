@@ -164,6 +164,57 @@ void run_many_dft_3d_test()
     }
 }
 
+// Ranks above PlanKey::max_rank are planned per call, outside the cache.
+template <typename T>
+void run_many_dft_high_rank_test()
+{
+    const int rank = 9;
+    const int howmany = 2;
+    const T eps = static_cast<T>(1e-4);
+    int dims[rank];
+    int points_per_transform = 1;
+    for (int d = 0; d < rank; ++d)
+    {
+        dims[d] = d == 0 ? 3 : 2;
+        points_per_transform *= dims[d];
+    }
+
+    std::vector<std::complex<T>> input(static_cast<std::size_t>(points_per_transform * howmany));
+    for (std::size_t i = 0; i < input.size(); ++i)
+    {
+        input[i] = std::complex<T>(static_cast<T>(std::cos(0.3 * static_cast<double>(i))), static_cast<T>((i % 7) * 0.25));
+    }
+    std::vector<std::complex<T>> forward(input.size());
+    std::vector<std::complex<T>> recovered(input.size());
+
+    clapfft::AdvancedFFT::many_dft<T>(rank, dims, howmany,
+                                      input.data(), nullptr,
+                                      1, points_per_transform,
+                                      forward.data(), nullptr,
+                                      1, points_per_transform,
+                                      1);
+    clapfft::AdvancedFFT::many_dft<T>(rank, dims, howmany,
+                                      forward.data(), nullptr,
+                                      1, points_per_transform,
+                                      recovered.data(), nullptr,
+                                      1, points_per_transform,
+                                      -1);
+
+    // DC of the first transform is the sum of its inputs.
+    std::complex<T> sum;
+    for (int i = 0; i < points_per_transform; ++i)
+    {
+        sum += input[static_cast<std::size_t>(i)];
+    }
+    assert(std::abs(forward[0] - sum) <= eps * static_cast<T>(points_per_transform));
+    for (std::size_t i = 0; i < recovered.size(); ++i)
+    {
+        recovered[i] /= static_cast<T>(points_per_transform);
+        assert(std::abs(recovered[i].real() - input[i].real()) <= eps);
+        assert(std::abs(recovered[i].imag() - input[i].imag()) <= eps);
+    }
+}
+
 int main()
 {
     run_many_dft_1d_test<float>();
@@ -178,6 +229,9 @@ int main()
     run_many_dft_3d_test<double>();
     run_many_dft_3d_test<long double>();
 
+    run_many_dft_high_rank_test<float>();
+    run_many_dft_high_rank_test<double>();
+
     std::cout << "advanced_many_dft tests passed." << std::endl;
     return 0;
 }
@@ -0,0 +1,120 @@
+#include <fftw3.h>
+#include <clapfft/async_fft.hpp>
+#include <clapfft/clapfft_api.hpp>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <future>
+#include <iostream>
+#include <vector>
+
+void test_submit_and_wait()
+{
+    std::cout << "Testing async submit..." << std::endl;
+    clapfft::AsyncFFT executor(3, 8);
+    assert(executor.size() == 3);
+    assert(executor.capacity() == 8);
+
+    const int n = 64;
+    const int count = 50;
+    std::vector<std::vector<std::complex<double>>> in(count, std::vector<std::complex<double>>(n));
+    std::vector<std::vector<std::complex<double>>> out(count, std::vector<std::complex<double>>(n));
+    std::vector<std::future<bool>> done;
+    for (int j = 0; j < count; ++j)
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            in[j][i] = std::complex<double>(std::cos(0.05 * i * (j + 1)), 0.0);
+        }
+        done.push_back(executor.submit(clapfft::TransformJob<double>::c2c(1, &n, in[j].data(), out[j].data(), FFTW_FORWARD)));
+    }
+    for (int j = 0; j < count; ++j)
+    {
+        const bool ok = done[j].get();
+        assert(ok);
+        (void)ok;
+        std::vector<std::complex<double>> expected;
+        clapfft::FFT::c2c_1d(in[j], expected, FFTW_FORWARD);
+        for (int i = 0; i < n; ++i)
+        {
+            assert(std::abs(expected[i] - out[j][i]) <= 1e-9);
+        }
+    }
+
+    // A malformed job completes with false instead of blocking.
+    std::future<bool> bad = executor.submit(clapfft::TransformJob<double>());
+    const bool bad_ok = bad.get();
+    assert(!bad_ok);
+    (void)bad_ok;
+
+    executor.wait_idle();
+    assert(executor.pending() == 0);
+}
+
+void test_bounded_queue()
+{
+    std::cout << "Testing async back-pressure..." << std::endl;
+    // One worker and room for one queued job: while the worker is busy the
+    // second queued job fills the queue, so some try_submit must fail.
+    clapfft::AsyncFFT executor(1, 1);
+    const int n = 4095;
+    std::vector<std::complex<float>> in(n, std::complex<float>(1.0f, 0.0f));
+    const int attempts = 50;
+    std::vector<std::vector<std::complex<float>>> out(attempts, std::vector<std::complex<float>>(n));
+    std::vector<std::future<bool>> accepted;
+    int rejected = 0;
+    for (int j = 0; j < attempts; ++j)
+    {
+        std::future<bool> f;
+        if (executor.try_submit(clapfft::TransformJob<float>::c2c(1, &n, in.data(), out[j].data(), FFTW_FORWARD), f))
+        {
+            accepted.push_back(std::move(f));
+        }
+        else
+        {
+            ++rejected;
+        }
+    }
+    assert(rejected > 0);
+    assert(!accepted.empty());
+    for (std::size_t j = 0; j < accepted.size(); ++j)
+    {
+        const bool ok = accepted[j].get();
+        assert(ok);
+        (void)ok;
+    }
+    (void)rejected;
+}
+
+void test_destructor_drains_queue()
+{
+    std::cout << "Testing async shutdown..." << std::endl;
+    const int n = 32;
+    std::vector<float> in(n, 1.0f);
+    std::vector<std::vector<std::complex<float>>> out(20, std::vector<std::complex<float>>(n / 2 + 1));
+    std::vector<std::future<bool>> done;
+    {
+        clapfft::AsyncFFT executor(2, 4);
+        for (std::size_t j = 0; j < out.size(); ++j)
+        {
+            done.push_back(executor.submit(clapfft::TransformJob<float>::r2c(1, &n, in.data(), out[j].data())));
+        }
+    }
+    for (std::size_t j = 0; j < done.size(); ++j)
+    {
+        assert(done[j].wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+        const bool ok = done[j].get();
+        assert(ok);
+        assert(std::abs(out[j][0].real() - n) <= 1e-3f);
+        (void)ok;
+    }
+}
+
+int main()
+{
+    test_submit_and_wait();
+    test_bounded_queue();
+    test_destructor_drains_queue();
+    std::cout << "All async FFT tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,306 @@
+#include <fftw3.h>
+#include <clapfft/batch_fft.hpp>
+#include <clapfft/clapfft_api.hpp>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <vector>
+
+void test_parallel_for_covers_range()
+{
+    std::cout << "Testing thread pool parallel_for..." << std::endl;
+    clapfft::ThreadPool pool(4);
+    assert(pool.size() == 4);
+
+    const std::size_t count = 1000;
+    std::vector<std::atomic<int>> hits(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        hits[i].store(0);
+    }
+    std::atomic<int> bad_worker(0);
+    pool.parallel_for(count, [&](std::size_t i, unsigned worker)
+                      {
+        if (worker >= pool.size())
+        {
+            bad_worker.fetch_add(1);
+        }
+        hits[i].fetch_add(1); });
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        assert(hits[i].load() == 1);
+    }
+    assert(bad_worker.load() == 0);
+
+    // Nested submission from inside a task must not deadlock.
+    std::atomic<int> inner(0);
+    pool.parallel_for(8, [&](std::size_t, unsigned)
+                      { pool.parallel_for(16, [&](std::size_t, unsigned)
+                                          { inner.fetch_add(1); }, 1); }, 1);
+    assert(inner.load() == 8 * 16);
+}
+
+void test_mixed_batch()
+{
+    std::cout << "Testing batch of mixed transforms..." << std::endl;
+    clapfft::ThreadPool pool(3);
+    const int sizes[] = {8, 12, 16, 30, 64};
+    const int count = 40;
+
+    std::vector<std::vector<std::complex<double>>> c_in(count);
+    std::vector<std::vector<std::complex<double>>> c_out(count);
+    std::vector<clapfft::TransformJob<double>> jobs;
+    for (int j = 0; j < count; ++j)
+    {
+        const int n = sizes[j % 5];
+        c_in[j].resize(static_cast<std::size_t>(n));
+        for (int i = 0; i < n; ++i)
+        {
+            c_in[j][static_cast<std::size_t>(i)] = std::complex<double>(std::cos(0.1 * (i + j)), std::sin(0.3 * i));
+        }
+        c_out[j].resize(static_cast<std::size_t>(n));
+        jobs.push_back(clapfft::TransformJob<double>::c2c(1, &n, c_in[j].data(), c_out[j].data(), FFTW_FORWARD));
+    }
+
+    // A 2D c2r job whose input must survive.
+    const int dims[2] = {6, 8};
+    std::vector<double> real(48);
+    for (std::size_t i = 0; i < real.size(); ++i)
+    {
+        real[i] = std::sin(0.2 * static_cast<double>(i));
+    }
+    std::vector<std::complex<double>> half(6 * 5);
+    std::vector<double> back(48);
+    clapfft::TransformJob<double> r2c = clapfft::TransformJob<double>::r2c(2, dims, real.data(), half.data());
+    bool ok = clapfft::BatchFFT::execute(&r2c, 1, pool);
+    assert(ok);
+    const std::vector<std::complex<double>> half_copy = half;
+    jobs.push_back(clapfft::TransformJob<double>::c2r(2, dims, half.data(), back.data()));
+
+    // In-place r2r.
+    const int n_r2r = 10;
+    std::vector<double> dct(10, 1.0);
+    const int kind = FFTW_REDFT10;
+    jobs.push_back(clapfft::TransformJob<double>::r2r(1, &n_r2r, dct.data(), dct.data(), &kind));
+
+    ok = clapfft::BatchFFT::execute(jobs, pool);
+    assert(ok);
+
+    for (int j = 0; j < count; ++j)
+    {
+        std::vector<std::complex<double>> expected;
+        clapfft::FFT::c2c_1d(c_in[j], expected, FFTW_FORWARD);
+        for (std::size_t i = 0; i < expected.size(); ++i)
+        {
+            assert(std::abs(expected[i] - c_out[j][i]) <= 1e-9);
+        }
+    }
+    for (std::size_t i = 0; i < half.size(); ++i)
+    {
+        assert(half[i] == half_copy[i]);
+    }
+    for (std::size_t i = 0; i < real.size(); ++i)
+    {
+        assert(std::abs(back[i] / 48.0 - real[i]) <= 1e-9);
+    }
+    assert(std::abs(dct[0] - 20.0) <= 1e-9);
+    assert(std::abs(dct[3]) <= 1e-9);
+    (void)ok;
+}
+
+void test_invalid_jobs()
+{
+    std::cout << "Testing invalid batch jobs..." << std::endl;
+    std::vector<float> in(16, 1.0f);
+    std::vector<std::complex<float>> out(9);
+    const int n = 16;
+    std::vector<clapfft::TransformJob<float>> jobs;
+    jobs.push_back(clapfft::TransformJob<float>::r2c(1, &n, in.data(), out.data()));
+    jobs.push_back(clapfft::TransformJob<float>());
+    jobs.push_back(clapfft::TransformJob<float>::r2c(1, &n, in.data(), reinterpret_cast<std::complex<float> *>(in.data())));
+    const bool ok = clapfft::BatchFFT::execute(jobs);
+    assert(!ok);
+    // The valid job still ran.
+    assert(std::abs(out[0].real() - 16.0f) <= 1e-4f);
+    const bool empty_ok = clapfft::BatchFFT::execute(std::vector<clapfft::TransformJob<float>>());
+    assert(empty_ok);
+    (void)ok;
+    (void)empty_ok;
+}
+
+void test_transform_batch_groups()
+{
+    std::cout << "Testing grouped transform_batch..." << std::endl;
+    clapfft::ThreadPool pool(3);
+
+    // Separately allocated r2c signals of a handful of lengths: packed path.
+    const int lengths[] = {17, 32, 45, 64, 100};
+    const int signals = 60;
+    std::vector<std::vector<float>> r_in(signals);
+    std::vector<std::vector<std::complex<float>>> r_out(signals);
+    std::vector<clapfft::TransformJob<float>> jobs;
+    for (int j = 0; j < signals; ++j)
+    {
+        const int n = lengths[(j * 7) % 5];
+        r_in[j].resize(static_cast<std::size_t>(n));
+        for (int i = 0; i < n; ++i)
+        {
+            r_in[j][static_cast<std::size_t>(i)] = static_cast<float>(std::cos(0.05 * i * (j + 1)));
+        }
+        r_out[j].resize(static_cast<std::size_t>(n / 2 + 1));
+        jobs.push_back(clapfft::TransformJob<float>::r2c(1, &n, r_in[j].data(), r_out[j].data()));
+    }
+    bool ok = clapfft::BatchFFT::transform_batch(jobs, pool);
+    assert(ok);
+    for (int j = 0; j < signals; ++j)
+    {
+        std::vector<std::complex<float>> expected;
+        clapfft::FFT::r2c_1d(r_in[j], expected);
+        assert(expected.size() == r_out[j].size());
+        for (std::size_t i = 0; i < expected.size(); ++i)
+        {
+            assert(std::abs(expected[i] - r_out[j][i]) <= 1e-3f);
+        }
+    }
+
+    // Rows of one matrix, in place and out of place: direct path.
+    const int n = 24;
+    const int rows = 10;
+    std::vector<std::complex<double>> matrix(static_cast<std::size_t>(n * rows));
+    for (std::size_t i = 0; i < matrix.size(); ++i)
+    {
+        matrix[i] = std::complex<double>(std::sin(0.1 * static_cast<double>(i)), 0.25);
+    }
+    const std::vector<std::complex<double>> original = matrix;
+    std::vector<std::complex<double>> spectra(matrix.size());
+    std::vector<clapfft::TransformJob<double>> c_jobs;
+    for (int r = rows - 1; r >= 0; --r)
+    {
+        c_jobs.push_back(clapfft::TransformJob<double>::c2c(1, &n, &matrix[r * n], &spectra[r * n], FFTW_FORWARD));
+    }
+    ok = clapfft::BatchFFT::transform_batch(c_jobs, pool);
+    assert(ok);
+    c_jobs.clear();
+    for (int r = 0; r < rows; ++r)
+    {
+        c_jobs.push_back(clapfft::TransformJob<double>::c2c(1, &n, &matrix[r * n], &matrix[r * n], FFTW_FORWARD));
+    }
+    ok = clapfft::BatchFFT::transform_batch(c_jobs, pool);
+    assert(ok);
+    for (int r = 0; r < rows; ++r)
+    {
+        std::vector<std::complex<double>> row(original.begin() + r * n, original.begin() + (r + 1) * n);
+        std::vector<std::complex<double>> expected;
+        clapfft::FFT::c2c_1d(row, expected, FFTW_FORWARD);
+        for (int i = 0; i < n; ++i)
+        {
+            assert(std::abs(expected[i] - spectra[r * n + i]) <= 1e-9);
+            assert(std::abs(expected[i] - matrix[r * n + i]) <= 1e-9);
+        }
+    }
+
+    // Grouped 2D c2r keeps its inputs; a malformed job fails alone.
+    const int dims[2] = {4, 6};
+    std::vector<std::vector<std::complex<double>>> half(5, std::vector<std::complex<double>>(4 * 4));
+    std::vector<std::vector<double>> real(5, std::vector<double>(24));
+    std::vector<clapfft::TransformJob<double>> c2r_jobs;
+    for (std::size_t j = 0; j < half.size(); ++j)
+    {
+        half[j][0] = std::complex<double>(static_cast<double>(j + 1), 0.0);
+        c2r_jobs.push_back(clapfft::TransformJob<double>::c2r(2, dims, half[j].data(), real[j].data()));
+    }
+    c2r_jobs.push_back(clapfft::TransformJob<double>());
+    ok = clapfft::BatchFFT::transform_batch(c2r_jobs, pool);
+    assert(!ok);
+    for (std::size_t j = 0; j < half.size(); ++j)
+    {
+        assert(half[j][0] == std::complex<double>(static_cast<double>(j + 1), 0.0));
+        for (std::size_t i = 0; i < real[j].size(); ++i)
+        {
+            assert(std::abs(real[j][i] - static_cast<double>(j + 1)) <= 1e-9);
+        }
+    }
+
+    ok = clapfft::BatchFFT::transform_batch(std::vector<clapfft::TransformJob<double>>(), pool);
+    assert(ok);
+    (void)ok;
+}
+
+void test_batched_c2r_job()
+{
+    std::cout << "Testing batched and strided c2r jobs..." << std::endl;
+    clapfft::ThreadPool pool(2);
+    const int n = 16;
+    const int bins = n / 2 + 1;
+    const int howmany = 4;
+    std::vector<double> real(static_cast<std::size_t>(howmany * n));
+    for (std::size_t i = 0; i < real.size(); ++i)
+    {
+        real[i] = std::sin(0.37 * static_cast<double>(i)) + 0.1 * static_cast<double>(i % 5);
+    }
+    std::vector<std::complex<double>> half(static_cast<std::size_t>(howmany * bins));
+    std::vector<clapfft::TransformJob<double>> forward;
+    for (int j = 0; j < howmany; ++j)
+    {
+        forward.push_back(clapfft::TransformJob<double>::r2c(1, &n, real.data() + j * n, half.data() + j * bins));
+    }
+    bool ok = clapfft::BatchFFT::execute(forward, pool);
+    assert(ok);
+    const std::vector<std::complex<double>> half_copy = half;
+
+    // One job covering all four transforms, back to back.
+    clapfft::TransformJob<double> batched = clapfft::TransformJob<double>::c2r(1, &n, half.data(), nullptr);
+    std::vector<double> back(real.size() + 8, 7.0);
+    batched.out = back.data();
+    batched.key.howmany = howmany;
+    batched.key.idist = bins;
+    batched.key.odist = n;
+    ok = clapfft::BatchFFT::execute(&batched, 1, pool);
+    assert(ok);
+
+    // The same spectra interleaved, stride 4 and distance 1.
+    std::vector<std::complex<double>> interleaved(half.size());
+    for (int j = 0; j < howmany; ++j)
+    {
+        for (int k = 0; k < bins; ++k)
+        {
+            interleaved[static_cast<std::size_t>(k * howmany + j)] = half[static_cast<std::size_t>(j * bins + k)];
+        }
+    }
+    const std::vector<std::complex<double>> interleaved_copy = interleaved;
+    clapfft::TransformJob<double> strided = clapfft::TransformJob<double>::c2r(1, &n, interleaved.data(), nullptr);
+    std::vector<double> strided_back(real.size());
+    strided.out = strided_back.data();
+    strided.key.howmany = howmany;
+    strided.key.istride = howmany;
+    strided.key.idist = 1;
+    strided.key.odist = n;
+    ok = clapfft::BatchFFT::execute(&strided, 1, pool);
+    assert(ok);
+
+    for (std::size_t i = 0; i < real.size(); ++i)
+    {
+        assert(std::abs(back[i] / n - real[i]) <= 1e-9);
+        assert(std::abs(strided_back[i] / n - real[i]) <= 1e-9);
+    }
+    // Nothing past the last transform is written, and the inputs survive.
+    for (std::size_t i = real.size(); i < back.size(); ++i)
+    {
+        assert(back[i] == 7.0);
+    }
+    assert(half == half_copy && interleaved == interleaved_copy);
+    (void)ok;
+}
+
+int main()
+{
+    test_parallel_for_covers_range();
+    test_mixed_batch();
+    test_invalid_jobs();
+    test_transform_batch_groups();
+    test_batched_c2r_job();
+    std::cout << "All batch FFT tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,175 @@
+#include <fftw3.h>
+#include <clapfft/channelizer.hpp>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    template <typename T>
+    std::vector<std::complex<T>> make_signal(std::size_t length)
+    {
+        std::vector<std::complex<T>> x(length);
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            const double t = static_cast<double>(i);
+            x[i] = std::complex<T>(static_cast<T>(std::sin(0.11 * t) + 0.3 * std::cos(2.3 * t * t)),
+                                   static_cast<T>(std::cos(0.7 * t) - 0.2 * std::sin(0.05 * t * t)));
+        }
+        return x;
+    }
+
+    // y_k[m] from the definition in Channelizer's header.
+    template <typename T>
+    std::complex<long double> direct(const std::vector<std::complex<T>> &x, const std::vector<T> &h, std::size_t M,
+                                     std::size_t D, std::size_t m, std::size_t k)
+    {
+        const long double two_pi = 6.283185307179586476925286766559L;
+        const std::size_t t = m * D;
+        std::complex<long double> sum;
+        for (std::size_t j = 0; j < h.size() && j <= t; ++j)
+        {
+            const std::size_t index = (k * ((t - j) % M)) % M;
+            const long double angle = -two_pi * static_cast<long double>(index) / static_cast<long double>(M);
+            const std::complex<long double> v(x[t - j].real(), x[t - j].imag());
+            sum += static_cast<long double>(h[j]) * v * std::complex<long double>(std::cos(angle), std::sin(angle));
+        }
+        return sum;
+    }
+
+    template <typename T>
+    void check_against_definition(clapfft::ChannelizerMode mode, long double tolerance)
+    {
+        const std::size_t M = 8, length = 203;
+        // Not a multiple of M, so the padding is exercised too.
+        std::vector<T> h(29);
+        for (std::size_t j = 0; j < h.size(); ++j)
+        {
+            h[j] = static_cast<T>(std::sin(0.4 * static_cast<double>(j) + 0.2) / 8.0);
+        }
+        const std::vector<std::complex<T>> x = make_signal<T>(length);
+
+        clapfft::Channelizer<T> bank(M, h, mode, 3);
+        const std::size_t D = mode == clapfft::ChannelizerMode::Critical ? M : M / 2;
+        assert(bank.valid() && bank.channels() == M && bank.mode() == mode);
+        assert(bank.decimation() == D && bank.taps() == 32);
+
+        // Uneven pushes: single samples, partial batches and several
+        // batches at once.
+        const std::size_t blocks = (length + D - 1) / D;
+        std::vector<std::complex<T>> y(blocks * M);
+        std::size_t pos = 0, produced = 0;
+        const std::size_t chunks[] = {1, 5, 40, 3, 100};
+        for (std::size_t c = 0; pos < length; c = (c + 1) % 5)
+        {
+            const std::size_t count = std::min(chunks[c], length - pos);
+            const std::size_t expected = bank.output_ready(count);
+            const std::size_t got = bank.push(x.data() + pos, count, y.data() + produced * M);
+            assert(got == expected);
+            (void)expected;
+            produced += got;
+            pos += count;
+        }
+        assert(produced == blocks);
+
+        long double worst = 0;
+        for (std::size_t m = 0; m < blocks; ++m)
+        {
+            for (std::size_t k = 0; k < M; ++k)
+            {
+                const std::complex<long double> got(y[m * M + k].real(), y[m * M + k].imag());
+                worst = std::max(worst, std::abs(got - direct(x, h, M, D, m, k)));
+            }
+        }
+        assert(worst <= tolerance);
+
+        // Starting over gives the same first blocks.
+        bank.reset();
+        std::vector<std::complex<T>> again(M * 4);
+        const std::size_t got = bank.push(x.data(), 3 * D + 1, again.data());
+        assert(got == 4);
+        for (std::size_t i = 0; i < again.size(); ++i)
+        {
+            assert(again[i] == y[i]);
+        }
+        (void)got;
+        (void)worst;
+        (void)tolerance;
+    }
+}
+
+void test_against_definition()
+{
+    std::cout << "Testing both modes against the direct filter bank..." << std::endl;
+    check_against_definition<double>(clapfft::ChannelizerMode::Critical, 1e-13L);
+    check_against_definition<double>(clapfft::ChannelizerMode::Oversampled, 1e-13L);
+    check_against_definition<float>(clapfft::ChannelizerMode::Oversampled, 1e-5L);
+    check_against_definition<long double>(clapfft::ChannelizerMode::Critical, 1e-13L);
+}
+
+void test_channel_separation()
+{
+    std::cout << "Testing tone separation with the designed prototype..." << std::endl;
+    const std::size_t M = 64, taps = 12;
+    const std::vector<double> h = clapfft::Channelizer<double>::design_prototype(M, taps);
+    assert(h.size() == M * taps);
+
+    // A real tone at the centre of channel 5 shows up in channels 5 and
+    // M - 5 at half its amplitude, and nowhere else.
+    const std::size_t length = 40 * M * taps;
+    std::vector<double> x(length);
+    for (std::size_t i = 0; i < length; ++i)
+    {
+        x[i] = 2.0 * std::cos(2.0 * M_PI * 5.0 * static_cast<double>(i) / M + 0.4);
+    }
+    const clapfft::ChannelizerMode modes[] = {clapfft::ChannelizerMode::Critical,
+                                              clapfft::ChannelizerMode::Oversampled};
+    for (std::size_t mi = 0; mi < 2; ++mi)
+    {
+        clapfft::Channelizer<double> bank(M, taps, modes[mi]);
+        assert(bank.valid() && bank.taps() == M * taps);
+        std::vector<std::complex<double>> y(bank.output_ready(length) * M);
+        const std::size_t blocks = bank.push(x.data(), length, y.data());
+        assert(blocks == (length + bank.decimation() - 1) / bank.decimation());
+
+        // Past the filter's start-up, compare the last block.
+        const std::complex<double> *last = y.data() + (blocks - 1) * M;
+        for (std::size_t k = 0; k < M; ++k)
+        {
+            const double expected = k == 5 || k == M - 5 ? 1.0 : 0.0;
+            assert(std::fabs(std::abs(last[k]) - expected) <= 1e-3);
+            (void)expected;
+        }
+        (void)last;
+    }
+}
+
+void test_invalid()
+{
+    std::cout << "Testing invalid configurations..." << std::endl;
+    assert(!clapfft::Channelizer<double>(0, std::vector<double>(8, 1.0)).valid());
+    assert(!clapfft::Channelizer<double>(8, std::vector<double>()).valid());
+    assert(!clapfft::Channelizer<double>(8, std::vector<double>(8, 1.0), clapfft::ChannelizerMode::Critical, 0).valid());
+    assert(!clapfft::Channelizer<double>(7, 4, clapfft::ChannelizerMode::Oversampled).valid());
+    assert(!clapfft::Channelizer<double>(8, 0).valid());
+    assert(clapfft::Channelizer<float>::design_prototype(0, 4).empty());
+
+    clapfft::Channelizer<float> none;
+    const float sample = 1.0f;
+    std::complex<float> out;
+    const std::size_t blocks = none.push(&sample, 1, &out);
+    assert(blocks == 0 && none.output_ready(100) == 0);
+    (void)blocks;
+    assert(none.channels() == 0 && none.decimation() == 0 && none.taps() == 0);
+}
+
+int main()
+{
+    test_against_definition();
+    test_channel_separation();
+    test_invalid();
+    std::cout << "All channelizer tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,199 @@
+#include <fftw3.h>
+#include <clapfft/chirp_z.hpp>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // X(f) = sum_j x[j] exp(-2 pi i f j), straight from the definition.
+    template <typename T>
+    std::complex<long double> dtft(const std::vector<T> &x, long double f)
+    {
+        const long double two_pi = 6.283185307179586476925286766559L;
+        std::complex<long double> sum;
+        for (std::size_t j = 0; j < x.size(); ++j)
+        {
+            const long double phase = -two_pi * f * static_cast<long double>(j);
+            sum += std::complex<long double>(x[j]) * std::complex<long double>(std::cos(phase), std::sin(phase));
+        }
+        return sum;
+    }
+
+    template <typename T>
+    std::complex<long double> dtft(const std::vector<std::complex<T>> &x, long double f)
+    {
+        const long double two_pi = 6.283185307179586476925286766559L;
+        std::complex<long double> sum;
+        for (std::size_t j = 0; j < x.size(); ++j)
+        {
+            const long double phase = -two_pi * f * static_cast<long double>(j);
+            sum += std::complex<long double>(x[j].real(), x[j].imag()) *
+                   std::complex<long double>(std::cos(phase), std::sin(phase));
+        }
+        return sum;
+    }
+
+    // Two tones 0.0004 cycles/sample apart, far closer than the 1 / n bin
+    // spacing of a plain FFT of the signal.
+    template <typename T>
+    std::vector<T> two_tones(std::size_t n)
+    {
+        std::vector<T> x(n);
+        for (std::size_t j = 0; j < n; ++j)
+        {
+            const double t = static_cast<double>(j);
+            x[j] = static_cast<T>(std::cos(2.0 * M_PI * 0.1230 * t) + 0.5 * std::cos(2.0 * M_PI * 0.1234 * t + 0.3));
+        }
+        return x;
+    }
+}
+
+void test_plain_dft()
+{
+    std::cout << "Testing CZT on the DFT grid..." << std::endl;
+    const std::size_t n = 37;
+    std::vector<std::complex<double>> x(n);
+    for (std::size_t j = 0; j < n; ++j)
+    {
+        x[j] = std::complex<double>(std::sin(0.3 * static_cast<double>(j)), std::cos(1.1 * static_cast<double>(j)));
+    }
+    const std::vector<std::complex<double>> X = clapfft::chirp_z(x, n, 0.0, 1.0 / static_cast<double>(n));
+    assert(X.size() == n);
+    for (std::size_t k = 0; k < n; ++k)
+    {
+        const std::complex<long double> expected = dtft(x, static_cast<long double>(k) / n);
+        assert(std::abs(std::complex<long double>(X[k].real(), X[k].imag()) - expected) <= 1e-11L);
+        (void)expected;
+    }
+}
+
+void test_zoom()
+{
+    std::cout << "Testing zoomed narrow-band analysis..." << std::endl;
+    const std::size_t n = 5000, m = 400;
+    const double f0 = 0.1220, f1 = 0.1245;
+    const std::vector<double> x = two_tones<double>(n);
+
+    clapfft::ChirpZ<double> czt(n, m, f0, (f1 - f0) / m);
+    assert(czt.valid() && czt.input_size() == n && czt.output_size() == m);
+    assert(czt.fft_size() >= n + m - 1);
+    std::vector<std::complex<double>> X(m);
+    bool ok = czt.transform(x.data(), X.data());
+    assert(ok);
+    double worst = 0.0;
+    for (std::size_t k = 0; k < m; ++k)
+    {
+        const std::complex<long double> expected = dtft(x, czt.frequency(k));
+        worst = std::max(worst, static_cast<double>(std::abs(std::complex<long double>(X[k].real(), X[k].imag()) - expected)));
+    }
+    assert(worst <= 1e-8);
+
+    // Both tones resolved: the two largest local maxima sit on them, to
+    // within a quarter of the plain FFT's 1 / n bin spacing (leakage from
+    // the neighbouring tone pulls each peak a little).
+    std::size_t first = 0, second = 0;
+    for (std::size_t k = 1; k + 1 < m; ++k)
+    {
+        if (std::abs(X[k]) >= std::abs(X[k - 1]) && std::abs(X[k]) >= std::abs(X[k + 1]))
+        {
+            if (std::abs(X[k]) > std::abs(X[first]))
+            {
+                second = first;
+                first = k;
+            }
+            else if (std::abs(X[k]) > std::abs(X[second]))
+            {
+                second = k;
+            }
+        }
+    }
+    assert(std::fabs(czt.frequency(first) - 0.1230) <= 5e-5);
+    assert(std::fabs(czt.frequency(second) - 0.1234) <= 5e-5);
+
+    // The free function agrees, and repeated zooms reuse the tables.
+    const std::vector<std::complex<double>> again = clapfft::zoom_fft(x, f0, f1, m);
+    assert(again.size() == m);
+    for (std::size_t k = 0; k < m; ++k)
+    {
+        assert(std::abs(again[k] - X[k]) <= 1e-12 * (1.0 + std::abs(X[k])));
+    }
+    ok = czt.transform(x.data(), X.data());
+    assert(ok && std::abs(again[7] - X[7]) <= 1e-12 * (1.0 + std::abs(X[7])));
+    (void)ok;
+    (void)worst;
+}
+
+void test_precisions_and_threads()
+{
+    std::cout << "Testing float, long double and shared tables across threads..." << std::endl;
+    const std::size_t n = 300, m = 64;
+    const std::vector<float> xf = two_tones<float>(n);
+    const std::vector<long double> xl = two_tones<long double>(n);
+    const std::vector<std::complex<float>> Xf = clapfft::zoom_fft(xf, 0.1, 0.15, m);
+    const std::vector<std::complex<long double>> Xl = clapfft::zoom_fft(xl, 0.1, 0.15, m);
+    assert(Xf.size() == m && Xl.size() == m);
+    for (std::size_t k = 0; k < m; ++k)
+    {
+        // The frequencies the transform was asked for, in double.
+        const long double f = 0.1 + static_cast<double>(k) * ((0.15 - 0.1) / static_cast<double>(m));
+        const std::complex<long double> expected = dtft(xl, f);
+        assert(std::abs(std::complex<long double>(Xf[k].real(), Xf[k].imag()) - expected) <= 1e-3L);
+        assert(std::abs(Xl[k] - expected) <= 1e-10L);
+        (void)expected;
+    }
+
+    std::vector<std::vector<std::complex<float>>> results(4, std::vector<std::complex<float>>(m));
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < results.size(); ++t)
+    {
+        threads.push_back(std::thread([&, t]()
+                                      {
+                                          clapfft::ChirpZ<float> czt(n, m, 0.1, 0.05 / m);
+                                          for (int r = 0; r < 20; ++r)
+                                          {
+                                              czt.transform(xf.data(), results[t].data());
+                                          } }));
+    }
+    for (std::size_t t = 0; t < threads.size(); ++t)
+    {
+        threads[t].join();
+    }
+    for (std::size_t t = 0; t < results.size(); ++t)
+    {
+        for (std::size_t k = 0; k < m; ++k)
+        {
+            assert(results[t][k] == results[0][k]);
+        }
+    }
+    clapfft::ChirpZ<float>::clear_cache();
+}
+
+void test_invalid()
+{
+    std::cout << "Testing invalid configurations..." << std::endl;
+    assert(!clapfft::ChirpZ<double>(0, 10, 0.0, 0.01).valid());
+    assert(!clapfft::ChirpZ<double>(10, 0, 0.0, 0.01).valid());
+    assert(!clapfft::ChirpZ<double>(10, 10, 0.0, std::nan("")).valid());
+    assert(clapfft::chirp_z(std::vector<std::complex<double>>(), 4, 0.0, 0.1).empty());
+    assert(clapfft::zoom_fft(std::vector<double>(8, 1.0), 0.0, 0.5, 0).empty());
+    clapfft::ChirpZ<double> none;
+    std::complex<double> out;
+    const double in = 1.0;
+    const bool ok = none.transform(&in, &out);
+    assert(!ok && none.frequency(3) == 0.0);
+    (void)ok;
+}
+
+int main()
+{
+    test_plain_dft();
+    test_zoom();
+    test_precisions_and_threads();
+    test_invalid();
+    std::cout << "All chirp-z tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,159 @@
+#include <fftw3.h>
+#include <clapfft/coalescing_fft.hpp>
+#include <clapfft/clapfft_api.hpp>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    std::vector<std::complex<double>> make_signal(int n, int seed)
+    {
+        std::vector<std::complex<double>> x(n);
+        for (int i = 0; i < n; ++i)
+        {
+            x[i] = std::complex<double>(std::cos(0.07 * i * (seed + 1)), std::sin(0.03 * i + seed));
+        }
+        return x;
+    }
+}
+
+void test_concurrent_requests_are_batched()
+{
+    std::cout << "Testing coalesced concurrent c2c_1d..." << std::endl;
+    const int n = 48;
+    const int threads = 6;
+    const int calls = 20;
+
+    std::vector<std::vector<std::complex<double>>> inputs;
+    std::vector<std::vector<std::complex<double>>> expected(threads);
+    for (int t = 0; t < threads; ++t)
+    {
+        inputs.push_back(make_signal(n, t));
+        clapfft::FFT::c2c_1d(inputs[t], expected[t], FFTW_FORWARD);
+    }
+
+    clapfft::CoalescingOptions options;
+    options.max_batch = 4;
+    options.window_us = 2000;
+    clapfft::CoalescingFFT::set_options(options);
+    clapfft::CoalescingFFT::reset_stats();
+    clapfft::CoalescingFFT::set_enabled(true);
+
+    std::vector<int> failures(threads, 0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&, t]()
+                             {
+            std::vector<std::complex<double>> out;
+            for (int c = 0; c < calls; ++c)
+            {
+                clapfft::FFT::c2c_1d(inputs[t], out, FFTW_FORWARD);
+                for (int i = 0; i < n; ++i)
+                {
+                    if (std::abs(out[i] - expected[t][i]) > 1e-9)
+                    {
+                        ++failures[t];
+                        break;
+                    }
+                }
+            } });
+    }
+    for (std::size_t t = 0; t < workers.size(); ++t)
+    {
+        workers[t].join();
+    }
+    clapfft::CoalescingFFT::set_enabled(false);
+
+    for (int t = 0; t < threads; ++t)
+    {
+        assert(failures[t] == 0);
+    }
+    const clapfft::CoalescingStats stats = clapfft::CoalescingFFT::stats();
+    assert(stats.requests == static_cast<std::uint64_t>(threads * calls));
+    assert(stats.batches > 0);
+    assert(stats.batches <= stats.requests);
+    assert(stats.average_batch() >= 1.0);
+    assert(stats.average_batch() <= static_cast<double>(options.max_batch));
+    (void)stats;
+}
+
+void test_direct_api()
+{
+    std::cout << "Testing CoalescingFFT::c2c_1d directly..." << std::endl;
+    clapfft::CoalescingOptions options;
+    options.max_batch = 1;
+    options.window_us = 0;
+    clapfft::CoalescingFFT::set_options(options);
+    assert(clapfft::CoalescingFFT::options().max_batch == 1);
+    clapfft::CoalescingFFT::reset_stats();
+
+    const int n = 16;
+    std::vector<std::complex<float>> in(n), out(n);
+    for (int i = 0; i < n; ++i)
+    {
+        in[i] = std::complex<float>(static_cast<float>(i % 3), 0.0f);
+    }
+    std::vector<std::complex<float>> expected;
+    clapfft::FFT::c2c_1d(in, expected, FFTW_BACKWARD);
+
+    bool ok = clapfft::CoalescingFFT::c2c_1d(in.data(), out.data(), n, FFTW_BACKWARD);
+    assert(ok);
+    for (int i = 0; i < n; ++i)
+    {
+        assert(std::abs(out[i] - expected[i]) <= 1e-4f);
+    }
+
+    // In place.
+    ok = clapfft::CoalescingFFT::c2c_1d(in.data(), in.data(), n, FFTW_BACKWARD);
+    assert(ok);
+    for (int i = 0; i < n; ++i)
+    {
+        assert(std::abs(in[i] - expected[i]) <= 1e-4f);
+    }
+
+    const clapfft::CoalescingStats stats = clapfft::CoalescingFFT::stats();
+    assert(stats.requests == 2);
+    assert(stats.batches == 2);
+    (void)stats;
+
+    // Later batches reuse the group's buffers, also after max_batch
+    // changes; nothing of an earlier request leaks into a later one.
+    for (int round = 0; round < 4; ++round)
+    {
+        options.max_batch = round < 2 ? 1 : 3;
+        clapfft::CoalescingFFT::set_options(options);
+        for (int i = 0; i < n; ++i)
+        {
+            in[i] = std::complex<float>(static_cast<float>((i + round) % 5), static_cast<float>(round));
+        }
+        clapfft::FFT::c2c_1d(in, expected, FFTW_BACKWARD);
+        ok = clapfft::CoalescingFFT::c2c_1d(in.data(), out.data(), n, FFTW_BACKWARD);
+        assert(ok);
+        for (int i = 0; i < n; ++i)
+        {
+            assert(std::abs(out[i] - expected[i]) <= 1e-4f);
+        }
+    }
+
+    ok = clapfft::CoalescingFFT::c2c_1d<float>(nullptr, out.data(), n, FFTW_FORWARD);
+    assert(!ok);
+    ok = clapfft::CoalescingFFT::c2c_1d(in.data(), out.data(), 0, FFTW_FORWARD);
+    assert(!ok);
+    (void)ok;
+
+    clapfft::CoalescingFFT::set_options(clapfft::CoalescingOptions());
+}
+
+int main()
+{
+    assert(!clapfft::CoalescingFFT::enabled());
+    test_concurrent_requests_are_batched();
+    test_direct_api();
+    std::cout << "All coalescing FFT tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,223 @@
+#include <fftw3.h>
+#include <clapfft/convolver.hpp>
+#include <clapfft/complex_ops.hpp>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <vector>
+
+#include "test_signals.hpp"
+
+using clapfft_test::direct_convolution;
+using clapfft_test::two_tone;
+
+void test_complex_multiply()
+{
+    std::cout << "Testing ComplexOps::multiply..." << std::endl;
+    const std::size_t count = 7;
+    std::vector<std::complex<float>> af(count), bf(count), cf(count);
+    std::vector<std::complex<double>> ad(count), bd(count), cd(count);
+    std::vector<std::complex<long double>> al(count), bl(count), cl(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const double re = 0.5 + static_cast<double>(i), im = 1.0 - 0.3 * static_cast<double>(i);
+        af[i] = std::complex<float>(static_cast<float>(re), static_cast<float>(im));
+        bf[i] = std::complex<float>(static_cast<float>(im), static_cast<float>(-re));
+        ad[i] = std::complex<double>(re, im);
+        bd[i] = std::complex<double>(im, -re);
+        al[i] = std::complex<long double>(re, im);
+        bl[i] = std::complex<long double>(im, -re);
+    }
+    clapfft::ComplexOps::multiply(af.data(), bf.data(), cf.data(), count);
+    clapfft::ComplexOps::multiply(ad.data(), bd.data(), cd.data(), count);
+    clapfft::ComplexOps::multiply(al.data(), bl.data(), cl.data(), count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        assert(std::abs(cf[i] - af[i] * bf[i]) <= 1e-5f);
+        assert(std::abs(cd[i] - ad[i] * bd[i]) <= 1e-12);
+        assert(std::abs(cl[i] - al[i] * bl[i]) <= 1e-12L);
+    }
+    // In place.
+    clapfft::ComplexOps::multiply(ad.data(), bd.data(), ad.data(), count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        assert(std::abs(ad[i] - cd[i]) <= 1e-12);
+    }
+}
+
+void test_choose_fft_size()
+{
+    std::cout << "Testing FFT size selection..." << std::endl;
+    const std::size_t taps[] = {1, 100, 1024, 5000, 65536};
+    for (std::size_t t = 0; t < sizeof(taps) / sizeof(taps[0]); ++t)
+    {
+        const std::size_t n = clapfft::Convolver<double>::choose_fft_size(taps[t]);
+        assert(n >= 2 * taps[t]);
+        assert((n & (n - 1)) == 0);
+        // No other power of two in range is cheaper.
+        const double chosen = (std::log2(static_cast<double>(n)) + 1.0) * static_cast<double>(n) / static_cast<double>(n - taps[t] + 1);
+        for (std::size_t other = n / 2; other >= 2 * taps[t] && other > 0; other /= 2)
+        {
+            assert((std::log2(static_cast<double>(other)) + 1.0) * static_cast<double>(other) / static_cast<double>(other - taps[t] + 1) >= chosen);
+        }
+        (void)chosen;
+    }
+}
+
+void test_mono_stream()
+{
+    std::cout << "Testing mono streaming convolution..." << std::endl;
+    const std::vector<double> kernel = two_tone<double>(100, 0.4);
+    const std::vector<double> signal = two_tone<double>(3000, 0.0);
+    const std::vector<double> expected = direct_convolution(signal, kernel);
+
+    clapfft::Convolver<double> conv(kernel);
+    assert(conv.valid());
+    assert(conv.taps() == 100 && conv.channels() == 1);
+    assert(conv.fft_size() == clapfft::Convolver<double>::choose_fft_size(100));
+    assert(conv.block_size() == conv.fft_size() - 99);
+
+    std::vector<double> out;
+    const std::size_t chunks[] = {1, 17, 400, 3, 999, 250};
+    std::size_t pos = 0;
+    for (std::size_t c = 0; pos < signal.size(); c = (c + 1) % 6)
+    {
+        const std::size_t count = std::min(chunks[c], signal.size() - pos);
+        const std::vector<double> chunk(signal.begin() + static_cast<std::ptrdiff_t>(pos),
+                                        signal.begin() + static_cast<std::ptrdiff_t>(pos + count));
+        const std::size_t ready = conv.output_ready(count);
+        const std::size_t produced = conv.push(chunk, out);
+        assert(produced == ready);
+        (void)ready;
+        (void)produced;
+        pos += count;
+    }
+    const std::size_t tail = conv.flush(out);
+    assert(out.size() == expected.size());
+    assert(tail > 0);
+    (void)tail;
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        assert(std::abs(out[i] - expected[i]) <= 1e-9);
+    }
+
+    // After flush, the stream starts over from silence.
+    std::vector<double> again;
+    conv.push(signal, again);
+    conv.flush(again);
+    assert(again.size() == expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        assert(std::abs(again[i] - expected[i]) <= 1e-9);
+    }
+}
+
+void test_impulse_and_step()
+{
+    std::cout << "Testing impulse and step responses..." << std::endl;
+    const std::vector<double> kernel = two_tone<double>(100, 0.4);
+    clapfft::Convolver<double> conv(kernel);
+    const std::size_t block = conv.block_size();
+
+    // An impulse just before a block boundary: its response straddles two
+    // blocks and must come out as the kernel, shifted, with silence around it.
+    const std::size_t at = block - 30;
+    std::vector<double> out;
+    conv.push(clapfft_test::impulse<double>(2 * block, at), out);
+    conv.flush(out);
+    assert(out.size() == 2 * block + 99);
+    for (std::size_t i = 0; i < out.size(); ++i)
+    {
+        const double want = i >= at && i < at + 100 ? kernel[i - at] : 0.0;
+        assert(std::abs(out[i] - want) <= 1e-12);
+        (void)want;
+    }
+
+    // A unit step integrates the kernel, then holds at its sum.
+    std::vector<double> step;
+    conv.push(std::vector<double>(2 * block, 1.0), step);
+    conv.flush(step);
+    double sum = 0.0;
+    for (std::size_t i = 0; i < 2 * block; ++i)
+    {
+        sum += i < 100 ? kernel[i] : 0.0;
+        assert(std::abs(step[i] - sum) <= 1e-9);
+    }
+    (void)sum;
+}
+
+void test_multichannel_batched()
+{
+    std::cout << "Testing batched multi-channel convolution..." << std::endl;
+    const std::size_t channels = 3;
+    const std::vector<float> kernel = two_tone<float>(99, 1.1);
+    std::vector<std::vector<float>> signals(channels);
+    for (std::size_t c = 0; c < channels; ++c)
+    {
+        signals[c] = two_tone<float>(700, 0.7 * static_cast<double>(c));
+    }
+
+    clapfft::Convolver<float> conv(kernel, channels, 64);
+    assert(conv.fft_size() == 256 && conv.block_size() == 158);
+
+    std::vector<std::vector<float>> out;
+    for (std::size_t pos = 0; pos < 700; pos += 100)
+    {
+        std::vector<std::vector<float>> chunk(channels);
+        for (std::size_t c = 0; c < channels; ++c)
+        {
+            chunk[c].assign(signals[c].begin() + static_cast<std::ptrdiff_t>(pos),
+                            signals[c].begin() + static_cast<std::ptrdiff_t>(pos + 100));
+        }
+        conv.push(chunk, out);
+    }
+    conv.flush(out);
+    assert(out.size() == channels);
+    for (std::size_t c = 0; c < channels; ++c)
+    {
+        const std::vector<float> expected = direct_convolution(signals[c], kernel);
+        assert(out[c].size() == expected.size());
+        for (std::size_t i = 0; i < expected.size(); ++i)
+        {
+            assert(std::abs(out[c][i] - expected[i]) <= 1e-3f);
+        }
+    }
+}
+
+void test_edge_cases()
+{
+    std::cout << "Testing single-tap kernels and invalid use..." << std::endl;
+    clapfft::Convolver<long double> gain(std::vector<long double>(1, 2.0L));
+    assert(gain.valid() && gain.taps() == 1);
+    std::vector<long double> in(10, 1.5L), out;
+    gain.push(in, out);
+    gain.flush(out);
+    assert(out.size() == 10);
+    for (std::size_t i = 0; i < out.size(); ++i)
+    {
+        assert(std::abs(out[i] - 3.0L) <= 1e-15L);
+    }
+
+    assert(!clapfft::Convolver<double>(std::vector<double>()).valid());
+    assert(!clapfft::Convolver<double>(std::vector<double>(4, 1.0), 0).valid());
+    clapfft::Convolver<double> stereo(std::vector<double>(4, 1.0), 2);
+    std::vector<double> mono_out;
+    std::size_t produced = stereo.push(std::vector<double>(1000, 1.0), mono_out);
+    assert(produced == 0 && mono_out.empty());
+    produced = stereo.flush(mono_out);
+    assert(produced == 0);
+    (void)produced;
+}
+
+int main()
+{
+    test_complex_multiply();
+    test_choose_fft_size();
+    test_mono_stream();
+    test_impulse_and_step();
+    test_multichannel_batched();
+    test_edge_cases();
+    std::cout << "All convolver tests passed!" << std::endl;
+    return 0;
+}
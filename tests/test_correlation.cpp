@@ -0,0 +1,351 @@
+#include <fftw3.h>
+#include <clapfft/correlation.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "test_signals.hpp"
+
+using clapfft_test::two_tone;
+
+namespace
+{
+    // Direct full correlation on 3D extents (leading 1s for lower ranks);
+    // with normalize, the Pearson coefficient over each lag's overlap.
+    std::vector<double> direct(const std::vector<double> &x, const int nx[3], const std::vector<double> &y,
+                               const int ny[3], bool normalize, std::size_t min_overlap)
+    {
+        int no[3];
+        for (int a = 0; a < 3; ++a)
+        {
+            no[a] = nx[a] + ny[a] - 1;
+        }
+        std::vector<double> out(static_cast<std::size_t>(no[0]) * no[1] * no[2], 0.0);
+        for (int l0 = 1 - ny[0]; l0 < nx[0]; ++l0)
+            for (int l1 = 1 - ny[1]; l1 < nx[1]; ++l1)
+                for (int l2 = 1 - ny[2]; l2 < nx[2]; ++l2)
+                {
+                    double sxy = 0, sx = 0, sy = 0, sxx = 0, syy = 0;
+                    std::size_t count = 0;
+                    for (int t0 = 0; t0 < ny[0]; ++t0)
+                        for (int t1 = 0; t1 < ny[1]; ++t1)
+                            for (int t2 = 0; t2 < ny[2]; ++t2)
+                            {
+                                const int u0 = t0 + l0, u1 = t1 + l1, u2 = t2 + l2;
+                                if (u0 < 0 || u0 >= nx[0] || u1 < 0 || u1 >= nx[1] || u2 < 0 || u2 >= nx[2])
+                                    continue;
+                                const double a = x[(static_cast<std::size_t>(u0) * nx[1] + u1) * nx[2] + u2];
+                                const double b = y[(static_cast<std::size_t>(t0) * ny[1] + t1) * ny[2] + t2];
+                                sxy += a * b;
+                                sx += a;
+                                sy += b;
+                                sxx += a * a;
+                                syy += b * b;
+                                ++count;
+                            }
+                    double value = sxy;
+                    if (normalize)
+                    {
+                        const double n = static_cast<double>(count);
+                        const double vx = sxx - sx * sx / n, vy = syy - sy * sy / n;
+                        value = count < min_overlap || vx <= 1e-12 * sxx || vy <= 1e-12 * syy
+                                    ? 0.0
+                                    : (sxy - sx * sy / n) / std::sqrt(vx * vy);
+                    }
+                    const std::size_t k = (static_cast<std::size_t>(l0 + ny[0] - 1) * no[1] + (l1 + ny[1] - 1)) * no[2] +
+                                          (l2 + ny[2] - 1);
+                    out[k] = value;
+                }
+        return out;
+    }
+
+    double max_error(const std::vector<double> &a, const std::vector<double> &b)
+    {
+        if (a.size() != b.size())
+        {
+            return HUGE_VAL;
+        }
+        double worst = 0.0;
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            worst = std::max(worst, std::fabs(a[i] - b[i]));
+        }
+        return worst;
+    }
+}
+
+void test_fast_sizes()
+{
+    std::cout << "Testing fast padded sizes..." << std::endl;
+    assert(clapfft::next_fast_size(0) == 1);
+    assert(clapfft::next_fast_size(1) == 1);
+    assert(clapfft::next_fast_size(11) == 12);
+    assert(clapfft::next_fast_size(13) == 14);
+    assert(clapfft::next_fast_size(97) == 98);
+    assert(clapfft::next_fast_size(1000) == 1000);
+    assert(clapfft::next_fast_size(1001) == 1008);
+}
+
+void test_1d()
+{
+    std::cout << "Testing 1D cross- and autocorrelation..." << std::endl;
+    const std::vector<double> x = two_tone<double>(300, 0.0);
+    const std::vector<double> y = two_tone<double>(37, 0.4);
+    const int nx[3] = {1, 1, 300}, ny[3] = {1, 1, 37};
+
+    const std::vector<double> r = clapfft::correlate(x, y);
+    assert(r.size() == 336);
+    double error = max_error(r, direct(x, nx, y, ny, false, 0));
+    assert(error <= 1e-9);
+    (void)error;
+    error = max_error(r, direct(x, nx, y, ny, false, 0));
+    assert(error <= 1e-9);
+
+    const std::vector<double> a = clapfft::autocorrelate(x);
+    assert(a.size() == 599);
+    error = max_error(a, direct(x, nx, x, nx, false, 0));
+    assert(error <= 1e-9);
+    for (std::size_t i = 0; i < 299; ++i)
+    {
+        assert(std::fabs(a[i] - a[598 - i]) <= 1e-9);
+    }
+
+    // Time-delay estimation: a copy of a stretch of x starting at 120
+    // peaks at lag 120 (index 120 + 37 - 1). The default overlap floor
+    // keeps the one- and two-sample edge lags from scoring +-1.
+    const std::vector<double> piece(x.begin() + 120, x.begin() + 157);
+    clapfft::CorrelationOptions ncc;
+    ncc.normalize = true;
+    const std::vector<double> c = clapfft::correlate(x, piece, ncc);
+    std::size_t best = 0;
+    for (std::size_t i = 1; i < c.size(); ++i)
+    {
+        best = c[i] > c[best] ? i : best;
+    }
+    assert(best == 156);
+    assert(std::fabs(c[best] - 1.0) <= 1e-9);
+    (void)best;
+
+    std::vector<float> xf(x.begin(), x.end()), yf(y.begin(), y.end());
+    const std::vector<float> rf = clapfft::correlate(xf, yf);
+    const std::vector<double> expected = direct(x, nx, y, ny, false, 0);
+    for (std::size_t i = 0; i < rf.size(); ++i)
+    {
+        assert(std::fabs(rf[i] - expected[i]) <= 1e-3);
+    }
+}
+
+void test_known_lag()
+{
+    std::cout << "Testing peaks of templates at known lags..." << std::endl;
+    // A template dropped into silence at lag 150: the plain correlation
+    // peaks there at the template's energy (Cauchy-Schwarz bounds every
+    // other lag by it).
+    const std::vector<double> y = two_tone<double>(37, 0.4);
+    double energy = 0.0;
+    for (std::size_t i = 0; i < y.size(); ++i)
+    {
+        energy += y[i] * y[i];
+    }
+    std::vector<double> x(300, 0.0);
+    std::copy(y.begin(), y.end(), x.begin() + 150);
+    const std::vector<double> r = clapfft::correlate(x, y);
+    std::size_t best = 0;
+    for (std::size_t i = 1; i < r.size(); ++i)
+    {
+        best = r[i] > r[best] ? i : best;
+    }
+    assert(best == 150 + 36);
+    assert(std::fabs(r[best] - energy) <= 1e-9 * energy);
+
+    // The same in 2D, at lag (5, 7).
+    const int sx[2] = {13, 17}, sy[2] = {4, 6};
+    const std::vector<double> y2 = two_tone<double>(4 * 6, 0.9);
+    std::vector<double> x2(13 * 17, 0.0);
+    for (int i = 0; i < 4; ++i)
+    {
+        std::copy(y2.begin() + i * 6, y2.begin() + (i + 1) * 6, x2.begin() + (5 + i) * 17 + 7);
+    }
+    std::vector<double> r2(16 * 22);
+    const bool ok = clapfft::correlate(2, sx, x2.data(), sy, y2.data(), r2.data());
+    assert(ok);
+    best = 0;
+    for (std::size_t i = 1; i < r2.size(); ++i)
+    {
+        best = r2[i] > r2[best] ? i : best;
+    }
+    assert(best == static_cast<std::size_t>((5 + 3) * 22 + 7 + 5));
+
+    // Normalised, over a constant stretch then the template at lag 150:
+    // the coefficient is 1 at the match and exactly 0 wherever
+    // the overlap is all constant (zero variance).
+    std::vector<double> z(300, 2.0);
+    std::copy(y.begin(), y.end(), z.begin() + 150);
+    clapfft::CorrelationOptions ncc;
+    ncc.normalize = true;
+    const std::vector<double> c = clapfft::correlate(z, y, ncc);
+    best = 0;
+    for (std::size_t i = 1; i < c.size(); ++i)
+    {
+        best = c[i] > c[best] ? i : best;
+    }
+    assert(best == 150 + 36);
+    assert(std::fabs(c[best] - 1.0) <= 1e-9);
+    for (std::size_t lag = 0; lag + 37 <= 150; ++lag)
+    {
+        assert(c[lag + 36] == 0.0);
+    }
+    (void)energy;
+    (void)ok;
+    (void)best;
+}
+
+void test_2d_3d()
+{
+    std::cout << "Testing 2D and 3D correlation..." << std::endl;
+    const int sx2[2] = {13, 17}, sy2[2] = {4, 6};
+    const std::vector<double> x2 = two_tone<double>(13 * 17, 0.2);
+    const std::vector<double> y2 = two_tone<double>(4 * 6, 0.9);
+    std::vector<double> r2(16 * 22);
+    double error = 0.0;
+    bool ok = clapfft::correlate(2, sx2, x2.data(), sy2, y2.data(), r2.data());
+    assert(ok);
+    const int nx2[3] = {1, 13, 17}, ny2[3] = {1, 4, 6};
+    error = max_error(r2, direct(x2, nx2, y2, ny2, false, 0));
+    assert(error <= 1e-9);
+
+    const int sx3[3] = {6, 5, 9}, sy3[3] = {3, 4, 2};
+    const std::vector<double> x3 = two_tone<double>(6 * 5 * 9, 0.3);
+    const std::vector<double> y3 = two_tone<double>(3 * 4 * 2, 0.7);
+    clapfft::Correlator<double> corr(3, sx3, sy3, y3.data());
+    assert(corr.valid() && corr.rank() == 3);
+    assert(corr.output_dims() == std::vector<int>({8, 8, 10}));
+    assert(corr.fft_dims() == std::vector<int>({8, 8, 10}));
+    std::vector<double> r3(corr.output_size());
+    ok = corr.apply(x3.data(), 1, r3.data());
+    assert(ok);
+    error = max_error(r3, direct(x3, sx3, y3, sy3, false, 0));
+    assert(error <= 1e-9);
+
+    // Normalised, 2D and 3D, with overlap floors.
+    clapfft::CorrelationOptions ncc;
+    ncc.normalize = true;
+    ncc.min_overlap = 0.25;
+    ok = clapfft::correlate(2, sx2, x2.data(), sy2, y2.data(), r2.data(), ncc);
+    assert(ok);
+    error = max_error(r2, direct(x2, nx2, y2, ny2, true, 6));
+    assert(error <= 1e-8);
+    std::vector<double> a3((2 * 6 - 1) * (2 * 5 - 1) * (2 * 9 - 1));
+    ok = clapfft::autocorrelate(3, sx3, x3.data(), a3.data(), ncc);
+    assert(ok);
+    error = max_error(a3, direct(x3, sx3, x3, sx3, true, 68));
+    assert(error <= 1e-8);
+    assert(std::fabs(a3[a3.size() / 2] - 1.0) <= 1e-12);
+    (void)ok;
+    (void)error;
+}
+
+void test_batched()
+{
+    std::cout << "Testing batched signal-versus-template correlation..." << std::endl;
+    const std::size_t batch = 11;
+    const int nx = 90, ny = 25;
+    const std::vector<double> templ = two_tone<double>(ny, 1.3);
+    std::vector<double> signals;
+    for (std::size_t b = 0; b < batch; ++b)
+    {
+        const std::vector<double> s = two_tone<double>(nx, 0.1 * static_cast<double>(b));
+        signals.insert(signals.end(), s.begin(), s.end());
+    }
+
+    for (int normalize = 0; normalize < 2; ++normalize)
+    {
+        clapfft::CorrelationOptions options;
+        options.normalize = normalize != 0;
+        options.max_batch = 4;
+        clapfft::Correlator<double> corr(1, &nx, &ny, templ.data(), options);
+        assert(corr.signal_size() == 90 && corr.output_size() == 114);
+        std::vector<double> out(batch * corr.output_size());
+        // Twice, so the second call runs on reused scratch.
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            const bool ok = corr.apply(signals.data(), batch, out.data());
+            assert(ok);
+            (void)ok;
+            for (std::size_t b = 0; b < batch; ++b)
+            {
+                const std::vector<double> x(signals.begin() + static_cast<std::ptrdiff_t>(b * nx),
+                                            signals.begin() + static_cast<std::ptrdiff_t>((b + 1) * nx));
+                const std::vector<double> got(out.begin() + static_cast<std::ptrdiff_t>(b * 114),
+                                              out.begin() + static_cast<std::ptrdiff_t>((b + 1) * 114));
+                const int n3[3] = {1, 1, nx}, m3[3] = {1, 1, ny};
+                const double error = max_error(got, direct(x, n3, templ, m3, options.normalize, 13));
+                assert(error <= 1e-8);
+                (void)error;
+            }
+        }
+    }
+
+    // Batched autocorrelation, long double.
+    std::vector<long double> many(3 * 40);
+    for (std::size_t i = 0; i < many.size(); ++i)
+    {
+        many[i] = static_cast<long double>(std::sin(0.3 * static_cast<double>(i)));
+    }
+    const int n = 40;
+    clapfft::Correlator<long double> autocorr(1, &n);
+    std::vector<long double> lags(3 * 79);
+    const bool ok = autocorr.apply(many.data(), 3, lags.data());
+    assert(ok);
+    (void)ok;
+    for (std::size_t b = 0; b < 3; ++b)
+    {
+        long double energy = 0;
+        for (std::size_t i = 0; i < 40; ++i)
+        {
+            energy += many[b * 40 + i] * many[b * 40 + i];
+        }
+        assert(std::fabs(lags[b * 79 + 39] - energy) <= 1e-12L);
+    }
+}
+
+void test_constant_and_invalid()
+{
+    std::cout << "Testing constant inputs and invalid use..." << std::endl;
+    clapfft::CorrelationOptions ncc;
+    ncc.normalize = true;
+    const std::vector<double> flat(50, 2.0);
+    const std::vector<double> c = clapfft::correlate(flat, two_tone<double>(10, 0.0), ncc);
+    for (std::size_t i = 0; i < c.size(); ++i)
+    {
+        assert(c[i] == 0.0);
+    }
+
+    assert(clapfft::correlate(std::vector<double>(), std::vector<double>(3, 1.0)).empty());
+    assert(clapfft::autocorrelate(std::vector<float>()).empty());
+    const int bad[2] = {4, 0}, good[2] = {4, 4};
+    assert(!clapfft::Correlator<double>(2, bad).valid());
+    assert(!clapfft::Correlator<double>(4, good).valid());
+    assert(!clapfft::Correlator<double>(2, good, good, nullptr).valid());
+    (void)bad;
+    (void)good;
+    clapfft::Correlator<double> none;
+    double out = 0;
+    const bool ok = none.apply(&out, 1, &out);
+    assert(!ok && none.output_dims().empty());
+    (void)ok;
+}
+
+int main()
+{
+    test_fast_sizes();
+    test_1d();
+    test_known_lag();
+    test_2d_3d();
+    test_batched();
+    test_constant_and_invalid();
+    std::cout << "All correlation tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,150 @@
+#include <fftw3.h>
+#include <clapfft/stft.hpp>
+#include <clapfft/clapfft_api.hpp>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <vector>
+
+#include "test_signals.hpp"
+
+using clapfft_test::two_tone;
+
+namespace
+{
+    template <typename T>
+    std::vector<std::complex<T>> analyse(const std::vector<T> &signal, const std::vector<T> &window, std::size_t hop)
+    {
+        clapfft::STFT<T> stft(window, hop);
+        std::vector<std::complex<T>> frames;
+        stft.push(signal, frames);
+        stft.flush(frames);
+        return frames;
+    }
+}
+
+void test_hann_round_trip()
+{
+    std::cout << "Testing STFT -> ISTFT round trip with a Hann window..." << std::endl;
+    const std::size_t n = 64, hop = 16;
+    const std::vector<double> window = clapfft::hann_window<double>(n);
+    const std::vector<double> signal = two_tone<double>(1000, 0.0);
+    const std::vector<std::complex<double>> frames = analyse(signal, window, hop);
+
+    clapfft::ISTFT<double> istft(window, hop, 4);
+    assert(istft.valid());
+    assert(istft.frame_size() == n && istft.hop() == hop && istft.bins() == n / 2 + 1);
+    std::vector<double> out;
+    std::size_t written = istft.push(frames, out);
+    const std::size_t frame_count = frames.size() / istft.bins();
+    assert(written == frame_count * hop);
+    written = istft.flush(out);
+    assert(written == n - hop);
+    (void)written;
+    (void)frame_count;
+    assert(out.size() == (frame_count - 1) * hop + n);
+    assert(out.size() >= signal.size());
+
+    // Sample 0 only meets the window's zero; it comes out as 0.
+    assert(out[0] == 0.0);
+    for (std::size_t t = 1; t < signal.size(); ++t)
+    {
+        assert(std::abs(out[t] - signal[t]) <= 1e-9);
+    }
+    // The zero padding of the last analysis frame.
+    for (std::size_t t = signal.size(); t < out.size(); ++t)
+    {
+        assert(std::abs(out[t]) <= 1e-9);
+    }
+}
+
+void test_non_cola_window_in_chunks()
+{
+    std::cout << "Testing a non-COLA window fed in chunks..." << std::endl;
+    const std::size_t n = 30, hop = 7;
+    std::vector<float> window(n);
+    for (std::size_t k = 0; k < n; ++k)
+    {
+        window[k] = 1.0f + 0.5f * static_cast<float>(std::sin(0.9 * static_cast<double>(k)));
+    }
+    const std::vector<float> signal = two_tone<float>(500, 0.0);
+    const std::vector<std::complex<float>> frames = analyse(signal, window, hop);
+
+    clapfft::ISTFT<float> istft(window, hop, 3);
+    const std::size_t bins = istft.bins();
+    const std::size_t frame_count = frames.size() / bins;
+    std::vector<float> out((frame_count - 1) * hop + n);
+    std::size_t pos = 0;
+    const std::size_t chunks[] = {1, 5, 2, 13, 4};
+    for (std::size_t f = 0, c = 0; f < frame_count; c = (c + 1) % 5)
+    {
+        const std::size_t count = std::min(chunks[c], frame_count - f);
+        pos += istft.push(frames.data() + f * bins, count, out.data() + pos);
+        f += count;
+    }
+    assert(pos == frame_count * hop);
+    pos += istft.flush(out.data() + pos);
+    assert(pos == out.size());
+    for (std::size_t t = 0; t < signal.size(); ++t)
+    {
+        assert(std::abs(out[t] - signal[t]) <= 1e-4f);
+    }
+}
+
+void test_rectangular_matches_c2r()
+{
+    std::cout << "Testing a rectangular window at hop n against c2r_1d..." << std::endl;
+    const std::size_t n = 16;
+    const std::size_t bins = n / 2 + 1;
+    std::vector<std::complex<long double>> frames(3 * bins);
+    for (std::size_t i = 0; i < frames.size(); ++i)
+    {
+        frames[i] = std::complex<long double>(std::cos(0.3L * i), i % bins == 0 || i % bins == bins - 1 ? 0.0L : std::sin(0.2L * i));
+    }
+    clapfft::ISTFT<long double> istft(std::vector<long double>(n, 1.0L), n);
+    std::vector<long double> out;
+    istft.push(frames, out);
+    assert(out.size() == 3 * n);
+    const std::size_t tail = istft.flush(out);
+    assert(tail == 0);
+    (void)tail;
+    for (std::size_t f = 0; f < 3; ++f)
+    {
+        const std::vector<std::complex<long double>> frame(frames.begin() + static_cast<std::ptrdiff_t>(f * bins),
+                                                           frames.begin() + static_cast<std::ptrdiff_t>((f + 1) * bins));
+        std::vector<long double> expected;
+        clapfft::FFT::c2r_1d(frame, expected);
+        for (std::size_t k = 0; k < n; ++k)
+        {
+            assert(std::abs(out[f * n + k] - expected[k] / n) <= 1e-12L);
+        }
+    }
+}
+
+void test_invalid_and_empty()
+{
+    std::cout << "Testing invalid configurations and empty streams..." << std::endl;
+    assert(!clapfft::ISTFT<double>(std::vector<double>(), 1).valid());
+    assert(!clapfft::ISTFT<double>(std::vector<double>(8, 1.0), 0).valid());
+    assert(!clapfft::ISTFT<double>(std::vector<double>(8, 1.0), 9).valid());
+
+    clapfft::ISTFT<double> istft(clapfft::hann_window<double>(8), 2);
+    std::vector<double> out;
+    std::size_t written = istft.flush(out);
+    assert(written == 0 && out.empty());
+    // A partial frame is ignored.
+    written = istft.push(std::vector<std::complex<double>>(3), out);
+    assert(written == 0 && out.empty());
+    (void)written;
+}
+
+int main()
+{
+    test_hann_round_trip();
+    test_non_cola_window_in_chunks();
+    test_rectangular_matches_c2r();
+    test_invalid_and_empty();
+    std::cout << "All ISTFT tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,169 @@
+#include <fftw3.h>
+#include <clapfft/nested_copy.hpp>
+#include <clapfft/aligned_buffer.hpp>
+#include <clapfft/clapfft_api.hpp>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <vector>
+
+void test_flatten_2d()
+{
+    std::cout << "Testing 2D flatten/unflatten..." << std::endl;
+    std::vector<std::vector<double>> in(3, std::vector<double>(5));
+    for (std::size_t i = 0; i < in.size(); ++i)
+    {
+        for (std::size_t j = 0; j < in[i].size(); ++j)
+        {
+            in[i][j] = static_cast<double>(10 * i + j);
+        }
+    }
+    // A short row is padded with zeros.
+    in[1].resize(2);
+
+    std::vector<double> flat(15, -1.0);
+    clapfft::NestedCopy::flatten(in, 5, flat.data());
+    assert(flat[0] == 0.0 && flat[4] == 4.0);
+    assert(flat[5] == 10.0 && flat[6] == 11.0 && flat[7] == 0.0 && flat[9] == 0.0);
+    assert(flat[14] == 24.0);
+
+    // Rows of the right length are reused; others are rebuilt.
+    std::vector<std::vector<double>> out(2);
+    out[0].resize(5);
+    const double *reused = out[0].data();
+    out[1].resize(9);
+    clapfft::NestedCopy::unflatten(flat.data(), 3, 5, out);
+    assert(out.size() == 3);
+    assert(out[0].data() == reused);
+    (void)reused;
+    for (std::size_t i = 0; i < out.size(); ++i)
+    {
+        assert(out[i].size() == 5);
+        for (std::size_t j = 0; j < 5; ++j)
+        {
+            assert(out[i][j] == flat[i * 5 + j]);
+        }
+    }
+
+    // Shrinking drops trailing rows.
+    clapfft::NestedCopy::unflatten(flat.data(), 1, 5, out);
+    assert(out.size() == 1 && out[0][4] == 4.0);
+}
+
+void test_flatten_3d()
+{
+    std::cout << "Testing 3D flatten/unflatten..." << std::endl;
+    const std::size_t n0 = 4, n1 = 3, n2 = 6;
+    std::vector<std::vector<std::vector<std::complex<float>>>> in(
+        n0, std::vector<std::vector<std::complex<float>>>(n1, std::vector<std::complex<float>>(n2)));
+    for (std::size_t i = 0; i < n0; ++i)
+    {
+        for (std::size_t j = 0; j < n1; ++j)
+        {
+            for (std::size_t k = 0; k < n2; ++k)
+            {
+                in[i][j][k] = std::complex<float>(static_cast<float>(i * 100 + j * 10 + k), static_cast<float>(k));
+            }
+        }
+    }
+    // A missing row is all zeros.
+    in[2].resize(2);
+
+    clapfft::AlignedBuffer<std::complex<float>> flat = clapfft::AlignedBuffer<std::complex<float>>::uninitialized(n0 * n1 * n2);
+    clapfft::NestedCopy::flatten(in, n1, n2, flat.data());
+    assert(flat[(1 * n1 + 2) * n2 + 5] == std::complex<float>(125.0f, 5.0f));
+    assert(flat[(2 * n1 + 2) * n2 + 3] == std::complex<float>(0.0f, 0.0f));
+
+    std::vector<std::vector<std::vector<std::complex<float>>>> out;
+    clapfft::NestedCopy::unflatten(flat.data(), n0, n1, n2, out);
+    assert(out.size() == n0);
+    for (std::size_t i = 0; i < n0; ++i)
+    {
+        assert(out[i].size() == n1);
+        for (std::size_t j = 0; j < n1; ++j)
+        {
+            assert(out[i][j].size() == n2);
+            for (std::size_t k = 0; k < n2; ++k)
+            {
+                assert(out[i][j][k] == flat[(i * n1 + j) * n2 + k]);
+            }
+        }
+    }
+}
+
+void test_large_threaded_copy()
+{
+    std::cout << "Testing large streamed, threaded copies..." << std::endl;
+    // 64 x 129 x 257 doubles is above both the parallel and the streaming
+    // thresholds; the odd row length exercises unaligned heads and tails.
+    const std::size_t n0 = 64, n1 = 129, n2 = 257;
+    assert(n0 * n1 * n2 * sizeof(double) >= clapfft::NestedCopy::streaming_copy_bytes);
+    std::vector<std::vector<std::vector<double>>> in(n0, std::vector<std::vector<double>>(n1, std::vector<double>(n2)));
+    for (std::size_t i = 0; i < n0; ++i)
+    {
+        for (std::size_t j = 0; j < n1; ++j)
+        {
+            for (std::size_t k = 0; k < n2; ++k)
+            {
+                in[i][j][k] = static_cast<double>((i * n1 + j) * n2 + k);
+            }
+        }
+    }
+
+    std::vector<double> flat(n0 * n1 * n2 + 1);
+    // Start one element in so the destination is not 16-byte aligned.
+    clapfft::NestedCopy::flatten(in, n1, n2, flat.data() + 1, 4);
+    for (std::size_t x = 0; x < n0 * n1 * n2; ++x)
+    {
+        assert(flat[x + 1] == static_cast<double>(x));
+    }
+
+    std::vector<std::vector<std::vector<double>>> out(n0, std::vector<std::vector<double>>(n1, std::vector<double>(n2)));
+    clapfft::NestedCopy::unflatten(flat.data() + 1, n0, n1, n2, out, 4);
+    assert(out == in);
+
+    std::vector<std::vector<double>> rows;
+    clapfft::NestedCopy::unflatten(flat.data() + 1, n0 * n1, n2, rows, 3);
+    std::vector<double> back(n0 * n1 * n2);
+    clapfft::NestedCopy::flatten(rows, n2, back.data(), 3);
+    for (std::size_t x = 0; x < back.size(); ++x)
+    {
+        assert(back[x] == flat[x + 1]);
+    }
+}
+
+void test_fft_reuses_output()
+{
+    std::cout << "Testing FFT::c2c_3d into a preshaped output..." << std::endl;
+    const int n = 8;
+    std::vector<std::vector<std::vector<std::complex<double>>>> in(
+        n, std::vector<std::vector<std::complex<double>>>(n, std::vector<std::complex<double>>(n)));
+    in[0][0][0] = std::complex<double>(1.0, 0.0);
+    std::vector<std::vector<std::vector<std::complex<double>>>> out(
+        n, std::vector<std::vector<std::complex<double>>>(n, std::vector<std::complex<double>>(n)));
+    const std::complex<double> *row = out[3][4].data();
+    clapfft::FFT::c2c_3d(in, out, FFTW_FORWARD, clapfft::CLAP_FFT_DEFAULT, 2);
+    assert(out[3][4].data() == row);
+    (void)row;
+    for (int i = 0; i < n; ++i)
+    {
+        for (int j = 0; j < n; ++j)
+        {
+            for (int k = 0; k < n; ++k)
+            {
+                assert(std::abs(out[i][j][k] - std::complex<double>(1.0, 0.0)) <= 1e-12);
+            }
+        }
+    }
+}
+
+int main()
+{
+    test_flatten_2d();
+    test_flatten_3d();
+    test_large_threaded_copy();
+    test_fft_reuses_output();
+    std::cout << "All nested copy tests passed!" << std::endl;
+    return 0;
+}
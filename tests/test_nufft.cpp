@@ -0,0 +1,189 @@
+#include <fftw3.h>
+#include <clapfft/nufft.hpp>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+    struct Problem
+    {
+        std::size_t rank;
+        std::size_t modes[3];
+        std::size_t points;
+    };
+
+    std::size_t mode_count(const Problem &p)
+    {
+        std::size_t total = 1;
+        for (std::size_t d = 0; d < p.rank; ++d)
+        {
+            total *= p.modes[d];
+        }
+        return total;
+    }
+
+    // k . x_j for mode index m (row-major, k_d from -floor(N_d / 2)).
+    template <typename T>
+    long double phase(const Problem &p, const std::vector<std::vector<T>> &x, std::size_t j, std::size_t m)
+    {
+        long double sum = 0;
+        for (std::size_t d = p.rank; d-- > 0;)
+        {
+            const long double k = static_cast<long double>(m % p.modes[d]) - static_cast<long double>(p.modes[d] / 2);
+            sum += k * static_cast<long double>(x[d][j]);
+            m /= p.modes[d];
+        }
+        return sum;
+    }
+
+    template <typename T>
+    long double relative_error(const std::vector<std::complex<T>> &got, const std::vector<std::complex<long double>> &want)
+    {
+        long double err = 0, norm = 0;
+        for (std::size_t i = 0; i < want.size(); ++i)
+        {
+            err += std::norm(std::complex<long double>(got[i].real(), got[i].imag()) - want[i]);
+            norm += std::norm(want[i]);
+        }
+        return std::sqrt(err / norm);
+    }
+
+    // Runs both types on random points against the direct sums.
+    template <typename T>
+    void check(const Problem &p, int sign, double tolerance, std::size_t max_subproblem,
+               clapfft::ThreadPool &pool = clapfft::ThreadPool::global())
+    {
+        std::mt19937 rng(static_cast<unsigned>(p.rank * 100 + p.points));
+        // Coordinates beyond [-pi, pi) check the periodic wrap.
+        std::uniform_real_distribution<double> coord(-7.0, 7.0), value(-1.0, 1.0);
+        std::vector<std::vector<T>> x(p.rank, std::vector<T>(p.points));
+        for (std::size_t d = 0; d < p.rank; ++d)
+        {
+            for (std::size_t j = 0; j < p.points; ++j)
+            {
+                x[d][j] = static_cast<T>(coord(rng));
+            }
+        }
+        const std::size_t total = mode_count(p);
+        std::vector<std::complex<T>> c(p.points), f(total);
+        for (std::size_t j = 0; j < p.points; ++j)
+        {
+            c[j] = std::complex<T>(static_cast<T>(value(rng)), static_cast<T>(value(rng)));
+        }
+        for (std::size_t m = 0; m < total; ++m)
+        {
+            f[m] = std::complex<T>(static_cast<T>(value(rng)), static_cast<T>(value(rng)));
+        }
+
+        std::vector<std::complex<long double>> f_exact(total), c_exact(p.points);
+        for (std::size_t j = 0; j < p.points; ++j)
+        {
+            for (std::size_t m = 0; m < total; ++m)
+            {
+                const long double a = static_cast<long double>(sign) * phase(p, x, j, m);
+                const std::complex<long double> e(std::cos(a), std::sin(a));
+                f_exact[m] += std::complex<long double>(c[j].real(), c[j].imag()) * e;
+                c_exact[j] += std::complex<long double>(f[m].real(), f[m].imag()) * e;
+            }
+        }
+
+        clapfft::NufftOptions options;
+        options.tolerance = tolerance;
+        options.max_subproblem = max_subproblem;
+        const T *y = p.rank > 1 ? x[1].data() : nullptr;
+        const T *z = p.rank > 2 ? x[2].data() : nullptr;
+
+        clapfft::Nufft<T> type1(clapfft::NufftType::Type1, p.rank, p.modes, sign, options, pool);
+        assert(type1.valid() && type1.rank() == p.rank && type1.type() == clapfft::NufftType::Type1);
+        assert(type1.modes().size() == p.rank && type1.grid_dims().size() == p.rank);
+        bool ok = type1.set_points(p.points, x[0].data(), y, z);
+        assert(ok && type1.point_count() == p.points);
+        std::vector<std::complex<T>> f_out(total);
+        ok = type1.execute(c.data(), f_out.data());
+        assert(ok);
+        const long double error1 = relative_error(f_out, f_exact);
+        assert(error1 <= 10 * tolerance);
+
+        clapfft::Nufft<T> type2(clapfft::NufftType::Type2, p.rank, p.modes, sign, options, pool);
+        ok = type2.set_points(p.points, x[0].data(), y, z);
+        assert(ok);
+        std::vector<std::complex<T>> c_out(p.points);
+        ok = type2.execute(f.data(), c_out.data());
+        assert(ok);
+        const long double error2 = relative_error(c_out, c_exact);
+        assert(error2 <= 10 * tolerance);
+        (void)ok;
+        (void)error1;
+        (void)error2;
+    }
+}
+
+void test_1d()
+{
+    std::cout << "Testing 1D type 1 and type 2..." << std::endl;
+    const Problem odd = {1, {37, 0, 0}, 200};
+    const Problem even = {1, {64, 0, 0}, 150};
+    check<double>(odd, 1, 1e-9, 10000);
+    check<double>(even, -1, 1e-6, 7);
+    check<long double>(odd, -1, 1e-9, 10000);
+    check<float>(even, 1, 1e-4, 10000);
+}
+
+void test_2d_3d()
+{
+    std::cout << "Testing 2D and 3D, many subproblems..." << std::endl;
+    const Problem plane = {2, {12, 17, 0}, 300};
+    const Problem volume = {3, {6, 8, 5}, 250};
+    check<double>(plane, 1, 1e-10, 16);
+    check<double>(volume, -1, 1e-8, 16);
+    check<float>(volume, 1, 1e-5, 50);
+
+    // A private pool gives the same answers.
+    clapfft::ThreadPool pool(3);
+    check<double>(volume, 1, 1e-8, 9, pool);
+}
+
+void test_invalid()
+{
+    std::cout << "Testing invalid configurations..." << std::endl;
+    const std::size_t modes[3] = {8, 8, 8};
+    const std::size_t empty[2] = {8, 0};
+    assert(!clapfft::Nufft<double>(clapfft::NufftType::Type1, 0, modes, 1).valid());
+    assert(!clapfft::Nufft<double>(clapfft::NufftType::Type1, 4, modes, 1).valid());
+    assert(!clapfft::Nufft<double>(clapfft::NufftType::Type1, 2, empty, 1).valid());
+    assert(!clapfft::Nufft<double>(clapfft::NufftType::Type2, 1, modes, 0).valid());
+    (void)empty;
+    clapfft::NufftOptions options;
+    options.upsampling = 1.0;
+    assert(!clapfft::Nufft<double>(clapfft::NufftType::Type1, 1, modes, 1, options).valid());
+
+    clapfft::Nufft<double> plane(clapfft::NufftType::Type1, 2, modes, 1);
+    const double x = 0.5;
+    bool ok = plane.set_points(1, &x);
+    assert(!ok && plane.point_count() == 0);
+
+    // No points: type 1 gives all-zero modes.
+    std::vector<std::complex<double>> out(64, std::complex<double>(1.0, 1.0));
+    const std::complex<double> none;
+    ok = plane.execute(&none, out.data());
+    assert(ok && out[5] == std::complex<double>());
+
+    clapfft::Nufft<float> invalid;
+    std::complex<float> value;
+    ok = invalid.execute(&value, &value);
+    assert(!ok && invalid.kernel_width() == 0 && invalid.modes().empty());
+    (void)ok;
+}
+
+int main()
+{
+    test_1d();
+    test_2d_3d();
+    test_invalid();
+    std::cout << "All NUFFT tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,183 @@
+#include <fftw3.h>
+#include <clapfft/numa.hpp>
+#include <clapfft/batch_fft.hpp>
+#include <clapfft/clapfft_api.hpp>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+void test_parse_cpu_list()
+{
+    std::cout << "Testing cpulist parsing..." << std::endl;
+    std::vector<int> cpus;
+    bool ok = clapfft::NumaTopology::parse_cpu_list("0-3,8,10-11\n", cpus);
+    assert(ok);
+    const int expected[] = {0, 1, 2, 3, 8, 10, 11};
+    assert(cpus.size() == sizeof(expected) / sizeof(expected[0]));
+    for (std::size_t i = 0; i < cpus.size(); ++i)
+    {
+        assert(cpus[i] == expected[i]);
+    }
+    (void)expected;
+
+    ok = clapfft::NumaTopology::parse_cpu_list("5,1-2,2", cpus);
+    assert(ok);
+    assert(cpus.size() == 3 && cpus[0] == 1 && cpus[2] == 5);
+
+    // A node without CPUs has an empty list.
+    ok = clapfft::NumaTopology::parse_cpu_list("", cpus);
+    assert(ok);
+    assert(cpus.empty());
+
+    ok = clapfft::NumaTopology::parse_cpu_list("3-1", cpus);
+    assert(!ok);
+    ok = clapfft::NumaTopology::parse_cpu_list("0,", cpus);
+    assert(!ok);
+    ok = clapfft::NumaTopology::parse_cpu_list("a-b", cpus);
+    assert(!ok);
+    (void)ok;
+}
+
+void test_discover_from_directory()
+{
+#ifdef __linux__
+    std::cout << "Testing topology discovery..." << std::endl;
+    char root[] = "/tmp/clapfft_numa_XXXXXX";
+    const bool made = mkdtemp(root) != nullptr;
+    assert(made);
+    (void)made;
+    const std::string base = root;
+    const char *names[] = {"node2", "node0", "nodefoo"};
+    const char *lists[] = {"4-7", "0-3", "8"};
+    for (int i = 0; i < 3; ++i)
+    {
+        const std::string dir = base + "/" + names[i];
+        mkdir(dir.c_str(), 0700);
+        std::ofstream(dir + "/cpulist") << lists[i] << "\n";
+    }
+
+    const clapfft::NumaTopology topology = clapfft::NumaTopology::discover(base);
+    assert(topology.node_count() == 2);
+    assert(topology.nodes()[0].id == 0);
+    assert(topology.nodes()[1].id == 2);
+    assert(topology.node_of_cpu(2) == 0);
+    assert(topology.node_of_cpu(6) == 2);
+    assert(topology.node_of_cpu(8) == -1);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        const std::string dir = base + "/" + names[i];
+        std::remove((dir + "/cpulist").c_str());
+        rmdir(dir.c_str());
+    }
+    rmdir(root);
+
+    // A missing directory means one node with every usable CPU.
+    const clapfft::NumaTopology flat = clapfft::NumaTopology::discover(base + "/missing");
+    assert(flat.node_count() == 1);
+    assert(flat.nodes()[0].id == 0);
+    assert(!flat.nodes()[0].cpus.empty());
+#endif
+}
+
+void test_system_topology()
+{
+    std::cout << "Testing system topology..." << std::endl;
+    const clapfft::NumaTopology &topology = clapfft::NumaTopology::system();
+    assert(topology.node_count() >= 1);
+    for (std::size_t i = 0; i < topology.node_count(); ++i)
+    {
+        assert(!topology.nodes()[i].cpus.empty());
+    }
+    const int here = clapfft::NumaTopology::current_node();
+    assert(here == -1 || topology.node_of_cpu(topology.nodes()[0].cpus[0]) >= 0);
+    (void)here;
+
+    std::vector<double> touched(4096, 1.0);
+    const int node = clapfft::NumaTopology::node_of_address(touched.data());
+    assert(node >= -1);
+    (void)node;
+    assert(clapfft::NumaTopology::node_of_address(nullptr) == -1);
+}
+
+void test_pinned_pool()
+{
+    std::cout << "Testing pinned thread pool..." << std::endl;
+    clapfft::ThreadPool pool(3, true);
+    assert(pool.size() == 3);
+    assert(pool.pinned_nodes() >= 1);
+    assert(pool.node_of(pool.size() - 1) == -1);
+    assert(pool.node_of(0) == clapfft::NumaTopology::system().nodes()[0].id);
+
+    clapfft::ThreadPool unpinned(3);
+    assert(unpinned.pinned_nodes() == 0);
+    assert(unpinned.node_of(0) == -1);
+
+    // Every index runs exactly once whatever node it asks for.
+    const std::size_t count = 200;
+    std::vector<int> nodes(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        nodes[i] = static_cast<int>(i % 3) - 1;
+    }
+    std::vector<std::atomic<int>> hits(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        hits[i].store(0);
+    }
+    pool.parallel_for_by_node(count, [&](std::size_t i, unsigned)
+                              { hits[i].fetch_add(1); },
+                              nodes);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        assert(hits[i].load() == 1);
+    }
+
+    // Batched jobs on a pinned pool give the usual results.
+    const int n = 128;
+    std::vector<std::vector<std::complex<double>>> in(16, std::vector<std::complex<double>>(n));
+    std::vector<std::vector<std::complex<double>>> out(16, std::vector<std::complex<double>>(n));
+    std::vector<clapfft::TransformJob<double>> jobs;
+    for (std::size_t j = 0; j < in.size(); ++j)
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            in[j][i] = std::complex<double>(std::sin(0.01 * i * (j + 1)), 0.5);
+        }
+        jobs.push_back(clapfft::TransformJob<double>::c2c(1, &n, in[j].data(), out[j].data(), FFTW_FORWARD));
+    }
+    const bool ok = clapfft::BatchFFT::execute(jobs, pool);
+    assert(ok);
+    (void)ok;
+    for (std::size_t j = 0; j < in.size(); ++j)
+    {
+        std::vector<std::complex<double>> expected;
+        clapfft::FFT::c2c_1d(in[j], expected, FFTW_FORWARD);
+        for (int i = 0; i < n; ++i)
+        {
+            assert(std::abs(expected[i] - out[j][i]) <= 1e-9);
+        }
+    }
+}
+
+int main()
+{
+    test_parse_cpu_list();
+    test_discover_from_directory();
+    test_system_topology();
+    test_pinned_pool();
+    std::cout << "All NUMA tests passed!" << std::endl;
+    return 0;
+}
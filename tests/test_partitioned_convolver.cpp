@@ -0,0 +1,247 @@
+#include <fftw3.h>
+#include <clapfft/partitioned_convolver.hpp>
+#include <clapfft/complex_ops.hpp>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <vector>
+
+#include "test_signals.hpp"
+
+using clapfft_test::direct_convolution;
+using clapfft_test::two_tone;
+
+namespace
+{
+    // Decaying noise-like tail, the shape of a room response.
+    template <typename T>
+    std::vector<T> make_response(std::size_t length)
+    {
+        std::vector<T> h(length);
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            const double t = static_cast<double>(i);
+            h[i] = static_cast<T>(std::exp(-t / static_cast<double>(length)) * std::sin(0.37 * t * t + 0.2));
+        }
+        return h;
+    }
+}
+
+void test_complex_multiply_add()
+{
+    std::cout << "Testing ComplexOps::multiply_add..." << std::endl;
+    const std::size_t count = 9;
+    std::vector<std::complex<float>> af(count), bf(count), cf(count);
+    std::vector<std::complex<double>> ad(count), bd(count), cd(count);
+    std::vector<std::complex<long double>> al(count), bl(count), cl(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const double re = 0.5 + static_cast<double>(i), im = 1.0 - 0.3 * static_cast<double>(i);
+        af[i] = std::complex<float>(static_cast<float>(re), static_cast<float>(im));
+        bf[i] = std::complex<float>(static_cast<float>(im), static_cast<float>(-re));
+        cf[i] = std::complex<float>(1.0f, -2.0f);
+        ad[i] = std::complex<double>(re, im);
+        bd[i] = std::complex<double>(im, -re);
+        cd[i] = std::complex<double>(1.0, -2.0);
+        al[i] = std::complex<long double>(re, im);
+        bl[i] = std::complex<long double>(im, -re);
+        cl[i] = std::complex<long double>(1.0L, -2.0L);
+    }
+    clapfft::ComplexOps::multiply_add(af.data(), bf.data(), cf.data(), count);
+    clapfft::ComplexOps::multiply_add(ad.data(), bd.data(), cd.data(), count);
+    clapfft::ComplexOps::multiply_add(al.data(), bl.data(), cl.data(), count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        assert(std::abs(cf[i] - (std::complex<float>(1.0f, -2.0f) + af[i] * bf[i])) <= 1e-5f);
+        assert(std::abs(cd[i] - (std::complex<double>(1.0, -2.0) + ad[i] * bd[i])) <= 1e-12);
+        assert(std::abs(cl[i] - (std::complex<long double>(1.0L, -2.0L) + al[i] * bl[i])) <= 1e-12L);
+    }
+}
+
+void test_long_kernel_stream()
+{
+    std::cout << "Testing mono streaming with a multi-partition kernel..." << std::endl;
+    const std::vector<double> kernel = make_response<double>(1000);
+    const std::vector<double> signal = two_tone<double>(3000, 0.0);
+    const std::vector<double> expected = direct_convolution(signal, kernel);
+
+    clapfft::PartitionedConvolver<double> conv(kernel, 1, 64);
+    assert(conv.valid());
+    assert(conv.taps() == 1000 && conv.channels() == 1);
+    assert(conv.block_size() == 64 && conv.partitions() == 16);
+
+    std::vector<double> out;
+    const std::size_t chunks[] = {1, 17, 64, 3, 500, 128};
+    std::size_t pos = 0;
+    for (std::size_t c = 0; pos < signal.size(); c = (c + 1) % 6)
+    {
+        const std::size_t count = std::min(chunks[c], signal.size() - pos);
+        const std::vector<double> chunk(signal.begin() + static_cast<std::ptrdiff_t>(pos),
+                                        signal.begin() + static_cast<std::ptrdiff_t>(pos + count));
+        const std::size_t ready = conv.output_ready(count);
+        const std::size_t produced = conv.push(chunk, out);
+        assert(produced == ready && produced % 64 == 0);
+        (void)ready;
+        (void)produced;
+        pos += count;
+        // Latency is one block: everything up to the last whole block is out.
+        assert(out.size() == pos / 64 * 64);
+    }
+    const std::size_t tail = conv.flush(out);
+    assert(out.size() == expected.size());
+    assert(tail == signal.size() % 64 + kernel.size() - 1);
+    (void)tail;
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        assert(std::abs(out[i] - expected[i]) <= 1e-9);
+    }
+
+    // After flush, the delay line starts over from silence.
+    std::vector<double> again;
+    conv.push(signal, again);
+    conv.flush(again);
+    assert(again.size() == expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        assert(std::abs(again[i] - expected[i]) <= 1e-9);
+    }
+}
+
+void test_block_size_and_latency()
+{
+    std::cout << "Testing block-size independence and one-block latency..." << std::endl;
+    const std::vector<double> kernel = make_response<double>(500);
+    const std::vector<double> signal = two_tone<double>(1000, 0.2);
+
+    // Partitioning is an implementation detail: every block size gives
+    // the same output, partial last partitions included.
+    std::vector<double> first;
+    const std::size_t blocks[] = {16, 37, 64, 500, 512};
+    for (std::size_t b = 0; b < sizeof(blocks) / sizeof(blocks[0]); ++b)
+    {
+        clapfft::PartitionedConvolver<double> conv(kernel, 1, blocks[b]);
+        assert(conv.partitions() == (500 + blocks[b] - 1) / blocks[b]);
+        std::vector<double> out;
+        conv.push(signal, out);
+        conv.flush(out);
+        assert(out.size() == signal.size() + kernel.size() - 1);
+        if (b == 0)
+        {
+            first = out;
+            continue;
+        }
+        for (std::size_t i = 0; i < out.size(); ++i)
+        {
+            assert(std::abs(out[i] - first[i]) <= 1e-10);
+        }
+    }
+
+    // Fed one sample at a time, an impulse's response starts the moment
+    // its block completes, and nothing comes out before then.
+    const std::size_t block = 32;
+    clapfft::PartitionedConvolver<double> conv(kernel, 1, block);
+    const std::vector<double> pulse = clapfft_test::impulse<double>(3 * block, 0);
+    std::vector<double> out;
+    for (std::size_t t = 0; t < pulse.size(); ++t)
+    {
+        const std::size_t produced = conv.push(std::vector<double>(1, pulse[t]), out);
+        assert(produced == ((t + 1) % block == 0 ? block : 0));
+        (void)produced;
+    }
+    assert(out.size() == pulse.size());
+    for (std::size_t i = 0; i < out.size(); ++i)
+    {
+        assert(std::abs(out[i] - kernel[i]) <= 1e-12);
+    }
+}
+
+void test_multichannel_batched()
+{
+    std::cout << "Testing batched multi-channel partitioned convolution..." << std::endl;
+    const std::size_t channels = 3;
+    const std::vector<float> kernel = make_response<float>(300);
+    std::vector<std::vector<float>> signals(channels);
+    for (std::size_t c = 0; c < channels; ++c)
+    {
+        signals[c] = two_tone<float>(700, 0.7 * static_cast<double>(c));
+    }
+
+    clapfft::PartitionedConvolver<float> conv(kernel, channels, 32);
+    assert(conv.partitions() == 10);
+
+    std::vector<std::vector<float>> out;
+    for (std::size_t pos = 0; pos < 700; pos += 100)
+    {
+        std::vector<std::vector<float>> chunk(channels);
+        for (std::size_t c = 0; c < channels; ++c)
+        {
+            chunk[c].assign(signals[c].begin() + static_cast<std::ptrdiff_t>(pos),
+                            signals[c].begin() + static_cast<std::ptrdiff_t>(pos + 100));
+        }
+        conv.push(chunk, out);
+    }
+    conv.flush(out);
+    assert(out.size() == channels);
+    for (std::size_t c = 0; c < channels; ++c)
+    {
+        const std::vector<float> expected = direct_convolution(signals[c], kernel);
+        assert(out[c].size() == expected.size());
+        for (std::size_t i = 0; i < expected.size(); ++i)
+        {
+            assert(std::abs(out[c][i] - expected[i]) <= 1e-3f);
+        }
+    }
+}
+
+void test_edge_cases()
+{
+    std::cout << "Testing short kernels and invalid use..." << std::endl;
+    // Kernel shorter than one block: a single partition.
+    const std::vector<double> kernel = make_response<double>(5);
+    const std::vector<double> signal = two_tone<double>(200, 0.3);
+    const std::vector<double> expected = direct_convolution(signal, kernel);
+    clapfft::PartitionedConvolver<double> short_conv(kernel, 1, 16);
+    assert(short_conv.partitions() == 1);
+    std::vector<double> out;
+    short_conv.push(signal, out);
+    short_conv.flush(out);
+    assert(out.size() == expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        assert(std::abs(out[i] - expected[i]) <= 1e-12);
+    }
+
+    clapfft::PartitionedConvolver<long double> gain(std::vector<long double>(1, 2.0L), 1, 4);
+    assert(gain.valid() && gain.taps() == 1);
+    std::vector<long double> in(10, 1.5L), scaled;
+    gain.push(in, scaled);
+    gain.flush(scaled);
+    assert(scaled.size() == 10);
+    for (std::size_t i = 0; i < scaled.size(); ++i)
+    {
+        assert(std::abs(scaled[i] - 3.0L) <= 1e-15L);
+    }
+
+    assert(!clapfft::PartitionedConvolver<double>(std::vector<double>()).valid());
+    assert(!clapfft::PartitionedConvolver<double>(std::vector<double>(4, 1.0), 0).valid());
+    assert(!clapfft::PartitionedConvolver<double>(std::vector<double>(4, 1.0), 1, 0).valid());
+    clapfft::PartitionedConvolver<double> stereo(std::vector<double>(4, 1.0), 2);
+    std::vector<double> mono_out;
+    std::size_t produced = stereo.push(std::vector<double>(1000, 1.0), mono_out);
+    assert(produced == 0 && mono_out.empty());
+    produced = stereo.flush(mono_out);
+    assert(produced == 0);
+    (void)produced;
+}
+
+int main()
+{
+    test_complex_multiply_add();
+    test_long_kernel_stream();
+    test_block_size_and_latency();
+    test_multichannel_batched();
+    test_edge_cases();
+    std::cout << "All partitioned convolver tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,305 @@
+#include <fftw3.h>
+#include <clapfft/clapfft_api.hpp>
+#include <clapfft/fft_plan_cache.hpp>
+#include <atomic>
+#include <set>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+void test_wrapper_survives_cleanup()
+{
+    std::cout << "Testing wrapper lifetime across cleanup..." << std::endl;
+    const int n = 32;
+    auto wrapper = clapfft::PlanCache<double>::get_c2c_1d(n, FFTW_FORWARD);
+    clapfft::PlanCache<double>::cleanup();
+    assert(clapfft::PlanCache<double>::size() == 0);
+
+    // The plan must still be usable through the reference we hold.
+    std::vector<std::complex<double>> in(static_cast<std::size_t>(n), std::complex<double>(1.0, 0.0));
+    std::vector<std::complex<double>> out(static_cast<std::size_t>(n));
+    fftw_execute_dft(reinterpret_cast<fftw_plan>(wrapper->plan),
+                     reinterpret_cast<fftw_complex *>(in.data()),
+                     reinterpret_cast<fftw_complex *>(out.data()));
+    assert(std::abs(out[0].real() - n) <= 1e-9);
+
+    auto fresh = clapfft::PlanCache<double>::get_c2c_1d(n, FFTW_FORWARD);
+    assert(fresh != wrapper);
+}
+
+void test_shrink_prefers_idle_plans()
+{
+    std::cout << "Testing shrink_to eviction order..." << std::endl;
+    clapfft::PlanCache<float>::cleanup();
+    auto held = clapfft::PlanCache<float>::get_c2c_1d(8, FFTW_FORWARD);
+    clapfft::PlanCache<float>::get_c2c_1d(16, FFTW_FORWARD);
+    clapfft::PlanCache<float>::get_c2c_1d(24, FFTW_FORWARD);
+    assert(clapfft::PlanCache<float>::size() == 3);
+
+    clapfft::PlanCache<float>::shrink_to(1);
+    assert(clapfft::PlanCache<float>::size() == 1);
+    assert(clapfft::PlanCache<float>::get_c2c_1d(8, FFTW_FORWARD) == held);
+
+    clapfft::PlanCache<float>::shrink_to(0);
+    assert(clapfft::PlanCache<float>::size() == 0);
+}
+
+void test_cleanup_during_execution()
+{
+    std::cout << "Testing cleanup concurrent with execution..." << std::endl;
+    const int n = 64;
+    const int workers = 4;
+    std::atomic<bool> stop(false);
+    std::atomic<int> failures(0);
+
+    std::vector<std::complex<double>> input(static_cast<std::size_t>(n));
+    for (int i = 0; i < n; ++i)
+    {
+        input[static_cast<std::size_t>(i)] = std::complex<double>(std::cos(0.3 * i), std::sin(0.1 * i));
+    }
+
+    std::vector<std::thread> pool;
+    for (int t = 0; t < workers; ++t)
+    {
+        pool.emplace_back([&]()
+                          {
+            std::vector<std::complex<double>> spectrum;
+            std::vector<std::complex<double>> recovered;
+            while (!stop.load())
+            {
+                clapfft::FFT::c2c_1d(input, spectrum, FFTW_FORWARD);
+                clapfft::FFT::c2c_1d(spectrum, recovered, FFTW_BACKWARD);
+                for (int i = 0; i < n; ++i)
+                {
+                    const std::complex<double> v = recovered[static_cast<std::size_t>(i)] / static_cast<double>(n);
+                    if (std::abs(v - input[static_cast<std::size_t>(i)]) > 1e-9)
+                    {
+                        failures.fetch_add(1);
+                    }
+                }
+            } });
+    }
+
+    for (int i = 0; i < 200; ++i)
+    {
+        if (i % 2 == 0)
+        {
+            clapfft::PlanCache<double>::cleanup();
+        }
+        else
+        {
+            clapfft::PlanCache<double>::shrink_to(0);
+        }
+        std::this_thread::yield();
+    }
+    stop.store(true);
+    for (std::size_t i = 0; i < pool.size(); ++i)
+    {
+        pool[i].join();
+    }
+    assert(failures.load() == 0);
+}
+
+void test_stats_and_entries()
+{
+    std::cout << "Testing plan cache statistics..." << std::endl;
+    clapfft::PlanCache<long double>::cleanup();
+    clapfft::PlanCache<long double>::reset_stats();
+
+    std::vector<long double> real(16, 1.0L);
+    std::vector<std::complex<long double>> spectrum;
+    for (int i = 0; i < 3; ++i)
+    {
+        clapfft::FFT::r2c_1d(real, spectrum);
+    }
+    std::vector<std::complex<long double>> c(8);
+    std::vector<std::complex<long double>> c_out;
+    clapfft::FFT::c2c_1d(c, c_out, FFTW_FORWARD);
+
+    const clapfft::PlanCacheStats stats = clapfft::PlanCache<long double>::stats();
+    const clapfft::PlanCacheKindStats &r2c = stats[clapfft::TransformKind::R2C];
+    assert(r2c.misses == 1);
+    assert(r2c.hits == 2);
+    assert(r2c.executions == 3);
+    assert(r2c.plans == 1);
+    assert(r2c.estimated_bytes > 0);
+    assert(stats[clapfft::TransformKind::C2C].executions == 1);
+    assert(stats.total().plans == 2);
+    assert(std::abs(r2c.hit_rate() - 2.0 / 3.0) < 1e-12);
+
+    const std::vector<clapfft::PlanCacheEntry> entries = clapfft::PlanCache<long double>::entries();
+    assert(entries.size() == 2);
+    for (std::size_t i = 0; i < entries.size(); ++i)
+    {
+        if (entries[i].key.kind == clapfft::TransformKind::R2C)
+        {
+            assert(entries[i].key.n[0] == 16);
+            assert(entries[i].executions == 3);
+            assert(entries[i].use_count == 0);
+        }
+    }
+
+    // Counters of evicted plans are kept in the per-kind totals.
+    clapfft::PlanCache<long double>::cleanup();
+    const clapfft::PlanCacheStats after = clapfft::PlanCache<long double>::stats();
+    assert(after[clapfft::TransformKind::R2C].executions == 3);
+    assert(after[clapfft::TransformKind::R2C].plans == 0);
+    (void)r2c;
+    (void)after;
+}
+
+void test_thread_local_front_end()
+{
+    std::cout << "Testing thread-local plan cache..." << std::endl;
+    std::thread worker([]()
+                       {
+        clapfft::PlanCache<double>::set_thread_local_cache(true);
+        auto a = clapfft::PlanCache<double>::get_r2c_1d(48);
+        auto b = clapfft::PlanCache<double>::get_r2c_1d(48);
+        assert(a == b);
+
+        // Eviction from the global cache must invalidate the local slot.
+        clapfft::PlanCache<double>::cleanup();
+        assert(a->evicted.load());
+        auto c = clapfft::PlanCache<double>::get_r2c_1d(48);
+        assert(c != a);
+        assert(!c->evicted.load());
+        assert(clapfft::PlanCache<double>::size() == 1);
+
+        clapfft::PlanCache<double>::shrink_to(0);
+        auto d = clapfft::PlanCache<double>::get_r2c_1d(48);
+        assert(d != c);
+
+        std::vector<double> in(48, 1.0);
+        std::vector<std::complex<double>> out;
+        clapfft::FFT::r2c_1d(in, out);
+        assert(std::abs(out[0].real() - 48.0) <= 1e-9);
+        clapfft::PlanCache<double>::set_thread_local_cache(false); });
+    worker.join();
+}
+
+void test_plan_key_hash_spread()
+{
+    std::cout << "Testing plan key hashing..." << std::endl;
+    clapfft::PlanKeyHash hash;
+    std::set<std::size_t> seen;
+    int keys = 0;
+    for (int n0 = 1; n0 <= 24; ++n0)
+    {
+        for (int n1 = 1; n1 <= 24; ++n1)
+        {
+            const int dims[2] = {n0, n1};
+            clapfft::PlanKey key(clapfft::TransformKind::C2C, 2, dims, clapfft::CLAP_FFT_ESTIMATE);
+            key.sign = FFTW_FORWARD;
+            seen.insert(hash(key));
+            ++keys;
+        }
+    }
+    // Swapped dimensions and neighbouring sizes must not collide.
+    assert(static_cast<int>(seen.size()) == keys);
+
+    const int n[1] = {64};
+    clapfft::PlanKey a(clapfft::TransformKind::C2C, 1, n, clapfft::CLAP_FFT_ESTIMATE);
+    clapfft::PlanKey b = a;
+    b.howmany = 4;
+    b.idist = 64;
+    b.odist = 64;
+    assert(a != b);
+    clapfft::PlanKey c = a;
+    c.in_place = true;
+    assert(a != c && hash(a) != hash(c));
+    clapfft::PlanKey d = a;
+    d.idist = 128; // irrelevant for a single transform
+    d.normalize();
+    assert(a == d);
+    (void)keys;
+    (void)b;
+    (void)c;
+}
+
+void test_advanced_shares_cache()
+{
+    std::cout << "Testing advanced plans share the cache..." << std::endl;
+    clapfft::PlanCache<double>::cleanup();
+    const int n = 16;
+    const int howmany = 3;
+    std::vector<std::complex<double>> in(static_cast<std::size_t>(n * howmany), std::complex<double>(1.0, 0.0));
+    std::vector<std::complex<double>> out(in.size());
+    int dims[1] = {n};
+    for (int i = 0; i < 2; ++i)
+    {
+        clapfft::AdvancedFFT::many_dft<double>(1, dims, howmany, in.data(), nullptr, 1, n,
+                                               out.data(), nullptr, 1, n, FFTW_FORWARD);
+    }
+    // In-place is a different plan.
+    clapfft::AdvancedFFT::many_dft<double>(1, dims, howmany, in.data(), nullptr, 1, n,
+                                           in.data(), nullptr, 1, n, FFTW_FORWARD);
+    assert(clapfft::PlanCache<double>::size() == 2);
+
+    assert(std::abs(out[static_cast<std::size_t>(n)].real() - n) <= 1e-9);
+    assert(std::abs(in[0].real() - n) <= 1e-9);
+
+    const std::vector<clapfft::PlanCacheEntry> entries = clapfft::PlanCache<double>::entries();
+    for (std::size_t i = 0; i < entries.size(); ++i)
+    {
+        assert(entries[i].key.howmany == howmany);
+        assert(entries[i].executions == (entries[i].key.in_place ? 1u : 2u));
+    }
+
+    // get() normalizes: a single transform with a stray distance and a
+    // tight explicit embedding is the plain plan.
+    clapfft::PlanKey plain(clapfft::TransformKind::C2C, 1, dims, clapfft::CLAP_FFT_DEFAULT);
+    plain.sign = FFTW_FORWARD;
+    clapfft::PlanKey stray = plain;
+    stray.idist = 40;
+    stray.inembed[0] = n;
+    const std::shared_ptr<clapfft::PlanCache<double>::Wrapper> first = clapfft::PlanCache<double>::get(plain);
+    const std::shared_ptr<clapfft::PlanCache<double>::Wrapper> second = clapfft::PlanCache<double>::get(stray);
+    assert(first && first == second && clapfft::PlanCache<double>::size() == 3);
+    (void)first;
+    (void)second;
+}
+
+void test_thread_count_in_key()
+{
+    std::cout << "Testing thread count in plan keys..." << std::endl;
+    clapfft::PlanCache<float>::cleanup();
+    auto single = clapfft::PlanCache<float>::get_c2c_2d(16, 16, FFTW_FORWARD);
+    auto threaded = clapfft::PlanCache<float>::get_c2c_2d(16, 16, FFTW_FORWARD, clapfft::CLAP_FFT_DEFAULT, 4);
+    auto zero = clapfft::PlanCache<float>::get_c2c_2d(16, 16, FFTW_FORWARD, clapfft::CLAP_FFT_DEFAULT, 0);
+    assert(zero == single);
+    if (clapfft::PlanCache<float>::threads_available())
+    {
+        assert(threaded != single);
+        assert(threaded->key.nthreads == 4);
+    }
+    else
+    {
+        // Without the threads libraries every request shares the serial plan.
+        assert(threaded == single);
+    }
+
+    std::vector<std::vector<std::complex<float>>> in(16, std::vector<std::complex<float>>(16, std::complex<float>(1.0f, 0.0f)));
+    std::vector<std::vector<std::complex<float>>> out;
+    clapfft::FFT::c2c_2d(in, out, FFTW_FORWARD, clapfft::CLAP_FFT_DEFAULT, 4);
+    assert(std::abs(out[0][0].real() - 256.0f) <= 1e-3f);
+    assert(std::abs(out[3][5]) <= 1e-3f);
+    (void)zero;
+}
+
+int main()
+{
+    test_wrapper_survives_cleanup();
+    test_shrink_prefers_idle_plans();
+    test_cleanup_during_execution();
+    test_stats_and_entries();
+    test_thread_local_front_end();
+    test_plan_key_hash_spread();
+    test_advanced_shares_cache();
+    test_thread_count_in_key();
+    std::cout << "All plan cache tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,116 @@
+#include <fftw3.h>
+#include <clapfft/clapfft_api.hpp>
+#include <clapfft/fft_plan_cache.hpp>
+#include <clapfft/planning_policy.hpp>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+using clapfft::PlanningPolicy;
+using clapfft::TransformKind;
+
+void test_set_get_resolve()
+{
+    std::cout << "Testing policy set/get/resolve..." << std::endl;
+    PlanningPolicy::reset();
+    assert(PlanningPolicy::get<double>(TransformKind::C2C) == clapfft::CLAP_FFT_ESTIMATE);
+
+    PlanningPolicy::set<double>(TransformKind::C2C, clapfft::CLAP_FFT_MEASURE);
+    assert(PlanningPolicy::get<double>(TransformKind::C2C) == clapfft::CLAP_FFT_MEASURE);
+    assert(PlanningPolicy::get<double>(TransformKind::R2C) == clapfft::CLAP_FFT_ESTIMATE);
+    assert(PlanningPolicy::get<float>(TransformKind::C2C) == clapfft::CLAP_FFT_ESTIMATE);
+
+    // Explicit flags are never overridden.
+    assert(PlanningPolicy::resolve<double>(TransformKind::C2C, clapfft::CLAP_FFT_ESTIMATE) == clapfft::CLAP_FFT_ESTIMATE);
+    assert(PlanningPolicy::resolve<double>(TransformKind::C2C, clapfft::CLAP_FFT_DEFAULT) == clapfft::CLAP_FFT_MEASURE);
+    assert(PlanningPolicy::resolve<double>(TransformKind::C2C, clapfft::CLAP_FFT_DEFAULT | clapfft::CLAP_FFT_UNALIGNED) ==
+           (clapfft::CLAP_FFT_MEASURE | clapfft::CLAP_FFT_UNALIGNED));
+
+    PlanningPolicy::set_all<long double>(clapfft::CLAP_FFT_PATIENT);
+    assert(PlanningPolicy::get<long double>(TransformKind::R2R) == clapfft::CLAP_FFT_PATIENT);
+    PlanningPolicy::reset();
+    assert(PlanningPolicy::get<long double>(TransformKind::R2R) == clapfft::CLAP_FFT_ESTIMATE);
+}
+
+void test_load_from_string()
+{
+    std::cout << "Testing policy parsing..." << std::endl;
+    PlanningPolicy::reset();
+    bool ok = PlanningPolicy::load_from_string(" double.c2c = measure; long_double=patient ,float.R2R=exhaustive # tuned");
+    assert(ok);
+    assert(PlanningPolicy::get<double>(TransformKind::C2C) == clapfft::CLAP_FFT_MEASURE);
+    assert(PlanningPolicy::get<double>(TransformKind::C2R) == clapfft::CLAP_FFT_ESTIMATE);
+    assert(PlanningPolicy::get<long double>(TransformKind::R2C) == clapfft::CLAP_FFT_PATIENT);
+    assert(PlanningPolicy::get<float>(TransformKind::R2R) == clapfft::CLAP_FFT_EXHAUSTIVE);
+
+    // Malformed entries are reported but do not stop the valid ones.
+    ok = PlanningPolicy::load_from_string("quad.c2c=measure; *.r2c=measure; double.c2c=fast; float");
+    assert(!ok);
+    assert(PlanningPolicy::get<float>(TransformKind::R2C) == clapfft::CLAP_FFT_MEASURE);
+    assert(PlanningPolicy::get<double>(TransformKind::C2C) == clapfft::CLAP_FFT_MEASURE);
+    PlanningPolicy::reset();
+    (void)ok;
+}
+
+void test_load_from_file()
+{
+    std::cout << "Testing policy files..." << std::endl;
+    PlanningPolicy::reset();
+    const char *filename = "test_planning_policy.conf";
+    {
+        std::ofstream file(filename);
+        file << "# planner policy\n"
+             << "double.r2c=measure\n"
+             << "\n"
+             << "*.c2r=patient\n";
+    }
+    bool ok = PlanningPolicy::load_from_file(filename);
+    std::remove(filename);
+    assert(ok);
+    assert(PlanningPolicy::get<double>(TransformKind::R2C) == clapfft::CLAP_FFT_MEASURE);
+    assert(PlanningPolicy::get<float>(TransformKind::C2R) == clapfft::CLAP_FFT_PATIENT);
+    assert(!PlanningPolicy::load_from_file("does_not_exist.conf"));
+    PlanningPolicy::reset();
+    (void)ok;
+}
+
+void test_cache_uses_policy()
+{
+    std::cout << "Testing cache keys follow the policy..." << std::endl;
+    PlanningPolicy::reset();
+    clapfft::PlanCache<double>::cleanup();
+    PlanningPolicy::set<double>(TransformKind::C2C, clapfft::CLAP_FFT_MEASURE);
+
+    std::vector<std::complex<double>> in(32, std::complex<double>(1.0, 0.0));
+    std::vector<std::complex<double>> out;
+    clapfft::FFT::c2c_1d(in, out, -1);
+    assert(std::abs(out[0].real() - 32.0) <= 1e-9);
+
+    // Defaulted and explicit requests for the same flags share one plan.
+    auto defaulted = clapfft::PlanCache<double>::get_c2c_1d(32, -1);
+    auto explicit_measure = clapfft::PlanCache<double>::get_c2c_1d(32, -1, clapfft::CLAP_FFT_MEASURE);
+    assert(defaulted == explicit_measure);
+    assert(clapfft::PlanCache<double>::size() == 1);
+
+    const std::vector<clapfft::PlanCacheEntry> entries = clapfft::PlanCache<double>::entries();
+    assert(entries.size() == 1 && entries[0].key.flags == clapfft::CLAP_FFT_MEASURE);
+
+    PlanningPolicy::reset();
+    clapfft::FFT::c2c_1d(in, out, -1);
+    assert(clapfft::PlanCache<double>::size() == 2);
+    clapfft::PlanCache<double>::cleanup();
+}
+
+int main()
+{
+    test_set_get_resolve();
+    test_load_from_string();
+    test_load_from_file();
+    test_cache_uses_policy();
+    std::cout << "All planning policy tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,168 @@
+#include <fftw3.h>
+#include <clapfft/pruned_dft.hpp>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    template <typename T>
+    std::vector<T> make_signal(std::size_t n)
+    {
+        std::vector<T> x(n);
+        for (std::size_t j = 0; j < n; ++j)
+        {
+            const double t = static_cast<double>(j);
+            x[j] = static_cast<T>(std::sin(0.013 * t) + 0.25 * std::cos(2.9 * t + 1.0) + 0.1 * std::sin(0.7 * t * t));
+        }
+        return x;
+    }
+
+    template <typename T>
+    std::complex<long double> dft_bin(const std::vector<T> &x, std::size_t k)
+    {
+        const long double two_pi = 6.283185307179586476925286766559L;
+        const std::size_t n = x.size();
+        std::complex<long double> sum;
+        for (std::size_t j = 0; j < n; ++j)
+        {
+            const long double angle = -two_pi * static_cast<long double>((k * j) % n) / static_cast<long double>(n);
+            sum += static_cast<long double>(x[j]) * std::complex<long double>(std::cos(angle), std::sin(angle));
+        }
+        return sum;
+    }
+
+    // Largest error of `dft` over its bins, relative to sqrt(n) (the
+    // size of a bin of unit-variance noise).
+    template <typename T>
+    long double worst_error(clapfft::PrunedDFT<T> &dft, const std::vector<T> &x)
+    {
+        std::vector<std::complex<T>> out(dft.bins().size());
+        const bool ok = dft.transform(x.data(), out.data());
+        assert(ok);
+        (void)ok;
+        long double worst = 0;
+        for (std::size_t i = 0; i < out.size(); ++i)
+        {
+            const std::complex<long double> got(out[i].real(), out[i].imag());
+            worst = std::max(worst, std::abs(got - dft_bin(x, dft.bins()[i])));
+        }
+        return worst / std::sqrt(static_cast<long double>(x.size()));
+    }
+
+    // Goertzel's recurrence loses more near bins 0 and n / 2, where its
+    // pole pair nearly coincides; the FFT paths are held tighter.
+    template <typename T>
+    void check_methods(long double goertzel_tolerance, long double tolerance)
+    {
+        const std::size_t n = 720;
+        const std::vector<std::size_t> bins = {0, 1, 7, 100, 359, 360, 361, 500, 719, 7};
+        const std::vector<T> x = make_signal<T>(n);
+
+        clapfft::PrunedDFT<T> goertzel(n, bins, clapfft::PruningMethod::Goertzel);
+        assert(goertzel.valid() && goertzel.method() == clapfft::PruningMethod::Goertzel);
+        assert(goertzel.size() == n && goertzel.bins() == bins && goertzel.factor() == 0);
+        long double error = worst_error(goertzel, x);
+        assert(error <= goertzel_tolerance);
+
+        // Even and odd factors, both ends, and the cost model's own pick.
+        const std::size_t factors[] = {2, 5, 9, 16, 45, 720, 0};
+        for (std::size_t f = 0; f < sizeof(factors) / sizeof(factors[0]); ++f)
+        {
+            clapfft::PrunedDFT<T> split(n, bins, clapfft::PruningMethod::Decomposition, factors[f]);
+            assert(split.valid() && split.method() == clapfft::PruningMethod::Decomposition);
+            assert(factors[f] == 0 ? n % split.factor() == 0 : split.factor() == factors[f]);
+            error = worst_error(split, x);
+            assert(error <= tolerance);
+        }
+        (void)error;
+        (void)goertzel_tolerance;
+        (void)tolerance;
+    }
+}
+
+void test_against_direct_dft()
+{
+    std::cout << "Testing Goertzel and decompositions against the direct DFT..." << std::endl;
+    check_methods<float>(1e-6L, 2e-5L);
+    check_methods<double>(1e-10L, 1e-13L);
+    check_methods<long double>(1e-10L, 1e-13L);
+}
+
+void test_cost_model()
+{
+    std::cout << "Testing the method choice..." << std::endl;
+    using Cost = clapfft::PrunedDFT<double>;
+    const std::size_t n = 65536;
+    std::vector<std::size_t> few, many, all;
+    for (std::size_t k = 0; k < 16; ++k)
+    {
+        few.push_back(1000 + 37 * k);
+    }
+    for (std::size_t k = 0; k < n; k += 3)
+    {
+        (k < 3000 ? many : all).push_back(k);
+    }
+
+    // Few bins of a power of two: a small factor, far cheaper than both
+    // Goertzel and the full transform.
+    Cost sparse(n, few);
+    assert(sparse.valid() && sparse.method() == clapfft::PruningMethod::Decomposition);
+    assert(sparse.factor() > 2 && sparse.factor() < 256);
+    const double chosen = Cost::estimated_cost(n, few.size(), sparse.method(), sparse.factor());
+    assert(chosen < Cost::estimated_cost(n, few.size(), clapfft::PruningMethod::Goertzel, 0));
+    assert(chosen < Cost::estimated_cost(n, few.size(), clapfft::PruningMethod::Decomposition, n));
+    (void)chosen;
+
+    // More bins push the factor up, and most of the spectrum is the
+    // full r2c.
+    Cost dense(n, many);
+    assert(dense.method() == clapfft::PruningMethod::Decomposition && dense.factor() > sparse.factor());
+    Cost full(n, all);
+    assert(full.method() == clapfft::PruningMethod::Decomposition && full.factor() == n);
+
+    // A prime size has no decomposition but the slow full transform.
+    const std::size_t prime = 65521;
+    Cost goertzel(prime, few);
+    assert(goertzel.valid() && goertzel.method() == clapfft::PruningMethod::Goertzel);
+    assert(Cost(prime, many).factor() == prime);
+
+    assert(std::isinf(Cost::estimated_cost(n, 4, clapfft::PruningMethod::Decomposition, 3)));
+    assert(std::isinf(Cost::estimated_cost(n, 4, clapfft::PruningMethod::Decomposition, 1)));
+}
+
+void test_invalid()
+{
+    std::cout << "Testing invalid configurations..." << std::endl;
+    assert(!clapfft::PrunedDFT<double>(0, {0}).valid());
+    assert(!clapfft::PrunedDFT<double>(8, {}).valid());
+    assert(!clapfft::PrunedDFT<double>(8, {8}).valid());
+    assert(!clapfft::PrunedDFT<double>(8, {1}, clapfft::PruningMethod::Decomposition, 3).valid());
+    assert(!clapfft::PrunedDFT<double>(8, {1}, clapfft::PruningMethod::Decomposition, 1).valid());
+    assert(!clapfft::PrunedDFT<double>(1, {0}, clapfft::PruningMethod::Decomposition).valid());
+
+    // One sample: X[0] = x[0] either way.
+    clapfft::PrunedDFT<float> single(1, {0});
+    const float sample = 2.5f;
+    std::complex<float> out;
+    bool ok = single.transform(&sample, &out);
+    assert(ok && single.method() == clapfft::PruningMethod::Goertzel && out == std::complex<float>(2.5f));
+
+    clapfft::PrunedDFT<double> none;
+    const double in = 1.0;
+    std::complex<double> bin;
+    ok = none.transform(&in, &bin);
+    assert(!ok && none.size() == 0 && none.bins().empty() && none.factor() == 0);
+    (void)ok;
+}
+
+int main()
+{
+    test_against_direct_dft();
+    test_cost_model();
+    test_invalid();
+    std::cout << "All pruned DFT tests passed!" << std::endl;
+    return 0;
+}
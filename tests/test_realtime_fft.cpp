@@ -0,0 +1,181 @@
+#include <fftw3.h>
+#include <clapfft/realtime_fft.hpp>
+#include <clapfft/clapfft_api.hpp>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    std::atomic<int> violations(0);
+
+    void count_violation(const char *)
+    {
+        violations.fetch_add(1);
+    }
+}
+
+void test_aligned_buffer()
+{
+    std::cout << "Testing aligned buffers..." << std::endl;
+    clapfft::AlignedBuffer<std::complex<float>> a(37);
+    assert(a.size() == 37);
+    assert(reinterpret_cast<std::uintptr_t>(a.data()) % clapfft::realtime_alignment == 0);
+    assert(a[36] == std::complex<float>(0.0f, 0.0f));
+
+    clapfft::AlignedBuffer<std::complex<float>> b(std::move(a));
+    assert(b.size() == 37 && a.size() == 0 && a.data() == nullptr);
+    clapfft::AlignedBuffer<double> empty;
+    assert(empty.size() == 0);
+}
+
+void test_realtime_transforms()
+{
+    std::cout << "Testing realtime c2c/r2c/c2r/r2r..." << std::endl;
+    const int n = 64;
+
+    clapfft::RealtimeFFT<double> fwd = clapfft::RealtimeFFT<double>::c2c(1, &n, FFTW_FORWARD);
+    assert(fwd.valid());
+    assert(fwd.input_size() == 64 && fwd.output_size() == 64);
+    clapfft::AlignedBuffer<std::complex<double>> in(n), out(n);
+    std::vector<std::complex<double>> ref_in(n);
+    for (int i = 0; i < n; ++i)
+    {
+        in[i] = ref_in[i] = std::complex<double>(std::cos(0.3 * i), std::sin(0.1 * i));
+    }
+    bool ok = fwd.execute(in.data(), out.data());
+    assert(ok);
+    std::vector<std::complex<double>> expected;
+    clapfft::FFT::c2c_1d(ref_in, expected, FFTW_FORWARD);
+    for (int i = 0; i < n; ++i)
+    {
+        assert(std::abs(expected[i] - out[i]) <= 1e-9);
+    }
+
+    // Planned out of place: in-place and misaligned calls are refused.
+    ok = fwd.execute(in.data(), in.data());
+    assert(!ok);
+    ok = fwd.execute(in.data() + 1, out.data());
+    assert(!ok);
+    // Wrong overload for the kind.
+    clapfft::AlignedBuffer<double> real(n), real_out(n);
+    ok = fwd.execute(real.data(), real_out.data());
+    assert(!ok);
+
+    clapfft::RealtimeFFT<double> in_place = clapfft::RealtimeFFT<double>::c2c(1, &n, FFTW_FORWARD, true);
+    ok = in_place.execute(in.data(), in.data());
+    assert(ok);
+    for (int i = 0; i < n; ++i)
+    {
+        assert(std::abs(expected[i] - in[i]) <= 1e-9);
+    }
+
+    // r2c then c2r of a 2D field; c2r leaves its input alone.
+    const int dims[2] = {8, 10};
+    clapfft::RealtimeFFT<float> r2c = clapfft::RealtimeFFT<float>::r2c(2, dims);
+    clapfft::RealtimeFFT<float> c2r = clapfft::RealtimeFFT<float>::c2r(2, dims);
+    assert(r2c.valid() && c2r.valid());
+    assert(r2c.input_size() == 80 && r2c.output_size() == 48);
+    assert(c2r.input_size() == 48 && c2r.output_size() == 80);
+    clapfft::AlignedBuffer<float> field(80), back(80);
+    clapfft::AlignedBuffer<std::complex<float>> spectrum(48);
+    for (std::size_t i = 0; i < field.size(); ++i)
+    {
+        field[i] = static_cast<float>(std::sin(0.2 * static_cast<double>(i)));
+    }
+    ok = r2c.execute(field.data(), spectrum.data());
+    assert(ok);
+    const std::complex<float> dc = spectrum[0];
+    ok = c2r.execute(spectrum.data(), back.data());
+    assert(ok);
+    assert(spectrum[0] == dc);
+    (void)dc;
+    for (std::size_t i = 0; i < field.size(); ++i)
+    {
+        assert(std::abs(back[i] / 80.0f - field[i]) <= 1e-4f);
+    }
+
+    const int kind = FFTW_REDFT10;
+    const int m = 16;
+    clapfft::RealtimeFFT<long double> dct = clapfft::RealtimeFFT<long double>::r2r(1, &m, &kind);
+    clapfft::AlignedBuffer<long double> ones(m), coeffs(m);
+    for (int i = 0; i < m; ++i)
+    {
+        ones[i] = 1.0L;
+    }
+    ok = dct.execute(ones.data(), coeffs.data());
+    assert(ok);
+    assert(std::abs(coeffs[0] - 32.0L) <= 1e-9L);
+    assert(std::abs(coeffs[5]) <= 1e-9L);
+
+    const int bad = 0;
+    clapfft::RealtimeFFT<double> invalid = clapfft::RealtimeFFT<double>::c2c(1, &bad, FFTW_FORWARD);
+    assert(!invalid.valid());
+    ok = invalid.execute(in.data(), out.data());
+    assert(!ok);
+    (void)ok;
+}
+
+void test_realtime_checks()
+{
+    std::cout << "Testing realtime checks..." << std::endl;
+    const int n = 32;
+    clapfft::RealtimeFFT<float> fft = clapfft::RealtimeFFT<float>::c2c(1, &n, FFTW_BACKWARD);
+    clapfft::AlignedBuffer<std::complex<float>> in(n), out(n);
+
+    clapfft::RealtimeChecks::set_handler(count_violation);
+    violations.store(0);
+    {
+        clapfft::RealtimeScope scope;
+        const bool ok = fft.execute(in.data(), out.data());
+        assert(ok);
+        (void)ok;
+    }
+    assert(violations.load() == 0);
+
+    {
+        clapfft::RealtimeScope scope;
+        int *volatile p = new int(3);
+        delete p;
+        std::mutex m;
+        m.lock();
+        m.unlock();
+        // The C allocator, which FFTW allocates through.
+        void *volatile q = std::malloc(16);
+        std::free(q);
+    }
+    if (clapfft::RealtimeChecks::available())
+    {
+#if defined(__GLIBC__)
+        assert(violations.load() == 5);
+#else
+        assert(violations.load() == 3);
+#endif
+    }
+    else
+    {
+        assert(violations.load() == 0);
+    }
+
+    // Outside a scope nothing is reported.
+    violations.store(0);
+    std::vector<int> v(100);
+    (void)v;
+    assert(violations.load() == 0);
+    clapfft::RealtimeChecks::set_handler(nullptr);
+}
+
+int main()
+{
+    test_aligned_buffer();
+    test_realtime_transforms();
+    test_realtime_checks();
+    std::cout << "All realtime FFT tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,52 @@
+#ifndef CLAPFFT_TEST_SIGNALS_HPP
+#define CLAPFFT_TEST_SIGNALS_HPP
+
+// Inputs and references shared by the streaming-filter tests.
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace clapfft_test
+{
+    // A slow sine plus a fast cosine: broadband enough that every
+    // partition and overlap boundary carries signal. `phase` shifts the
+    // slow component so channels and kernels differ.
+    template <typename T>
+    std::vector<T> two_tone(std::size_t length, double phase)
+    {
+        std::vector<T> signal(length);
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            signal[i] = static_cast<T>(std::sin(0.031 * static_cast<double>(i) + phase) +
+                                       0.5 * std::cos(1.7 * static_cast<double>(i)));
+        }
+        return signal;
+    }
+
+    // Unit impulse at `at`.
+    template <typename T>
+    std::vector<T> impulse(std::size_t length, std::size_t at)
+    {
+        std::vector<T> signal(length, T(0));
+        signal[at] = T(1);
+        return signal;
+    }
+
+    // Full linear convolution, x.size() + h.size() - 1 samples.
+    template <typename T>
+    std::vector<T> direct_convolution(const std::vector<T> &x, const std::vector<T> &h)
+    {
+        std::vector<T> y(x.size() + h.size() - 1, T(0));
+        for (std::size_t i = 0; i < x.size(); ++i)
+        {
+            for (std::size_t k = 0; k < h.size(); ++k)
+            {
+                y[i + k] += x[i] * h[k];
+            }
+        }
+        return y;
+    }
+} // namespace clapfft_test
+
+#endif // CLAPFFT_TEST_SIGNALS_HPP
@@ -0,0 +1,225 @@
+#include <fftw3.h>
+#include <clapfft/sliding_dft.hpp>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <vector>
+
+#include "test_signals.hpp"
+
+using clapfft_test::two_tone;
+
+namespace
+{
+    // DFT bin k of the n samples ending at `end` (exclusive), zeros before
+    // the start of x.
+    template <typename S>
+    std::complex<long double> window_bin(const std::vector<S> &x, std::size_t end, std::size_t n, std::size_t k)
+    {
+        const long double two_pi = 6.283185307179586476925286766559L;
+        std::complex<long double> sum;
+        for (std::size_t j = 0; j < n; ++j)
+        {
+            if (end + j < n)
+            {
+                continue;
+            }
+            const std::complex<long double> v(x[end + j - n]);
+            const long double angle = -two_pi * static_cast<long double>((k * j) % n) / static_cast<long double>(n);
+            sum += v * std::complex<long double>(std::cos(angle), std::sin(angle));
+        }
+        return sum;
+    }
+
+    template <typename T>
+    long double distance(const std::complex<T> &a, const std::complex<long double> &b)
+    {
+        return std::abs(std::complex<long double>(a.real(), a.imag()) - b);
+    }
+}
+
+void test_tracks_window()
+{
+    std::cout << "Testing per-sample bins against the direct DFT..." << std::endl;
+    const std::size_t n = 64;
+    const std::vector<std::size_t> bins = {0, 1, 5, 31, 32, 63};
+    const std::vector<double> x = two_tone<double>(500, 0.0);
+
+    clapfft::SlidingDFT<double> sdft(n, bins);
+    assert(sdft.valid() && sdft.window_size() == n && sdft.channels() == 1);
+    assert(sdft.resync_interval() == n && sdft.bins() == bins);
+
+    // Every sample's spectrum, across resyncs and partial windows.
+    std::vector<std::complex<double>> out(x.size() * bins.size());
+    std::size_t pos = 0;
+    const std::size_t chunks[] = {1, 7, 64, 100, 3};
+    for (std::size_t c = 0; pos < x.size(); c = (c + 1) % 5)
+    {
+        const std::size_t count = std::min(chunks[c], x.size() - pos);
+        const bool ok = sdft.push(x.data() + pos, count, out.data() + pos * bins.size());
+        assert(ok);
+        (void)ok;
+        pos += count;
+    }
+    long double worst = 0;
+    for (std::size_t s = 0; s < x.size(); ++s)
+    {
+        for (std::size_t i = 0; i < bins.size(); ++i)
+        {
+            worst = std::max(worst, distance(out[s * bins.size() + i], window_bin(x, s + 1, n, bins[i])));
+        }
+    }
+    assert(worst <= 1e-11L);
+
+    std::vector<std::complex<double>> now(bins.size());
+    sdft.spectrum(now.data());
+    for (std::size_t i = 0; i < bins.size(); ++i)
+    {
+        assert(now[i] == out[(x.size() - 1) * bins.size() + i]);
+    }
+
+    sdft.reset();
+    sdft.spectrum(now.data());
+    for (std::size_t i = 0; i < bins.size(); ++i)
+    {
+        assert(now[i] == std::complex<double>());
+    }
+    (void)worst;
+}
+
+void test_bin_centre_tone()
+{
+    std::cout << "Testing a complex exponential at a bin centre..." << std::endl;
+    // x[t] = A exp(2 pi i k0 t / n). Once the window is full, bin k0 is
+    // n A exp(2 pi i k0 (t + 1) / n) and every other bin is zero.
+    const std::size_t n = 64, k0 = 5, length = 300;
+    const std::vector<std::size_t> bins = {0, 4, 5, 6, 59};
+    const long double two_pi = 6.283185307179586476925286766559L;
+    const std::complex<long double> amplitude(0.5L, -1.5L);
+    std::vector<std::complex<double>> x(length);
+    for (std::size_t t = 0; t < length; ++t)
+    {
+        const long double angle = two_pi * static_cast<long double>((k0 * t) % n) / static_cast<long double>(n);
+        const std::complex<long double> v = amplitude * std::complex<long double>(std::cos(angle), std::sin(angle));
+        x[t] = std::complex<double>(static_cast<double>(v.real()), static_cast<double>(v.imag()));
+    }
+
+    clapfft::SlidingDFT<double> sdft(n, bins, 1, 40);
+    std::vector<std::complex<double>> out(length * bins.size());
+    const bool ok = sdft.push(x.data(), length, out.data());
+    assert(ok);
+    (void)ok;
+    long double worst = 0;
+    for (std::size_t t = n - 1; t < length; ++t)
+    {
+        const long double angle = two_pi * static_cast<long double>((k0 * (t + 1)) % n) / static_cast<long double>(n);
+        const std::complex<long double> peak =
+            static_cast<long double>(n) * amplitude * std::complex<long double>(std::cos(angle), std::sin(angle));
+        for (std::size_t i = 0; i < bins.size(); ++i)
+        {
+            const std::complex<long double> want = bins[i] == k0 ? peak : std::complex<long double>();
+            worst = std::max(worst, distance(out[t * bins.size() + i], want));
+        }
+    }
+    assert(worst <= 1e-11L);
+    (void)worst;
+}
+
+void test_multichannel_complex()
+{
+    std::cout << "Testing complex multi-channel input..." << std::endl;
+    const std::size_t n = 50, channels = 3;
+    const std::vector<std::size_t> bins = {2, 3, 17, 49};
+    std::vector<std::vector<std::complex<float>>> x(channels);
+    std::vector<const std::complex<float> *> in(channels);
+    for (std::size_t c = 0; c < channels; ++c)
+    {
+        const std::vector<float> re = two_tone<float>(300, 0.5 * static_cast<double>(c));
+        const std::vector<float> im = two_tone<float>(300, 2.0 + static_cast<double>(c));
+        for (std::size_t i = 0; i < re.size(); ++i)
+        {
+            x[c].push_back(std::complex<float>(re[i], im[i]));
+        }
+        in[c] = x[c].data();
+    }
+
+    clapfft::SlidingDFT<float> sdft(n, bins, channels, 37);
+    const bool ok = sdft.push(in.data(), 300);
+    assert(ok);
+    (void)ok;
+    std::vector<std::complex<float>> now(channels * bins.size());
+    sdft.spectrum(now.data());
+    for (std::size_t c = 0; c < channels; ++c)
+    {
+        for (std::size_t i = 0; i < bins.size(); ++i)
+        {
+            assert(distance(now[c * bins.size() + i], window_bin(x[c], 300, n, bins[i])) <= 1e-4L);
+        }
+    }
+}
+
+void test_long_run_stability()
+{
+    std::cout << "Testing error growth over a long stream..." << std::endl;
+    // Without resyncs the modulated recurrence only accumulates rounding
+    // in the running sums; with them the error stays at a single
+    // window's worth.
+    const std::size_t n = 256, length = 200000;
+    const std::vector<std::size_t> bins = {1, 10, 77, 128, 200};
+    const std::vector<float> x = two_tone<float>(length, 0.7);
+    clapfft::SlidingDFT<float> free_running(n, bins, 1, length + 1);
+    clapfft::SlidingDFT<float> resynced(n, bins);
+    free_running.push(x.data(), length);
+    resynced.push(x.data(), length);
+
+    std::vector<std::complex<float>> a(bins.size()), b(bins.size());
+    free_running.spectrum(a.data());
+    resynced.spectrum(b.data());
+    long double drift = 0, fresh = 0;
+    for (std::size_t i = 0; i < bins.size(); ++i)
+    {
+        const std::complex<long double> expected = window_bin(x, length, n, bins[i]);
+        drift = std::max(drift, distance(a[i], expected));
+        fresh = std::max(fresh, distance(b[i], expected));
+    }
+    assert(drift <= 5e-3L);
+    assert(fresh <= 5e-4L);
+
+    // An explicit resync brings the free-running one back.
+    free_running.resync();
+    free_running.spectrum(a.data());
+    for (std::size_t i = 0; i < bins.size(); ++i)
+    {
+        assert(distance(a[i], window_bin(x, length, n, bins[i])) <= 5e-4L);
+    }
+    (void)drift;
+    (void)fresh;
+}
+
+void test_invalid()
+{
+    std::cout << "Testing invalid configurations..." << std::endl;
+    assert(!clapfft::SlidingDFT<double>(0, {0}).valid());
+    assert(!clapfft::SlidingDFT<double>(8, {}).valid());
+    assert(!clapfft::SlidingDFT<double>(8, {8}).valid());
+    assert(!clapfft::SlidingDFT<double>(8, {1}, 0).valid());
+    clapfft::SlidingDFT<long double> stereo(8, {1}, 2);
+    const long double sample = 1.0L;
+    const bool ok = stereo.push(&sample, 1);
+    assert(!ok && stereo.valid());
+    (void)ok;
+    clapfft::SlidingDFT<double> none;
+    assert(none.bins().empty() && none.window_size() == 0);
+}
+
+int main()
+{
+    test_tracks_window();
+    test_bin_centre_tone();
+    test_multichannel_complex();
+    test_long_run_stability();
+    test_invalid();
+    std::cout << "All sliding DFT tests passed!" << std::endl;
+    return 0;
+}
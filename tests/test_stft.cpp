@@ -0,0 +1,205 @@
+#include <fftw3.h>
+#include <clapfft/stft.hpp>
+#include <clapfft/aligned_buffer.hpp>
+#include <clapfft/clapfft_api.hpp>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <vector>
+
+#include "test_signals.hpp"
+
+using clapfft_test::two_tone;
+
+namespace
+{
+    // Frame-at-a-time reference built on FFT::r2c_1d.
+    template <typename T>
+    std::vector<std::complex<T>> reference_stft(const std::vector<T> &signal, const std::vector<T> &window,
+                                                std::size_t hop)
+    {
+        const std::size_t n = window.size();
+        std::vector<std::complex<T>> result;
+        for (std::size_t start = 0; start + n <= signal.size(); start += hop)
+        {
+            std::vector<T> frame(n);
+            for (std::size_t k = 0; k < n; ++k)
+            {
+                frame[k] = signal[start + k] * window[k];
+            }
+            std::vector<std::complex<T>> spectrum;
+            clapfft::FFT::r2c_1d(frame, spectrum);
+            result.insert(result.end(), spectrum.begin(), spectrum.end());
+        }
+        return result;
+    }
+}
+
+void test_hann_window()
+{
+    std::cout << "Testing Hann window..." << std::endl;
+    const std::vector<double> w = clapfft::hann_window<double>(8);
+    assert(w.size() == 8);
+    assert(std::abs(w[0]) <= 1e-15);
+    assert(std::abs(w[4] - 1.0) <= 1e-15);
+    // Periodic: copies shifted by n / 2 sum to one.
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        assert(std::abs(w[i] + w[i + 4] - 1.0) <= 1e-12);
+    }
+}
+
+void test_streaming_matches_reference()
+{
+    std::cout << "Testing streaming STFT against per-frame r2c..." << std::endl;
+    const std::size_t n = 64, hop = 16;
+    const std::vector<double> window = clapfft::hann_window<double>(n);
+    const std::vector<double> signal = two_tone<double>(1000, 0.0);
+    const std::vector<std::complex<double>> expected = reference_stft(signal, window, hop);
+
+    // Small batches so pushes span several full and partial batches.
+    clapfft::STFT<double> stft(window, hop, 4);
+    assert(stft.valid());
+    assert(stft.frame_size() == n && stft.hop() == hop && stft.bins() == n / 2 + 1);
+
+    const std::size_t chunks[] = {1, 7, 63, 2, 150, 333, 17, 1, 200};
+    std::vector<std::complex<double>> out;
+    std::size_t pos = 0;
+    std::size_t frames = 0;
+    for (std::size_t c = 0; pos < signal.size(); c = (c + 1) % (sizeof(chunks) / sizeof(chunks[0])))
+    {
+        const std::size_t count = std::min(chunks[c], signal.size() - pos);
+        const std::vector<double> chunk(signal.begin() + static_cast<std::ptrdiff_t>(pos),
+                                        signal.begin() + static_cast<std::ptrdiff_t>(pos + count));
+        const std::size_t ready = stft.frames_ready(count);
+        const std::size_t produced = stft.push(chunk, out);
+        assert(produced == ready);
+        (void)ready;
+        frames += produced;
+        pos += count;
+    }
+    assert(frames == (signal.size() - n) / hop + 1);
+    assert(out.size() == expected.size());
+    for (std::size_t i = 0; i < out.size(); ++i)
+    {
+        assert(std::abs(out[i] - expected[i]) <= 1e-9);
+    }
+}
+
+void test_stationary_tone()
+{
+    std::cout << "Testing frame magnitudes of a stationary tone..." << std::endl;
+    // cos(2 pi k0 t / n) under a periodic Hann window of n points: every
+    // frame, wherever it starts, has |X[k0]| = n / 4, |X[k0 +- 1]| = n / 8
+    // and nothing in the other bins.
+    const std::size_t n = 64, hop = 24, k0 = 8;
+    const long double two_pi = 6.283185307179586476925286766559L;
+    std::vector<double> tone(600);
+    for (std::size_t t = 0; t < tone.size(); ++t)
+    {
+        tone[t] = static_cast<double>(std::cos(two_pi * static_cast<long double>((k0 * t) % n) / static_cast<long double>(n)));
+    }
+    clapfft::STFT<double> stft(clapfft::hann_window<double>(n), hop, 5);
+    std::vector<std::complex<double>> out;
+    const std::size_t frames = stft.push(tone, out);
+    assert(frames == (tone.size() - n) / hop + 1);
+    const std::size_t bins = stft.bins();
+    for (std::size_t f = 0; f < frames; ++f)
+    {
+        for (std::size_t b = 0; b < bins; ++b)
+        {
+            const double want = b == k0 ? n / 4.0 : b + 1 == k0 || b == k0 + 1 ? n / 8.0 : 0.0;
+            assert(std::abs(std::abs(out[f * bins + b]) - want) <= 1e-12);
+            (void)want;
+        }
+    }
+    (void)frames;
+}
+
+void test_aligned_output_and_flush()
+{
+    std::cout << "Testing aligned output and flush..." << std::endl;
+    const std::size_t n = 32, hop = 8;
+    const std::vector<float> window = clapfft::hann_window<float>(n);
+    const std::vector<float> signal = two_tone<float>(100, 0.0);
+    const std::vector<std::complex<float>> expected = reference_stft(signal, window, hop);
+
+    clapfft::STFT<float> stft(window, hop, 3);
+    const std::size_t bins = stft.bins();
+    clapfft::AlignedBuffer<std::complex<float>> out(16 * bins);
+    std::size_t frames = stft.push(signal.data(), 60, out.data());
+    frames += stft.push(signal.data() + 60, 40, out.data() + frames * bins);
+    assert(frames == 9);
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        assert(std::abs(out[i] - expected[i]) <= 1e-4f);
+    }
+
+    // Samples 96..99 are not in any frame yet: one zero-padded frame.
+    const std::size_t last = stft.flush(out.data() + frames * bins);
+    assert(last == 1);
+    std::vector<float> padded(n, 0.0f);
+    for (std::size_t k = 0; k < 28; ++k)
+    {
+        padded[k] = signal[72 + k] * window[k];
+    }
+    std::vector<std::complex<float>> tail;
+    clapfft::FFT::r2c_1d(padded, tail);
+    for (std::size_t b = 0; b < bins; ++b)
+    {
+        assert(std::abs(out[frames * bins + b] - tail[b]) <= 1e-4f);
+    }
+
+    // After a flush the stream starts over; a fully covered stream adds
+    // no frame.
+    std::vector<std::complex<float>> again;
+    frames = stft.push(std::vector<float>(signal.begin(), signal.begin() + 40), again);
+    assert(frames == 2);
+    frames = stft.flush(again);
+    assert(frames == 0);
+    assert(again.size() == 2 * bins);
+
+    // Fewer samples than one frame: flush pads them into one.
+    frames = stft.push(std::vector<float>(signal.begin(), signal.begin() + 5), again);
+    assert(frames == 0);
+    frames = stft.flush(again);
+    assert(frames == 1);
+    assert(again.size() == 3 * bins);
+    (void)last;
+}
+
+void test_long_double_and_invalid()
+{
+    std::cout << "Testing long double and invalid configurations..." << std::endl;
+    const std::vector<long double> window(16, 1.0L);
+    clapfft::STFT<long double> stft(window, 16);
+    std::vector<long double> ones(48, 1.0L);
+    std::vector<std::complex<long double>> out;
+    std::size_t frames = stft.push(ones, out);
+    assert(frames == 3);
+    assert(std::abs(out[0] - std::complex<long double>(16.0L, 0.0L)) <= 1e-12L);
+    assert(std::abs(out[1]) <= 1e-12L);
+
+    assert(!clapfft::STFT<double>(std::vector<double>(), 1).valid());
+    assert(!clapfft::STFT<double>(std::vector<double>(8, 1.0), 0).valid());
+    assert(!clapfft::STFT<double>(std::vector<double>(8, 1.0), 9).valid());
+    clapfft::STFT<double> invalid;
+    std::vector<std::complex<double>> none;
+    frames = invalid.push(std::vector<double>(100, 1.0), none);
+    assert(frames == 0 && none.empty());
+    frames = invalid.flush(none);
+    assert(frames == 0);
+    (void)frames;
+}
+
+int main()
+{
+    test_hann_window();
+    test_streaming_matches_reference();
+    test_stationary_tone();
+    test_aligned_output_and_flush();
+    test_long_double_and_invalid();
+    std::cout << "All STFT tests passed!" << std::endl;
+    return 0;
+}
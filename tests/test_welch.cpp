@@ -0,0 +1,273 @@
+#include <fftw3.h>
+#include <clapfft/complex_ops.hpp>
+#include <clapfft/welch.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+    const long double pi = 3.141592653589793238462643383279502884L;
+
+    template <typename T>
+    std::vector<T> hann(std::size_t n)
+    {
+        std::vector<T> w(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            w[i] = static_cast<T>(0.5L - 0.5L * std::cos(2 * pi * static_cast<long double>(i) / static_cast<long double>(n)));
+        }
+        return w;
+    }
+
+    // Mean one-sided periodogram over the segments of x, by direct DFT.
+    template <typename T>
+    std::vector<long double> reference(const std::vector<T> &x, const std::vector<T> &w, std::size_t hop, double fs,
+                                       const clapfft::WelchOptions &options)
+    {
+        const std::size_t n = w.size(), bins = n / 2 + 1;
+        long double sum = 0, squares = 0;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            sum += w[i];
+            squares += static_cast<long double>(w[i]) * w[i];
+        }
+        const long double scale =
+            options.scaling == clapfft::PsdScaling::Density ? 1.0L / (static_cast<long double>(fs) * squares) : 1.0L / (sum * sum);
+
+        std::vector<long double> psd(bins);
+        std::size_t segments = 0;
+        for (std::size_t start = 0; start + n <= x.size(); start += hop, ++segments)
+        {
+            long double mean = 0;
+            if (options.detrend)
+            {
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    mean += x[start + i];
+                }
+                mean /= static_cast<long double>(n);
+            }
+            for (std::size_t k = 0; k < bins; ++k)
+            {
+                std::complex<long double> acc;
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    const long double a = -2 * pi * static_cast<long double>((k * i) % n) / static_cast<long double>(n);
+                    acc += (static_cast<long double>(x[start + i]) - mean) * static_cast<long double>(w[i]) *
+                           std::complex<long double>(std::cos(a), std::sin(a));
+                }
+                const long double factor = k >= 1 && k <= (n - 1) / 2 ? 2 : 1;
+                psd[k] += factor * scale * std::norm(acc);
+            }
+        }
+        for (std::size_t k = 0; k < bins; ++k)
+        {
+            psd[k] /= static_cast<long double>(segments);
+        }
+        return psd;
+    }
+
+    template <typename T>
+    long double relative_error(const T *got, const std::vector<long double> &want)
+    {
+        long double err = 0, norm = 0;
+        for (std::size_t k = 0; k < want.size(); ++k)
+        {
+            err += (got[k] - want[k]) * (got[k] - want[k]);
+            norm += want[k] * want[k];
+        }
+        return std::sqrt(err / norm);
+    }
+
+    // Streams several channels in uneven chunks and compares each against
+    // the direct reference.
+    template <typename T>
+    void check(std::size_t channels, std::size_t n, std::size_t hop, std::size_t length, const clapfft::WelchOptions &base,
+               double tolerance)
+    {
+        std::mt19937 rng(static_cast<unsigned>(n * 31 + hop + channels));
+        std::uniform_real_distribution<double> value(-1.0, 1.0);
+        std::vector<std::vector<T>> x(channels, std::vector<T>(length));
+        for (std::size_t c = 0; c < channels; ++c)
+        {
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                // An offset per channel makes detrending matter.
+                x[c][i] = static_cast<T>(value(rng) + 0.5 * static_cast<double>(c));
+            }
+        }
+        const std::vector<T> w = hann<T>(n);
+        const double fs = 48000.0;
+        clapfft::WelchOptions options = base;
+        options.hop = hop;
+
+        clapfft::Welch<T> welch(channels, w, fs, options);
+        assert(welch.valid() && welch.channels() == channels && welch.segment_size() == n);
+        assert(welch.hop() == hop && welch.bins() == n / 2 + 1);
+
+        const std::size_t chunks[] = {1, 7, n / 3 + 1, 2 * n + 5, 3, n};
+        std::size_t at = 0, completed = 0;
+        for (std::size_t i = 0; at < length; ++i)
+        {
+            const std::size_t count = std::min(chunks[i % 6], length - at);
+            std::vector<const T *> in(channels);
+            for (std::size_t c = 0; c < channels; ++c)
+            {
+                in[c] = x[c].data() + at;
+            }
+            completed += welch.push(in.data(), count);
+            at += count;
+        }
+        const std::size_t expected = (length - n) / hop + 1;
+        assert(completed == expected && welch.segments() == expected);
+
+        std::vector<T> psd(channels * welch.bins());
+        const std::size_t segments = welch.psd(psd.data());
+        assert(segments == expected);
+        for (std::size_t c = 0; c < channels; ++c)
+        {
+            const std::vector<long double> want = reference(x[c], w, hop, fs, options);
+            const long double error = relative_error(psd.data() + c * welch.bins(), want);
+            assert(error <= tolerance);
+            (void)error;
+        }
+        (void)completed;
+        (void)segments;
+        (void)expected;
+        (void)tolerance;
+    }
+}
+
+void test_norm_add()
+{
+    std::cout << "Testing ComplexOps::norm_add..." << std::endl;
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> value(-2.0, 2.0);
+    // Odd counts run the vector loops and their tails.
+    std::vector<std::complex<double>> a(13);
+    std::vector<std::complex<float>> af(13);
+    std::vector<std::complex<long double>> al(13);
+    std::vector<double> acc(13, 1.0);
+    std::vector<float> accf(13, 1.0f);
+    std::vector<long double> accl(13, 1.0L);
+    for (std::size_t i = 0; i < a.size(); ++i)
+    {
+        a[i] = std::complex<double>(value(rng), value(rng));
+        af[i] = std::complex<float>(static_cast<float>(a[i].real()), static_cast<float>(a[i].imag()));
+        al[i] = std::complex<long double>(a[i].real(), a[i].imag());
+    }
+    clapfft::ComplexOps::norm_add(a.data(), acc.data(), a.size());
+    clapfft::ComplexOps::norm_add(af.data(), accf.data(), af.size());
+    clapfft::ComplexOps::norm_add(al.data(), accl.data(), al.size());
+    for (std::size_t i = 0; i < a.size(); ++i)
+    {
+        const double want = 1.0 + std::norm(a[i]);
+        assert(std::abs(acc[i] - want) <= 1e-14 * want);
+        assert(std::abs(accf[i] - want) <= 1e-6 * want);
+        assert(std::abs(static_cast<double>(accl[i]) - want) <= 1e-14 * want);
+        (void)want;
+    }
+}
+
+void test_against_reference()
+{
+    std::cout << "Testing against direct periodograms..." << std::endl;
+    clapfft::WelchOptions density;
+    clapfft::WelchOptions spectrum;
+    spectrum.scaling = clapfft::PsdScaling::Spectrum;
+    spectrum.detrend = true;
+    clapfft::WelchOptions small_batch = density;
+    small_batch.detrend = true;
+    small_batch.max_batch = 3;
+
+    check<double>(1, 64, 32, 1000, density, 1e-12);
+    check<double>(3, 45, 17, 700, spectrum, 1e-12);
+    check<double>(2, 32, 32, 500, small_batch, 1e-12);
+    check<long double>(2, 40, 10, 400, spectrum, 1e-12);
+    check<float>(4, 128, 64, 2000, small_batch, 1e-5);
+    check<float>(1, 27, 5, 300, density, 1e-5);
+}
+
+void test_tone_power()
+{
+    std::cout << "Testing the power of a sine..." << std::endl;
+    const std::size_t n = 256, length = 40000;
+    const double fs = 1000.0, amplitude = 3.0, frequency = 123.0;
+    std::vector<double> x(length);
+    for (std::size_t i = 0; i < length; ++i)
+    {
+        x[i] = amplitude * std::sin(2 * static_cast<double>(pi) * frequency * static_cast<double>(i) / fs);
+    }
+    const std::vector<double> w = hann<double>(n);
+    const std::vector<double> psd = clapfft::welch(x, w, fs);
+    assert(psd.size() == n / 2 + 1);
+
+    // The density integrates to the signal's power, A^2 / 2.
+    double power = 0;
+    std::size_t peak = 0;
+    for (std::size_t k = 0; k < psd.size(); ++k)
+    {
+        power += psd[k] * fs / static_cast<double>(n);
+        peak = psd[k] > psd[peak] ? k : peak;
+    }
+    assert(std::abs(power - amplitude * amplitude / 2) <= 1e-3 * amplitude * amplitude);
+
+    clapfft::Welch<double> welch(1, w, fs);
+    const std::vector<double> f = welch.frequencies();
+    assert(f.size() == n / 2 + 1 && f[0] == 0.0 && std::abs(f[n / 2] - fs / 2) < 1e-12);
+    assert(std::abs(f[peak] - frequency) <= fs / static_cast<double>(n));
+    (void)power;
+    (void)peak;
+}
+
+void test_reset_and_invalid()
+{
+    std::cout << "Testing reset and invalid configurations..." << std::endl;
+    const std::vector<double> w = hann<double>(16);
+    clapfft::Welch<double> welch(1, w, 1.0);
+    std::vector<double> x(40, 1.0), psd(welch.bins(), -1.0);
+
+    // Before any full segment the estimate is zero.
+    std::size_t done = welch.push(x.data(), 15);
+    assert(done == 0 && welch.psd(psd.data()) == 0 && psd[0] == 0.0);
+    done = welch.push(x.data(), 1);
+    assert(done == 1 && welch.segments() == 1);
+    welch.reset();
+    assert(welch.segments() == 0 && welch.psd(psd.data()) == 0 && psd[0] == 0.0);
+    done = welch.push(x.data(), x.size());
+    assert(done == 4);
+
+    // Two channels need the multi-channel push.
+    clapfft::Welch<double> pair(2, w, 1.0);
+    assert(pair.push(x.data(), x.size()) == 0);
+
+    clapfft::WelchOptions options;
+    options.hop = 17;
+    assert(!clapfft::Welch<double>(1, w, 1.0, options).valid());
+    assert(!clapfft::Welch<double>(0, w, 1.0).valid());
+    assert(!clapfft::Welch<double>(1, std::vector<double>(), 1.0).valid());
+    assert(!clapfft::Welch<double>(1, std::vector<double>(8, 0.0), 1.0).valid());
+    assert(!clapfft::Welch<double>(1, w, 0.0).valid());
+    assert(clapfft::welch(std::vector<double>(15, 1.0), w, 1.0).empty());
+
+    clapfft::Welch<float> invalid;
+    float out = 0;
+    assert(!invalid.valid() && invalid.push(&out, 1) == 0 && invalid.psd(&out) == 0 && invalid.frequencies().empty());
+    (void)done;
+    (void)out;
+}
+
+int main()
+{
+    test_norm_add();
+    test_against_reference();
+    test_tone_power();
+    test_reset_and_invalid();
+    std::cout << "All Welch tests passed!" << std::endl;
+    return 0;
+}